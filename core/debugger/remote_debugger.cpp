@@ -37,6 +37,7 @@
 #include "core/debugger/script_debugger.h"
 #include "core/input/input.h"
 #include "core/object/script_language.h"
+#include "core/os/allocation_tracker.h"
 #include "core/os/os.h"
 
 class RemoteDebugger::MultiplayerProfiler : public EngineProfiler {
@@ -174,6 +175,49 @@ public:
 	}
 };
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+// Off unless a client enables "profiler:allocations", which the editor itself never does:
+// the messages are meant for an EditorDebuggerPlugin that registered the "allocations" capture.
+class RemoteDebugger::AllocationProfiler : public EngineProfiler {
+	int max_sites = 32;
+
+public:
+	void toggle(bool p_enable, const Array &p_opts) {
+		if (p_enable && p_opts.size() > 0) {
+			max_sites = MAX(1, int(p_opts[0]));
+		}
+	}
+
+	void add(const Array &p_data) {}
+
+	void tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) {
+		// Frame boundaries are set by Main::iteration(), this only reports the last one.
+		Vector<AllocationTracker::SiteStats> stats = AllocationTracker::get_frame_summary();
+
+		uint64_t total_count = 0;
+		uint64_t total_bytes = 0;
+		for (const AllocationTracker::SiteStats &s : stats) {
+			total_count += s.count;
+			total_bytes += s.bytes;
+		}
+
+		// Format: frame, total count, total bytes, then (site, count, bytes) for the largest sites.
+		int sites = MIN(max_sites, stats.size());
+		Array arr;
+		arr.resize(3 + sites * 3);
+		arr[0] = AllocationTracker::get_frame_count();
+		arr[1] = total_count;
+		arr[2] = total_bytes;
+		for (int i = 0; i < sites; i++) {
+			arr[3 + i * 3 + 0] = stats[i].site;
+			arr[3 + i * 3 + 1] = stats[i].count;
+			arr[3 + i * 3 + 2] = stats[i].bytes;
+		}
+		EngineDebugger::get_singleton()->send_message("allocations:frame", arr);
+	}
+};
+#endif
+
 Error RemoteDebugger::_put_msg(String p_message, Array p_data) {
 	Array msg;
 	msg.push_back(p_message);
@@ -668,6 +712,12 @@ RemoteDebugger::RemoteDebugger(Ref<RemoteDebuggerPeer> p_peer) {
 		profiler_enable("performance", true);
 	}
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+	// Allocation Profiler
+	allocation_profiler.instantiate();
+	allocation_profiler->bind("allocations");
+#endif
+
 	// Core and profiler captures.
 	Capture core_cap(this,
 			[](void *p_user, const String &p_cmd, const Array &p_data, bool &r_captured) {
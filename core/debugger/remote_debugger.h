@@ -52,9 +52,15 @@ private:
 
 	class MultiplayerProfiler;
 	class PerformanceProfiler;
+#ifdef ALLOCATION_TRACKING_ENABLED
+	class AllocationProfiler;
+#endif
 
 	Ref<MultiplayerProfiler> multiplayer_profiler;
 	Ref<PerformanceProfiler> performance_profiler;
+#ifdef ALLOCATION_TRACKING_ENABLED
+	Ref<AllocationProfiler> allocation_profiler;
+#endif
 
 	Ref<RemoteDebuggerPeer> peer;
 
@@ -35,10 +35,99 @@
 
 #include "thirdparty/misc/fastlz.h"
 
+#include <zdict.h>
 #include <zlib.h>
 #include <zstd.h>
 
-int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+struct Compression::ZstdDictionary {
+	ZSTD_CDict *cdict = nullptr;
+	ZSTD_DDict *ddict = nullptr;
+	uint32_t id = 0;
+};
+
+Compression::ZstdDictionary *Compression::zstd_dictionary_create(const Vector<uint8_t> &p_data) {
+	ERR_FAIL_COND_V(p_data.is_empty(), nullptr);
+
+	// Both trained dictionaries (as produced by `zstd --train`) and raw content are accepted.
+	ZstdDictionary *dict = memnew(ZstdDictionary);
+	dict->cdict = ZSTD_createCDict(p_data.ptr(), p_data.size(), zstd_level);
+	dict->ddict = ZSTD_createDDict(p_data.ptr(), p_data.size());
+	if (!dict->cdict || !dict->ddict) {
+		zstd_dictionary_free(dict);
+		ERR_FAIL_V_MSG(nullptr, "Invalid zstd dictionary.");
+	}
+	// Raw content dictionaries have no ID of their own.
+	dict->id = ZSTD_getDictID_fromDict(p_data.ptr(), p_data.size());
+	if (dict->id == 0) {
+		dict->id = MAX(hash_murmur3_buffer(p_data.ptr(), p_data.size()), 1u);
+	}
+	return dict;
+}
+
+uint32_t Compression::zstd_dictionary_get_id(const ZstdDictionary *p_dict) {
+	ERR_FAIL_NULL_V(p_dict, 0);
+	return p_dict->id;
+}
+
+void Compression::zstd_dictionary_free(ZstdDictionary *p_dict) {
+	if (!p_dict) {
+		return;
+	}
+	ZSTD_freeCDict(p_dict->cdict);
+	ZSTD_freeDDict(p_dict->ddict);
+	memdelete(p_dict);
+}
+
+Vector<uint8_t> Compression::zstd_dictionary_build(const Vector<Vector<uint8_t>> &p_samples, int p_max_size) {
+	Vector<uint8_t> dict;
+	ERR_FAIL_COND_V(p_max_size <= 0, dict);
+
+	Vector<uint8_t> samples;
+	Vector<size_t> sample_sizes;
+	for (int i = 0; i < p_samples.size(); i++) {
+		if (p_samples[i].is_empty()) {
+			continue;
+		}
+		int ofs = samples.size();
+		samples.resize(ofs + p_samples[i].size());
+		memcpy(samples.ptrw() + ofs, p_samples[i].ptr(), p_samples[i].size());
+		sample_sizes.push_back(p_samples[i].size());
+	}
+	if (sample_sizes.is_empty()) {
+		return dict;
+	}
+
+	dict.resize(p_max_size);
+	size_t ret = ZDICT_trainFromBuffer(dict.ptrw(), p_max_size, samples.ptr(), sample_sizes.ptr(), sample_sizes.size());
+	if (!ZDICT_isError(ret)) {
+		dict.resize(ret);
+		return dict;
+	}
+	print_verbose(vformat("Can't train a zstd dictionary on %d samples: %s.", sample_sizes.size(), ZDICT_getErrorName(ret)));
+
+	// Training fails on too few or too uniform samples. Those share most of their content,
+	// so a few of them make a good raw content dictionary, a larger one would take more
+	// space than it saves.
+	const int dict_size = MIN(p_max_size, samples.size() / 8);
+	int sample_count = 0;
+	int used = 0;
+	while (sample_count < p_samples.size() && used < dict_size) {
+		used += MIN(p_samples[sample_count].size(), dict_size - used);
+		sample_count++;
+	}
+	// zstd references content near the end of a dictionary more cheaply, so the samples are
+	// laid out in reverse order to give the first (presumably most relevant) ones that spot.
+	dict.resize(used);
+	int ofs = used;
+	for (int i = 0; i < sample_count; i++) {
+		int len = MIN(p_samples[i].size(), ofs);
+		ofs -= len;
+		memcpy(dict.ptrw() + ofs, p_samples[i].ptr(), len);
+	}
+	return dict;
+}
+
+int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode, const ZstdDictionary *p_zstd_dict) {
 	switch (p_mode) {
 		case MODE_FASTLZ: {
 			if (p_src_size < 16) {
@@ -84,9 +173,14 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 				ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, zstd_window_log_size);
 			}
 			int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
-			int ret = ZSTD_compressCCtx(cctx, p_dst, max_dst_size, p_src, p_src_size, zstd_level);
+			size_t ret;
+			if (p_zstd_dict) {
+				ret = ZSTD_compress_usingCDict(cctx, p_dst, max_dst_size, p_src, p_src_size, p_zstd_dict->cdict);
+			} else {
+				ret = ZSTD_compressCCtx(cctx, p_dst, max_dst_size, p_src, p_src_size, zstd_level);
+			}
 			ZSTD_freeCCtx(cctx);
-			return ret;
+			return ZSTD_isError(ret) ? -1 : (int)ret;
 		} break;
 	}
 
@@ -127,7 +221,7 @@ int Compression::get_max_compressed_buffer_size(int p_src_size, Mode p_mode) {
 	ERR_FAIL_V(-1);
 }
 
-int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode, const ZstdDictionary *p_zstd_dict) {
 	switch (p_mode) {
 		case MODE_FASTLZ: {
 			int ret_size = 0;
@@ -171,9 +265,14 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 			if (zstd_long_distance_matching) {
 				ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, zstd_window_log_size);
 			}
-			int ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+			size_t ret;
+			if (p_zstd_dict) {
+				ret = ZSTD_decompress_usingDDict(dctx, p_dst, p_dst_max_size, p_src, p_src_size, p_zstd_dict->ddict);
+			} else {
+				ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+			}
 			ZSTD_freeDCtx(dctx);
-			return ret;
+			return ZSTD_isError(ret) ? -1 : (int)ret;
 		} break;
 	}
 
@@ -50,9 +50,20 @@ public:
 		MODE_GZIP
 	};
 
-	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	// Digested zstd dictionary, immutable once created and safe to share between threads.
+	struct ZstdDictionary;
+
+	static ZstdDictionary *zstd_dictionary_create(const Vector<uint8_t> &p_data);
+	static void zstd_dictionary_free(ZstdDictionary *p_dict);
+	// Identifies the dictionary in compressed streams, never 0.
+	static uint32_t zstd_dictionary_get_id(const ZstdDictionary *p_dict);
+	// Trains a dictionary on the samples, or makes a raw content one out of the first ones if
+	// training fails. Empty if there's too little data for either.
+	static Vector<uint8_t> zstd_dictionary_build(const Vector<Vector<uint8_t>> &p_samples, int p_max_size = 112640);
+
+	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, const ZstdDictionary *p_zstd_dict = nullptr);
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
-	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, const ZstdDictionary *p_zstd_dict = nullptr);
 	static int decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_size, const uint8_t *p_src, int p_src_size, Mode p_mode);
 };
 
@@ -30,6 +30,7 @@
 
 #include "file_access.h"
 
+#include "core/config/engine.h"
 #include "core/config/project_settings.h"
 #include "core/crypto/crypto_core.h"
 #include "core/io/file_access_pack.h"
@@ -37,6 +38,7 @@
 #include "core/os/os.h"
 
 FileAccess::CreateFunc FileAccess::create_func[ACCESS_MAX] = { nullptr, nullptr };
+FileAccess::CreateFunc FileAccess::create_mapped_func = nullptr;
 
 FileAccess::FileCloseFailNotify FileAccess::close_fail_notify = nullptr;
 
@@ -111,6 +113,38 @@ Ref<FileAccess> FileAccess::open(const String &p_path, int p_mode_flags, Error *
 	return ret;
 }
 
+Ref<FileAccess> FileAccess::open_mapped(const String &p_path, Error *r_error) {
+	// Files inside packs are already served from the mapped pack, if any.
+	bool in_pack = PackedData::get_singleton() && !PackedData::get_singleton()->is_disabled() && PackedData::get_singleton()->has_path(p_path);
+
+	// Reading a mapped file after someone else truncated it raises SIGBUS instead
+	// of an error, so only map files that nothing writes to while they're open.
+	// user:// is written by the game itself, and the editor rewrites project
+	// files and exports packs.
+	bool can_map = !in_pack && !p_path.begins_with("user://") && !Engine::get_singleton()->is_editor_hint();
+
+	if (create_mapped_func && can_map) {
+		Ref<FileAccess> ret = create_mapped_func();
+		if (p_path.begins_with("res://")) {
+			ret->_set_access_type(ACCESS_RESOURCES);
+		} else if (p_path.begins_with("user://")) {
+			ret->_set_access_type(ACCESS_USERDATA);
+		} else {
+			ret->_set_access_type(ACCESS_FILESYSTEM);
+		}
+
+		if (ret->_open(p_path, READ) == OK) {
+			if (r_error) {
+				*r_error = OK;
+			}
+			return ret;
+		}
+	}
+
+	// Mapping isn't available for this file, fall back to regular reads.
+	return open(p_path, READ, r_error);
+}
+
 FileAccess::CreateFunc FileAccess::get_create_func(AccessType p_access) {
 	return create_func[p_access];
 }
@@ -71,6 +71,7 @@ private:
 
 	AccessType _access_type = ACCESS_FILESYSTEM;
 	static CreateFunc create_func[ACCESS_MAX]; /** default file access creation function for a platform */
+	static CreateFunc create_mapped_func; /** read-only memory-mapped file access, if the platform provides one */
 	template <class T>
 	static Ref<FileAccess> _create_builtin() {
 		return memnew(T);
@@ -115,6 +116,8 @@ public:
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
 	virtual String get_as_utf8_string() const;
 
+	virtual const uint8_t *get_mapped_span(uint64_t p_offset, uint64_t p_length) const { return nullptr; } ///< get the bytes at [p_offset, p_offset + p_length) without copying, or nullptr if the file is not memory-mapped
+
 	/**
 	 * Use this for files WRITTEN in _big_ endian machines (ie, amiga/mac)
 	 * It's not about the current CPU type but file formats.
@@ -151,6 +154,7 @@ public:
 	static Ref<FileAccess> create(AccessType p_access); /// Create a file access (for the current platform) this is the only portable way of accessing files.
 	static Ref<FileAccess> create_for_path(const String &p_path);
 	static Ref<FileAccess> open(const String &p_path, int p_mode_flags, Error *r_error = nullptr); /// Create a file access (for the current platform) this is the only portable way of accessing files.
+	static Ref<FileAccess> open_mapped(const String &p_path, Error *r_error = nullptr); /// Open a file for reading, memory-mapped if the platform supports it. Only for files that aren't modified while open, see the implementation.
 	static CreateFunc get_create_func(AccessType p_access);
 	static bool exists(const String &p_name); ///< return true if a file exists
 	static uint64_t get_modified_time(const String &p_file);
@@ -172,6 +176,11 @@ public:
 		create_func[p_access] = _create_builtin<T>;
 	}
 
+	template <class T>
+	static void make_default_mapped() {
+		create_mapped_func = _create_builtin<T>;
+	}
+
 	FileAccess() {}
 	virtual ~FileAccess() {}
 };
@@ -30,6 +30,7 @@
 
 #include "file_access_compressed.h"
 
+#include "core/io/marshalls.h"
 #include "core/string/print_string.h"
 
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size) {
@@ -58,9 +59,228 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 		}                                                   \
 	}
 
+Vector<uint8_t> FileAccessCompressed::compress_buffer(const uint8_t *p_data, uint64_t p_size, const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size, const Compression::ZstdDictionary *p_zstd_dict) {
+	Vector<uint8_t> ret;
+	ERR_FAIL_COND_V(p_magic.length() != 4, ret);
+	ERR_FAIL_COND_V(p_block_size == 0, ret);
+	ERR_FAIL_COND_V_MSG(p_size > UINT32_MAX, ret, "Compressed files are limited to 4 GiB.");
+
+	// Header: magic, compression mode, dictionary ID (if the mode has MODE_FLAG_ZSTD_DICTIONARY),
+	// block size, total size, then the compressed size of each block.
+	if (p_mode != Compression::MODE_ZSTD) {
+		p_zstd_dict = nullptr;
+	}
+	uint32_t bc = (p_size / p_block_size) + 1;
+	uint64_t header_size = (p_zstd_dict ? 20 : 16) + bc * 4;
+	uint64_t max_size = header_size + 4;
+	for (uint32_t i = 0; i < bc; i++) {
+		uint32_t bl = i == (bc - 1) ? p_size % p_block_size : p_block_size;
+		max_size += Compression::get_max_compressed_buffer_size(bl, p_mode);
+	}
+	ret.resize(max_size);
+	uint8_t *w = ret.ptrw();
+
+	CharString mgc = p_magic.ascii();
+	memcpy(w, mgc.get_data(), 4);
+	uint8_t *h = w + 4;
+	if (p_zstd_dict) {
+		h += encode_uint32(p_mode | MODE_FLAG_ZSTD_DICTIONARY, h);
+		h += encode_uint32(Compression::zstd_dictionary_get_id(p_zstd_dict), h);
+	} else {
+		h += encode_uint32(p_mode, h);
+	}
+	h += encode_uint32(p_block_size, h);
+	h += encode_uint32(p_size, h);
+
+	uint64_t ofs = header_size;
+	for (uint32_t i = 0; i < bc; i++) {
+		uint32_t bl = i == (bc - 1) ? p_size % p_block_size : p_block_size;
+		int s = Compression::compress(w + ofs, p_data + (uint64_t)i * p_block_size, bl, p_mode, p_zstd_dict);
+		ERR_FAIL_COND_V(s < 0, Vector<uint8_t>());
+		encode_uint32(s, h + i * 4);
+		ofs += s;
+	}
+
+	memcpy(w + ofs, mgc.get_data(), 4); // Magic at the end too.
+	ret.resize(ofs + 4);
+	return ret;
+}
+
+void FileAccessCompressed::set_zstd_dictionary(const Compression::ZstdDictionary *p_dict) {
+	ERR_FAIL_COND_MSG(f.is_valid(), "Dictionary must be set before opening the file.");
+	zstd_dict = p_dict;
+}
+
+void FileAccessCompressed::set_read_ahead(bool p_enable) {
+	ERR_FAIL_COND_MSG(f.is_valid(), "Read-ahead must be configured before opening the file.");
+	read_ahead = p_enable;
+}
+
+uint32_t FileAccessCompressed::_get_block_size(uint32_t p_block) const {
+	return p_block == read_block_count - 1 ? read_total - (uint64_t)p_block * block_size : block_size;
+}
+
+Error FileAccessCompressed::_decompress_block(uint32_t p_block, Vector<uint8_t> &r_comp, Vector<uint8_t> &r_data) const {
+	const ReadBlock &rb = read_blocks[p_block];
+	if ((uint32_t)r_comp.size() < rb.csize) {
+		r_comp.resize(rb.csize);
+	}
+	if ((uint32_t)r_data.size() != block_size) {
+		r_data.resize(block_size);
+	}
+
+	// Always seek, the base file may be shared with the read-ahead thread.
+	f->seek(rb.offset);
+	if (f->get_buffer(r_comp.ptrw(), rb.csize) != rb.csize) {
+		return ERR_FILE_CORRUPT;
+	}
+	int ret = Compression::decompress(r_data.ptrw(), block_size, r_comp.ptr(), rb.csize, cmode, read_zstd_dict);
+	return ret == -1 ? ERR_FILE_CORRUPT : OK;
+}
+
+void FileAccessCompressed::_finish_read_ahead() const {
+	if (!read_ahead_pending) {
+		return;
+	}
+	read_ahead_done.wait();
+	read_ahead_pending = false;
+	if (read_ahead_error != OK) {
+		// Dropped; the block will be decoded again (and the error reported) if it's actually read.
+		return;
+	}
+
+	CachedBlock *victim = nullptr;
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+		if (block_cache[i].index != read_block && (!victim || block_cache[i].last_used < victim->last_used)) {
+			victim = &block_cache[i];
+		}
+	}
+	SWAP(victim->data, read_ahead_data);
+	victim->index = read_ahead_block;
+	// Ranked below every block actually read, so it's the first to go if the reader stops being sequential.
+	victim->last_used = 0;
+}
+
+Thread FileAccessCompressed::read_ahead_thread;
+Mutex FileAccessCompressed::read_ahead_mutex;
+Semaphore FileAccessCompressed::read_ahead_requests;
+List<const FileAccessCompressed *> FileAccessCompressed::read_ahead_queue;
+bool FileAccessCompressed::read_ahead_exit = false;
+
+void FileAccessCompressed::_read_ahead_thread(void *p_userdata) {
+	while (true) {
+		read_ahead_requests.wait();
+		const FileAccessCompressed *fac = nullptr;
+		{
+			MutexLock lock(read_ahead_mutex);
+			if (read_ahead_exit) {
+				break;
+			}
+			fac = read_ahead_queue.front()->get();
+			read_ahead_queue.pop_front();
+		}
+		fac->read_ahead_error = fac->_decompress_block(fac->read_ahead_block, fac->read_ahead_comp_buffer, fac->read_ahead_data);
+		fac->read_ahead_done.post();
+	}
+}
+
+bool FileAccessCompressed::_request_read_ahead(uint32_t p_block) const {
+	MutexLock lock(read_ahead_mutex);
+	if (!read_ahead_thread.is_started()) {
+		read_ahead_thread.start(_read_ahead_thread, nullptr);
+		if (!read_ahead_thread.is_started()) {
+			return false; // No threads on this platform.
+		}
+	}
+	read_ahead_block = p_block;
+	read_ahead_pending = true;
+	read_ahead_queue.push_back(this);
+	read_ahead_requests.post();
+	return true;
+}
+
+void FileAccessCompressed::finish_read_ahead() {
+	{
+		MutexLock lock(read_ahead_mutex);
+		if (!read_ahead_thread.is_started()) {
+			return;
+		}
+		read_ahead_exit = true;
+		read_ahead_requests.post();
+	}
+	read_ahead_thread.wait_to_finish();
+	read_ahead_exit = false;
+}
+
+void FileAccessCompressed::_stop_read_ahead() {
+	if (!read_ahead_active) {
+		return;
+	}
+	_finish_read_ahead();
+	read_ahead_active = false;
+	read_ahead_comp_buffer.clear();
+	read_ahead_data.clear();
+}
+
+Error FileAccessCompressed::_load_block(uint32_t p_block) const {
+	_finish_read_ahead();
+
+	CachedBlock *cached = nullptr;
+	CachedBlock *victim = &block_cache[0];
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+		if (block_cache[i].index == p_block) {
+			cached = &block_cache[i];
+			break;
+		}
+		if (block_cache[i].last_used < victim->last_used) {
+			victim = &block_cache[i];
+		}
+	}
+
+	if (!cached) {
+		cached = victim;
+		Error err = _decompress_block(p_block, comp_buffer, cached->data);
+		if (err != OK) {
+			cached->index = UINT32_MAX;
+			cached->last_used = 0;
+			return err;
+		}
+		cached->index = p_block;
+	}
+
+	cached->last_used = ++block_cache_tick;
+	read_ptr = cached->data.ptr();
+	read_block = p_block;
+	read_block_size = _get_block_size(p_block);
+
+	bool sequential = p_block == last_loaded_block + 1; // Also true for the first block, as UINT32_MAX + 1 wraps to 0.
+	last_loaded_block = p_block;
+
+	if (sequential && read_ahead_active && p_block + 1 < read_block_count && _get_block_size(p_block + 1) > 0) {
+		for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+			if (block_cache[i].index == p_block + 1) {
+				return OK;
+			}
+		}
+		_request_read_ahead(p_block + 1);
+	}
+
+	return OK;
+}
+
 Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	f = p_base;
-	cmode = (Compression::Mode)f->get_32();
+	uint32_t mode = f->get_32();
+	read_zstd_dict = nullptr;
+	if (mode & MODE_FLAG_ZSTD_DICTIONARY) {
+		uint32_t dict_id = f->get_32();
+		if (!zstd_dict || Compression::zstd_dictionary_get_id(zstd_dict) != dict_id) {
+			f.unref();
+			ERR_FAIL_V_MSG(ERR_FILE_UNRECOGNIZED, "Can't open compressed file '" + p_base->get_path() + "', it needs the zstd dictionary with ID " + itos(dict_id) + ".");
+		}
+		read_zstd_dict = zstd_dict;
+	}
+	cmode = (Compression::Mode)(mode & ~MODE_FLAG_ZSTD_DICTIONARY);
 	block_size = f->get_32();
 	if (block_size == 0) {
 		f.unref();
@@ -69,30 +289,31 @@ Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	read_total = f->get_32();
 	uint32_t bc = (read_total / block_size) + 1;
 	uint64_t acc_ofs = f->get_position() + bc * 4;
-	uint32_t max_bs = 0;
+	read_blocks.resize(bc);
+	ReadBlock *rbw = read_blocks.ptrw();
 	for (uint32_t i = 0; i < bc; i++) {
-		ReadBlock rb;
-		rb.offset = acc_ofs;
-		rb.csize = f->get_32();
-		acc_ofs += rb.csize;
-		max_bs = MAX(max_bs, rb.csize);
-		read_blocks.push_back(rb);
-	}
-
-	comp_buffer.resize(max_bs);
-	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
-	at_end = false;
-	read_eof = false;
-	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
+		rbw[i].offset = acc_ofs;
+		rbw[i].csize = f->get_32();
+		acc_ofs += rbw[i].csize;
+	}
 
-	int ret = Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+		block_cache[i] = CachedBlock();
+	}
+	block_cache_tick = 0;
+	last_loaded_block = UINT32_MAX;
+	read_block_count = bc;
+	read_eof = false;
 	read_pos = 0;
+	at_end = read_total == 0;
 
-	return ret == -1 ? ERR_FILE_CORRUPT : OK;
+	read_ahead_active = read_ahead && bc >= READ_AHEAD_MIN_BLOCKS;
+
+	Error err = _load_block(0);
+	if (err != OK) {
+		_stop_read_ahead();
+	}
+	return err;
 }
 
 Error FileAccessCompressed::_open(const String &p_path, int p_mode_flags) {
@@ -137,45 +358,19 @@ void FileAccessCompressed::_close() {
 	}
 
 	if (writing) {
-		//save block table and all compressed blocks
-
-		CharString mgc = magic.utf8();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //write header 4
-		f->store_32(cmode); //write compression mode 4
-		f->store_32(block_size); //write block size 4
-		f->store_32(write_max); //max amount of data written 4
-		uint32_t bc = (write_max / block_size) + 1;
-
-		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(0); //compressed sizes, will update later
-		}
-
-		Vector<int> block_sizes;
-		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
-
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
-		}
-
-		f->seek(16); //ok write block sizes
-		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(block_sizes[i]);
-		}
-		f->seek_end();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //magic at the end too
+		Vector<uint8_t> data = compress_buffer(write_ptr, write_max, magic, cmode, block_size, zstd_dict);
+		f->store_buffer(data.ptr(), data.size());
 
 		buffer.clear();
 
 	} else {
+		_stop_read_ahead();
 		comp_buffer.clear();
-		buffer.clear();
 		read_blocks.clear();
+		for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+			block_cache[i] = CachedBlock();
+		}
+		read_ptr = nullptr;
 	}
 	f.unref();
 }
@@ -194,21 +389,16 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 
 	} else {
 		ERR_FAIL_COND(p_position > read_total);
+		read_eof = false;
 		if (p_position == read_total) {
 			at_end = true;
 		} else {
-			at_end = false;
-			read_eof = false;
 			uint32_t block_idx = p_position / block_size;
-			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_MSG(ret == -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			if (block_idx != read_block || !read_ptr) {
+				Error err = _load_block(block_idx);
+				ERR_FAIL_COND_MSG(err != OK, "Compressed file is corrupt.");
 			}
-
+			at_end = false;
 			read_pos = p_position % block_size;
 		}
 	}
@@ -228,7 +418,7 @@ uint64_t FileAccessCompressed::get_position() const {
 	if (writing) {
 		return write_pos;
 	} else {
-		return (uint64_t)read_block * block_size + read_pos;
+		return at_end ? read_total : (uint64_t)read_block * block_size + read_pos;
 	}
 }
 
@@ -263,18 +453,11 @@ uint8_t FileAccessCompressed::get_8() const {
 
 	read_pos++;
 	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
-			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			int total = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			ERR_FAIL_COND_V_MSG(total == -1, 0, "Compressed file is corrupt.");
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+		if (read_block + 1 < read_block_count && _get_block_size(read_block + 1) > 0) {
+			Error err = _load_block(read_block + 1);
+			ERR_FAIL_COND_V_MSG(err != OK, 0, "Compressed file is corrupt.");
 			read_pos = 0;
-
 		} else {
-			read_block--;
 			at_end = true;
 		}
 	}
@@ -287,37 +470,30 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 	ERR_FAIL_COND_V_MSG(f.is_null(), -1, "File must be opened before use.");
 	ERR_FAIL_COND_V_MSG(writing, -1, "File has not been opened in read mode.");
 
-	if (at_end) {
-		read_eof = true;
-		return 0;
-	}
+	uint64_t read = 0;
+	while (read < p_length) {
+		if (at_end) {
+			read_eof = true;
+			break;
+		}
+
+		uint64_t chunk = MIN(p_length - read, read_block_size - read_pos);
+		memcpy(p_dst + read, read_ptr + read_pos, chunk);
+		read_pos += chunk;
+		read += chunk;
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
 		if (read_pos >= read_block_size) {
-			read_block++;
-
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_V_MSG(ret == -1, -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			if (read_block + 1 < read_block_count && _get_block_size(read_block + 1) > 0) {
+				Error err = _load_block(read_block + 1);
+				ERR_FAIL_COND_V_MSG(err != OK, -1, "Compressed file is corrupt.");
 				read_pos = 0;
-
 			} else {
-				read_block--;
 				at_end = true;
-				if (i + 1 < p_length) {
-					read_eof = true;
-				}
-				return i + 1;
 			}
 		}
 	}
 
-	return p_length;
+	return read;
 }
 
 Error FileAccessCompressed::get_error() const {
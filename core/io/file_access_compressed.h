@@ -33,6 +33,10 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/list.h"
 
 class FileAccessCompressed : public FileAccess {
 	Compression::Mode cmode = Compression::MODE_ZSTD;
@@ -50,24 +54,84 @@ class FileAccessCompressed : public FileAccess {
 		uint64_t offset;
 	};
 
+	// Recently decompressed blocks, so seeking back and forth within a small window
+	// (as the binary resource loader does) doesn't decompress the same block again.
+	enum {
+		BLOCK_CACHE_SIZE = 4,
+		READ_AHEAD_MIN_BLOCKS = 8,
+	};
+
+	struct CachedBlock {
+		uint32_t index = UINT32_MAX;
+		uint64_t last_used = 0;
+		Vector<uint8_t> data;
+	};
+
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	mutable const uint8_t *read_ptr = nullptr;
 	mutable uint32_t read_block = 0;
 	uint32_t read_block_count = 0;
 	mutable uint32_t read_block_size = 0;
 	mutable uint64_t read_pos = 0;
 	Vector<ReadBlock> read_blocks;
 	uint64_t read_total = 0;
+	mutable CachedBlock block_cache[BLOCK_CACHE_SIZE];
+	mutable uint64_t block_cache_tick = 0;
+	mutable uint32_t last_loaded_block = UINT32_MAX;
+
+	// Read-ahead: while the caller consumes a block sequentially, the next one is read
+	// and decompressed by a background thread shared by all files. At most one block
+	// per file is in flight, and the base file is only touched by that thread while a
+	// request is pending.
+	bool read_ahead = false;
+	bool read_ahead_active = false;
+	mutable Semaphore read_ahead_done;
+	mutable bool read_ahead_pending = false;
+	mutable uint32_t read_ahead_block = 0;
+	mutable Error read_ahead_error = OK;
+	mutable Vector<uint8_t> read_ahead_comp_buffer;
+	mutable Vector<uint8_t> read_ahead_data;
+
+	static Thread read_ahead_thread;
+	static Mutex read_ahead_mutex;
+	static Semaphore read_ahead_requests;
+	static List<const FileAccessCompressed *> read_ahead_queue;
+	static bool read_ahead_exit;
+
+	// Streams compressed with a dictionary have this flag in the mode, followed by the dictionary ID.
+	static const uint32_t MODE_FLAG_ZSTD_DICTIONARY = 1u << 31;
+
+	const Compression::ZstdDictionary *zstd_dict = nullptr;
+	const Compression::ZstdDictionary *read_zstd_dict = nullptr; // zstd_dict if the stream being read uses it.
 
 	String magic = "GCMP";
 	mutable Vector<uint8_t> buffer;
-	Ref<FileAccess> f;
+	mutable Ref<FileAccess> f; // Seeked from const readers when switching blocks.
+
+	uint32_t _get_block_size(uint32_t p_block) const;
+	Error _decompress_block(uint32_t p_block, Vector<uint8_t> &r_comp, Vector<uint8_t> &r_data) const;
+	Error _load_block(uint32_t p_block) const;
+	bool _request_read_ahead(uint32_t p_block) const;
+	void _finish_read_ahead() const;
+	void _stop_read_ahead();
+	static void _read_ahead_thread(void *p_userdata);
 
 	void _close();
 
 public:
 	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
 
+	// Produces the same stream as writing p_data through a FileAccessCompressed, without going through a file.
+	static Vector<uint8_t> compress_buffer(const uint8_t *p_data, uint64_t p_size, const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size, const Compression::ZstdDictionary *p_zstd_dict = nullptr);
+
+	// Must be set before opening and outlive the file. Only used with Compression::MODE_ZSTD.
+	void set_zstd_dictionary(const Compression::ZstdDictionary *p_dict);
+	// Decompress the next block on a background thread while reading sequentially.
+	// Only takes effect for files with enough blocks to be worth it.
+	void set_read_ahead(bool p_enable);
+	// Stops the read-ahead thread, which is started on first use.
+	static void finish_read_ahead();
+
 	Error open_after_magic(Ref<FileAccess> p_base);
 
 	virtual Error _open(const String &p_path, int p_mode_flags); ///< open a file
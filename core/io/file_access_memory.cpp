@@ -149,6 +149,13 @@ uint64_t FileAccessMemory::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return read;
 }
 
+const uint8_t *FileAccessMemory::get_mapped_span(uint64_t p_offset, uint64_t p_length) const {
+	if (!data || p_offset > length || p_length > length - p_offset) {
+		return nullptr;
+	}
+	return data + p_offset;
+}
+
 Error FileAccessMemory::get_error() const {
 	return pos >= length ? ERR_FILE_EOF : OK;
 }
@@ -30,7 +30,9 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/file_access_memory.h"
 #include "core/object/script_language.h"
 #include "core/os/os.h"
 #include "core/version.h"
@@ -47,13 +49,50 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t
 	return ERR_FILE_UNRECOGNIZED;
 }
 
-void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
+// Returns true if p_dir is left empty.
+bool PackedData::_remove_pack_files(PackedDir *p_dir, const String &p_dir_path, const String &p_pack) {
+	Vector<String> removed_files;
+	for (const String &E : p_dir->files) {
+		PathMD5 pmd5(p_dir_path.plus_file(E).md5_buffer());
+		HashMap<PathMD5, PackedFile, PathMD5>::Iterator F = files.find(pmd5);
+		if (F && F->value.pack == p_pack) {
+			files.remove(F);
+			removed_files.push_back(E);
+		}
+	}
+	for (int i = 0; i < removed_files.size(); i++) {
+		p_dir->files.erase(removed_files[i]);
+	}
+
+	Vector<String> removed_dirs;
+	for (const KeyValue<String, PackedDir *> &E : p_dir->subdirs) {
+		if (_remove_pack_files(E.value, p_dir_path.plus_file(E.key), p_pack)) {
+			removed_dirs.push_back(E.key);
+		}
+	}
+	for (int i = 0; i < removed_dirs.size(); i++) {
+		memdelete(p_dir->subdirs[removed_dirs[i]]);
+		p_dir->subdirs.erase(removed_dirs[i]);
+	}
+
+	return p_dir->files.is_empty() && p_dir->subdirs.is_empty();
+}
+
+void PackedData::remove_pack(const String &p_path) {
+	_remove_pack_files(root, "res://", p_path);
+	for (int i = 0; i < sources.size(); i++) {
+		sources[i]->remove_pack(p_path);
+	}
+}
+
+void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, bool p_compressed) {
 	PathMD5 pmd5(p_path.md5_buffer());
 
 	bool exists = files.has(pmd5);
 
 	PackedFile pf;
 	pf.encrypted = p_encrypted;
+	pf.compressed = p_compressed;
 	pf.pack = p_pkg_path;
 	pf.offset = p_ofs;
 	pf.size = p_size;
@@ -95,6 +134,31 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 	}
 }
 
+bool PackedData::compress_file(const Vector<uint8_t> &p_data, Compression::Mode p_mode, float p_max_ratio, Vector<uint8_t> &r_stored, const Compression::ZstdDictionary *p_zstd_dict) {
+	if (p_data.is_empty()) {
+		return false;
+	}
+
+	Vector<uint8_t> compressed = FileAccessCompressed::compress_buffer(p_data.ptr(), p_data.size(), PACK_COMPRESSED_MAGIC, p_mode, PACK_COMPRESSED_BLOCK_SIZE, p_zstd_dict);
+	if (compressed.is_empty() || compressed.size() > p_data.size() * (double)p_max_ratio) {
+		return false;
+	}
+
+	r_stored = compressed;
+	return true;
+}
+
+Vector<uint8_t> PackedData::build_zstd_dictionary(const Vector<Vector<uint8_t>> &p_files) {
+	// Dictionaries help most with small files, which share headers, class and property names.
+	// Only the start of large files is sampled, it's all the dictionary has room for anyway.
+	const int max_sample_size = PACK_COMPRESSED_BLOCK_SIZE;
+	Vector<Vector<uint8_t>> samples;
+	for (int i = 0; i < p_files.size(); i++) {
+		samples.push_back(p_files[i].size() > max_sample_size ? p_files[i].slice(0, max_sample_size) : p_files[i]);
+	}
+	return Compression::zstd_dictionary_build(samples);
+}
+
 void PackedData::add_pack_source(PackSource *p_source) {
 	if (p_source != nullptr) {
 		sources.push_back(p_source);
@@ -127,10 +191,11 @@ PackedData::~PackedData() {
 //////////////////////////////////////////////////////////////////
 
 bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
-	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	Ref<FileAccess> f = FileAccess::open_mapped(p_path);
 	if (f.is_null()) {
 		return false;
 	}
+	Ref<FileAccess> pack_f = f;
 
 	bool pck_header_found = false;
 
@@ -200,7 +265,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
+	ERR_FAIL_COND_V_MSG(version < PACK_FORMAT_VERSION_MIN || version > PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
 	ERR_FAIL_COND_V_MSG(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false, "Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + ".");
 
 	uint32_t pack_flags = f->get_32();
@@ -231,6 +296,9 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f = fae;
 	}
 
+	uint64_t dict_ofs = 0;
+	uint64_t dict_size = 0;
+
 	for (int i = 0; i < file_count; i++) {
 		uint32_t sl = f->get_32();
 		CharString cs;
@@ -246,15 +314,61 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		uint8_t md5[16];
 		f->get_buffer(md5, 16);
 		uint32_t flags = f->get_32();
+		if (version < 3) {
+			flags &= ~(PACK_FILE_COMPRESSED | PACK_FILE_ZSTD_DICTIONARY); // Not defined yet, must be ignored.
+		}
 
-		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+		if (flags & PACK_FILE_ZSTD_DICTIONARY) {
+			dict_ofs = ofs + p_offset;
+			dict_size = size;
+			continue;
+		}
+
+		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED), (flags & PACK_FILE_COMPRESSED));
+	}
+
+	if (dict_size > 0) {
+		Vector<uint8_t> dict_data;
+		dict_data.resize(dict_size);
+		pack_f->seek(dict_ofs);
+		pack_f->get_buffer(dict_data.ptrw(), dict_size);
+		Compression::ZstdDictionary *dict = Compression::zstd_dictionary_create(dict_data);
+		ERR_FAIL_NULL_V_MSG(dict, false, "Can't load the zstd dictionary of pack '" + p_path + "'.");
+		zstd_dictionaries[p_path] = dict;
+		owned_zstd_dictionaries.push_back(dict);
+	}
+
+	if (pack_f->get_mapped_span(0, pack_f->get_length())) {
+		mapped_packs[p_path] = pack_f;
 	}
 
 	return true;
 }
 
 Ref<FileAccess> PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
-	return memnew(FileAccessPack(p_path, *p_file));
+	PackedData::PackedFile pf = *p_file;
+	if (pf.compressed) {
+		HashMap<String, Compression::ZstdDictionary *>::ConstIterator D = zstd_dictionaries.find(pf.pack);
+		if (D) {
+			pf.zstd_dict = D->value;
+		}
+	}
+	HashMap<String, Ref<FileAccess>>::ConstIterator E = mapped_packs.find(pf.pack);
+	if (E) {
+		return memnew(FileAccessPack(p_path, pf, E->value));
+	}
+	return memnew(FileAccessPack(p_path, pf));
+}
+
+void PackedSourcePCK::remove_pack(const String &p_path) {
+	mapped_packs.erase(p_path);
+	zstd_dictionaries.erase(p_path);
+}
+
+PackedSourcePCK::~PackedSourcePCK() {
+	for (int i = 0; i < owned_zstd_dictionaries.size(); i++) {
+		Compression::zstd_dictionary_free(owned_zstd_dictionaries[i]);
+	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -281,7 +395,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (!mapped) {
+		f->seek(off + MIN(p_position, pf.size));
+	}
 	pos = p_position;
 }
 
@@ -308,6 +424,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (mapped) {
+		return mapped[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -326,21 +446,35 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
-	pos += p_length;
-
 	if (to_read <= 0) {
+		pos += p_length;
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+
+	if (mapped) {
+		memcpy(p_dst, mapped + pos, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
+	pos += p_length;
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_span(uint64_t p_offset, uint64_t p_length) const {
+	if (!mapped || p_offset > pf.size || p_length > pf.size - p_offset) {
+		return nullptr;
+	}
+	return mapped + p_offset;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
 
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (!mapped) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -366,29 +500,69 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
-	ERR_FAIL_COND_MSG(f.is_null(), "Can't open pack-referenced file '" + String(pf.pack) + "'.");
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Ref<FileAccess> &p_mapped_pack) :
+		pf(p_file) {
+	if (p_mapped_pack.is_valid() && !pf.encrypted) {
+		mapped = p_mapped_pack->get_mapped_span(pf.offset, pf.size);
+		if (mapped && !pf.compressed) {
+			// Keep the mapping alive, all reads are served from memory.
+			f = p_mapped_pack;
+			off = pf.offset;
+			return;
+		} else if (mapped) {
+			// Decode straight from the mapping, the shared pack file is never read from.
+			Ref<FileAccessMemory> fam;
+			fam.instantiate();
+			fam->open_custom(mapped, pf.size);
+			mapped_pack = p_mapped_pack;
+			mapped = nullptr;
+			f = fam;
+			off = 0;
+		}
+	}
 
-	f->seek(pf.offset);
-	off = pf.offset;
+	if (f.is_null()) {
+		f = FileAccess::open(pf.pack, FileAccess::READ);
+		ERR_FAIL_COND_MSG(f.is_null(), "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
-	if (pf.encrypted) {
-		Ref<FileAccessEncrypted> fae;
-		fae.instantiate();
-		ERR_FAIL_COND_MSG(fae.is_null(), "Can't open encrypted pack-referenced file '" + String(pf.pack) + "'.");
+		f->seek(pf.offset);
+		off = pf.offset;
 
-		Vector<uint8_t> key;
-		key.resize(32);
-		for (int i = 0; i < key.size(); i++) {
-			key.write[i] = script_encryption_key[i];
+		if (pf.encrypted) {
+			Ref<FileAccessEncrypted> fae;
+			fae.instantiate();
+			ERR_FAIL_COND_MSG(fae.is_null(), "Can't open encrypted pack-referenced file '" + String(pf.pack) + "'.");
+
+			Vector<uint8_t> key;
+			key.resize(32);
+			for (int i = 0; i < key.size(); i++) {
+				key.write[i] = script_encryption_key[i];
+			}
+
+			Error err = fae->open_and_parse(f, key, FileAccessEncrypted::MODE_READ, false);
+			ERR_FAIL_COND_MSG(err, "Can't open encrypted pack-referenced file '" + String(pf.pack) + "'.");
+			f = fae;
+			off = 0;
 		}
+	}
 
-		Error err = fae->open_and_parse(f, key, FileAccessEncrypted::MODE_READ, false);
-		ERR_FAIL_COND_MSG(err, "Can't open encrypted pack-referenced file '" + String(pf.pack) + "'.");
-		f = fae;
+	if (pf.compressed) {
+		uint8_t magic[4] = {};
+		f->get_buffer(magic, 4);
+
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure(PACK_COMPRESSED_MAGIC, Compression::MODE_ZSTD, PACK_COMPRESSED_BLOCK_SIZE); // Mode and block size are read from the stream.
+		fac->set_zstd_dictionary(pf.zstd_dict);
+		fac->set_read_ahead(true);
+		Error err = memcmp(magic, PACK_COMPRESSED_MAGIC, 4) == 0 ? fac->open_after_magic(f) : ERR_FILE_CORRUPT;
+		if (err != OK) {
+			f.unref();
+			ERR_FAIL_MSG("Can't open compressed pack-referenced file '" + String(pf.pack) + "'.");
+		}
+		f = fac;
 		off = 0;
+		pf.size = fac->get_length();
 	}
 	pos = 0;
 	eof = false;
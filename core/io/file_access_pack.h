@@ -31,6 +31,7 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "core/io/compression.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/string/print_string.h"
@@ -41,16 +42,26 @@
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
-#define PACK_FORMAT_VERSION 2
+// Version 3 added PACK_FILE_COMPRESSED entries, version 2 packs are still read.
+#define PACK_FORMAT_VERSION 3
+#define PACK_FORMAT_VERSION_MIN 2
 
 enum PackFlags {
 	PACK_DIR_ENCRYPTED = 1 << 0
 };
 
 enum PackFileFlags {
-	PACK_FILE_ENCRYPTED = 1 << 0
+	PACK_FILE_ENCRYPTED = 1 << 0,
+	PACK_FILE_COMPRESSED = 1 << 1, // Stored as a FileAccessCompressed stream, the directory size is the stored (compressed) size.
+	PACK_FILE_ZSTD_DICTIONARY = 1 << 2, // The zstd dictionary of the compressed entries, not a project file.
 };
 
+// Magic and block size of compressed pack entries.
+#define PACK_COMPRESSED_MAGIC "GCPK"
+#define PACK_COMPRESSED_BLOCK_SIZE 65536
+// Directory path of the PACK_FILE_ZSTD_DICTIONARY entry.
+#define PACK_ZSTD_DICTIONARY_PATH "res://.godot/pack.zdict"
+
 class PackSource;
 
 class PackedData {
@@ -66,6 +77,8 @@ public:
 		uint8_t md5[16];
 		PackSource *src = nullptr;
 		bool encrypted;
+		bool compressed = false;
+		const Compression::ZstdDictionary *zstd_dict = nullptr; // Set by the source when opening a compressed file.
 	};
 
 private:
@@ -106,16 +119,26 @@ private:
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	bool _remove_pack_files(PackedDir *p_dir, const String &p_dir_path, const String &p_pack);
 
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false, bool p_compressed = false); // for PackSource
+
+	// For pack writers. Returns true and fills r_stored if p_data compresses to at most p_max_ratio of its size,
+	// so incompressible files (already compressed textures, audio, video) are stored as is.
+	static bool compress_file(const Vector<uint8_t> &p_data, Compression::Mode p_mode, float p_max_ratio, Vector<uint8_t> &r_stored, const Compression::ZstdDictionary *p_zstd_dict = nullptr);
+	// For pack writers. Trains the dictionary stored as the PACK_FILE_ZSTD_DICTIONARY entry on the files to compress,
+	// returns an empty one if they're too few or too small.
+	static Vector<uint8_t> build_zstd_dictionary(const Vector<Vector<uint8_t>> &p_files);
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
 
 	static PackedData *get_singleton() { return singleton; }
 	Error add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
+	// Removes the files that come from the pack. Files it replaced are not restored.
+	void remove_pack(const String &p_path);
 
 	_FORCE_INLINE_ Ref<FileAccess> try_open_path(const String &p_path);
 	_FORCE_INLINE_ bool has_path(const String &p_path);
@@ -131,23 +154,36 @@ class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) = 0;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) = 0;
+	virtual void remove_pack(const String &p_path) {}
 	virtual ~PackSource() {}
 };
 
 class PackedSourcePCK : public PackSource {
+	HashMap<String, Ref<FileAccess>> mapped_packs; // Whole-pack mappings shared by all the files they contain.
+	// Dictionaries of the packs' compressed files. Open files may still use them after the pack is removed
+	// or replaced, so they're only freed with the source.
+	HashMap<String, Compression::ZstdDictionary *> zstd_dictionaries;
+	Vector<Compression::ZstdDictionary *> owned_zstd_dictionaries;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
+	virtual void remove_pack(const String &p_path) override;
+
+	~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
 	PackedData::PackedFile pf;
 
-	mutable uint64_t pos;
-	mutable bool eof;
-	uint64_t off;
+	mutable uint64_t pos = 0;
+	mutable bool eof = false;
+	uint64_t off = 0;
 
 	Ref<FileAccess> f;
+	const uint8_t *mapped = nullptr; // Contents inside the pack mapping, f is then shared and must not be read from.
+	Ref<FileAccess> mapped_pack; // Keeps the mapping alive when compressed contents are decoded from it.
+
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -167,6 +203,8 @@ public:
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
 
+	virtual const uint8_t *get_mapped_span(uint64_t p_offset, uint64_t p_length) const;
+
 	virtual void set_big_endian(bool p_big_endian);
 
 	virtual Error get_error() const;
@@ -178,7 +216,7 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Ref<FileAccess> &p_mapped_pack = Ref<FileAccess>());
 };
 
 Ref<FileAccess> PackedData::try_open_path(const String &p_path) {
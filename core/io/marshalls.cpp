@@ -59,6 +59,48 @@ ObjectID EncodedObjectAsID::get_object_id() const {
 #define ENCODE_FLAG_64 1 << 16
 #define ENCODE_FLAG_OBJECT_AS_ID 1 << 16
 
+// Packed array elements are stored as little-endian words, which is their in-memory layout on
+// little-endian hosts. These copy them in bulk, and only swap bytes in place on big-endian hosts.
+static void _copy_words_32(void *p_dst, const void *p_src, int p_count) {
+#ifdef BIG_ENDIAN_ENABLED
+	// Either side may be unaligned, swap each word through a local.
+	uint8_t *dst = (uint8_t *)p_dst;
+	const uint8_t *src = (const uint8_t *)p_src;
+	for (int i = 0; i < p_count; i++) {
+		uint32_t word;
+		memcpy(&word, src + i * sizeof(uint32_t), sizeof(uint32_t));
+		word = BSWAP32(word);
+		memcpy(dst + i * sizeof(uint32_t), &word, sizeof(uint32_t));
+	}
+#else
+	memcpy(p_dst, p_src, p_count * sizeof(uint32_t));
+#endif
+}
+
+static void _copy_words_64(void *p_dst, const void *p_src, int p_count) {
+#ifdef BIG_ENDIAN_ENABLED
+	// Either side may be unaligned, swap each word through a local.
+	uint8_t *dst = (uint8_t *)p_dst;
+	const uint8_t *src = (const uint8_t *)p_src;
+	for (int i = 0; i < p_count; i++) {
+		uint64_t word;
+		memcpy(&word, src + i * sizeof(uint64_t), sizeof(uint64_t));
+		word = BSWAP64(word);
+		memcpy(dst + i * sizeof(uint64_t), &word, sizeof(uint64_t));
+	}
+#else
+	memcpy(p_dst, p_src, p_count * sizeof(uint64_t));
+#endif
+}
+
+static void _copy_reals(void *p_dst, const void *p_src, int p_count) {
+#ifdef REAL_T_IS_DOUBLE
+	_copy_words_64(p_dst, p_src, p_count);
+#else
+	_copy_words_32(p_dst, p_src, p_count);
+#endif
+}
+
 static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r_string) {
 	ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
 
@@ -721,10 +763,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
-				uint8_t *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = buf[i];
-				}
+				memcpy(data.ptrw(), buf, count);
 			}
 
 			r_variant = data;
@@ -748,12 +787,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<int32_t> data;
 
 			if (count) {
-				//const int*rbuf=(const int*)buf;
 				data.resize(count);
-				int32_t *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = decode_uint32(&buf[i * 4]);
-				}
+				_copy_words_32(data.ptrw(), buf, count);
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -772,12 +807,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<int64_t> data;
 
 			if (count) {
-				//const int*rbuf=(const int*)buf;
 				data.resize(count);
-				int64_t *w = data.ptrw();
-				for (int64_t i = 0; i < count; i++) {
-					w[i] = decode_uint64(&buf[i * 8]);
-				}
+				_copy_words_64(data.ptrw(), buf, count);
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -796,12 +827,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<float> data;
 
 			if (count) {
-				//const float*rbuf=(const float*)buf;
 				data.resize(count);
-				float *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = decode_float(&buf[i * 4]);
-				}
+				_copy_words_32(data.ptrw(), buf, count);
 			}
 			r_variant = data;
 
@@ -822,10 +849,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
-				double *w = data.ptrw();
-				for (int64_t i = 0; i < count; i++) {
-					w[i] = decode_double(&buf[i * 8]);
-				}
+				_copy_words_64(data.ptrw(), buf, count);
 			}
 			r_variant = data;
 
@@ -879,10 +903,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
+#ifdef REAL_T_IS_DOUBLE
+					_copy_reals(w, buf, count * 2);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 0);
 						w[i].y = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 1);
 					}
+#endif
 
 					int adv = sizeof(double) * 2 * count;
 
@@ -904,10 +932,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
+#ifdef REAL_T_IS_DOUBLE
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 0);
 						w[i].y = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 1);
 					}
+#else
+					_copy_reals(w, buf, count * 2);
+#endif
 
 					int adv = sizeof(float) * 2 * count;
 
@@ -939,11 +971,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
+#ifdef REAL_T_IS_DOUBLE
+					_copy_reals(w, buf, count * 3);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 0);
 						w[i].y = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 1);
 						w[i].z = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 2);
 					}
+#endif
 
 					int adv = sizeof(double) * 3 * count;
 
@@ -965,11 +1001,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
+#ifdef REAL_T_IS_DOUBLE
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 0);
 						w[i].y = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 1);
 						w[i].z = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 2);
 					}
+#else
+					_copy_reals(w, buf, count * 3);
+#endif
 
 					int adv = sizeof(float) * 3 * count;
 
@@ -1000,15 +1040,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				carray.resize(count);
-				Color *w = carray.ptrw();
-
-				for (int32_t i = 0; i < count; i++) {
-					// Colors should always be in single-precision.
-					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
-					w[i].g = decode_float(buf + i * 4 * 4 + 4 * 1);
-					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
-					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
-				}
+				// Colors should always be in single-precision.
+				_copy_words_32(carray.ptrw(), buf, count * 4);
 
 				int adv = 4 * 4 * count;
 
@@ -1536,10 +1569,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const int32_t *r = data.ptr();
-				for (int32_t i = 0; i < datalen; i++) {
-					encode_uint32(r[i], &buf[i * datasize]);
-				}
+				_copy_words_32(buf, data.ptr(), datalen);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1553,10 +1583,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const int64_t *r = data.ptr();
-				for (int64_t i = 0; i < datalen; i++) {
-					encode_uint64(r[i], &buf[i * datasize]);
-				}
+				_copy_words_64(buf, data.ptr(), datalen);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1570,10 +1597,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const float *r = data.ptr();
-				for (int i = 0; i < datalen; i++) {
-					encode_float(r[i], &buf[i * datasize]);
-				}
+				_copy_words_32(buf, data.ptr(), datalen);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1587,10 +1611,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const double *r = data.ptr();
-				for (int i = 0; i < datalen; i++) {
-					encode_double(r[i], &buf[i * datasize]);
-				}
+				_copy_words_64(buf, data.ptr(), datalen);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1639,13 +1660,8 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
-				for (int i = 0; i < len; i++) {
-					Vector2 v = data.get(i);
-
-					encode_real(v.x, &buf[0]);
-					encode_real(v.y, &buf[sizeof(real_t)]);
-					buf += sizeof(real_t) * 2;
-				}
+				_copy_reals(buf, data.ptr(), len * 2);
+				buf += sizeof(real_t) * 2 * len;
 			}
 
 			r_len += sizeof(real_t) * 2 * len;
@@ -1663,14 +1679,8 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
-				for (int i = 0; i < len; i++) {
-					Vector3 v = data.get(i);
-
-					encode_real(v.x, &buf[0]);
-					encode_real(v.y, &buf[sizeof(real_t)]);
-					encode_real(v.z, &buf[sizeof(real_t) * 2]);
-					buf += sizeof(real_t) * 3;
-				}
+				_copy_reals(buf, data.ptr(), len * 3);
+				buf += sizeof(real_t) * 3 * len;
 			}
 
 			r_len += sizeof(real_t) * 3 * len;
@@ -1688,15 +1698,8 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
-				for (int i = 0; i < len; i++) {
-					Color c = data.get(i);
-
-					encode_float(c.r, &buf[0]);
-					encode_float(c.g, &buf[4]);
-					encode_float(c.b, &buf[8]);
-					encode_float(c.a, &buf[12]);
-					buf += 4 * 4; // Colors should always be in single-precision.
-				}
+				_copy_words_32(buf, data.ptr(), len * 4); // Colors should always be in single-precision.
+				buf += 4 * 4 * len;
 			}
 
 			r_len += 4 * 4 * len;
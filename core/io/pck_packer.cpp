@@ -34,6 +34,8 @@
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/version.h"
 
 static int _get_pad(int p_alignment, int p_n) {
@@ -48,7 +50,8 @@ static int _get_pad(int p_alignment, int p_n) {
 
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
-	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("set_compression", "mode", "max_ratio", "zstd_dictionary"), &PCKPacker::set_compression, DEFVAL(0.9), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt", "compress"), &PCKPacker::add_file, DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
 
@@ -101,12 +104,19 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	file->store_32(pack_flags); // flags
 
 	files.clear();
-	ofs = 0;
 
 	return OK;
 }
 
-Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt) {
+void PCKPacker::set_compression(int p_mode, float p_max_ratio, bool p_zstd_dictionary) {
+	ERR_FAIL_INDEX(p_mode, Compression::MODE_GZIP + 1);
+	ERR_FAIL_COND(p_max_ratio <= 0);
+	compression_mode = p_mode;
+	compression_max_ratio = p_max_ratio;
+	compression_zstd_dictionary = p_zstd_dictionary;
+}
+
+Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt, bool p_compress) {
 	Ref<FileAccess> f = FileAccess::open(p_src, FileAccess::READ);
 	if (f.is_null()) {
 		return ERR_FILE_CANT_OPEN;
@@ -115,7 +125,6 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	File pf;
 	pf.path = p_file;
 	pf.src_path = p_src;
-	pf.ofs = ofs;
 	pf.size = f->get_length();
 
 	Vector<uint8_t> data = FileAccess::get_file_as_array(p_src);
@@ -128,38 +137,33 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 		}
 	}
 	pf.encrypted = p_encrypt;
-
-	uint64_t _size = pf.size;
-	if (p_encrypt) { // Add encryption overhead.
-		if (_size % 16) { // Pad to encryption block size.
-			_size += 16 - (_size % 16);
-		}
-		_size += 16; // hash
-		_size += 8; // data size
-		_size += 16; // iv
-	}
-
-	int pad = _get_pad(alignment, ofs + _size);
-	ofs = ofs + _size + pad;
+	pf.compress = p_compress;
 
 	files.push_back(pf);
 
 	return OK;
 }
 
-Error PCKPacker::flush(bool p_verbose) {
-	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
-
-	int64_t file_base_ofs = file->get_position();
-	file->store_64(0); // files base
-
-	for (int i = 0; i < 16; i++) {
-		file->store_32(0); // reserved
+void PCKPacker::_compress_file(uint32_t p_index, const int *p_files) {
+	File &pf = files.write[p_files[p_index]];
+	Vector<uint8_t> data = FileAccess::get_file_as_array(pf.src_path);
+	if (data.size() != (int64_t)pf.size || !PackedData::compress_file(data, (Compression::Mode)compression_mode, compression_max_ratio, pf.compressed, zstd_dict)) {
+		pf.compressed.clear();
 	}
+}
 
-	// write the index
-	file->store_32(files.size());
+void PCKPacker::_build_zstd_dictionary(const Vector<int> &p_files) {
+	Vector<Vector<uint8_t>> data;
+	for (int i = 0; i < p_files.size(); i++) {
+		data.push_back(FileAccess::get_file_as_array(files[p_files[i]].src_path));
+	}
+	zstd_dict_data = PackedData::build_zstd_dictionary(data);
+	if (!zstd_dict_data.is_empty()) {
+		zstd_dict = Compression::zstd_dictionary_create(zstd_dict_data);
+	}
+}
 
+Error PCKPacker::_store_directory() {
 	Ref<FileAccessEncrypted> fae;
 	Ref<FileAccess> fhead = file;
 
@@ -184,21 +188,61 @@ Error PCKPacker::flush(bool p_verbose) {
 		}
 
 		fhead->store_64(files[i].ofs);
-		fhead->store_64(files[i].size); // pay attention here, this is where file is
+		fhead->store_64(files[i].stored_size); // pay attention here, this is where file is
 		fhead->store_buffer(files[i].md5.ptr(), 16); //also save md5 for file
 
 		uint32_t flags = 0;
 		if (files[i].encrypted) {
 			flags |= PACK_FILE_ENCRYPTED;
 		}
+		if (files[i].stored_compressed) {
+			flags |= PACK_FILE_COMPRESSED;
+		}
+		if (files[i].zstd_dictionary) {
+			flags |= PACK_FILE_ZSTD_DICTIONARY;
+		}
 		fhead->store_32(flags);
 	}
 
-	if (fae.is_valid()) {
-		fhead.unref();
-		fae.unref();
+	return OK;
+}
+
+Error PCKPacker::flush(bool p_verbose) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+
+	// Compressed files can share a zstd dictionary, trained on the first batch.
+	bool use_zstd_dict = false;
+	if (compression_zstd_dictionary && compression_mode == Compression::MODE_ZSTD) {
+		for (int i = 0; i < files.size() && !use_zstd_dict; i++) {
+			use_zstd_dict = files[i].compress;
+		}
+	}
+	if (use_zstd_dict) {
+		File pf;
+		pf.path = PACK_ZSTD_DICTIONARY_PATH;
+		pf.zstd_dictionary = true;
+		pf.md5.resize(16);
+		memset(pf.md5.ptrw(), 0, 16);
+		files.push_back(pf);
+	}
+
+	int64_t file_base_ofs = file->get_position();
+	file->store_64(0); // files base
+
+	for (int i = 0; i < 16; i++) {
+		file->store_32(0); // reserved
 	}
 
+	// write the index
+	file->store_32(files.size());
+
+	// Offsets and stored sizes are only known once the files are compressed, so the
+	// directory is written with placeholders first and rewritten at the end. Entries
+	// have a fixed size, so the rewrite covers exactly the same bytes.
+	int64_t dir_ofs = file->get_position();
+	Error err = _store_directory();
+	ERR_FAIL_COND_V(err != OK, err);
+
 	int header_padding = _get_pad(alignment, file->get_position());
 	for (int i = 0; i < header_padding; i++) {
 		file->store_8(Math::rand() % 256);
@@ -213,42 +257,95 @@ Error PCKPacker::flush(bool p_verbose) {
 	uint8_t *buf = memnew_arr(uint8_t, buf_max);
 
 	int count = 0;
-	for (int i = 0; i < files.size(); i++) {
-		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
+	int batch_start = 0;
+	while (batch_start < files.size()) {
+		// Compress in parallel one batch at a time, so only a batch is held in memory.
+		Vector<int> to_compress;
+		uint64_t batch_size = 0;
+		int batch_end = batch_start;
+		while (batch_end < files.size() && (batch_end == batch_start || batch_size < PCK_PACKER_BATCH_SIZE)) {
+			if (files[batch_end].compress) {
+				to_compress.push_back(batch_end);
+				batch_size += files[batch_end].size;
+			}
+			batch_end++;
+		}
+		if (use_zstd_dict && batch_start == 0) {
+			_build_zstd_dictionary(to_compress);
+		}
+		if (to_compress.size() > 1 && OS::get_singleton()->get_processor_count() > 1) {
+			ThreadWorkPool pool;
+			pool.init();
+			pool.do_work(to_compress.size(), this, &PCKPacker::_compress_file, to_compress.ptr());
+			pool.finish();
+		} else {
+			for (int i = 0; i < to_compress.size(); i++) {
+				_compress_file(i, to_compress.ptr());
+			}
+		}
 
-		Ref<FileAccess> ftmp = file;
-		if (files[i].encrypted) {
-			fae.instantiate();
-			ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+		for (int i = batch_start; i < batch_end; i++) {
+			File &pf = files.write[i];
+			pf.ofs = file->get_position() - file_base;
+			pf.stored_compressed = !pf.compressed.is_empty();
+			pf.stored_size = pf.stored_compressed ? pf.compressed.size() : pf.size;
+
+			Ref<FileAccessEncrypted> fae;
+			Ref<FileAccess> ftmp = file;
+			if (pf.encrypted) {
+				fae.instantiate();
+				ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+
+				err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
+				ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
+				ftmp = fae;
+			}
 
-			Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
-			ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
-			ftmp = fae;
-		}
+			if (pf.zstd_dictionary) {
+				pf.stored_size = zstd_dict_data.size();
+				ftmp->store_buffer(zstd_dict_data.ptr(), zstd_dict_data.size());
+				CryptoCore::md5(zstd_dict_data.ptr(), zstd_dict_data.size(), pf.md5.ptrw());
+			} else if (pf.stored_compressed) {
+				ftmp->store_buffer(pf.compressed.ptr(), pf.compressed.size());
+				pf.compressed.clear();
+			} else {
+				Ref<FileAccess> src = FileAccess::open(pf.src_path, FileAccess::READ);
+				uint64_t to_write = pf.size;
+				while (to_write > 0) {
+					uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
+					ftmp->store_buffer(buf, read);
+					to_write -= read;
+				}
+			}
 
-		while (to_write > 0) {
-			uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
-			ftmp->store_buffer(buf, read);
-			to_write -= read;
-		}
+			if (fae.is_valid()) {
+				ftmp.unref();
+				fae.unref();
+			}
 
-		if (fae.is_valid()) {
-			ftmp.unref();
-			fae.unref();
-		}
+			int pad = _get_pad(alignment, file->get_position());
+			for (int j = 0; j < pad; j++) {
+				file->store_8(Math::rand() % 256);
+			}
 
-		int pad = _get_pad(alignment, file->get_position());
-		for (int j = 0; j < pad; j++) {
-			file->store_8(Math::rand() % 256);
+			count += 1;
+			const int file_num = files.size();
+			if (p_verbose && (file_num > 0)) {
+				print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", count, file_num, float(count) / file_num * 100, pf.src_path, pf.path));
+			}
 		}
+		batch_start = batch_end;
+	}
 
-		count += 1;
-		const int file_num = files.size();
-		if (p_verbose && (file_num > 0)) {
-			print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", count, file_num, float(count) / file_num * 100, files[i].src_path, files[i].path));
-		}
+	file->seek(dir_ofs);
+	err = _store_directory();
+	ERR_FAIL_COND_V(err != OK, err);
+
+	if (zstd_dict) {
+		Compression::zstd_dictionary_free(zstd_dict);
+		zstd_dict = nullptr;
 	}
+	zstd_dict_data.clear();
 
 	if (p_verbose) {
 		printf("\n");
@@ -259,3 +356,9 @@ Error PCKPacker::flush(bool p_verbose) {
 
 	return OK;
 }
+
+PCKPacker::~PCKPacker() {
+	if (zstd_dict) {
+		Compression::zstd_dictionary_free(zstd_dict);
+	}
+}
@@ -31,20 +31,28 @@
 #ifndef PCK_PACKER_H
 #define PCK_PACKER_H
 
+#include "core/io/compression.h"
 #include "core/object/ref_counted.h"
 
 class FileAccess;
 
+// Uncompressed bytes compressed at once by flush().
+#define PCK_PACKER_BATCH_SIZE (64 * 1024 * 1024)
+
 class PCKPacker : public RefCounted {
 	GDCLASS(PCKPacker, RefCounted);
 
 	Ref<FileAccess> file;
 	int alignment = 0;
-	uint64_t ofs = 0;
 
 	Vector<uint8_t> key;
 	bool enc_dir = false;
 
+	int compression_mode = Compression::MODE_ZSTD;
+	float compression_max_ratio = 0.9;
+	bool compression_zstd_dictionary = false;
+	Compression::ZstdDictionary *zstd_dict = nullptr;
+
 	static void _bind_methods();
 
 	struct File {
@@ -53,16 +61,28 @@ class PCKPacker : public RefCounted {
 		uint64_t ofs = 0;
 		uint64_t size = 0;
 		bool encrypted = false;
+		bool compress = false;
+		bool zstd_dictionary = false; // The PACK_FILE_ZSTD_DICTIONARY entry, stored from zstd_dict_data.
+		bool stored_compressed = false;
+		uint64_t stored_size = 0;
+		Vector<uint8_t> compressed; // Compressed contents while the file's batch is written, empty if the file didn't compress well enough.
 		Vector<uint8_t> md5;
 	};
 	Vector<File> files;
+	Vector<uint8_t> zstd_dict_data;
+
+	void _compress_file(uint32_t p_index, const int *p_files);
+	Error _store_directory();
+	void _build_zstd_dictionary(const Vector<int> &p_files);
 
 public:
 	Error pck_start(const String &p_file, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
-	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false);
+	void set_compression(int p_mode, float p_max_ratio = 0.9, bool p_zstd_dictionary = false);
+	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false, bool p_compress = false);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker() {}
+	~PCKPacker();
 };
 
 #endif // PCK_PACKER_H
@@ -56,32 +56,34 @@ void Resource::set_path(const String &p_path, bool p_take_over) {
 		p_take_over = false; // Can't take over an empty path
 	}
 
-	ResourceCache::lock.lock();
-
 	if (!path_cache.is_empty()) {
-		ResourceCache::resources.erase(path_cache);
+		ResourceCache::_remove(this, path_cache);
 	}
 
 	path_cache = "";
 
-	Ref<Resource> existing = ResourceCache::get_ref(p_path);
+	if (!p_path.is_empty()) {
+		ResourceCache::Shard &shard = ResourceCache::_get_shard(p_path);
+		shard.lock.write_lock();
 
-	if (existing.is_valid()) {
-		if (p_take_over) {
-			existing->path_cache = String();
-			ResourceCache::resources.erase(p_path);
-		} else {
-			ResourceCache::lock.unlock();
-			ERR_FAIL_MSG("Another resource is loaded from path '" + p_path + "' (possible cyclic resource inclusion).");
+		Resource **existing = shard.resources.getptr(p_path);
+
+		// A resource with no references left is being deleted and can simply be replaced,
+		// its destructor won't remove an entry it no longer owns.
+		if (existing && (*existing)->reference_get_count() > 0) {
+			if (p_take_over) {
+				(*existing)->path_cache = String();
+			} else {
+				shard.lock.write_unlock();
+				ERR_FAIL_MSG("Another resource is loaded from path '" + p_path + "' (possible cyclic resource inclusion).");
+			}
 		}
-	}
 
-	path_cache = p_path;
+		path_cache = p_path;
+		shard.resources[path_cache] = this;
 
-	if (!path_cache.is_empty()) {
-		ResourceCache::resources[path_cache] = this;
+		shard.lock.write_unlock();
 	}
-	ResourceCache::lock.unlock();
 
 	_resource_path_changed();
 }
@@ -450,16 +452,14 @@ Resource::Resource() :
 
 Resource::~Resource() {
 	if (!path_cache.is_empty()) {
-		ResourceCache::lock.lock();
-		ResourceCache::resources.erase(path_cache);
-		ResourceCache::lock.unlock();
+		ResourceCache::_remove(this, path_cache);
 	}
 	if (owners.size()) {
 		WARN_PRINT("Resource is still owned.");
 	}
 }
 
-HashMap<String, Resource *> ResourceCache::resources;
+ResourceCache::Shard ResourceCache::shards[ResourceCache::SHARD_COUNT];
 #ifdef TOOLS_ENABLED
 HashMap<String, HashMap<String, String>> ResourceCache::resource_path_cache;
 #endif
@@ -469,85 +469,97 @@ Mutex ResourceCache::lock;
 RWLock ResourceCache::path_cache_lock;
 #endif
 
+void ResourceCache::_remove(Resource *p_resource, const String &p_path) {
+	Shard &shard = _get_shard(p_path);
+	shard.lock.write_lock();
+
+	// The path may have been taken over by another resource meanwhile.
+	Resource **res = shard.resources.getptr(p_path);
+	if (res && *res == p_resource) {
+		shard.resources.erase(p_path);
+	}
+
+	shard.lock.write_unlock();
+}
+
 void ResourceCache::clear() {
-	if (resources.size()) {
+	if (get_cached_resource_count()) {
 		ERR_PRINT("Resources still in use at exit (run with --verbose for details).");
 		if (OS::get_singleton()->is_stdout_verbose()) {
-			for (const KeyValue<String, Resource *> &E : resources) {
-				print_line(vformat("Resource still in use: %s (%s)", E.key, E.value->get_class()));
+			for (int i = 0; i < SHARD_COUNT; i++) {
+				for (const KeyValue<String, Resource *> &E : shards[i].resources) {
+					print_line(vformat("Resource still in use: %s (%s)", E.key, E.value->get_class()));
+				}
 			}
 		}
 	}
 
-	resources.clear();
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		shards[i].resources.clear();
+	}
 }
 
 void ResourceCache::reload_externals() {
 }
 
 bool ResourceCache::has(const String &p_path) {
-	lock.lock();
+	Shard &shard = _get_shard(p_path);
+	shard.lock.read_lock();
 
-	Resource **res = resources.getptr(p_path);
+	Resource **res = shard.resources.getptr(p_path);
 
-	if (res && (*res)->reference_get_count() == 0) {
-		// This resource is in the process of being deleted, ignore its existence.
-		(*res)->path_cache = String();
-		resources.erase(p_path);
-		res = nullptr;
-	}
-
-	lock.unlock();
+	// A resource with no references left is in the process of being deleted, ignore its existence.
+	bool found = res && (*res)->reference_get_count() > 0;
 
-	if (!res) {
-		return false;
-	}
+	shard.lock.read_unlock();
 
-	return true;
+	return found;
 }
 
 Ref<Resource> ResourceCache::get_ref(const String &p_path) {
 	Ref<Resource> ref;
-	lock.lock();
+	Shard &shard = _get_shard(p_path);
+	shard.lock.read_lock();
 
-	Resource **res = resources.getptr(p_path);
+	Resource **res = shard.resources.getptr(p_path);
 
 	if (res) {
+		// Fails to reference a resource that is in the process of being deleted,
+		// which is then left for its destructor to remove.
 		ref = Ref<Resource>(*res);
 	}
 
-	if (res && !ref.is_valid()) {
-		// This resource is in the process of being deleted, ignore its existence
-		(*res)->path_cache = String();
-		resources.erase(p_path);
-		res = nullptr;
-	}
-
-	lock.unlock();
+	shard.lock.read_unlock();
 
 	return ref;
 }
 
 void ResourceCache::get_cached_resources(List<Ref<Resource>> *p_resources) {
-	lock.lock();
-	for (KeyValue<String, Resource *> &E : resources) {
-		p_resources->push_back(Ref<Resource>(E.value));
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		shards[i].lock.read_lock();
+		for (KeyValue<String, Resource *> &E : shards[i].resources) {
+			Ref<Resource> ref = Ref<Resource>(E.value);
+			if (ref.is_valid()) {
+				p_resources->push_back(ref);
+			}
+		}
+		shards[i].lock.read_unlock();
 	}
-	lock.unlock();
 }
 
 int ResourceCache::get_cached_resource_count() {
-	lock.lock();
-	int rc = resources.size();
-	lock.unlock();
+	int rc = 0;
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		shards[i].lock.read_lock();
+		rc += shards[i].resources.size();
+		shards[i].lock.read_unlock();
+	}
 
 	return rc;
 }
 
 void ResourceCache::dump(const char *p_file, bool p_short) {
 #ifdef DEBUG_ENABLED
-	lock.lock();
-
 	HashMap<String, int> type_count;
 
 	Ref<FileAccess> f;
@@ -556,20 +568,26 @@ void ResourceCache::dump(const char *p_file, bool p_short) {
 		ERR_FAIL_COND_MSG(f.is_null(), "Cannot create file at path '" + String::utf8(p_file) + "'.");
 	}
 
-	for (KeyValue<String, Resource *> &E : resources) {
-		Resource *r = E.value;
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		shards[i].lock.read_lock();
 
-		if (!type_count.has(r->get_class())) {
-			type_count[r->get_class()] = 0;
-		}
+		for (KeyValue<String, Resource *> &E : shards[i].resources) {
+			Resource *r = E.value;
+
+			if (!type_count.has(r->get_class())) {
+				type_count[r->get_class()] = 0;
+			}
 
-		type_count[r->get_class()]++;
+			type_count[r->get_class()]++;
 
-		if (!p_short) {
-			if (f.is_valid()) {
-				f->store_line(r->get_class() + ": " + r->get_path());
+			if (!p_short) {
+				if (f.is_valid()) {
+					f->store_line(r->get_class() + ": " + r->get_path());
+				}
 			}
 		}
+
+		shards[i].lock.read_unlock();
 	}
 
 	for (const KeyValue<String, int> &E : type_count) {
@@ -577,8 +595,6 @@ void ResourceCache::dump(const char *p_file, bool p_short) {
 			f->store_line(E.key + " count: " + itos(E.value));
 		}
 	}
-
-	lock.unlock();
 #else
 	WARN_PRINT("ResourceCache::dump only with in debug builds.");
 #endif
@@ -153,8 +153,27 @@ public:
 class ResourceCache {
 	friend class Resource;
 	friend class ResourceLoader; //need the lock
-	static Mutex lock;
-	static HashMap<String, Resource *> resources;
+
+	// The cache is split into shards by path hash, so that loads, lookups and
+	// frees of unrelated resources on different threads don't serialize on a
+	// single lock. Lookups only take the shard lock in shared mode.
+	enum {
+		SHARD_COUNT = 64,
+	};
+
+	struct Shard {
+		RWLock lock;
+		HashMap<String, Resource *> resources;
+	};
+
+	static Mutex lock; // Protects the translation remapped list.
+	static Shard shards[SHARD_COUNT];
+
+	_FORCE_INLINE_ static Shard &_get_shard(const String &p_path) {
+		return shards[p_path.hash() & (SHARD_COUNT - 1)];
+	}
+	static void _remove(Resource *p_resource, const String &p_path);
+
 #ifdef TOOLS_ENABLED
 	static HashMap<String, HashMap<String, String>> resource_path_cache; // Each tscn has a set of resource paths and IDs.
 	static RWLock path_cache_lock;
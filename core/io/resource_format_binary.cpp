@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access_compressed.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/image.h"
 #include "core/io/marshalls.h"
 #include "core/io/missing_resource.h"
@@ -156,15 +157,37 @@ StringName ResourceLoaderBinary::_get_string() {
 		if (len == 0) {
 			return StringName();
 		}
-		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
-		s.parse_utf8(&str_buf[0]);
+		if (!_parse_mapped_utf8(s, len)) {
+			f->get_buffer((uint8_t *)&str_buf[0], len);
+			s.parse_utf8(&str_buf[0]);
+		}
 		return s;
 	}
 
 	return string_map[id];
 }
 
+Error ResourceLoaderBinary::_load_external_resource(int p_index) {
+	if (external_resources[p_index].cache.is_null()) {
+		//cache not here yet, wait for it?
+		if (use_sub_threads) {
+			Error err;
+			external_resources.write[p_index].cache = ResourceLoader::load_threaded_get(external_resources[p_index].path, &err);
+
+			if (err != OK || external_resources[p_index].cache.is_null()) {
+				if (!ResourceLoader::get_abort_on_missing_resources()) {
+					ResourceLoader::notify_dependency_error(local_path, external_resources[p_index].path, external_resources[p_index].type);
+				} else {
+					error = ERR_FILE_MISSING_DEPENDENCIES;
+					ERR_FAIL_V_MSG(error, "Can't load dependency: " + external_resources[p_index].path + ".");
+				}
+			}
+		}
+	}
+	return OK;
+}
+
 Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 	uint32_t type = f->get_32();
 	print_bl("find property of type: " + itos(type));
@@ -367,11 +390,13 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					}
 
 					//always use internal cache for loading internal resources
-					if (!internal_index_cache.has(path)) {
+					const HashMap<String, Ref<Resource>> &index_cache = decode_owner ? decode_owner->internal_index_cache : internal_index_cache;
+					HashMap<String, Ref<Resource>>::ConstIterator E = index_cache.find(path);
+					if (!E) {
 						WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
 						r_v = Variant();
 					} else {
-						r_v = internal_index_cache[path];
+						r_v = E->value;
 					}
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE: {
@@ -405,21 +430,9 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 						WARN_PRINT("Broken external resource! (index out of size)");
 						r_v = Variant();
 					} else {
-						if (external_resources[erindex].cache.is_null()) {
-							//cache not here yet, wait for it?
-							if (use_sub_threads) {
-								Error err;
-								external_resources.write[erindex].cache = ResourceLoader::load_threaded_get(external_resources[erindex].path, &err);
-
-								if (err != OK || external_resources[erindex].cache.is_null()) {
-									if (!ResourceLoader::get_abort_on_missing_resources()) {
-										ResourceLoader::notify_dependency_error(local_path, external_resources[erindex].path, external_resources[erindex].type);
-									} else {
-										error = ERR_FILE_MISSING_DEPENDENCIES;
-										ERR_FAIL_V_MSG(error, "Can't load dependency: " + external_resources[erindex].path + ".");
-									}
-								}
-							}
+						Error err = _load_external_resource(erindex);
+						if (err != OK) {
+							return err;
 						}
 
 						r_v = external_resources[erindex].cache;
@@ -626,6 +639,12 @@ void ResourceLoaderBinary::set_local_path(const String &p_local_path) {
 	res_path = p_local_path;
 }
 
+void ResourceLoaderBinary::set_sub_threads(ThreadWorkPool *p_decode_pool, Mutex *p_decode_pool_mutex) {
+	use_sub_threads = true;
+	decode_pool = p_decode_pool;
+	decode_pool_mutex = p_decode_pool_mutex;
+}
+
 Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
@@ -674,8 +693,15 @@ Error ResourceLoaderBinary::load() {
 		}
 	}
 
+	// Create all internal resources first, so properties referencing them can
+	// be decoded in any order (and on several threads) before being applied.
+	Vector<InternalResourceLoad> loads;
+	loads.resize(internal_resources.size());
+	LocalVector<uint32_t> to_decode;
+
 	for (int i = 0; i < internal_resources.size(); i++) {
 		bool main = i == (internal_resources.size() - 1);
+		InternalResourceLoad &load = loads.write[i];
 
 		//maybe it is loaded already
 		String path;
@@ -698,6 +724,7 @@ Error ResourceLoaderBinary::load() {
 					//already loaded, don't do anything
 					error = OK;
 					internal_index_cache[path] = cached;
+					load.cached = true;
 					continue;
 				}
 			}
@@ -712,6 +739,7 @@ Error ResourceLoaderBinary::load() {
 		f->seek(offset);
 
 		String t = get_unicode_string();
+		load.properties_offset = f->get_position();
 
 		Ref<Resource> res;
 
@@ -724,8 +752,6 @@ Error ResourceLoaderBinary::load() {
 			}
 		}
 
-		MissingResource *missing_resource = nullptr;
-
 		if (res.is_null()) {
 			//did not replace
 
@@ -733,10 +759,10 @@ Error ResourceLoaderBinary::load() {
 			if (!obj) {
 				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
 					//create a missing resource
-					missing_resource = memnew(MissingResource);
-					missing_resource->set_original_class(t);
-					missing_resource->set_recording_properties(true);
-					obj = missing_resource;
+					load.missing_resource = memnew(MissingResource);
+					load.missing_resource->set_original_class(t);
+					load.missing_resource->set_recording_properties(true);
+					obj = load.missing_resource;
 				} else {
 					error = ERR_FILE_CORRUPT;
 					ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
@@ -762,29 +788,94 @@ Error ResourceLoaderBinary::load() {
 			internal_index_cache[path] = res;
 		}
 
-		int pc = f->get_32();
+		load.resource = res;
+		to_decode.push_back(i);
+	}
 
-		//set properties
+	// Each decoder reads from its own view of the file contents, so this only pays off when
+	// they're already in memory. Otherwise the file is streamed as usual.
+	const uint8_t *mapped_data = nullptr;
+	bool parallel = use_sub_threads && decode_pool && to_decode.size() > 1 && f->get_length() >= PARALLEL_DECODE_MIN_SIZE;
+	if (parallel) {
+		mapped_data = f->get_mapped_span(0, f->get_length());
+		parallel = mapped_data != nullptr;
+	}
+	if (parallel && decode_pool_mutex->try_lock() != OK) {
+		parallel = false; // Another load is using the decode threads.
+	}
 
-		Dictionary missing_resource_properties;
+	if (parallel) {
+		// Decoders only read shared state, so make sure every external resource is
+		// ready beforehand instead of waiting for them from the decode threads.
+		for (int i = 0; i < external_resources.size(); i++) {
+			Error err = _load_external_resource(i);
+			if (err != OK) {
+				decode_pool_mutex->unlock();
+				return err;
+			}
+		}
 
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
+		ParallelDecode decode;
+		decode.length = f->get_length();
+		decode.data = mapped_data;
 
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
+		LocalVector<Error> errors;
+		errors.resize(to_decode.size());
+		decode.indices = to_decode.ptr();
+		decode.loads = loads.ptrw();
+		decode.errors = errors.ptr();
 
-			Variant value;
+		if (decode_pool->get_thread_count() == 0) {
+			decode_pool->init();
+		}
+		decode_pool->do_work(to_decode.size(), this, &ResourceLoaderBinary::_decode_internal_resource, &decode);
+		decode_pool_mutex->unlock();
+		decoded_in_parallel = true;
 
-			error = parse_variant(value);
-			if (error) {
+		for (uint32_t i = 0; i < errors.size(); i++) {
+			if (errors[i] != OK) {
+				error = errors[i];
 				return error;
 			}
+		}
+
+		if (progress) {
+			*progress = 1.0;
+		}
+	} else {
+		for (uint32_t i = 0; i < to_decode.size(); i++) {
+			Error err = _decode_properties(loads.write[to_decode[i]]);
+			if (err != OK) {
+				error = err;
+				return error;
+			}
+
+			if (progress) {
+				*progress = (i + 1) / float(to_decode.size());
+			}
+		}
+	}
+
+	for (int i = 0; i < internal_resources.size(); i++) {
+		bool main = i == (internal_resources.size() - 1);
+		InternalResourceLoad &load = loads.write[i];
+
+		if (load.cached) {
+			continue;
+		}
+
+		Ref<Resource> res = load.resource;
+
+		//set properties
+
+		Dictionary missing_resource_properties;
+
+		for (int j = 0; j < load.property_names.size(); j++) {
+			const StringName &name = load.property_names[j];
+			const Variant &value = load.property_values[j];
 
 			bool set_valid = true;
-			if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
+			if (value.get_type() == Variant::OBJECT && load.missing_resource != nullptr) {
 				// If the property being set is a missing resource (and the parent is not),
 				// then setting it will most likely not work.
 				// Instead, save it as metadata.
@@ -801,8 +892,12 @@ Error ResourceLoaderBinary::load() {
 			}
 		}
 
-		if (missing_resource) {
-			missing_resource->set_recording_properties(false);
+		// Release the decoded values, the resource holds its own copies now.
+		load.property_names.clear();
+		load.property_values.clear();
+
+		if (load.missing_resource) {
+			load.missing_resource->set_recording_properties(false);
 		}
 
 		if (!missing_resource_properties.is_empty()) {
@@ -813,10 +908,6 @@ Error ResourceLoaderBinary::load() {
 		res->set_edited(false);
 #endif
 
-		if (progress) {
-			*progress = (i + 1) / float(internal_resources.size());
-		}
-
 		resource_cache.push_back(res);
 
 		if (main) {
@@ -831,6 +922,52 @@ Error ResourceLoaderBinary::load() {
 	return ERR_FILE_EOF;
 }
 
+Error ResourceLoaderBinary::_decode_properties(InternalResourceLoad &r_load) {
+	f->seek(r_load.properties_offset);
+
+	int pc = f->get_32();
+	r_load.property_names.resize(pc);
+	r_load.property_values.resize(pc);
+
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
+
+		if (name == StringName()) {
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
+		r_load.property_names.write[j] = name;
+
+		Error err = parse_variant(r_load.property_values.write[j]);
+		if (err) {
+			return err;
+		}
+	}
+
+	return OK;
+}
+
+void ResourceLoaderBinary::_decode_internal_resource(uint32_t p_index, ParallelDecode *p_decode) {
+	Ref<FileAccessMemory> fa;
+	fa.instantiate();
+	fa->open_custom(p_decode->data, p_decode->length);
+	fa->set_big_endian(f->is_big_endian());
+	fa->real_is_double = f->real_is_double;
+
+	ResourceLoaderBinary decoder;
+	decoder.decode_owner = this;
+	decoder.f = fa;
+	decoder.local_path = local_path;
+	decoder.res_path = res_path;
+	decoder.ver_format = ver_format;
+	decoder.using_named_scene_ids = using_named_scene_ids;
+	decoder.string_map = string_map;
+	decoder.external_resources = external_resources;
+	decoder.internal_resources = internal_resources;
+	decoder.remaps = remaps;
+
+	p_decode->errors[p_index] = decoder._decode_properties(p_decode->loads[p_decode->indices[p_index]]);
+}
+
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
 	translation_remapped = p_remapped;
 }
@@ -859,12 +996,27 @@ String ResourceLoaderBinary::get_unicode_string() {
 	if (len == 0) {
 		return String();
 	}
-	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
-	s.parse_utf8(&str_buf[0]);
+	if (!_parse_mapped_utf8(s, len)) {
+		f->get_buffer((uint8_t *)&str_buf[0], len);
+		s.parse_utf8(&str_buf[0]);
+	}
 	return s;
 }
 
+bool ResourceLoaderBinary::_parse_mapped_utf8(String &r_string, uint32_t p_len) {
+	// When the file is memory-mapped (e.g. inside a mapped PCK), decode the
+	// string in place instead of copying it into str_buf first.
+	uint64_t pos = f->get_position();
+	const uint8_t *span = f->get_mapped_span(pos, p_len);
+	if (!span) {
+		return false;
+	}
+	r_string.parse_utf8((const char *)span, p_len);
+	f->seek(pos + p_len);
+	return true;
+}
+
 void ResourceLoaderBinary::get_dependencies(Ref<FileAccess> p_f, List<String> *p_dependencies, bool p_add_types) {
 	open(p_f, false, true);
 	if (error) {
@@ -897,6 +1049,7 @@ void ResourceLoaderBinary::open(Ref<FileAccess> p_f, bool p_no_resources, bool p
 		// Compressed.
 		Ref<FileAccessCompressed> fac;
 		fac.instantiate();
+		fac->set_read_ahead(true);
 		error = fac->open_after_magic(f);
 		if (error != OK) {
 			f.unref();
@@ -1069,7 +1222,9 @@ Ref<Resource> ResourceFormatLoaderBinary::load(const String &p_path, const Strin
 
 	ResourceLoaderBinary loader;
 	loader.cache_mode = p_cache_mode;
-	loader.use_sub_threads = p_use_sub_threads;
+	if (p_use_sub_threads) {
+		loader.set_sub_threads(&decode_pool, &decode_pool_mutex);
+	}
 	loader.progress = r_progress;
 	String path = !p_original_path.is_empty() ? p_original_path : p_path;
 	loader.local_path = ProjectSettings::get_singleton()->localize_path(path);
@@ -34,6 +34,9 @@
 #include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/templates/thread_work_pool.h"
+
+class MissingResource;
 
 class ResourceLoaderBinary {
 	bool translation_remapped = false;
@@ -77,7 +80,40 @@ class ResourceLoaderBinary {
 	Vector<IntResource> internal_resources;
 	HashMap<String, Ref<Resource>> internal_index_cache;
 
+	struct InternalResourceLoad {
+		Ref<Resource> resource;
+		MissingResource *missing_resource = nullptr;
+		bool cached = false; // Reused from the cache, nothing to decode.
+		uint64_t properties_offset = 0;
+		Vector<StringName> property_names;
+		Vector<Variant> property_values;
+	};
+
+	struct ParallelDecode {
+		const uint8_t *data = nullptr;
+		uint64_t length = 0;
+		const uint32_t *indices = nullptr;
+		InternalResourceLoad *loads = nullptr;
+		Error *errors = nullptr;
+	};
+
+	enum {
+		PARALLEL_DECODE_MIN_SIZE = 256 * 1024
+	};
+
+	// Sub-resources are decoded on these threads when loading with sub-threads.
+	ThreadWorkPool *decode_pool = nullptr;
+	Mutex *decode_pool_mutex = nullptr;
+	bool decoded_in_parallel = false;
+	// Set on the per-thread decoders, which read internal resources from their owner.
+	const ResourceLoaderBinary *decode_owner = nullptr;
+
+	Error _decode_properties(InternalResourceLoad &r_load);
+	void _decode_internal_resource(uint32_t p_index, ParallelDecode *p_decode);
+	Error _load_external_resource(int p_index);
+
 	String get_unicode_string();
+	bool _parse_mapped_utf8(String &r_string, uint32_t p_len);
 	void _advance_padding(uint32_t p_len);
 
 	HashMap<String, String> remaps;
@@ -96,6 +132,8 @@ public:
 	Ref<Resource> get_resource();
 	Error load();
 	void set_translation_remapped(bool p_remapped);
+	void set_sub_threads(ThreadWorkPool *p_decode_pool, Mutex *p_decode_pool_mutex);
+	bool was_decoded_in_parallel() const { return decoded_in_parallel; }
 
 	void set_remaps(const HashMap<String, String> &p_remaps) { remaps = p_remaps; }
 	void open(Ref<FileAccess> p_f, bool p_no_resources = false, bool p_keep_uuid_paths = false);
@@ -106,6 +144,9 @@ public:
 };
 
 class ResourceFormatLoaderBinary : public ResourceFormatLoader {
+	ThreadWorkPool decode_pool;
+	Mutex decode_pool_mutex;
+
 public:
 	virtual Ref<Resource> load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE);
 	virtual void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const;
@@ -145,6 +145,8 @@ public:
 	virtual Error import_group_file(const String &p_group_file, const HashMap<String, HashMap<StringName, Variant>> &p_source_file_options, const HashMap<String, String> &p_base_paths) { return ERR_UNAVAILABLE; }
 	virtual bool are_import_settings_valid(const String &p_path) const { return true; }
 	virtual String get_import_settings_string() const { return String(); }
+	// Whether the result only depends on the source file, the options and get_import_settings_string(), so it can be reused from an import cache.
+	virtual bool can_import_cached(const HashMap<StringName, Variant> &p_options) const { return false; }
 };
 
 VARIANT_ENUM_CAST(ResourceImporter::ImportOrder);
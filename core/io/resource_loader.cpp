@@ -216,11 +216,8 @@ Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_origin
 void ResourceLoader::_thread_load_function(void *p_userdata) {
 	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
 	load_task.loader_id = Thread::get_caller_id();
+	load_task.start_ticks = OS::get_singleton()->get_ticks_usec();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
-	}
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
@@ -232,15 +229,7 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
 	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
-
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		print_lt("END: " + load_task.local_path + " / queued: " + itos(thread_load_queue.size()));
 
 		for (int i = 0; i < load_task.poll_requests; i++) {
 			load_task.semaphore->post();
@@ -271,7 +260,82 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		}
 	}
 
+	// The task may be freed once unlocked, copy what the timing callback needs.
+	ResourceLoadTimingCallback timing_callback = _load_timing_callback;
+	String local_path;
+	uint64_t queued_usec = 0;
+	uint64_t load_usec = 0;
+	if (timing_callback) {
+		local_path = load_task.local_path;
+		queued_usec = load_task.start_ticks - load_task.request_ticks;
+		load_usec = OS::get_singleton()->get_ticks_usec() - load_task.start_ticks;
+	}
+
 	thread_load_mutex->unlock();
+
+	// Called without the lock, so it can take as long as it needs or use ResourceLoader itself.
+	if (timing_callback) {
+		timing_callback(local_path, queued_usec, load_usec);
+	}
+}
+
+void ResourceLoader::_thread_load_worker(void *p_userdata) {
+	while (true) {
+		thread_load_semaphore->wait();
+
+		thread_load_mutex->lock();
+		if (thread_load_exit) {
+			thread_load_mutex->unlock();
+			break;
+		}
+		if (thread_load_queue.is_empty()) {
+			// The task was already taken over by a thread waiting for it.
+			thread_load_mutex->unlock();
+			continue;
+		}
+
+		ThreadLoadTask &load_task = thread_load_tasks[thread_load_queue.front()->get()];
+		thread_load_queue.pop_front();
+		load_task.queued = false;
+		thread_load_mutex->unlock();
+
+		_thread_load_function(&load_task);
+	}
+}
+
+void ResourceLoader::_start_thread_load_workers() {
+	// Called with thread_load_mutex locked.
+	if (thread_load_workers) {
+		return;
+	}
+	thread_load_workers = memnew_arr(Thread, thread_load_max);
+	for (int i = 0; i < thread_load_max; i++) {
+		thread_load_workers[i].start(_thread_load_worker, nullptr);
+	}
+}
+
+String ResourceLoader::_find_queued_task(const String &p_path, HashSet<String> &r_visited) {
+	// Called with thread_load_mutex locked. Looks for a task nobody started yet
+	// among p_path and its dependencies, so a waiting thread can load it itself.
+	if (r_visited.has(p_path)) {
+		return String();
+	}
+	r_visited.insert(p_path);
+
+	HashMap<String, ThreadLoadTask>::Iterator E = thread_load_tasks.find(p_path);
+	if (!E) {
+		return String();
+	}
+	if (E->value.queued) {
+		return p_path;
+	}
+	for (const String &F : E->value.sub_tasks) {
+		String found = _find_queued_task(F, r_visited);
+		if (!found.is_empty()) {
+			return found;
+		}
+	}
+	return String();
 }
 
 static String _validate_local_path(const String &p_path) {
@@ -357,19 +421,15 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 
 	if (load_task.resource.is_null()) { //needs to be loaded in thread
 
-		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
-		}
+		_start_thread_load_workers();
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		load_task.semaphore = memnew(Semaphore);
+		load_task.queued = true;
+		load_task.request_ticks = OS::get_singleton()->get_ticks_usec();
+		thread_load_queue.push_back(local_path);
+		thread_load_semaphore->post();
 
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+		print_lt("REQUEST: " + local_path + " / queued: " + itos(thread_load_queue.size()));
 	}
 
 	thread_load_mutex->unlock();
@@ -419,6 +479,22 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 	return status;
 }
 
+bool ResourceLoader::load_threaded_prioritize(const String &p_path) {
+	String local_path = _validate_local_path(p_path);
+
+	thread_load_mutex->lock();
+	HashMap<String, ThreadLoadTask>::Iterator E = thread_load_tasks.find(local_path);
+	if (!E || !E->value.queued) {
+		thread_load_mutex->unlock();
+		return false; // Unknown, or already being loaded.
+	}
+
+	thread_load_queue.erase(local_path);
+	thread_load_queue.push_front(local_path);
+	thread_load_mutex->unlock();
+	return true;
+}
+
 Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	String local_path = _validate_local_path(p_path);
 
@@ -433,40 +509,36 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 
 	ThreadLoadTask &load_task = thread_load_tasks[local_path];
 
-	//semaphore still exists, meaning it's still loading, request poll
+	// While the task hasn't been picked up by a worker, load it right here
+	// instead of blocking. Otherwise run whatever it still waits on, so
+	// waiting threads keep working and the pool can never starve itself.
+	while (load_task.semaphore) {
+		HashSet<String> visited;
+		String queued_path = _find_queued_task(local_path, visited);
+		if (queued_path.is_empty()) {
+			break;
+		}
+
+		ThreadLoadTask &queued_task = thread_load_tasks[queued_path];
+		thread_load_queue.erase(queued_path);
+		queued_task.queued = false;
+
+		thread_load_mutex->unlock();
+		_thread_load_function(&queued_task);
+		thread_load_mutex->lock();
+	}
+
+	//semaphore still exists, meaning it's still loading on another thread, request poll
 	Semaphore *semaphore = load_task.semaphore;
 	if (semaphore) {
 		load_task.poll_requests++;
 
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
-			}
-
-			thread_suspended_count++;
-
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-		}
+		print_lt("GET: waiting for " + local_path + " / queued: " + itos(thread_load_queue.size()));
 
 		thread_load_mutex->unlock();
 		semaphore->wait();
 		thread_load_mutex->lock();
 
-		thread_suspended_count--;
-
 		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
 			thread_load_mutex->unlock();
 			if (r_error) {
@@ -484,10 +556,6 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 	load_task.requests--;
 
 	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			load_task.thread->wait_to_finish();
-			memdelete(load_task.thread);
-		}
 		thread_load_tasks.erase(local_path);
 	}
 
@@ -544,6 +612,7 @@ Ref<Resource> ResourceLoader::load(const String &p_path, const String &p_type_hi
 		load_task.type_hint = p_type_hint;
 		load_task.cache_mode = p_cache_mode; //ignore
 		load_task.loader_id = Thread::get_caller_id();
+		load_task.request_ticks = OS::get_singleton()->get_ticks_usec();
 
 		thread_load_tasks[local_path] = load_task;
 
@@ -921,6 +990,12 @@ void ResourceLoader::set_load_callback(ResourceLoadedCallback p_callback) {
 
 ResourceLoadedCallback ResourceLoader::_loaded_callback = nullptr;
 
+void ResourceLoader::set_load_timing_callback(ResourceLoadTimingCallback p_callback) {
+	_load_timing_callback = p_callback;
+}
+
+ResourceLoadTimingCallback ResourceLoader::_load_timing_callback = nullptr;
+
 Ref<ResourceFormatLoader> ResourceLoader::_find_custom_resource_format_loader(String path) {
 	for (int i = 0; i < loader_count; ++i) {
 		if (loader[i]->get_script_instance() && loader[i]->get_script_instance()->get_script()->get_path() == path) {
@@ -1000,13 +1075,26 @@ void ResourceLoader::remove_custom_loaders() {
 void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
 	thread_load_max = OS::get_singleton()->get_processor_count();
-	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
+	thread_load_exit = false;
 	thread_load_semaphore = memnew(Semaphore);
 }
 
 void ResourceLoader::finalize() {
+	if (thread_load_workers) {
+		thread_load_mutex->lock();
+		thread_load_exit = true;
+		thread_load_mutex->unlock();
+
+		for (int i = 0; i < thread_load_max; i++) {
+			thread_load_semaphore->post();
+		}
+		for (int i = 0; i < thread_load_max; i++) {
+			thread_load_workers[i].wait_to_finish();
+		}
+		memdelete_arr(thread_load_workers);
+		thread_load_workers = nullptr;
+	}
+
 	memdelete(thread_load_mutex);
 	memdelete(thread_load_semaphore);
 }
@@ -1023,12 +1111,12 @@ bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
+List<String> ResourceLoader::thread_load_queue;
 Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
+Thread *ResourceLoader::thread_load_workers = nullptr;
 
-int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
 int ResourceLoader::thread_load_max = 0;
+bool ResourceLoader::thread_load_exit = false;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
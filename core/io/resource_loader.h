@@ -86,6 +86,7 @@ typedef void (*DependencyErrorNotify)(void *p_ud, const String &p_loading, const
 
 typedef Error (*ResourceLoaderImport)(const String &p_path);
 typedef void (*ResourceLoadedCallback)(Ref<Resource> p_resource, const String &p_path);
+typedef void (*ResourceLoadTimingCallback)(const String &p_path, uint64_t p_queued_usec, uint64_t p_load_usec);
 
 class ResourceLoader {
 	enum {
@@ -125,11 +126,11 @@ private:
 	static Ref<Resource> _load(const String &p_path, const String &p_original_path, const String &p_type_hint, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error, bool p_use_sub_threads, float *r_progress);
 
 	static ResourceLoadedCallback _loaded_callback;
+	static ResourceLoadTimingCallback _load_timing_callback;
 
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
 	struct ThreadLoadTask {
-		Thread *thread = nullptr;
 		Thread::ID loader_id = 0;
 		Semaphore *semaphore = nullptr;
 		String local_path;
@@ -142,26 +143,33 @@ private:
 		Ref<Resource> resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
+		bool queued = false; // Waiting in thread_load_queue for a worker.
 		int requests = 0;
 		int poll_requests = 0;
+		uint64_t request_ticks = 0;
+		uint64_t start_ticks = 0;
 		HashSet<String> sub_tasks;
 	};
 
 	static void _thread_load_function(void *p_userdata);
+	static void _thread_load_worker(void *p_userdata);
+	static void _start_thread_load_workers();
+	static String _find_queued_task(const String &p_path, HashSet<String> &r_visited);
 	static Mutex *thread_load_mutex;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
+	static List<String> thread_load_queue;
 	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
-	static int thread_loading_count;
-	static int thread_suspended_count;
+	static Thread *thread_load_workers;
 	static int thread_load_max;
+	static bool thread_load_exit;
 
 	static float _dependency_get_progress(const String &p_path);
 
 public:
 	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, const String &p_source_resource = String());
 	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = nullptr);
+	// Moves a request that no worker picked up yet to the front of the queue.
+	static bool load_threaded_prioritize(const String &p_path);
 	static Ref<Resource> load_threaded_get(const String &p_path, Error *r_error = nullptr);
 
 	static Ref<Resource> load(const String &p_path, const String &p_type_hint = "", ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, Error *r_error = nullptr);
@@ -216,6 +224,7 @@ public:
 	static void clear_translation_remaps();
 
 	static void set_load_callback(ResourceLoadedCallback p_callback);
+	static void set_load_timing_callback(ResourceLoadTimingCallback p_callback);
 	static ResourceLoaderImport import;
 
 	static bool add_custom_resource_format_loader(String script_path);
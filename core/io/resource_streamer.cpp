@@ -0,0 +1,339 @@
+/*************************************************************************/
+/*  resource_streamer.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "resource_streamer.h"
+
+#include "core/io/file_access.h"
+#include "core/io/resource_loader.h"
+
+ResourceStreamer *ResourceStreamer::singleton = nullptr;
+
+uint64_t ResourceStreamer::_estimate_size(const String &p_path) {
+	// What's actually read from disk (the imported file for imported resources).
+	String path = ResourceLoader::import_remap(ResourceLoader::path_remap(p_path));
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+	return f.is_valid() ? f->get_length() : 0;
+}
+
+void ResourceStreamer::_evict_to(uint64_t p_target, int p_below_priority, List<String> &r_evicted) {
+	if (resident_bytes + loading_bytes <= p_target) {
+		return;
+	}
+
+	Vector<Entry *> candidates;
+	for (KeyValue<String, Entry> &E : entries) {
+		Entry &e = E.value;
+		// Only resources nobody else holds on to, evicting the others wouldn't free anything.
+		if (e.state == STATE_RESIDENT && e.priority < p_below_priority && e.resource->reference_get_count() == 1) {
+			candidates.push_back(&e);
+		}
+	}
+	candidates.sort_custom<EntryUseCompare>();
+
+	for (int i = 0; i < candidates.size() && resident_bytes + loading_bytes > p_target; i++) {
+		String path = candidates[i]->path;
+		resident_bytes -= candidates[i]->size;
+		evicted_count++;
+		entries.erase(path);
+		r_evicted.push_back(path);
+	}
+}
+
+void ResourceStreamer::request(const String &p_path, int p_priority, const String &p_type_hint) {
+	ERR_FAIL_COND(p_path.is_empty());
+
+	bool needs_size;
+	{
+		MutexLock lock(mutex);
+		HashMap<String, Entry>::ConstIterator E = entries.find(p_path);
+		needs_size = !E || E->value.state == STATE_FAILED;
+	}
+	// Opens the file, so it's done before locking.
+	uint64_t size = needs_size ? _estimate_size(p_path) : 0;
+
+	MutexLock lock(mutex);
+	HashMap<String, Entry>::Iterator E = entries.find(p_path);
+	if (!E) {
+		Entry e;
+		e.path = p_path;
+		e.type_hint = p_type_hint;
+		e.size = size;
+		e.order = request_counter++;
+		E = entries.insert(p_path, e);
+	}
+
+	Entry &e = E->value;
+	if (e.state == STATE_LOADING && p_priority > e.priority) {
+		ResourceLoader::load_threaded_prioritize(p_path);
+	}
+	if (e.state == STATE_FAILED) {
+		// Requested again, the file may have been fixed or created since.
+		e.state = STATE_PENDING;
+		e.type_hint = p_type_hint;
+		if (needs_size) {
+			e.size = size;
+		}
+	}
+	e.priority = p_priority;
+	e.released = false;
+	e.last_used = ++use_counter;
+}
+
+void ResourceStreamer::release(const String &p_path) {
+	MutexLock lock(mutex);
+	HashMap<String, Entry>::Iterator E = entries.find(p_path);
+	if (!E) {
+		return;
+	}
+
+	Entry &e = E->value;
+	if (e.state == STATE_LOADING) {
+		e.released = true;
+		return;
+	}
+	if (e.state == STATE_RESIDENT) {
+		resident_bytes -= e.size;
+	}
+	entries.erase(p_path);
+}
+
+void ResourceStreamer::clear() {
+	List<String> loading;
+
+	mutex.lock();
+	for (const KeyValue<String, Entry> &E : entries) {
+		if (E.value.state == STATE_LOADING) {
+			loading.push_back(E.key);
+		}
+	}
+	entries.clear();
+	loading_count = 0;
+	loading_bytes = 0;
+	resident_bytes = 0;
+	mutex.unlock();
+
+	// Loads can't be cancelled, wait for them so the requests are released. This is done
+	// unlocked, so other threads can keep using the streamer in the meantime.
+	for (const String &path : loading) {
+		ResourceLoader::load_threaded_get(path);
+	}
+}
+
+bool ResourceStreamer::is_resident(const String &p_path) {
+	MutexLock lock(mutex);
+	HashMap<String, Entry>::ConstIterator E = entries.find(p_path);
+	return E && E->value.state == STATE_RESIDENT;
+}
+
+Ref<Resource> ResourceStreamer::get_resource(const String &p_path) {
+	MutexLock lock(mutex);
+	HashMap<String, Entry>::Iterator E = entries.find(p_path);
+	if (!E || E->value.state != STATE_RESIDENT) {
+		return Ref<Resource>();
+	}
+	E->value.last_used = ++use_counter;
+	return E->value.resource;
+}
+
+void ResourceStreamer::set_memory_budget(uint64_t p_bytes) {
+	MutexLock lock(mutex);
+	memory_budget = p_bytes;
+}
+
+uint64_t ResourceStreamer::get_memory_budget() {
+	MutexLock lock(mutex);
+	return memory_budget;
+}
+
+void ResourceStreamer::set_max_concurrent_loads(int p_count) {
+	ERR_FAIL_COND(p_count < 1);
+	MutexLock lock(mutex);
+	max_concurrent_loads = p_count;
+}
+
+int ResourceStreamer::get_max_concurrent_loads() {
+	MutexLock lock(mutex);
+	return max_concurrent_loads;
+}
+
+uint64_t ResourceStreamer::get_resident_bytes() {
+	MutexLock lock(mutex);
+	return resident_bytes;
+}
+
+int ResourceStreamer::get_resident_count() {
+	MutexLock lock(mutex);
+	int count = 0;
+	for (const KeyValue<String, Entry> &E : entries) {
+		count += E.value.state == STATE_RESIDENT ? 1 : 0;
+	}
+	return count;
+}
+
+int ResourceStreamer::get_pending_count() {
+	MutexLock lock(mutex);
+	int count = 0;
+	for (const KeyValue<String, Entry> &E : entries) {
+		count += (E.value.state == STATE_PENDING || E.value.state == STATE_LOADING) ? 1 : 0;
+	}
+	return count;
+}
+
+uint64_t ResourceStreamer::get_evicted_count() {
+	MutexLock lock(mutex);
+	return evicted_count;
+}
+
+void ResourceStreamer::poll() {
+	List<String> loaded;
+	List<String> failed;
+	List<String> evicted;
+
+	mutex.lock();
+
+	if (entries.is_empty()) {
+		mutex.unlock();
+		return;
+	}
+
+	// Collect finished loads.
+	if (loading_count > 0) {
+		List<String> dropped;
+		for (KeyValue<String, Entry> &E : entries) {
+			Entry &e = E.value;
+			if (e.state != STATE_LOADING || ResourceLoader::load_threaded_get_status(E.key) == ResourceLoader::THREAD_LOAD_IN_PROGRESS) {
+				continue;
+			}
+
+			Ref<Resource> res = ResourceLoader::load_threaded_get(E.key);
+			loading_count--;
+			loading_bytes -= e.size;
+
+			if (e.released) {
+				dropped.push_back(E.key);
+			} else if (res.is_valid()) {
+				e.resource = res;
+				e.state = STATE_RESIDENT;
+				resident_bytes += e.size;
+				loaded.push_back(E.key);
+			} else {
+				e.state = STATE_FAILED;
+				failed.push_back(E.key);
+			}
+		}
+		for (const String &path : dropped) {
+			entries.erase(path);
+		}
+	}
+
+	if (memory_budget > 0) {
+		_evict_to(memory_budget, INT_MAX, evicted);
+	}
+
+	// Start the most important pending loads.
+	if (loading_count < max_concurrent_loads) {
+		Vector<Entry *> pending;
+		for (KeyValue<String, Entry> &E : entries) {
+			if (E.value.state == STATE_PENDING) {
+				pending.push_back(&E.value);
+			}
+		}
+		pending.sort_custom<EntryPriorityCompare>();
+
+		for (int i = 0; i < pending.size() && loading_count < max_concurrent_loads; i++) {
+			Entry &e = *pending[i];
+
+			if (memory_budget > 0 && resident_bytes + loading_bytes > 0 && resident_bytes + loading_bytes + e.size > memory_budget) {
+				// Make room with anything less important, otherwise wait (lower priorities must not overtake).
+				_evict_to(memory_budget > e.size ? memory_budget - e.size : 0, e.priority, evicted);
+				if (resident_bytes + loading_bytes > 0 && resident_bytes + loading_bytes + e.size > memory_budget) {
+					break;
+				}
+			}
+
+			if (ResourceLoader::load_threaded_request(e.path, e.type_hint) != OK) {
+				e.state = STATE_FAILED;
+				failed.push_back(e.path);
+				continue;
+			}
+			e.state = STATE_LOADING;
+			loading_count++;
+			loading_bytes += e.size;
+		}
+	}
+
+	mutex.unlock();
+
+	for (const String &path : loaded) {
+		emit_signal(SNAME("resource_loaded"), path);
+	}
+	for (const String &path : failed) {
+		emit_signal(SNAME("resource_load_failed"), path);
+	}
+	for (const String &path : evicted) {
+		emit_signal(SNAME("resource_evicted"), path);
+	}
+}
+
+void ResourceStreamer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("request", "path", "priority", "type_hint"), &ResourceStreamer::request, DEFVAL(0), DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("release", "path"), &ResourceStreamer::release);
+	ClassDB::bind_method(D_METHOD("clear"), &ResourceStreamer::clear);
+	ClassDB::bind_method(D_METHOD("is_resident", "path"), &ResourceStreamer::is_resident);
+	ClassDB::bind_method(D_METHOD("get_resource", "path"), &ResourceStreamer::get_resource);
+
+	ClassDB::bind_method(D_METHOD("set_memory_budget", "bytes"), &ResourceStreamer::set_memory_budget);
+	ClassDB::bind_method(D_METHOD("get_memory_budget"), &ResourceStreamer::get_memory_budget);
+	ClassDB::bind_method(D_METHOD("set_max_concurrent_loads", "count"), &ResourceStreamer::set_max_concurrent_loads);
+	ClassDB::bind_method(D_METHOD("get_max_concurrent_loads"), &ResourceStreamer::get_max_concurrent_loads);
+
+	ClassDB::bind_method(D_METHOD("get_resident_bytes"), &ResourceStreamer::get_resident_bytes);
+	ClassDB::bind_method(D_METHOD("get_resident_count"), &ResourceStreamer::get_resident_count);
+	ClassDB::bind_method(D_METHOD("get_pending_count"), &ResourceStreamer::get_pending_count);
+	ClassDB::bind_method(D_METHOD("get_evicted_count"), &ResourceStreamer::get_evicted_count);
+
+	ClassDB::bind_method(D_METHOD("poll"), &ResourceStreamer::poll);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "memory_budget", PROPERTY_HINT_RANGE, "0,1,1,or_greater,suffix:B"), "set_memory_budget", "get_memory_budget");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_concurrent_loads", PROPERTY_HINT_RANGE, "1,64,1"), "set_max_concurrent_loads", "get_max_concurrent_loads");
+
+	ADD_SIGNAL(MethodInfo("resource_loaded", PropertyInfo(Variant::STRING, "path")));
+	ADD_SIGNAL(MethodInfo("resource_load_failed", PropertyInfo(Variant::STRING, "path")));
+	ADD_SIGNAL(MethodInfo("resource_evicted", PropertyInfo(Variant::STRING, "path")));
+}
+
+ResourceStreamer::ResourceStreamer() {
+	singleton = this;
+}
+
+ResourceStreamer::~ResourceStreamer() {
+	clear();
+	singleton = nullptr;
+}
@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  resource_streamer.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RESOURCE_STREAMER_H
+#define RESOURCE_STREAMER_H
+
+#include "core/io/resource.h"
+#include "core/object/class_db.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+
+// Keeps a prioritised set of resources loaded in the background, within a memory budget.
+// Built on ResourceLoader's threaded requests; poll() is called once per frame by Main.
+class ResourceStreamer : public Object {
+	GDCLASS(ResourceStreamer, Object);
+
+	enum State {
+		STATE_PENDING,
+		STATE_LOADING,
+		STATE_RESIDENT,
+		STATE_FAILED,
+	};
+
+	struct Entry {
+		String path;
+		String type_hint;
+		int priority = 0;
+		State state = STATE_PENDING;
+		bool released = false; // Released while loading, dropped once the load finishes.
+		Ref<Resource> resource;
+		uint64_t size = 0; // Estimated from the size of the stored file when requested.
+		uint64_t order = 0; // Request order, breaks priority ties.
+		uint64_t last_used = 0;
+	};
+
+	struct EntryPriorityCompare {
+		_FORCE_INLINE_ bool operator()(const Entry *p_a, const Entry *p_b) const {
+			return p_a->priority != p_b->priority ? p_a->priority > p_b->priority : p_a->order < p_b->order;
+		}
+	};
+
+	struct EntryUseCompare {
+		_FORCE_INLINE_ bool operator()(const Entry *p_a, const Entry *p_b) const {
+			return p_a->last_used < p_b->last_used;
+		}
+	};
+
+	static ResourceStreamer *singleton;
+
+	Mutex mutex;
+	HashMap<String, Entry> entries;
+	uint64_t memory_budget = 0; // 0 means unlimited.
+	int max_concurrent_loads = 4;
+	uint64_t use_counter = 0;
+	uint64_t request_counter = 0;
+
+	int loading_count = 0;
+	uint64_t loading_bytes = 0;
+	uint64_t resident_bytes = 0;
+	uint64_t evicted_count = 0;
+
+	static uint64_t _estimate_size(const String &p_path);
+	void _evict_to(uint64_t p_target, int p_below_priority, List<String> &r_evicted);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static ResourceStreamer *get_singleton() { return singleton; }
+
+	void request(const String &p_path, int p_priority = 0, const String &p_type_hint = "");
+	void release(const String &p_path);
+	void clear();
+
+	bool is_resident(const String &p_path);
+	Ref<Resource> get_resource(const String &p_path);
+
+	void set_memory_budget(uint64_t p_bytes);
+	uint64_t get_memory_budget();
+	void set_max_concurrent_loads(int p_count);
+	int get_max_concurrent_loads();
+
+	uint64_t get_resident_bytes();
+	int get_resident_count();
+	int get_pending_count();
+	uint64_t get_evicted_count();
+
+	void poll();
+
+	ResourceStreamer();
+	~ResourceStreamer();
+};
+
+#endif // RESOURCE_STREAMER_H
@@ -32,6 +32,7 @@
 
 #include "core/config/engine.h"
 #include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/version.h"
 
 #define OBJTYPE_RLOCK RWLockRead _rw_lockr_(lock);
@@ -421,6 +422,14 @@ static MethodInfo info_from_bind(MethodBind *p_method) {
 	return minfo;
 }
 
+#ifndef DEBUG_METHODS_ENABLED
+struct MethodBindIDComparator {
+	_FORCE_INLINE_ bool operator()(const MethodBind *p_a, const MethodBind *p_b) const {
+		return p_a->get_method_id() < p_b->get_method_id();
+	}
+};
+#endif
+
 void ClassDB::get_method_list(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance, bool p_exclude_from_properties) {
 	OBJTYPE_RLOCK;
 
@@ -455,9 +464,16 @@ void ClassDB::get_method_list(const StringName &p_class, List<MethodInfo> *p_met
 
 #else
 
+		// The method map iterates in hash order, method IDs follow the order the methods were bound in.
+		LocalVector<MethodBind *> binds;
+		binds.reserve(type->method_map.size());
 		for (KeyValue<StringName, MethodBind *> &E : type->method_map) {
-			MethodBind *m = E.value;
-			MethodInfo minfo = info_from_bind(m);
+			binds.push_back(E.value);
+		}
+		binds.sort_custom<MethodBindIDComparator>();
+
+		for (uint32_t i = 0; i < binds.size(); i++) {
+			MethodInfo minfo = info_from_bind(binds[i]);
 			p_methods->push_back(minfo);
 		}
 
@@ -522,6 +538,13 @@ bool ClassDB::get_method_info(const StringName &p_class, const StringName &p_met
 }
 
 MethodBind *ClassDB::get_method(const StringName &p_class, const StringName &p_name) {
+	LookupTableReader reader;
+	const LookupTable *table = _get_lookup_table(p_class);
+	if (likely(table)) {
+		MethodBind *const *method = table->methods.getptr(p_name);
+		return method ? *method : nullptr;
+	}
+
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -547,6 +570,7 @@ void ClassDB::bind_integer_constant(const StringName &p_class, const StringName
 		ERR_FAIL();
 	}
 
+	_invalidate_lookup_tables(p_class);
 	type->constant_map[p_name] = p_constant;
 
 	String enum_name = p_enum;
@@ -785,6 +809,7 @@ void ClassDB::add_signal(const StringName &p_class, const MethodInfo &p_signal)
 	}
 #endif
 
+	_invalidate_lookup_tables(p_class);
 	type->signal_map[sname] = p_signal;
 }
 
@@ -937,6 +962,7 @@ void ClassDB::add_property(const StringName &p_class, const PropertyInfo &p_pinf
 	psg.index = p_index;
 	psg.type = p_pinfo.type;
 
+	_invalidate_lookup_tables(p_class);
 	type->property_setget[p_pinfo.name] = psg;
 }
 
@@ -1009,46 +1035,81 @@ bool ClassDB::get_property_info(const StringName &p_class, const StringName &p_p
 	return false;
 }
 
+static void _set_property_setget(Object *p_object, const ClassDB::PropertySetGet *psg, const Variant &p_value, bool *r_valid) {
+	if (!psg->setter) {
+		if (r_valid) {
+			*r_valid = false;
+		}
+		return; //return true but do nothing
+	}
+
+	Callable::CallError ce;
+
+	if (psg->index >= 0) {
+		Variant index = psg->index;
+		const Variant *arg[2] = { &index, &p_value };
+		//p_object->call(psg->setter,arg,2,ce);
+		if (psg->_setptr) {
+			psg->_setptr->call(p_object, arg, 2, ce);
+		} else {
+			p_object->callp(psg->setter, arg, 2, ce);
+		}
+
+	} else {
+		const Variant *arg[1] = { &p_value };
+		if (psg->_setptr) {
+			psg->_setptr->call(p_object, arg, 1, ce);
+		} else {
+			p_object->callp(psg->setter, arg, 1, ce);
+		}
+	}
+
+	if (r_valid) {
+		*r_valid = ce.error == Callable::CallError::CALL_OK;
+	}
+}
+
+static void _get_property_setget(Object *p_object, const ClassDB::PropertySetGet *psg, Variant &r_value) {
+	if (!psg->getter) {
+		return; //return true but do nothing
+	}
+
+	if (psg->index >= 0) {
+		Variant index = psg->index;
+		const Variant *arg[1] = { &index };
+		Callable::CallError ce;
+		r_value = p_object->callp(psg->getter, arg, 1, ce);
+
+	} else {
+		Callable::CallError ce;
+		if (psg->_getptr) {
+			r_value = psg->_getptr->call(p_object, nullptr, 0, ce);
+		} else {
+			r_value = p_object->callp(psg->getter, nullptr, 0, ce);
+		}
+	}
+}
+
 bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
 	ERR_FAIL_NULL_V(p_object, false);
 
+	LookupTableReader reader;
+	const LookupTable *table = _get_lookup_table(p_object->get_class_name());
+	if (likely(table)) {
+		const LookupTable::Member *member = table->members.getptr(p_property);
+		if (!member || !member->has_setget) {
+			return false;
+		}
+		_set_property_setget(p_object, &member->setget, p_value, r_valid);
+		return true;
+	}
+
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
 		if (psg) {
-			if (!psg->setter) {
-				if (r_valid) {
-					*r_valid = false;
-				}
-				return true; //return true but do nothing
-			}
-
-			Callable::CallError ce;
-
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[2] = { &index, &p_value };
-				//p_object->call(psg->setter,arg,2,ce);
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 2, ce);
-				} else {
-					p_object->callp(psg->setter, arg, 2, ce);
-				}
-
-			} else {
-				const Variant *arg[1] = { &p_value };
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 1, ce);
-				} else {
-					p_object->callp(psg->setter, arg, 1, ce);
-				}
-			}
-
-			if (r_valid) {
-				*r_valid = ce.error == Callable::CallError::CALL_OK;
-			}
-
+			_set_property_setget(p_object, psg, p_value, r_valid);
 			return true;
 		}
 
@@ -1061,29 +1122,36 @@ bool ClassDB::set_property(Object *p_object, const StringName &p_property, const
 bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 	ERR_FAIL_NULL_V(p_object, false);
 
+	LookupTableReader reader;
+	const LookupTable *table = _get_lookup_table(p_object->get_class_name());
+	if (likely(table)) {
+		const LookupTable::Member *member = table->members.getptr(p_property);
+		if (!member) {
+			return false;
+		}
+		switch (member->type) {
+			case LookupTable::Member::TYPE_PROPERTY: {
+				_get_property_setget(p_object, &member->setget, r_value);
+			} break;
+			case LookupTable::Member::TYPE_CONSTANT: {
+				r_value = member->constant;
+			} break;
+			case LookupTable::Member::TYPE_METHOD: {
+				r_value = Callable(p_object, p_property);
+			} break;
+			case LookupTable::Member::TYPE_SIGNAL: {
+				r_value = Signal(p_object, p_property);
+			} break;
+		}
+		return true;
+	}
+
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
 		if (psg) {
-			if (!psg->getter) {
-				return true; //return true but do nothing
-			}
-
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[1] = { &index };
-				Callable::CallError ce;
-				r_value = p_object->callp(psg->getter, arg, 1, ce);
-
-			} else {
-				Callable::CallError ce;
-				if (psg->_getptr) {
-					r_value = psg->_getptr->call(p_object, nullptr, 0, ce);
-				} else {
-					r_value = p_object->callp(psg->getter, nullptr, 0, ce);
-				}
-			}
+			_get_property_setget(p_object, psg, r_value);
 			return true;
 		}
 
@@ -1236,6 +1304,8 @@ void ClassDB::bind_method_custom(const StringName &p_class, MethodBind *p_method
 		ERR_FAIL_MSG("Method already bound '" + p_class + "::" + p_method->get_name() + "'.");
 	}
 
+	_invalidate_lookup_tables(p_class);
+
 #ifdef DEBUG_METHODS_ENABLED
 	type->method_order.push_back(p_method->get_name());
 #endif
@@ -1286,6 +1356,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 	type->method_order.push_back(mdname);
 #endif
 
+	_invalidate_lookup_tables(instance_type);
 	type->method_map[mdname] = p_bind;
 
 	Vector<Variant> defvals;
@@ -1511,6 +1582,7 @@ void ClassDB::register_extension_class(ObjectNativeExtension *p_extension) {
 void ClassDB::unregister_extension_class(const StringName &p_class) {
 	ERR_FAIL_COND(!classes.has(p_class));
 	classes.erase(p_class);
+	_invalidate_lookup_tables(p_class);
 }
 
 HashMap<StringName, ClassDB::NativeStruct> ClassDB::native_structs;
@@ -1539,6 +1611,199 @@ uint64_t ClassDB::get_native_struct_size(const StringName &p_name) {
 
 RWLock ClassDB::lock;
 
+std::atomic<ClassDB::LookupTables *> ClassDB::lookup_tables = { nullptr };
+std::atomic<uint32_t> ClassDB::lookup_table_readers = { 0 };
+std::atomic<bool> ClassDB::has_retired_lookup_tables = { false };
+LocalVector<ClassDB::LookupTables *> ClassDB::retired_lookup_tables;
+LocalVector<ClassDB::LookupTable *> ClassDB::retired_lookup_table_entries;
+Mutex ClassDB::lookup_tables_mutex;
+
+ClassDB::LookupTable *ClassDB::_get_lookup_table(const StringName &p_class) {
+	LookupTables *tables = lookup_tables.load();
+	if (unlikely(!tables)) {
+		return nullptr;
+	}
+
+	LookupTable *const *table = tables->getptr(p_class);
+	if (unlikely(!table)) {
+		return nullptr; // Registered after the tables were created.
+	}
+
+	if (unlikely(!(*table)->built.is_set())) {
+		_build_lookup_table(*table);
+	}
+	return *table;
+}
+
+void ClassDB::_build_lookup_table(LookupTable *p_table) {
+	OBJTYPE_RLOCK;
+	MutexLock lookup_lock(lookup_tables_mutex);
+
+	if (p_table->built.is_set()) {
+		return; // Another thread got here first.
+	}
+
+	// Walk from the class to the root, so entries closer to the class win.
+	for (const ClassInfo *check = p_table->class_info; check; check = check->inherits_ptr) {
+		for (const KeyValue<StringName, MethodBind *> &E : check->method_map) {
+			if (E.value && !p_table->methods.has(E.key)) {
+				p_table->methods.insert(E.key, E.value);
+			}
+		}
+
+		for (const KeyValue<StringName, PropertySetGet> &E : check->property_setget) {
+			LookupTable::Member *member = p_table->members.getptr(E.key);
+			if (!member) {
+				LookupTable::Member new_member;
+				new_member.type = LookupTable::Member::TYPE_PROPERTY;
+				new_member.has_setget = true;
+				new_member.setget = E.value;
+				p_table->members.insert(E.key, new_member);
+			} else if (!member->has_setget) {
+				// Shadowed for get_property() by a member of a derived class,
+				// but still the property set_property() should use.
+				member->has_setget = true;
+				member->setget = E.value;
+			}
+		}
+
+		for (const KeyValue<StringName, int64_t> &E : check->constant_map) {
+			if (!p_table->members.has(E.key)) {
+				LookupTable::Member new_member;
+				new_member.type = LookupTable::Member::TYPE_CONSTANT;
+				new_member.constant = E.value;
+				p_table->members.insert(E.key, new_member);
+			}
+		}
+
+		for (const KeyValue<StringName, MethodBind *> &E : check->method_map) {
+			if (!p_table->members.has(E.key)) {
+				LookupTable::Member new_member;
+				new_member.type = LookupTable::Member::TYPE_METHOD;
+				p_table->members.insert(E.key, new_member);
+			}
+		}
+
+		for (const KeyValue<StringName, MethodInfo> &E : check->signal_map) {
+			if (!p_table->members.has(E.key)) {
+				LookupTable::Member new_member;
+				new_member.type = LookupTable::Member::TYPE_SIGNAL;
+				p_table->members.insert(E.key, new_member);
+			}
+		}
+	}
+
+	p_table->built.set();
+}
+
+void ClassDB::_invalidate_lookup_tables(const StringName &p_class) {
+	MutexLock lookup_lock(lookup_tables_mutex);
+
+	LookupTables *tables = lookup_tables.load();
+	if (!tables) {
+		return;
+	}
+
+	// Tables are read without locking, so the changed ones are replaced with
+	// empty tables in a new set, which are filled again on first use.
+	LookupTables *new_tables = memnew(LookupTables(tables->size()));
+	for (const KeyValue<StringName, LookupTable *> &E : *tables) {
+		ClassInfo *class_info = classes.getptr(E.key);
+		if (!class_info) {
+			retired_lookup_table_entries.push_back(E.value); // Unregistered.
+			continue;
+		}
+
+		bool affected = false;
+		for (const ClassInfo *check = class_info; check && !affected; check = check->inherits_ptr) {
+			affected = check->name == p_class || check->inherits == p_class;
+		}
+		if (!affected) {
+			new_tables->insert(E.key, E.value);
+			continue;
+		}
+
+		LookupTable *table = memnew(LookupTable);
+		table->class_info = class_info;
+		new_tables->insert(E.key, table);
+		retired_lookup_table_entries.push_back(E.value);
+	}
+
+	lookup_tables.store(new_tables);
+	retired_lookup_tables.push_back(tables);
+	has_retired_lookup_tables.store(true);
+	_free_retired_lookup_tables();
+}
+
+void ClassDB::_free_lookup_tables(LookupTables *p_tables) {
+	for (KeyValue<StringName, LookupTable *> &E : *p_tables) {
+		memdelete(E.value);
+	}
+	memdelete(p_tables);
+}
+
+void ClassDB::enable_lookup_tables() {
+	OBJTYPE_RLOCK;
+	MutexLock lookup_lock(lookup_tables_mutex);
+
+	LookupTables *tables = memnew(LookupTables(classes.size()));
+	for (KeyValue<StringName, ClassInfo> &E : classes) {
+		LookupTable *table = memnew(LookupTable);
+		table->class_info = &E.value;
+		tables->insert(E.key, table);
+	}
+
+	_retire_lookup_tables();
+	lookup_tables.store(tables);
+	_free_retired_lookup_tables();
+}
+
+void ClassDB::disable_lookup_tables() {
+	MutexLock lookup_lock(lookup_tables_mutex);
+
+	_retire_lookup_tables();
+	lookup_tables.store(nullptr);
+	_free_retired_lookup_tables();
+}
+
+bool ClassDB::are_lookup_tables_enabled() {
+	return lookup_tables.load() != nullptr;
+}
+
+void ClassDB::_retire_lookup_tables() {
+	LookupTables *tables = lookup_tables.load();
+	if (!tables) {
+		return;
+	}
+	for (const KeyValue<StringName, LookupTable *> &E : *tables) {
+		retired_lookup_table_entries.push_back(E.value);
+	}
+	retired_lookup_tables.push_back(tables);
+	has_retired_lookup_tables.store(true);
+}
+
+void ClassDB::_free_retired_lookup_tables() {
+	MutexLock lookup_lock(lookup_tables_mutex); // Recursive, so callers may already hold it.
+
+	// What was retired can't be reached from the current set anymore. Lookups
+	// starting after this check load the current set, so only those already
+	// in progress may still read retired entries.
+	if (lookup_table_readers.load() != 0) {
+		return; // Left to the last of them.
+	}
+
+	// Retired sets share their tables with newer sets, tables are retired on their own.
+	for (uint32_t i = 0; i < retired_lookup_tables.size(); i++) {
+		memdelete(retired_lookup_tables[i]);
+	}
+	retired_lookup_tables.clear();
+	for (uint32_t i = 0; i < retired_lookup_table_entries.size(); i++) {
+		memdelete(retired_lookup_table_entries[i]);
+	}
+	retired_lookup_table_entries.clear();
+	has_retired_lookup_tables.store(false);
+}
+
 void ClassDB::cleanup_defaults() {
 	default_values.clear();
 	default_values_cached.clear();
@@ -1547,6 +1812,12 @@ void ClassDB::cleanup_defaults() {
 void ClassDB::cleanup() {
 	//OBJTYPE_LOCK; hah not here
 
+	if (lookup_tables.load()) {
+		_free_lookup_tables(lookup_tables.load());
+		lookup_tables.store(nullptr);
+	}
+	_free_retired_lookup_tables();
+
 	for (KeyValue<StringName, ClassInfo> &E : classes) {
 		ClassInfo &ti = E.value;
 
@@ -33,7 +33,10 @@
 
 #include "core/object/method_bind.h"
 #include "core/object/object.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/local_vector.h"
 
 // Makes callable_mp readily available in all classes connecting signals.
 // Needs to come after method_bind and object have been included.
@@ -102,7 +105,7 @@ public:
 
 		ObjectNativeExtension *native_extension = nullptr;
 
-		HashMap<StringName, MethodBind *> method_map;
+		FlatHashMap<StringName, MethodBind *> method_map;
 		HashMap<StringName, int64_t> constant_map;
 		struct EnumInfo {
 			List<StringName> constants;
@@ -121,7 +124,7 @@ public:
 		HashMap<StringName, MethodInfo> virtual_methods_map;
 		HashMap<StringName, Vector<Error>> method_error_values;
 #endif
-		HashMap<StringName, PropertySetGet> property_setget;
+		FlatHashMap<StringName, PropertySetGet> property_setget;
 
 		StringName inherits;
 		StringName name;
@@ -165,10 +168,73 @@ public:
 	static HashMap<StringName, NativeStruct> native_structs;
 
 private:
+	// Flattened per-class tables (inherited entries included), so that
+	// get_method() and the property accessors resolve a name with a single
+	// hash probe instead of walking the inheritance chain under the lock.
+	// The set of tables is created by enable_lookup_tables() once registration
+	// is finished, each table is filled on first use, and they are read without
+	// locking afterwards. Modifying a class that has a table publishes a new
+	// set where the tables of that class and the classes inheriting it start
+	// over empty. Replaced sets and tables are freed once no lookup is in
+	// progress, as other threads may still be reading them until then.
+	struct LookupTable {
+		struct Member {
+			// What get_property() resolves the name to. At each level of the
+			// hierarchy properties come first, then constants, methods and signals.
+			enum Type {
+				TYPE_PROPERTY,
+				TYPE_CONSTANT,
+				TYPE_METHOD,
+				TYPE_SIGNAL,
+			};
+
+			Type type = TYPE_PROPERTY;
+			int64_t constant = 0;
+			// Nearest property with this name, used by set_property(). For
+			// TYPE_PROPERTY it is also the one used by get_property().
+			bool has_setget = false;
+			PropertySetGet setget;
+		};
+
+		ClassInfo *class_info = nullptr;
+		SafeFlag built;
+		FlatHashMap<StringName, MethodBind *> methods;
+		FlatHashMap<StringName, Member> members;
+	};
+
+	typedef FlatHashMap<StringName, LookupTable *> LookupTables;
+
+	static std::atomic<LookupTables *> lookup_tables;
+	// Lookups in progress, replaced sets and tables are freed once there are none.
+	static std::atomic<uint32_t> lookup_table_readers;
+	static std::atomic<bool> has_retired_lookup_tables;
+	static LocalVector<LookupTables *> retired_lookup_tables;
+	static LocalVector<LookupTable *> retired_lookup_table_entries;
+	static Mutex lookup_tables_mutex;
+
+	// Held while a table returned by _get_lookup_table() is used.
+	struct LookupTableReader {
+		_FORCE_INLINE_ LookupTableReader() {
+			lookup_table_readers.fetch_add(1);
+		}
+		_FORCE_INLINE_ ~LookupTableReader() {
+			if (lookup_table_readers.fetch_sub(1) == 1 && unlikely(has_retired_lookup_tables.load())) {
+				_free_retired_lookup_tables();
+			}
+		}
+	};
+
 	// Non-locking variants of get_parent_class and is_parent_class.
 	static StringName _get_parent_class(const StringName &p_class);
 	static bool _is_parent_class(const StringName &p_class, const StringName &p_inherits);
 
+	static LookupTable *_get_lookup_table(const StringName &p_class);
+	static void _build_lookup_table(LookupTable *p_table);
+	static void _invalidate_lookup_tables(const StringName &p_class);
+	static void _free_lookup_tables(LookupTables *p_tables);
+	static void _retire_lookup_tables();
+	static void _free_retired_lookup_tables();
+
 public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
 	template <class T>
@@ -286,6 +352,7 @@ public:
 			// Overloading not supported
 			ERR_FAIL_V_MSG(nullptr, "Method already bound: " + instance_type + "::" + p_name + ".");
 		}
+		_invalidate_lookup_tables(instance_type);
 		type->method_map[p_name] = bind;
 #ifdef DEBUG_METHODS_ENABLED
 		// FIXME: <reduz> set_return_type is no longer in MethodBind, so I guess it should be moved to vararg method bind
@@ -360,6 +427,10 @@ public:
 
 	static void set_current_api(APIType p_api);
 	static APIType get_current_api();
+	static void enable_lookup_tables();
+	static void disable_lookup_tables();
+	static bool are_lookup_tables_enabled();
+
 	static void cleanup_defaults();
 	static void cleanup();
 
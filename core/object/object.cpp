@@ -946,6 +946,8 @@ Error Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::Cal
 	return emit_signalp(signal, args, argc);
 }
 
+SafeNumeric<uint64_t> Object::last_emission_id;
+
 Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int p_argcount) {
 	if (_block_signals) {
 		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
@@ -975,6 +977,8 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 
 	Vector<const Variant *> bind_mem;
 
+	uint64_t emission_id = last_emission_id.increment();
+
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
@@ -1008,10 +1012,13 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 			MessageQueue::get_singleton()->push_callablep(c.callable, args, argc, true);
 		} else {
 			Callable::CallError ce;
+			uint64_t outer_emission_id = _emission_id;
 			_emitting = true;
+			_emission_id = emission_id;
 			Variant ret;
 			c.callable.call(args, argc, ret, ce);
 			_emitting = false;
+			_emission_id = outer_emission_id;
 
 			if (ce.error != Callable::CallError::CALL_OK) {
 #ifdef DEBUG_ENABLED
@@ -1553,6 +1560,10 @@ bool Object::is_blocking_signals() const {
 	return _block_signals;
 }
 
+uint64_t Object::get_signal_emission_id() const {
+	return _emission_id;
+}
+
 void Object::get_translatable_strings(List<String> *p_strings) const {
 	List<PropertyInfo> plist;
 	get_property_list(&plist);
@@ -551,6 +551,8 @@ private:
 	void _postinitialize();
 	bool _can_translate = true;
 	bool _emitting = false;
+	uint64_t _emission_id = 0;
+	static SafeNumeric<uint64_t> last_emission_id;
 #ifdef TOOLS_ENABLED
 	bool _edited = false;
 	uint32_t _edited_version = 0;
@@ -839,6 +841,8 @@ public:
 
 	void set_block_signals(bool p_block);
 	bool is_blocking_signals() const;
+	// Id of the emission whose connections are being called, zero if none. Later emissions have greater ids.
+	uint64_t get_signal_emission_id() const;
 
 	Variant::Type get_static_property_type(const StringName &p_property, bool *r_valid = nullptr) const;
 	Variant::Type get_static_property_type_indexed(const Vector<StringName> &p_path, bool *r_valid = nullptr) const;
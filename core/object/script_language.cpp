@@ -34,6 +34,7 @@
 #include "core/core_string_names.h"
 #include "core/debugger/engine_debugger.h"
 #include "core/debugger/script_debugger.h"
+#include "core/io/file_access.h"
 
 #include <stdint.h>
 
@@ -205,6 +206,40 @@ void ScriptServer::thread_exit() {
 	}
 }
 
+void ScriptServer::prewarm_languages(const Vector<String> &p_paths) {
+	for (int i = 0; i < _language_count; i++) {
+		_languages[i]->prewarm_scripts(p_paths);
+	}
+}
+
+void ScriptServer::sampling_profiler_start(uint32_t p_interval_usec) {
+	for (int i = 0; i < _language_count; i++) {
+		_languages[i]->sampling_profiler_start(p_interval_usec);
+	}
+}
+
+void ScriptServer::sampling_profiler_stop() {
+	for (int i = 0; i < _language_count; i++) {
+		_languages[i]->sampling_profiler_stop();
+	}
+}
+
+Error ScriptServer::sampling_profiler_dump(const String &p_path) {
+	HashMap<String, uint64_t> samples;
+	for (int i = 0; i < _language_count; i++) {
+		_languages[i]->sampling_profiler_get_samples(samples);
+	}
+
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(f.is_null(), ERR_CANT_CREATE, "Can't write script samples to: " + p_path + ".");
+
+	// One "stack count" line per call stack, the folded format flame graph tools read.
+	for (const KeyValue<String, uint64_t> &E : samples) {
+		f->store_line(E.key + " " + itos(E.value));
+	}
+	return OK;
+}
+
 HashMap<StringName, ScriptServer::GlobalScriptClass> ScriptServer::global_classes;
 
 void ScriptServer::global_classes_clear() {
@@ -75,6 +75,11 @@ public:
 
 	static void thread_enter();
 	static void thread_exit();
+	static void prewarm_languages(const Vector<String> &p_paths);
+
+	static void sampling_profiler_start(uint32_t p_interval_usec);
+	static void sampling_profiler_stop();
+	static Error sampling_profiler_dump(const String &p_path);
 
 	static void global_classes_clear();
 	static void add_global_class(const StringName &p_class, const StringName &p_base, const StringName &p_language, const String &p_path);
@@ -418,12 +423,19 @@ public:
 	virtual int profiling_get_accumulated_data(ProfilingInfo *p_info_arr, int p_info_max) = 0;
 	virtual int profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_info_max) = 0;
 
+	// Optional, statistical profiling that is also available in release builds.
+	// Samples are counted per folded call stack ("outer;inner"), outermost function first.
+	virtual void sampling_profiler_start(uint32_t p_interval_usec) {}
+	virtual void sampling_profiler_stop() {}
+	virtual void sampling_profiler_get_samples(HashMap<String, uint64_t> &r_samples) {}
+
 	virtual void *alloc_instance_binding_data(Object *p_object) { return nullptr; } //optional, not used by all languages
 	virtual void free_instance_binding_data(void *p_data) {} //optional, not used by all languages
 	virtual void refcount_incremented_instance_binding(Object *p_object) {} //optional, not used by all languages
 	virtual bool refcount_decremented_instance_binding(Object *p_object) { return true; } //return true if it can die //optional, not used by all languages
 
 	virtual void frame();
+	virtual void prewarm_scripts(const Vector<String> &p_paths) {} // Optional, compiles the scripts used by these resources ahead of loading them.
 
 	virtual bool handles_global_class_type(const String &p_type) const { return false; }
 	virtual String get_global_class_name(const String &p_path, String *r_base_type = nullptr, String *r_icon_path = nullptr) const { return String(); }
@@ -0,0 +1,202 @@
+/*************************************************************************/
+/*  allocation_tracker.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "allocation_tracker.h"
+
+#ifdef ALLOCATION_TRACKING_ENABLED
+
+#include "core/io/file_access.h"
+#include "core/templates/sort_array.h"
+
+thread_local AllocationTracker::ThreadBuffer AllocationTracker::thread_buffer;
+
+AllocationTracker::State &AllocationTracker::_get_state() {
+	// Placement new into static storage, so no destructor runs at exit.
+	alignas(State) static uint8_t storage[sizeof(State)];
+	static State *state = new (storage) State;
+	return *state;
+}
+
+void AllocationTracker::record(const char *p_site, size_t p_bytes) {
+	ThreadBuffer &tb = thread_buffer;
+	if (tb.busy) {
+		return;
+	}
+
+	Event &e = tb.events[tb.count++];
+	e.site = p_site ? p_site : "(untagged)";
+	e.bytes = p_bytes;
+
+	if (tb.count == THREAD_BUFFER_SIZE) {
+		_flush(tb);
+	}
+}
+
+void AllocationTracker::_flush(ThreadBuffer &p_buffer) {
+	p_buffer.busy = true;
+	{
+		State &state = _get_state();
+		MutexLock lock(state.mutex);
+		for (uint32_t i = 0; i < p_buffer.count; i++) {
+			const Event &e = p_buffer.events[i];
+			Counter *c = state.frame_counters.getptr(e.site);
+			if (!c) {
+				c = &state.frame_counters.insert(e.site, Counter())->value;
+			}
+			c->count++;
+			c->bytes += e.bytes;
+		}
+	}
+	p_buffer.count = 0;
+	p_buffer.busy = false;
+}
+
+void AllocationTracker::thread_flush() {
+	ThreadBuffer &tb = thread_buffer;
+	if (!tb.busy && tb.count > 0) {
+		_flush(tb);
+	}
+}
+
+Vector<AllocationTracker::SiteStats> AllocationTracker::_collect(const HashMap<const char *, Counter> &p_counters) {
+	// The same file and line can end up as distinct literals in different translation units.
+	HashMap<String, SiteStats> merged;
+	for (const KeyValue<const char *, Counter> &E : p_counters) {
+		String site = E.key;
+		SiteStats *s = merged.getptr(site);
+		if (!s) {
+			s = &merged.insert(site, SiteStats())->value;
+			s->site = site;
+		}
+		s->count += E.value.count;
+		s->bytes += E.value.bytes;
+	}
+
+	struct SortByBytes {
+		_FORCE_INLINE_ bool operator()(const SiteStats &p_a, const SiteStats &p_b) const {
+			return p_a.bytes > p_b.bytes;
+		}
+	};
+
+	Vector<SiteStats> ret;
+	ret.resize(merged.size());
+	int idx = 0;
+	for (const KeyValue<String, SiteStats> &E : merged) {
+		ret.write[idx++] = E.value;
+	}
+	ret.sort_custom<SortByBytes>();
+	return ret;
+}
+
+void AllocationTracker::frame_end() {
+	ThreadBuffer &tb = thread_buffer;
+	if (tb.busy) {
+		return;
+	}
+	_flush(tb);
+
+	tb.busy = true;
+	{
+		State &state = _get_state();
+		MutexLock lock(state.mutex);
+		for (const KeyValue<const char *, Counter> &E : state.frame_counters) {
+			Counter *c = state.total_counters.getptr(E.key);
+			if (!c) {
+				c = &state.total_counters.insert(E.key, Counter())->value;
+			}
+			c->count += E.value.count;
+			c->bytes += E.value.bytes;
+		}
+		state.last_frame = _collect(state.frame_counters);
+		state.frame_counters.clear();
+		state.frames++;
+	}
+	tb.busy = false;
+}
+
+Vector<AllocationTracker::SiteStats> AllocationTracker::get_frame_summary() {
+	State &state = _get_state();
+	MutexLock lock(state.mutex);
+	return state.last_frame;
+}
+
+Vector<AllocationTracker::SiteStats> AllocationTracker::get_total_summary() {
+	ThreadBuffer &tb = thread_buffer;
+	bool was_busy = tb.busy;
+	tb.busy = true;
+	Vector<SiteStats> ret;
+	{
+		State &state = _get_state();
+		MutexLock lock(state.mutex);
+		ret = _collect(state.total_counters);
+	}
+	tb.busy = was_busy;
+	return ret;
+}
+
+uint64_t AllocationTracker::get_frame_count() {
+	State &state = _get_state();
+	MutexLock lock(state.mutex);
+	return state.frames;
+}
+
+Error AllocationTracker::dump(const String &p_path) {
+	Vector<SiteStats> stats = get_total_summary();
+	uint64_t frame_count = get_frame_count();
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Can't write allocation report to: " + p_path);
+
+	f->store_line("site,count,bytes,count_per_frame,bytes_per_frame");
+	for (const SiteStats &s : stats) {
+		uint64_t div = MAX(frame_count, (uint64_t)1);
+		f->store_line(vformat("\"%s\",%d,%d,%.2f,%.2f", s.site, s.count, s.bytes, double(s.count) / div, double(s.bytes) / div));
+	}
+
+	return OK;
+}
+
+void AllocationTracker::clear() {
+	ThreadBuffer &tb = thread_buffer;
+	tb.busy = true;
+	{
+		State &state = _get_state();
+		MutexLock lock(state.mutex);
+		state.frame_counters.clear();
+		state.total_counters.clear();
+		state.last_frame.clear();
+		state.frames = 0;
+	}
+	tb.count = 0;
+	tb.busy = false;
+}
+
+#endif // ALLOCATION_TRACKING_ENABLED
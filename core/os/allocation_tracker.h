@@ -0,0 +1,110 @@
+/*************************************************************************/
+/*  allocation_tracker.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#ifdef ALLOCATION_TRACKING_ENABLED
+
+#include "core/os/mutex.h"
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/vector.h"
+
+// Counts allocations and bytes per call site. Only built with `alloc_tracking=yes`.
+// Allocations made through memnew()/memalloc()/memrealloc() are attributed to their
+// file and line, containers to their tag (see ALLOCATION_SITE()), and the rest to "(untagged)".
+// Events go to a per-thread buffer first, so recording is lock-free until the buffer fills up.
+class AllocationTracker {
+public:
+	struct SiteStats {
+		String site;
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+private:
+	enum {
+		THREAD_BUFFER_SIZE = 1024,
+	};
+
+	struct Event {
+		const char *site = nullptr;
+		uint64_t bytes = 0;
+	};
+
+	struct ThreadBuffer {
+		Event events[THREAD_BUFFER_SIZE];
+		uint32_t count = 0;
+		bool busy = false; // Set while the tracker itself allocates, to avoid recursion.
+	};
+
+	struct Counter {
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	// Allocations happen during static initialization and teardown, so the shared state
+	// is constructed on first use and never destroyed.
+	struct State {
+		BinaryMutex mutex;
+		HashMap<const char *, Counter> frame_counters;
+		HashMap<const char *, Counter> total_counters;
+		Vector<SiteStats> last_frame;
+		uint64_t frames = 0;
+	};
+
+	static thread_local ThreadBuffer thread_buffer;
+
+	static State &_get_state();
+	static void _flush(ThreadBuffer &p_buffer);
+	static Vector<SiteStats> _collect(const HashMap<const char *, Counter> &p_counters);
+
+public:
+	static void record(const char *p_site, size_t p_bytes);
+
+	// Called once per main loop iteration. Allocations still buffered in other threads
+	// are attributed to the frame in which those threads flush them.
+	static void frame_end();
+	// Called by Thread when a thread exits, so what it buffered isn't lost.
+	static void thread_flush();
+
+	// Sorted by bytes, largest first.
+	static Vector<SiteStats> get_frame_summary();
+	static Vector<SiteStats> get_total_summary();
+	static uint64_t get_frame_count();
+
+	static Error dump(const String &p_path);
+	static void clear();
+};
+
+#endif // ALLOCATION_TRACKING_ENABLED
+
+#endif // ALLOCATION_TRACKER_H
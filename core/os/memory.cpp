@@ -31,12 +31,17 @@
 #include "memory.h"
 
 #include "core/error/error_macros.h"
+#include "core/os/allocation_tracker.h"
 #include "core/templates/safe_refcount.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
+#ifdef ALLOCATION_TRACKING_ENABLED
+	Memory::set_alloc_site(p_description);
+#endif
 	return Memory::alloc_static(p_size, false);
 }
 
@@ -65,7 +70,20 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+thread_local const char *Memory::alloc_site = nullptr;
+
+void Memory::set_alloc_site(const char *p_site) {
+	alloc_site = p_site;
+}
+#endif
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+#ifdef ALLOCATION_TRACKING_ENABLED
+	AllocationTracker::record(alloc_site, p_bytes);
+	alloc_site = nullptr;
+#endif
+
 #ifdef DEBUG_ENABLED
 	bool prepad = true;
 #else
@@ -99,6 +117,11 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		return alloc_static(p_bytes, p_pad_align);
 	}
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+	AllocationTracker::record(alloc_site, p_bytes);
+	alloc_site = nullptr;
+#endif
+
 	uint8_t *mem = (uint8_t *)p_memory;
 
 #ifdef DEBUG_ENABLED
@@ -191,6 +214,167 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+thread_local ScratchArena::ThreadState ScratchArena::thread_state;
+
+SafeNumeric<uint64_t> ScratchArena::chunk_alloc_count;
+
+#define SCRATCH_CHUNK_HEADER_SIZE ((sizeof(Chunk) + PAD_ALIGN - 1) & ~(size_t)(PAD_ALIGN - 1))
+#define SCRATCH_ALIGN_SIZE(m_bytes) (((m_bytes) + PAD_ALIGN - 1) & ~(size_t)(PAD_ALIGN - 1))
+
+ScratchArena::Scope::Scope() {
+	ThreadState &ts = thread_state;
+	chunk = ts.current;
+	used = chunk ? chunk->used : 0;
+	prev = ts.scope;
+	ts.scope = this;
+}
+
+ScratchArena::Scope::~Scope() {
+	ThreadState &ts = thread_state;
+	ts.current = chunk;
+	if (chunk) {
+		chunk->used = used;
+	}
+	ts.scope = prev;
+}
+
+void *ScratchArena::alloc(size_t p_bytes) {
+	ThreadState &ts = thread_state;
+	ERR_FAIL_COND_V_MSG(!ts.scope, nullptr, "Scratch memory can only be allocated inside a ScratchArena::Scope.");
+
+	// Every allocation is prefixed with its size, so realloc() knows how much to copy.
+	size_t needed = PAD_ALIGN + SCRATCH_ALIGN_SIZE(p_bytes);
+
+	Chunk *chunk = ts.current;
+	if (!chunk || chunk->used + needed > chunk->size) {
+		// Chunks past the current one hold no live allocations and can be reused.
+		Chunk *next = chunk ? chunk->next : ts.first;
+		if (!next || next->size < needed) {
+			size_t size = MAX((size_t)CHUNK_SIZE, needed);
+			Chunk *new_chunk = (Chunk *)Memory::alloc_static(SCRATCH_CHUNK_HEADER_SIZE + size, false);
+			ERR_FAIL_COND_V(!new_chunk, nullptr);
+			memnew_placement(new_chunk, Chunk);
+			new_chunk->size = size;
+			new_chunk->next = next;
+			if (chunk) {
+				chunk->next = new_chunk;
+			} else {
+				ts.first = new_chunk;
+			}
+			next = new_chunk;
+			chunk_alloc_count.increment();
+		}
+		chunk = next;
+		chunk->used = 0;
+		ts.current = chunk;
+	}
+
+	uint8_t *mem = (uint8_t *)chunk + SCRATCH_CHUNK_HEADER_SIZE + chunk->used;
+	*(uint64_t *)mem = p_bytes;
+	chunk->used += needed;
+
+	ts.alloc_count++;
+
+	return mem + PAD_ALIGN;
+}
+
+bool ScratchArena::_is_in_scope(const ThreadState &p_ts, const uint8_t *p_mem) {
+	// The innermost scope owns everything from where it started up to the end of the current chunk.
+	const Scope *scope = p_ts.scope;
+	Chunk *chunk = scope->chunk ? scope->chunk : p_ts.first;
+	size_t start = scope->chunk ? scope->used : 0;
+	while (chunk) {
+		const uint8_t *chunk_data = (const uint8_t *)chunk + SCRATCH_CHUNK_HEADER_SIZE;
+		if (p_mem >= chunk_data + start && p_mem < chunk_data + chunk->used) {
+			return true;
+		}
+		if (chunk == p_ts.current) {
+			break;
+		}
+		chunk = chunk->next;
+		start = 0;
+	}
+	return false;
+}
+
+void *ScratchArena::_realloc(ThreadState &p_ts, void *p_memory, size_t p_bytes) {
+	uint8_t *mem = (uint8_t *)p_memory - PAD_ALIGN;
+	uint64_t *s = (uint64_t *)mem;
+
+	// The most recent allocation can grow or shrink in place.
+	Chunk *chunk = p_ts.current;
+	if (chunk) {
+		uint8_t *chunk_data = (uint8_t *)chunk + SCRATCH_CHUNK_HEADER_SIZE;
+		size_t offset = mem - chunk_data;
+		if (mem >= chunk_data && offset + PAD_ALIGN + SCRATCH_ALIGN_SIZE(*s) == chunk->used) {
+			size_t needed = PAD_ALIGN + SCRATCH_ALIGN_SIZE(p_bytes);
+			if (offset + needed <= chunk->size) {
+				chunk->used = offset + needed;
+				*s = p_bytes;
+				return p_memory;
+			}
+		}
+	}
+
+	void *new_mem = alloc(p_bytes);
+	ERR_FAIL_COND_V(!new_mem, nullptr);
+	memcpy(new_mem, p_memory, MIN(*s, (uint64_t)p_bytes));
+
+	return new_mem;
+}
+
+void *ScratchArena::realloc(void *p_memory, size_t p_bytes) {
+	if (p_memory == nullptr) {
+		return alloc(p_bytes);
+	}
+
+	ThreadState &ts = thread_state;
+	ERR_FAIL_COND_V_MSG(!ts.scope, nullptr, "Scratch memory can only be allocated inside a ScratchArena::Scope.");
+
+	if (_is_in_scope(ts, (uint8_t *)p_memory - PAD_ALIGN)) {
+		return _realloc(ts, p_memory, p_bytes);
+	}
+
+	// The allocation belongs to an outer scope, whatever it's grown into must outlive the innermost
+	// one. That is only possible while the innermost scopes are empty: they are moved to start
+	// after the grown allocation.
+	Chunk *start_chunk = ts.current;
+	size_t start_used = start_chunk ? start_chunk->used : 0;
+	ERR_FAIL_COND_V_MSG(ts.scope->chunk != start_chunk || ts.scope->used != start_used, nullptr,
+			"Can't grow an allocation of an outer ScratchArena::Scope after allocating in a nested one.");
+
+	void *new_mem = _realloc(ts, p_memory, p_bytes);
+	ERR_FAIL_COND_V(!new_mem, nullptr);
+	for (Scope *scope = ts.scope; scope && scope->chunk == start_chunk && scope->used == start_used; scope = scope->prev) {
+		scope->chunk = ts.current;
+		scope->used = ts.current->used;
+	}
+
+	return new_mem;
+}
+
+void ScratchArena::thread_release() {
+	ThreadState &ts = thread_state;
+	ERR_FAIL_COND_MSG(ts.scope, "Can't release scratch memory while a ScratchArena::Scope is active.");
+
+	Chunk *chunk = ts.first;
+	while (chunk) {
+		Chunk *next = chunk->next;
+		Memory::free_static(chunk, false);
+		chunk = next;
+	}
+	ts.first = nullptr;
+	ts.current = nullptr;
+}
+
+uint64_t ScratchArena::get_alloc_count() {
+	return thread_state.alloc_count;
+}
+
+uint64_t ScratchArena::get_chunk_alloc_count() {
+	return chunk_alloc_count.get();
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -49,7 +49,16 @@ class Memory {
 
 	static SafeNumeric<uint64_t> alloc_count;
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+	static thread_local const char *alloc_site;
+#endif
+
 public:
+#ifdef ALLOCATION_TRACKING_ENABLED
+	// Attributes the next allocation made by this thread to p_site.
+	static void set_alloc_site(const char *p_site);
+#endif
+
 	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
 	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false);
 	static void free_static(void *p_ptr, bool p_pad_align = false);
@@ -62,9 +71,73 @@ public:
 class DefaultAllocator {
 public:
 	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
+	_FORCE_INLINE_ static void *realloc(void *p_memory, size_t p_bytes) { return Memory::realloc_static(p_memory, p_bytes, false); }
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
+// Per-thread bump allocator for short-lived scratch memory (culling results,
+// query buffers and similar per-call temporaries).
+// Allocations are only valid inside a ScratchArena::Scope, and everything
+// allocated within a scope is released at once when it ends; free() is a no-op.
+// An allocation of an outer scope can only be grown in a nested scope that has
+// not allocated anything yet, the nested scope then starts after it.
+// Chunks are kept around for reuse, so steady state use does not touch the heap.
+class ScratchArena {
+	struct Chunk {
+		Chunk *next = nullptr;
+		size_t size = 0;
+		size_t used = 0;
+	};
+
+public:
+	enum {
+		CHUNK_SIZE = 64 * 1024
+	};
+
+	class Scope {
+		friend class ScratchArena;
+
+		// Where the scope started, allocations before it belong to outer scopes.
+		Chunk *chunk = nullptr;
+		size_t used = 0;
+		Scope *prev = nullptr;
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	public:
+		Scope();
+		~Scope();
+	};
+
+private:
+	struct ThreadState {
+		Chunk *first = nullptr;
+		Chunk *current = nullptr;
+		Scope *scope = nullptr; // Innermost scope.
+		uint64_t alloc_count = 0;
+	};
+
+	static thread_local ThreadState thread_state;
+
+	static SafeNumeric<uint64_t> chunk_alloc_count;
+
+	static bool _is_in_scope(const ThreadState &p_ts, const uint8_t *p_mem);
+	static void *_realloc(ThreadState &p_ts, void *p_memory, size_t p_bytes);
+
+public:
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	_FORCE_INLINE_ static void free(void *p_ptr) {}
+
+	// Frees the chunks owned by the calling thread, must be called outside any scope.
+	static void thread_release();
+
+	// Allocations made by the calling thread.
+	static uint64_t get_alloc_count();
+	static uint64_t get_chunk_alloc_count();
+};
+
 void *operator new(size_t p_size, const char *p_description); ///< operator new that takes a description and uses MemoryStaticPool
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)); ///< operator new that takes a description and uses MemoryStaticPool
 
@@ -78,8 +151,16 @@ void operator delete(void *p_mem, void *(*p_allocfunc)(size_t p_size));
 void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_description);
 #endif
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+#define _ALLOCATION_SITE_HERE __FILE__ ":" _MKSTR(__LINE__)
+#define ALLOCATION_SITE(m_site) Memory::set_alloc_site(m_site)
+#define memalloc(m_size) (Memory::set_alloc_site(_ALLOCATION_SITE_HERE), Memory::alloc_static(m_size))
+#define memrealloc(m_mem, m_size) (Memory::set_alloc_site(_ALLOCATION_SITE_HERE), Memory::realloc_static(m_mem, m_size))
+#else
+#define ALLOCATION_SITE(m_site) ((void)0)
 #define memalloc(m_size) Memory::alloc_static(m_size)
 #define memrealloc(m_mem, m_size) Memory::realloc_static(m_mem, m_size)
+#endif
 #define memfree(m_mem) Memory::free_static(m_mem)
 
 _ALWAYS_INLINE_ void postinitialize_handler(void *) {}
@@ -90,7 +171,11 @@ _ALWAYS_INLINE_ T *_post_initialize(T *p_obj) {
 	return p_obj;
 }
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+#define memnew(m_class) _post_initialize(new (_ALLOCATION_SITE_HERE) m_class)
+#else
 #define memnew(m_class) _post_initialize(new ("") m_class)
+#endif
 
 #define memnew_allocator(m_class, m_allocator) _post_initialize(new (m_allocator::alloc) m_class)
 #define memnew_placement(m_placement, m_class) _post_initialize(new (m_placement) m_class)
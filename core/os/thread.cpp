@@ -34,6 +34,7 @@
 #include "thread.h"
 
 #include "core/object/script_language.h"
+#include "core/os/allocation_tracker.h"
 
 #if !defined(NO_THREADS)
 
@@ -74,6 +75,10 @@ void Thread::callback(Thread *p_self, const Settings &p_settings, Callback p_cal
 	ScriptServer::thread_enter(); //scripts may need to attach a stack
 	p_callback(p_userdata);
 	ScriptServer::thread_exit();
+	ScratchArena::thread_release();
+#ifdef ALLOCATION_TRACKING_ENABLED
+	AllocationTracker::thread_flush();
+#endif
 	if (term_func) {
 		term_func();
 	}
@@ -45,6 +45,7 @@
 #include "core/input/shortcut.h"
 #include "core/io/config_file.h"
 #include "core/io/dtls_server.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/http_client.h"
 #include "core/io/image_loader.h"
 #include "core/io/json.h"
@@ -57,6 +58,7 @@
 #include "core/io/pck_packer.h"
 #include "core/io/resource_format_binary.h"
 #include "core/io/resource_importer.h"
+#include "core/io/resource_streamer.h"
 #include "core/io/resource_uid.h"
 #include "core/io/stream_peer_ssl.h"
 #include "core/io/tcp_server.h"
@@ -109,6 +111,7 @@ extern void register_global_constants();
 extern void unregister_global_constants();
 
 static ResourceUID *resource_uid = nullptr;
+static ResourceStreamer *resource_streamer = nullptr;
 
 static bool _is_core_extensions_registered = false;
 
@@ -246,10 +249,12 @@ void register_core_types() {
 	GDREGISTER_ABSTRACT_CLASS(NativeExtensionManager);
 
 	GDREGISTER_ABSTRACT_CLASS(ResourceUID);
+	GDREGISTER_ABSTRACT_CLASS(ResourceStreamer);
 
 	GDREGISTER_CLASS(EngineProfiler);
 
 	resource_uid = memnew(ResourceUID);
+	resource_streamer = memnew(ResourceStreamer);
 
 	native_extension_manager = memnew(NativeExtensionManager);
 
@@ -319,6 +324,7 @@ void register_core_singletons() {
 	Engine::get_singleton()->add_singleton(Engine::Singleton("Time", Time::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("NativeExtensionManager", NativeExtensionManager::get_singleton()));
 	Engine::get_singleton()->add_singleton(Engine::Singleton("ResourceUID", ResourceUID::get_singleton()));
+	Engine::get_singleton()->add_singleton(Engine::Singleton("ResourceStreamer", ResourceStreamer::get_singleton()));
 }
 
 void register_core_extensions() {
@@ -338,6 +344,8 @@ void unregister_core_extensions() {
 void unregister_core_types() {
 	memdelete(native_extension_manager);
 
+	memdelete(resource_streamer);
+	FileAccessCompressed::finish_read_ahead();
 	memdelete(resource_uid);
 	memdelete(_resource_loader);
 	memdelete(_resource_saver);
@@ -390,4 +398,6 @@ void unregister_core_types() {
 	ResourceCache::clear();
 	CoreStringNames::free();
 	StringName::cleanup();
+
+	ScratchArena::thread_release();
 }
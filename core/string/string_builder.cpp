@@ -61,7 +61,10 @@ String StringBuilder::as_string() const {
 		return "";
 	}
 
-	char32_t *buffer = memnew_arr(char32_t, string_length);
+	// Write straight into the result instead of going through a temporary buffer.
+	String final_string;
+	final_string.resize(string_length + 1);
+	char32_t *buffer = final_string.ptrw();
 
 	int current_position = 0;
 
@@ -91,9 +94,7 @@ String StringBuilder::as_string() const {
 		}
 	}
 
-	String final_string = String(buffer, string_length);
-
-	memdelete_arr(buffer);
+	buffer[string_length] = 0;
 
 	return final_string;
 }
@@ -0,0 +1,623 @@
+/*************************************************************************/
+/*  flat_hash_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/math/math_funcs.h"
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_GROUP_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * Control byte group used by FlatHashMap and FlatHashSet.
+ *
+ * Every slot of a flat table owns one control byte: 0x80 when empty, 0xFE when
+ * deleted, or the low 7 bits of the key hash when full. Probing loads a whole
+ * group of control bytes at once and matches the 7 hash bits against all of
+ * them in parallel, with SSE2 when available and 64-bit SWAR arithmetic
+ * otherwise. Match results are bitmasks; use get_index() to turn the lowest set
+ * bit into a slot offset within the group.
+ */
+
+struct FlatHashGroup {
+	static constexpr uint8_t CTRL_EMPTY = 0x80;
+	static constexpr uint8_t CTRL_DELETED = 0xFE;
+
+#ifdef FLAT_HASH_GROUP_SSE2
+	static constexpr uint32_t WIDTH = 16;
+	static constexpr uint32_t INDEX_SHIFT = 0;
+
+	__m128i ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashGroup(const uint8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_ctrl));
+	}
+
+	_FORCE_INLINE_ uint64_t match(uint8_t p_h2) const {
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)p_h2), ctrl));
+	}
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)CTRL_EMPTY), ctrl));
+	}
+	// Empty and deleted slots are the only ones with the high bit set.
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		return (uint32_t)_mm_movemask_epi8(ctrl);
+	}
+#else
+	static constexpr uint32_t WIDTH = 8;
+	static constexpr uint32_t INDEX_SHIFT = 3;
+	static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+	static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+
+	uint64_t ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashGroup(const uint8_t *p_ctrl) {
+		memcpy(&ctrl, p_ctrl, sizeof(ctrl));
+#ifdef BIG_ENDIAN_ENABLED
+		ctrl = BSWAP64(ctrl);
+#endif
+	}
+
+	// May report false positives for full slots next to a real match, callers
+	// always compare the key afterwards. Empty and deleted slots never match.
+	_FORCE_INLINE_ uint64_t match(uint8_t p_h2) const {
+		const uint64_t x = ctrl ^ (LSBS * p_h2);
+		return (x - LSBS) & ~x & MSBS;
+	}
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		return (ctrl & (~ctrl << 6)) & MSBS;
+	}
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		return ctrl & MSBS;
+	}
+#endif
+
+	static _FORCE_INLINE_ uint32_t get_index(uint64_t p_mask) {
+#if defined(__GNUC__) || defined(__clang__)
+		return (uint32_t)__builtin_ctzll(p_mask) >> INDEX_SHIFT;
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)p_mask)) {
+			return (uint32_t)index >> INDEX_SHIFT;
+		}
+		_BitScanForward(&index, (unsigned long)(p_mask >> 32));
+		return (uint32_t)(index + 32) >> INDEX_SHIFT;
+#else
+		uint32_t index = 0;
+		while (!(p_mask & 1)) {
+			p_mask >>= 1;
+			index++;
+		}
+		return index >> INDEX_SHIFT;
+#endif
+	}
+
+	// Splits a key hash into the probe start (h1) and the control byte (h2).
+	// The hash is remixed first, as some hashers (e.g. djb2 for strings) leave
+	// poorly distributed low bits.
+	static _FORCE_INLINE_ uint32_t mix_hash(uint32_t p_hash) {
+		return hash_fmix32(p_hash);
+	}
+	static _FORCE_INLINE_ uint32_t get_h1(uint32_t p_hash) { return p_hash >> 7; }
+	static _FORCE_INLINE_ uint8_t get_h2(uint32_t p_hash) { return p_hash & 0x7F; }
+
+	// Tables are filled up to 7/8 of their capacity, so there is always an
+	// empty slot to terminate probing.
+	static _FORCE_INLINE_ uint32_t get_max_load(uint32_t p_capacity) { return p_capacity - p_capacity / 8; }
+
+	static _FORCE_INLINE_ uint32_t get_capacity_for(uint32_t p_elements) {
+		uint32_t capacity = WIDTH;
+		while (get_max_load(capacity) < p_elements) {
+			capacity <<= 1;
+		}
+		return capacity;
+	}
+};
+
+/**
+ * An unordered HashMap that stores its key/value pairs inline, in the probing
+ * array itself (SwissTable-style open addressing). A lookup only touches the
+ * control bytes of one or two groups and the matching slot, instead of a hash
+ * array plus a separately allocated node as HashMap does.
+ *
+ * The API mirrors HashMap, with two differences:
+ *
+ * - Iteration order is unspecified (it depends on the hashes), so only use
+ *   this for maps where insertion order does not matter.
+ * - Inserting may move the stored pairs, which invalidates iterators and
+ *   pointers returned by getptr() or operator[]. Erasing never moves pairs.
+ *
+ * The assignment operator copy the pairs from one map to the other.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+	typedef FlatHashGroup Group;
+	typedef KeyValue<TKey, TValue> Slot;
+
+	static constexpr uint32_t INVALID_POS = 0xFFFFFFFF;
+
+	uint8_t *ctrl = nullptr;
+	KeyValue<TKey, TValue> *slots = nullptr;
+
+	uint32_t capacity = 0; // Power of two, or zero while nothing is allocated.
+	uint32_t reserved_capacity = 0;
+	uint32_t num_elements = 0;
+	uint32_t num_deleted = 0;
+
+	// The first WIDTH control bytes are mirrored past the end of the array, so
+	// a group can be loaded starting from any slot.
+	_FORCE_INLINE_ void _set_ctrl(uint32_t p_pos, uint8_t p_ctrl) {
+		ctrl[p_pos] = p_ctrl;
+		if (p_pos < Group::WIDTH) {
+			ctrl[capacity + p_pos] = p_ctrl;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		return Group::mix_hash(Hasher::hash(p_key));
+	}
+
+	uint32_t _lookup_pos(const TKey &p_key) const {
+		if (num_elements == 0) {
+			return INVALID_POS;
+		}
+
+		const uint32_t hash = _hash(p_key);
+		const uint8_t h2 = Group::get_h2(hash);
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = Group::get_h1(hash) & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			const Group group(ctrl + pos);
+			for (uint64_t match = group.match(h2); match; match &= match - 1) {
+				const uint32_t slot = (pos + Group::get_index(match)) & mask;
+				if (Comparator::compare(slots[slot].key, p_key)) {
+					return slot;
+				}
+			}
+			if (group.match_empty()) {
+				return INVALID_POS;
+			}
+			// Triangular probing over groups visits every slot exactly once.
+			step += Group::WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	// Finds where a key that is known not to be in the table should go.
+	uint32_t _find_free_pos(uint32_t p_hash) const {
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = Group::get_h1(p_hash) & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			const uint64_t free = Group(ctrl + pos).match_empty_or_deleted();
+			if (free) {
+				return (pos + Group::get_index(free)) & mask;
+			}
+			step += Group::WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	void _allocate(uint32_t p_capacity) {
+		capacity = p_capacity;
+		ctrl = reinterpret_cast<uint8_t *>(Memory::alloc_static(capacity + Group::WIDTH));
+		slots = reinterpret_cast<KeyValue<TKey, TValue> *>(Memory::alloc_static(sizeof(KeyValue<TKey, TValue>) * capacity));
+		memset(ctrl, Group::CTRL_EMPTY, capacity + Group::WIDTH);
+		num_deleted = 0;
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		uint8_t *old_ctrl = ctrl;
+		KeyValue<TKey, TValue> *old_slots = slots;
+		const uint32_t old_capacity = capacity;
+
+		_allocate(p_new_capacity);
+
+		if (old_ctrl == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] & 0x80) {
+				continue;
+			}
+			const uint32_t hash = _hash(old_slots[i].key);
+			const uint32_t pos = _find_free_pos(hash);
+			_set_ctrl(pos, Group::get_h2(hash));
+			memnew_placement(&slots[pos], Slot(old_slots[i]));
+			old_slots[i].~KeyValue<TKey, TValue>();
+		}
+
+		Memory::free_static(old_slots);
+		Memory::free_static(old_ctrl);
+	}
+
+	// Makes room for one more element, moving all of them.
+	void _grow() {
+		// Grow if the table is really full, otherwise just purge the deleted slots.
+		if (num_elements + 1 > Group::get_max_load(capacity) / 2) {
+			_resize_and_rehash(capacity << 1);
+		} else {
+			_resize_and_rehash(capacity);
+		}
+	}
+
+	uint32_t _insert_new(const TKey &p_key, const TValue &p_value) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t pos = _find_free_pos(hash);
+		if (ctrl[pos] == Group::CTRL_DELETED) {
+			num_deleted--;
+		}
+		_set_ctrl(pos, Group::get_h2(hash));
+		memnew_placement(&slots[pos], Slot(p_key, p_value));
+		num_elements++;
+		return pos;
+	}
+
+	uint32_t _insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t pos = _lookup_pos(p_key);
+		if (pos != INVALID_POS) {
+			slots[pos].value = p_value;
+			return pos;
+		}
+
+		if (unlikely(ctrl == nullptr)) {
+			// Allocate on demand to save memory.
+			_allocate(MAX(reserved_capacity, Group::WIDTH));
+		} else if (num_elements + num_deleted + 1 > Group::get_max_load(capacity)) {
+			ERR_FAIL_COND_V_MSG(num_elements + 1 > Group::get_max_load(capacity) / 2 && capacity >= (1u << 31), INVALID_POS, "Hash table maximum capacity reached, aborting insertion.");
+			// The arguments may refer to an element of this table (e.g. `map[a] = map[b]`),
+			// copy them before the slots move.
+			const TKey key = p_key;
+			const TValue value = p_value;
+			_grow();
+			return _insert_new(key, value);
+		}
+
+		return _insert_new(p_key, p_value);
+	}
+
+	void _erase_pos(uint32_t p_pos) {
+		slots[p_pos].~KeyValue<TKey, TValue>();
+		num_elements--;
+
+		if (num_elements == 0) {
+			// Nothing left to probe past, reset the tombstones for free.
+			memset(ctrl, Group::CTRL_EMPTY, capacity + Group::WIDTH);
+			num_deleted = 0;
+		} else {
+			_set_ctrl(p_pos, Group::CTRL_DELETED);
+			num_deleted++;
+		}
+	}
+
+	void _copy_from(const FlatHashMap &p_other) {
+		_allocate(p_other.capacity);
+		memcpy(ctrl, p_other.ctrl, capacity + Group::WIDTH);
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (!(ctrl[i] & 0x80)) {
+				memnew_placement(&slots[i], Slot(p_other.slots[i]));
+			}
+		}
+		num_elements = p_other.num_elements;
+		num_deleted = p_other.num_deleted;
+	}
+
+	_FORCE_INLINE_ uint32_t _next_pos(uint32_t p_pos) const {
+		while (p_pos < capacity && (ctrl[p_pos] & 0x80)) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity ? capacity : MAX(reserved_capacity, Group::WIDTH); }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (ctrl == nullptr) {
+			return;
+		}
+		if (num_elements > 0) {
+			for (uint32_t i = 0; i < capacity; i++) {
+				if (!(ctrl[i] & 0x80)) {
+					slots[i].~KeyValue<TKey, TValue>();
+				}
+			}
+		}
+		memset(ctrl, Group::CTRL_EMPTY, capacity + Group::WIDTH);
+		num_elements = 0;
+		num_deleted = 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		const uint32_t pos = _lookup_pos(p_key);
+		CRASH_COND_MSG(pos == INVALID_POS, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		const uint32_t pos = _lookup_pos(p_key);
+		CRASH_COND_MSG(pos == INVALID_POS, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		const uint32_t pos = _lookup_pos(p_key);
+		if (pos != INVALID_POS) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		const uint32_t pos = _lookup_pos(p_key);
+		if (pos != INVALID_POS) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		return _lookup_pos(p_key) != INVALID_POS;
+	}
+
+	bool erase(const TKey &p_key) {
+		const uint32_t pos = _lookup_pos(p_key);
+		if (pos == INVALID_POS) {
+			return false;
+		}
+		_erase_pos(pos);
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		const uint32_t new_capacity = Group::get_capacity_for(p_new_capacity);
+		if (ctrl == nullptr) {
+			reserved_capacity = MAX(reserved_capacity, new_capacity);
+			return; // Unallocated yet.
+		}
+		if (new_capacity > capacity) {
+			_resize_and_rehash(new_capacity);
+		}
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (map && pos < map->capacity) {
+				pos = map->_next_pos(pos + 1);
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return map == b.map && pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return map != b.map || pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map != nullptr && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+		_FORCE_INLINE_ ConstIterator(const ConstIterator &p_it) {
+			map = p_it.map;
+			pos = p_it.pos;
+		}
+		_FORCE_INLINE_ void operator=(const ConstIterator &p_it) {
+			map = p_it.map;
+			pos = p_it.pos;
+		}
+
+	private:
+		const FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (map && pos < map->capacity) {
+				pos = map->_next_pos(pos + 1);
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return map == b.map && pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return map != b.map || pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map != nullptr && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ Iterator(FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ Iterator() {}
+		_FORCE_INLINE_ Iterator(const Iterator &p_it) {
+			map = p_it.map;
+			pos = p_it.pos;
+		}
+		_FORCE_INLINE_ void operator=(const Iterator &p_it) {
+			map = p_it.map;
+			pos = p_it.pos;
+		}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, pos);
+		}
+
+	private:
+		FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, num_elements ? _next_pos(0) : capacity);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		const uint32_t pos = _lookup_pos(p_key);
+		if (pos == INVALID_POS) {
+			return end();
+		}
+		return Iterator(this, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, num_elements ? _next_pos(0) : capacity);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		const uint32_t pos = _lookup_pos(p_key);
+		if (pos == INVALID_POS) {
+			return end();
+		}
+		return ConstIterator(this, pos);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		const uint32_t pos = _lookup_pos(p_key);
+		CRASH_COND(pos == INVALID_POS);
+		return slots[pos].value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = _lookup_pos(p_key);
+		if (pos == INVALID_POS) {
+			pos = _insert(p_key, TValue());
+			CRASH_COND(pos == INVALID_POS);
+		}
+		return slots[pos].value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t pos = _insert(p_key, p_value);
+		if (pos == INVALID_POS) {
+			return end();
+		}
+		return Iterator(this, pos);
+	}
+
+	/* Constructors */
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		reserved_capacity = p_other.reserved_capacity;
+		if (p_other.ctrl != nullptr) {
+			_copy_from(p_other);
+		}
+	}
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		if (ctrl != nullptr) {
+			Memory::free_static(slots);
+			Memory::free_static(ctrl);
+			ctrl = nullptr;
+			slots = nullptr;
+			capacity = 0;
+		}
+
+		reserved_capacity = p_other.reserved_capacity;
+		if (p_other.ctrl != nullptr) {
+			_copy_from(p_other);
+		}
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashMap() {}
+
+	~FlatHashMap() {
+		clear();
+
+		if (ctrl != nullptr) {
+			Memory::free_static(slots);
+			Memory::free_static(ctrl);
+		}
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
@@ -0,0 +1,385 @@
+/*************************************************************************/
+/*  flat_hash_set.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FLAT_HASH_SET_H
+#define FLAT_HASH_SET_H
+
+#include "core/templates/flat_hash_map.h"
+
+/**
+ * An unordered HashSet that stores its keys inline in the probing array,
+ * see FlatHashMap for the layout.
+ *
+ * Iteration order is unspecified, and inserting may move the stored keys,
+ * which invalidates iterators. Erasing never moves keys.
+ */
+
+template <class TKey,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashSet {
+	typedef FlatHashGroup Group;
+
+	static constexpr uint32_t INVALID_POS = 0xFFFFFFFF;
+
+	uint8_t *ctrl = nullptr;
+	TKey *keys = nullptr;
+
+	uint32_t capacity = 0; // Power of two, or zero while nothing is allocated.
+	uint32_t reserved_capacity = 0;
+	uint32_t num_elements = 0;
+	uint32_t num_deleted = 0;
+
+	_FORCE_INLINE_ void _set_ctrl(uint32_t p_pos, uint8_t p_ctrl) {
+		ctrl[p_pos] = p_ctrl;
+		if (p_pos < Group::WIDTH) {
+			ctrl[capacity + p_pos] = p_ctrl;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		return Group::mix_hash(Hasher::hash(p_key));
+	}
+
+	uint32_t _lookup_pos(const TKey &p_key) const {
+		if (num_elements == 0) {
+			return INVALID_POS;
+		}
+
+		const uint32_t hash = _hash(p_key);
+		const uint8_t h2 = Group::get_h2(hash);
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = Group::get_h1(hash) & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			const Group group(ctrl + pos);
+			for (uint64_t match = group.match(h2); match; match &= match - 1) {
+				const uint32_t slot = (pos + Group::get_index(match)) & mask;
+				if (Comparator::compare(keys[slot], p_key)) {
+					return slot;
+				}
+			}
+			if (group.match_empty()) {
+				return INVALID_POS;
+			}
+			step += Group::WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	uint32_t _find_free_pos(uint32_t p_hash) const {
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = Group::get_h1(p_hash) & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			const uint64_t free = Group(ctrl + pos).match_empty_or_deleted();
+			if (free) {
+				return (pos + Group::get_index(free)) & mask;
+			}
+			step += Group::WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	void _allocate(uint32_t p_capacity) {
+		capacity = p_capacity;
+		ctrl = reinterpret_cast<uint8_t *>(Memory::alloc_static(capacity + Group::WIDTH));
+		keys = reinterpret_cast<TKey *>(Memory::alloc_static(sizeof(TKey) * capacity));
+		memset(ctrl, Group::CTRL_EMPTY, capacity + Group::WIDTH);
+		num_deleted = 0;
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		uint8_t *old_ctrl = ctrl;
+		TKey *old_keys = keys;
+		const uint32_t old_capacity = capacity;
+
+		_allocate(p_new_capacity);
+
+		if (old_ctrl == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] & 0x80) {
+				continue;
+			}
+			const uint32_t hash = _hash(old_keys[i]);
+			const uint32_t pos = _find_free_pos(hash);
+			_set_ctrl(pos, Group::get_h2(hash));
+			memnew_placement(&keys[pos], TKey(old_keys[i]));
+			old_keys[i].~TKey();
+		}
+
+		Memory::free_static(old_keys);
+		Memory::free_static(old_ctrl);
+	}
+
+	// Makes room for one more element, moving all of them.
+	void _grow() {
+		// Grow if the table is really full, otherwise just purge the deleted slots.
+		if (num_elements + 1 > Group::get_max_load(capacity) / 2) {
+			_resize_and_rehash(capacity << 1);
+		} else {
+			_resize_and_rehash(capacity);
+		}
+	}
+
+	uint32_t _insert_new(const TKey &p_key) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t pos = _find_free_pos(hash);
+		if (ctrl[pos] == Group::CTRL_DELETED) {
+			num_deleted--;
+		}
+		_set_ctrl(pos, Group::get_h2(hash));
+		memnew_placement(&keys[pos], TKey(p_key));
+		num_elements++;
+		return pos;
+	}
+
+	uint32_t _insert(const TKey &p_key) {
+		uint32_t pos = _lookup_pos(p_key);
+		if (pos != INVALID_POS) {
+			return pos;
+		}
+
+		if (unlikely(ctrl == nullptr)) {
+			// Allocate on demand to save memory.
+			_allocate(MAX(reserved_capacity, Group::WIDTH));
+		} else if (num_elements + num_deleted + 1 > Group::get_max_load(capacity)) {
+			ERR_FAIL_COND_V_MSG(num_elements + 1 > Group::get_max_load(capacity) / 2 && capacity >= (1u << 31), INVALID_POS, "Hash table maximum capacity reached, aborting insertion.");
+			// The argument may refer to an element of this set, copy it before the keys move.
+			const TKey key = p_key;
+			_grow();
+			return _insert_new(key);
+		}
+
+		return _insert_new(p_key);
+	}
+
+	void _copy_from(const FlatHashSet &p_other) {
+		_allocate(p_other.capacity);
+		memcpy(ctrl, p_other.ctrl, capacity + Group::WIDTH);
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (!(ctrl[i] & 0x80)) {
+				memnew_placement(&keys[i], TKey(p_other.keys[i]));
+			}
+		}
+		num_elements = p_other.num_elements;
+		num_deleted = p_other.num_deleted;
+	}
+
+	_FORCE_INLINE_ uint32_t _next_pos(uint32_t p_pos) const {
+		while (p_pos < capacity && (ctrl[p_pos] & 0x80)) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity ? capacity : MAX(reserved_capacity, Group::WIDTH); }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (ctrl == nullptr) {
+			return;
+		}
+		if (num_elements > 0) {
+			for (uint32_t i = 0; i < capacity; i++) {
+				if (!(ctrl[i] & 0x80)) {
+					keys[i].~TKey();
+				}
+			}
+		}
+		memset(ctrl, Group::CTRL_EMPTY, capacity + Group::WIDTH);
+		num_elements = 0;
+		num_deleted = 0;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		return _lookup_pos(p_key) != INVALID_POS;
+	}
+
+	bool erase(const TKey &p_key) {
+		const uint32_t pos = _lookup_pos(p_key);
+		if (pos == INVALID_POS) {
+			return false;
+		}
+
+		keys[pos].~TKey();
+		num_elements--;
+
+		if (num_elements == 0) {
+			memset(ctrl, Group::CTRL_EMPTY, capacity + Group::WIDTH);
+			num_deleted = 0;
+		} else {
+			_set_ctrl(pos, Group::CTRL_DELETED);
+			num_deleted++;
+		}
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		const uint32_t new_capacity = Group::get_capacity_for(p_new_capacity);
+		if (ctrl == nullptr) {
+			reserved_capacity = MAX(reserved_capacity, new_capacity);
+			return; // Unallocated yet.
+		}
+		if (new_capacity > capacity) {
+			_resize_and_rehash(new_capacity);
+		}
+	}
+
+	/** Iterator API **/
+
+	struct Iterator {
+		_FORCE_INLINE_ const TKey &operator*() const {
+			return set->keys[pos];
+		}
+		_FORCE_INLINE_ const TKey *operator->() const {
+			return &set->keys[pos];
+		}
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (set && pos < set->capacity) {
+				pos = set->_next_pos(pos + 1);
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return set == b.set && pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return set != b.set || pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return set != nullptr && pos < set->capacity;
+		}
+
+		_FORCE_INLINE_ Iterator(const FlatHashSet *p_set, uint32_t p_pos) {
+			set = p_set;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ Iterator() {}
+		_FORCE_INLINE_ Iterator(const Iterator &p_it) {
+			set = p_it.set;
+			pos = p_it.pos;
+		}
+		_FORCE_INLINE_ void operator=(const Iterator &p_it) {
+			set = p_it.set;
+			pos = p_it.pos;
+		}
+
+	private:
+		const FlatHashSet *set = nullptr;
+		uint32_t pos = 0;
+	};
+
+	_FORCE_INLINE_ Iterator begin() const {
+		return Iterator(this, num_elements ? _next_pos(0) : capacity);
+	}
+	_FORCE_INLINE_ Iterator end() const {
+		return Iterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) const {
+		const uint32_t pos = _lookup_pos(p_key);
+		if (pos == INVALID_POS) {
+			return end();
+		}
+		return Iterator(this, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(*p_iter);
+		}
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key) {
+		const uint32_t pos = _insert(p_key);
+		if (pos == INVALID_POS) {
+			return end();
+		}
+		return Iterator(this, pos);
+	}
+
+	/* Constructors */
+
+	FlatHashSet(const FlatHashSet &p_other) {
+		reserved_capacity = p_other.reserved_capacity;
+		if (p_other.ctrl != nullptr) {
+			_copy_from(p_other);
+		}
+	}
+
+	void operator=(const FlatHashSet &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		if (ctrl != nullptr) {
+			Memory::free_static(keys);
+			Memory::free_static(ctrl);
+			ctrl = nullptr;
+			keys = nullptr;
+			capacity = 0;
+		}
+
+		reserved_capacity = p_other.reserved_capacity;
+		if (p_other.ctrl != nullptr) {
+			_copy_from(p_other);
+		}
+	}
+
+	FlatHashSet(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashSet() {}
+
+	~FlatHashSet() {
+		clear();
+
+		if (ctrl != nullptr) {
+			Memory::free_static(keys);
+			Memory::free_static(ctrl);
+		}
+	}
+};
+
+#endif // FLAT_HASH_SET_H
@@ -74,6 +74,7 @@ void ThreadWorkPool::finish() {
 
 	memdelete_arr(threads);
 	threads = nullptr;
+	thread_count = 0;
 }
 
 ThreadWorkPool::~ThreadWorkPool() {
@@ -39,9 +39,11 @@
 
 class ThreadWorkPool {
 	std::atomic<uint32_t> index;
+	std::atomic<uint32_t> completed;
 
 	struct BaseWork {
 		std::atomic<uint32_t> *index = nullptr;
+		std::atomic<uint32_t> *completed = nullptr;
 		uint32_t max_elements = 0;
 		virtual void work() = 0;
 		virtual ~BaseWork() = default;
@@ -59,6 +61,7 @@ class ThreadWorkPool {
 					break;
 				}
 				(instance->*method)(work_index, userdata);
+				completed->fetch_add(1, std::memory_order_release);
 			}
 		}
 	};
@@ -85,12 +88,14 @@ public:
 		ERR_FAIL_COND(current_work != nullptr);
 
 		index.store(0, std::memory_order_release);
+		completed.store(0, std::memory_order_release);
 
 		Work<C, M, U> *w = memnew((Work<C, M, U>));
 		w->instance = p_instance;
 		w->userdata = p_userdata;
 		w->method = p_method;
 		w->index = &index;
+		w->completed = &completed;
 		w->max_elements = p_elements;
 
 		current_work = w;
@@ -112,6 +117,13 @@ public:
 		return index.load(std::memory_order_acquire) >= current_work->max_elements;
 	}
 
+	// Unlike is_done_dispatching(), only true once the last elements have finished too. Poll this
+	// instead when the elements may need the dispatching thread (e.g. to flush a queue) to finish.
+	bool is_done_working() const {
+		ERR_FAIL_COND_V(current_work == nullptr, true);
+		return completed.load(std::memory_order_acquire) >= current_work->max_elements;
+	}
+
 	uint32_t get_work_index() const {
 		ERR_FAIL_COND_V(current_work == nullptr, 0);
 		uint32_t idx = index.load(std::memory_order_acquire);
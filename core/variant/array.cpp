@@ -39,10 +39,251 @@
 #include "core/variant/callable.h"
 #include "core/variant/variant.h"
 
+// Element storage of an Array. Small arrays (return tuples, signal arguments, short
+// configurations) keep their elements in a block of INLINE_CAPACITY slots, so building one
+// costs a single allocation besides the ArrayPrivate, without the reallocations of a growing
+// Vector. The block is only allocated when the first element is added, as most arrays stay
+// empty. Past INLINE_CAPACITY the elements move to a Vector, which keeps copies of large arrays
+// between ArrayPrivates copy-on-write, and the block is released.
+class ArrayStorage {
+public:
+	enum {
+		INLINE_CAPACITY = 4,
+	};
+
+private:
+	// Allocated on first use, and freed once the elements spill to the heap.
+	struct InlineData {
+		Variant data[INLINE_CAPACITY];
+		int size = 0;
+	};
+
+	InlineData *inline_data = nullptr;
+	Vector<Variant> heap; // Only holds elements once spilled, so it's never empty then.
+
+	_FORCE_INLINE_ bool _is_spilled() const { return !heap.is_empty(); }
+	_FORCE_INLINE_ int _inline_size() const { return inline_data ? inline_data->size : 0; }
+
+	InlineData *_get_inline_data() {
+		if (!inline_data) {
+			inline_data = memnew(InlineData);
+		}
+		return inline_data;
+	}
+
+	void _free_inline_data() {
+		if (inline_data) {
+			memdelete(inline_data);
+			inline_data = nullptr;
+		}
+	}
+
+	void _spill(int p_size) {
+		heap.resize(p_size);
+		if (inline_data) {
+			Variant *w = heap.ptrw();
+			for (int i = 0; i < inline_data->size; i++) {
+				w[i] = inline_data->data[i];
+			}
+			_free_inline_data();
+		}
+	}
+
+	void _copy_from(const ArrayStorage &p_from) {
+		heap = p_from.heap;
+		if (_is_spilled()) {
+			_free_inline_data();
+			return;
+		}
+		const int from_size = p_from._inline_size();
+		const int old_size = _inline_size();
+		if (from_size > 0) {
+			InlineData *data = _get_inline_data();
+			for (int i = 0; i < from_size; i++) {
+				data->data[i] = p_from.inline_data->data[i];
+			}
+		}
+		for (int i = from_size; i < old_size; i++) {
+			inline_data->data[i] = Variant();
+		}
+		if (inline_data) {
+			inline_data->size = from_size;
+		}
+	}
+
+public:
+	ArrayStorage() {}
+	ArrayStorage(const ArrayStorage &p_from) { _copy_from(p_from); }
+	void operator=(const ArrayStorage &p_from) {
+		if (this != &p_from) {
+			_copy_from(p_from);
+		}
+	}
+	~ArrayStorage() { _free_inline_data(); }
+
+	_FORCE_INLINE_ int size() const { return _is_spilled() ? heap.size() : _inline_size(); }
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+
+	_FORCE_INLINE_ const Variant *ptr() const { return _is_spilled() ? heap.ptr() : (inline_data ? inline_data->data : nullptr); }
+	_FORCE_INLINE_ Variant *ptrw() { return _is_spilled() ? heap.ptrw() : (inline_data ? inline_data->data : nullptr); }
+
+	// There is deliberately no non-const operator[], reads must not trigger copy-on-write.
+	_FORCE_INLINE_ const Variant &operator[](int p_index) const {
+		CRASH_BAD_INDEX(p_index, size());
+		return ptr()[p_index];
+	}
+	_FORCE_INLINE_ const Variant &get(int p_index) const { return operator[](p_index); }
+	_FORCE_INLINE_ Variant &write(int p_index) {
+		CRASH_BAD_INDEX(p_index, size());
+		return ptrw()[p_index];
+	}
+
+	Error resize(int p_size) {
+		ERR_FAIL_COND_V(p_size < 0, ERR_INVALID_PARAMETER);
+		if (_is_spilled()) {
+			if (p_size == 0) {
+				heap.clear();
+				return OK;
+			}
+			return heap.resize(p_size);
+		}
+		if (p_size > INLINE_CAPACITY) {
+			_spill(p_size);
+			return OK;
+		}
+		if (p_size == _inline_size()) {
+			return OK;
+		}
+		InlineData *data = _get_inline_data();
+		for (int i = p_size; i < data->size; i++) {
+			data->data[i] = Variant();
+		}
+		data->size = p_size;
+		return OK;
+	}
+
+	_FORCE_INLINE_ void clear() { resize(0); }
+
+	void push_back(const Variant &p_value) {
+		if (_is_spilled()) {
+			heap.push_back(p_value);
+		} else if (_inline_size() < INLINE_CAPACITY) {
+			InlineData *data = _get_inline_data();
+			data->data[data->size++] = p_value;
+		} else {
+			const Variant value = p_value; // May point into the inline data.
+			_spill(INLINE_CAPACITY + 1);
+			heap.write[heap.size() - 1] = value;
+		}
+	}
+
+	Error insert(int p_pos, const Variant &p_value) {
+		ERR_FAIL_INDEX_V(p_pos, size() + 1, ERR_INVALID_PARAMETER);
+		if (_is_spilled()) {
+			return heap.insert(p_pos, p_value);
+		}
+		const Variant value = p_value; // May point into the inline data.
+		if (_inline_size() == INLINE_CAPACITY) {
+			_spill(INLINE_CAPACITY);
+			return heap.insert(p_pos, value);
+		}
+		InlineData *data = _get_inline_data();
+		for (int i = data->size; i > p_pos; i--) {
+			data->data[i] = data->data[i - 1];
+		}
+		data->data[p_pos] = value;
+		data->size++;
+		return OK;
+	}
+
+	void remove_at(int p_index) {
+		ERR_FAIL_INDEX(p_index, size());
+		if (_is_spilled()) {
+			heap.remove_at(p_index);
+			return;
+		}
+		InlineData *data = inline_data;
+		data->size--;
+		for (int i = p_index; i < data->size; i++) {
+			data->data[i] = data->data[i + 1];
+		}
+		data->data[data->size] = Variant();
+	}
+
+	int find(const Variant &p_value, int p_from = 0) const {
+		if (p_from < 0) {
+			return -1;
+		}
+		const Variant *r = ptr();
+		const int s = size();
+		for (int i = p_from; i < s; i++) {
+			if (r[i] == p_value) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void erase(const Variant &p_value) {
+		int idx = find(p_value);
+		if (idx >= 0) {
+			remove_at(idx);
+		}
+	}
+
+	void fill(const Variant &p_value) {
+		const Variant value = p_value;
+		Variant *w = ptrw();
+		const int s = size();
+		for (int i = 0; i < s; i++) {
+			w[i] = value;
+		}
+	}
+
+	void append_array(const ArrayStorage &p_other) {
+		const int s = size();
+		const int other_size = p_other.size();
+		if (other_size == 0) {
+			return;
+		}
+		resize(s + other_size);
+		// Fetched after resizing, p_other may be this storage.
+		Variant *w = ptrw();
+		const Variant *r = p_other.ptr();
+		for (int i = 0; i < other_size; i++) {
+			w[s + i] = r[i];
+		}
+	}
+
+	void reverse() {
+		Variant *w = ptrw();
+		const int s = size();
+		for (int i = 0; i < s / 2; i++) {
+			SWAP(w[i], w[s - i - 1]);
+		}
+	}
+
+	template <class Comparator, bool Validate = SORT_ARRAY_VALIDATE_ENABLED, class... Args>
+	void sort_custom(Args &&...args) {
+		const int s = size();
+		if (s == 0) {
+			return;
+		}
+		SortArray<Variant, Comparator, Validate> sorter{ args... };
+		sorter.sort(ptrw(), s);
+	}
+
+	template <class Comparator, class... Args>
+	int bsearch_custom(const Variant &p_value, bool p_before, Args &&...args) const {
+		SearchArray<Variant, Comparator> search{ args... };
+		return search.bisect(ptr(), size(), p_value, p_before);
+	}
+};
+
 class ArrayPrivate {
 public:
 	SafeRefCount refcount;
-	Vector<Variant> array;
+	ArrayStorage array;
 	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
 	ContainerTypeValidate typed;
 };
@@ -94,7 +335,7 @@ Variant &Array::operator[](int p_idx) {
 		*_p->read_only = _p->array[p_idx];
 		return *_p->read_only;
 	}
-	return _p->array.write[p_idx];
+	return _p->array.write(p_idx);
 }
 
 const Variant &Array::operator[](int p_idx) const {
@@ -118,6 +359,15 @@ void Array::clear() {
 	_p->array.clear();
 }
 
+const Variant *Array::ptr() const {
+	return _p->array.ptr();
+}
+
+Variant *Array::ptrw() {
+	ERR_FAIL_COND_V_MSG(_p->read_only, nullptr, "Array is in read-only state.");
+	return _p->array.ptrw();
+}
+
 bool Array::operator==(const Array &p_array) const {
 	return recursive_equal(p_array, 0);
 }
@@ -131,8 +381,8 @@ bool Array::recursive_equal(const Array &p_array, int recursion_count) const {
 	if (_p == p_array._p) {
 		return true;
 	}
-	const Vector<Variant> &a1 = _p->array;
-	const Vector<Variant> &a2 = p_array._p->array;
+	const ArrayStorage &a1 = _p->array;
+	const ArrayStorage &a2 = p_array._p->array;
 	const int size = a1.size();
 	if (size != a2.size()) {
 		return false;
@@ -217,16 +467,16 @@ bool Array::_assign(const Array &p_array) {
 
 		} else {
 			//for non objects, we need to check if there is a valid conversion, which needs to happen one by one, so this is the worst case.
-			Vector<Variant> new_array;
+			ArrayStorage new_array;
 			new_array.resize(p_array._p->array.size());
 			for (int i = 0; i < p_array._p->array.size(); i++) {
 				Variant src_val = p_array._p->array[i];
 				if (src_val.get_type() == _p->typed.type) {
-					new_array.write[i] = src_val;
+					new_array.write(i) = src_val;
 				} else if (Variant::can_convert_strict(src_val.get_type(), _p->typed.type)) {
 					Variant *ptr = &src_val;
 					Callable::CallError ce;
-					Variant::construct(_p->typed.type, new_array.write[i], (const Variant **)&ptr, 1, ce);
+					Variant::construct(_p->typed.type, new_array.write(i), (const Variant **)&ptr, 1, ce);
 					if (ce.error != Callable::CallError::CALL_OK) {
 						ERR_FAIL_V_MSG(false, "Unable to convert array index " + itos(i) + " from '" + Variant::get_type_name(src_val.get_type()) + "' to '" + Variant::get_type_name(_p->typed.type) + "'.");
 					}
@@ -587,7 +837,7 @@ void Array::shuffle() {
 int Array::bsearch(const Variant &p_value, bool p_before) {
 	ERR_FAIL_COND_V(!_p->typed.validate(p_value, "binary search"), -1);
 	SearchArray<Variant, _ArrayVariantSort> avs;
-	return avs.bisect(_p->array.ptrw(), _p->array.size(), p_value, p_before);
+	return avs.bisect(_p->array.ptr(), _p->array.size(), p_value, p_before);
 }
 
 int Array::bsearch_custom(const Variant &p_value, const Callable &p_callable, bool p_before) {
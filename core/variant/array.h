@@ -40,12 +40,24 @@ class ArrayPrivate;
 class Object;
 class StringName;
 class Callable;
+template <class T>
+class Vector;
 
 class Array {
 	mutable ArrayPrivate *_p;
 	void _ref(const Array &p_from) const;
 	void _unref() const;
 
+	// Contiguous elements for bulk conversions, valid until the array is resized.
+	// Writing through ptrw() bypasses the element type check of typed arrays.
+	const Variant *ptr() const;
+	Variant *ptrw();
+
+	template <class T>
+	friend void _convert_packed_to_array(const Vector<T> &p_src, Array &r_dst);
+	template <class T>
+	friend void _convert_array_to_packed(const Array &p_src, Vector<T> &r_dst);
+
 protected:
 	Array(const Array &p_base, uint32_t p_type, const StringName &p_class_name, const Variant &p_script);
 	bool _assign(const Array &p_array);
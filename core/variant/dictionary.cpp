@@ -39,10 +39,237 @@
 #include "core/variant/type_info.h"
 #include "core/variant/variant_internal.h"
 
+// Key/value storage of a Dictionary. The first INLINE_CAPACITY pairs are kept in a block of
+// slots in insertion order and looked up linearly, so small dictionaries need one allocation
+// besides the DictionaryPrivate. The block is only allocated on the first insertion, as most
+// dictionaries stay empty. Pairs added after those go to a HashMap, which keeps insertion order
+// too. Pairs never move once added, like HashMap elements: erasing an inline pair leaves its
+// slot empty, and the slots are only reused once the dictionary is empty again.
+class DictionaryStorage {
+public:
+	typedef KeyValue<Variant, Variant> Pair;
+	typedef HashMap<Variant, Variant, VariantHasher, VariantComparator> Map;
+
+	enum {
+		INLINE_CAPACITY = 4,
+	};
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const Pair &operator*() const { return storage ? storage->_pairs()[index] : *E; }
+		_FORCE_INLINE_ const Pair *operator->() const { return storage ? &storage->_pairs()[index] : &(*E); }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (storage) {
+				// Inline pairs are followed by the hashed ones.
+				index = storage->_next_inline(index + 1);
+				if (index == -1) {
+					E = storage->map.begin();
+					storage = nullptr;
+				}
+			} else {
+				++E;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return storage == b.storage && index == b.index && E == b.E; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return !(*this == b); }
+
+		ConstIterator() {}
+		ConstIterator(const DictionaryStorage *p_storage, int p_index) {
+			storage = p_storage;
+			index = p_index;
+		}
+		ConstIterator(const Map::ConstIterator &p_E) {
+			E = p_E;
+		}
+
+	private:
+		const DictionaryStorage *storage = nullptr;
+		int index = -1;
+		Map::ConstIterator E;
+	};
+
+private:
+	// Allocated on the first insertion and kept until the storage is destroyed.
+	struct InlineSlots {
+		uint8_t used_mask = 0; // Bit i is set if slot i holds a pair.
+		uint8_t end = 0; // Slots from here on were never used.
+		uint8_t count = 0;
+		alignas(Pair) uint8_t pairs[INLINE_CAPACITY * sizeof(Pair)];
+	};
+
+	InlineSlots *inline_slots = nullptr;
+	Map map;
+
+	_FORCE_INLINE_ Pair *_pairs() { return reinterpret_cast<Pair *>(inline_slots->pairs); }
+	_FORCE_INLINE_ const Pair *_pairs() const { return reinterpret_cast<const Pair *>(inline_slots->pairs); }
+	_FORCE_INLINE_ bool _is_used(int p_index) const { return inline_slots->used_mask & (1 << p_index); }
+	_FORCE_INLINE_ int _inline_end() const { return inline_slots ? inline_slots->end : 0; }
+	_FORCE_INLINE_ int _inline_count() const { return inline_slots ? inline_slots->count : 0; }
+
+	// First used slot from p_from on, or -1.
+	int _next_inline(int p_from) const {
+		const int inline_end = _inline_end();
+		for (int i = p_from; i < inline_end; i++) {
+			if (_is_used(i)) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	int _find_inline(const Variant &p_key) const {
+		const int inline_end = _inline_end();
+		for (int i = 0; i < inline_end; i++) {
+			if (_is_used(i) && VariantComparator::compare(_pairs()[i].key, p_key)) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void _clear_inline() {
+		const int inline_end = _inline_end();
+		for (int i = 0; i < inline_end; i++) {
+			if (_is_used(i)) {
+				_pairs()[i].~Pair();
+			}
+		}
+		if (inline_slots) {
+			inline_slots->used_mask = 0;
+			inline_slots->end = 0;
+			inline_slots->count = 0;
+		}
+	}
+
+	void _alloc_inline() {
+		if (!inline_slots) {
+			inline_slots = memnew(InlineSlots);
+		}
+	}
+
+	void _copy_from(const DictionaryStorage &p_from) {
+		const int from_end = p_from._inline_end();
+		if (from_end > 0) {
+			_alloc_inline();
+			const Pair *from_pairs = p_from._pairs();
+			Pair *pairs = _pairs();
+			for (int i = 0; i < from_end; i++) {
+				if (p_from._is_used(i)) {
+					memnew_placement(&pairs[i], Pair(from_pairs[i]));
+				}
+			}
+			inline_slots->used_mask = p_from.inline_slots->used_mask;
+			inline_slots->end = p_from.inline_slots->end;
+			inline_slots->count = p_from.inline_slots->count;
+		}
+		map = p_from.map;
+	}
+
+public:
+	_FORCE_INLINE_ int size() const { return _inline_count() + map.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+
+	void clear() {
+		_clear_inline();
+		map.clear();
+	}
+
+	const Variant *getptr(const Variant &p_key) const {
+		int idx = _find_inline(p_key);
+		if (idx >= 0) {
+			return &_pairs()[idx].value;
+		}
+		if (map.is_empty()) {
+			return nullptr;
+		}
+		Map::ConstIterator E = map.find(p_key);
+		return E ? &E->value : nullptr;
+	}
+
+	Variant *getptr(const Variant &p_key) {
+		return const_cast<Variant *>(const_cast<const DictionaryStorage *>(this)->getptr(p_key));
+	}
+
+	_FORCE_INLINE_ bool has(const Variant &p_key) const { return getptr(p_key) != nullptr; }
+
+	Variant &operator[](const Variant &p_key) {
+		Variant *value = getptr(p_key);
+		if (value) {
+			return *value;
+		}
+		if (is_empty()) {
+			clear(); // Start over with the inline slots.
+		}
+		if (_inline_end() < INLINE_CAPACITY) {
+			_alloc_inline();
+			const int idx = inline_slots->end;
+			Pair *pair = memnew_placement(&_pairs()[idx], Pair(p_key, Variant()));
+			inline_slots->used_mask |= 1 << idx;
+			inline_slots->end++;
+			inline_slots->count++;
+			return pair->value;
+		}
+		return map[p_key];
+	}
+
+	bool erase(const Variant &p_key) {
+		int idx = _find_inline(p_key);
+		if (idx < 0) {
+			return map.erase(p_key);
+		}
+		_pairs()[idx].~Pair();
+		inline_slots->used_mask &= ~(1 << idx);
+		inline_slots->count--;
+		return true;
+	}
+
+	// Iterator to the pair following p_key, or end() if there is none.
+	ConstIterator next(const Variant &p_key) const {
+		int idx = _find_inline(p_key);
+		if (idx >= 0) {
+			ConstIterator it(this, idx);
+			return ++it;
+		}
+		Map::ConstIterator E = map.find(p_key);
+		if (E) {
+			++E;
+		}
+		return ConstIterator(E);
+	}
+
+	ConstIterator begin() const {
+		int idx = _next_inline(0);
+		if (idx >= 0) {
+			return ConstIterator(this, idx);
+		}
+		return ConstIterator(map.begin());
+	}
+	_FORCE_INLINE_ ConstIterator end() const { return ConstIterator(); }
+
+	void operator=(const DictionaryStorage &p_from) {
+		if (this == &p_from) {
+			return;
+		}
+		clear();
+		_copy_from(p_from);
+	}
+
+	DictionaryStorage() {}
+	DictionaryStorage(const DictionaryStorage &p_from) {
+		_copy_from(p_from);
+	}
+	~DictionaryStorage() {
+		_clear_inline();
+		if (inline_slots) {
+			memdelete(inline_slots);
+		}
+	}
+};
+
 struct DictionaryPrivate {
 	SafeRefCount refcount;
 	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
-	HashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
+	DictionaryStorage variant_map;
 };
 
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
@@ -109,55 +336,43 @@ const Variant &Dictionary::operator[](const Variant &p_key) const {
 }
 
 const Variant *Dictionary::getptr(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstIterator E;
+	const DictionaryStorage &storage = _p->variant_map;
 
 	if (p_key.get_type() == Variant::STRING_NAME) {
 		const StringName *sn = VariantInternal::get_string_name(&p_key);
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(sn->operator String());
+		return storage.getptr(sn->operator String());
 	} else {
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
+		return storage.getptr(p_key);
 	}
-
-	if (!E) {
-		return nullptr;
-	}
-	return &E->value;
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::Iterator E;
+	Variant *value;
 
 	if (p_key.get_type() == Variant::STRING_NAME) {
 		const StringName *sn = VariantInternal::get_string_name(&p_key);
-		E = ((HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(sn->operator String());
+		value = _p->variant_map.getptr(sn->operator String());
 	} else {
-		E = ((HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
+		value = _p->variant_map.getptr(p_key);
 	}
-	if (!E) {
+	if (!value) {
 		return nullptr;
 	}
 	if (unlikely(_p->read_only != nullptr)) {
-		*_p->read_only = E->value;
+		*_p->read_only = *value;
 		return _p->read_only;
 	} else {
-		return &E->value;
+		return value;
 	}
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstIterator E;
-
-	if (p_key.get_type() == Variant::STRING_NAME) {
-		const StringName *sn = VariantInternal::get_string_name(&p_key);
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(sn->operator String());
-	} else {
-		E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
-	}
+	const Variant *value = getptr(p_key);
 
-	if (!E) {
+	if (!value) {
 		return Variant();
 	}
-	return E->value;
+	return *value;
 }
 
 Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
@@ -228,9 +443,10 @@ bool Dictionary::recursive_equal(const Dictionary &p_dictionary, int recursion_c
 		return true;
 	}
 	recursion_count++;
+	const DictionaryStorage &other_storage = p_dictionary._p->variant_map;
 	for (const KeyValue<Variant, Variant> &this_E : _p->variant_map) {
-		HashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstIterator other_E = ((const HashMap<Variant, Variant, VariantHasher, VariantComparator> *)&p_dictionary._p->variant_map)->find(this_E.key);
-		if (!other_E || !this_E.value.hash_compare(other_E->value, recursion_count)) {
+		const Variant *other_value = other_storage.getptr(this_E.key);
+		if (!other_value || !this_E.value.hash_compare(*other_value, recursion_count)) {
 			return false;
 		}
 	}
@@ -344,22 +560,17 @@ Array Dictionary::values() const {
 }
 
 const Variant *Dictionary::next(const Variant *p_key) const {
+	const DictionaryStorage &storage = _p->variant_map;
+	DictionaryStorage::ConstIterator E;
+
 	if (p_key == nullptr) {
 		// caller wants to get the first element
-		if (_p->variant_map.begin()) {
-			return &_p->variant_map.begin()->key;
-		}
-		return nullptr;
-	}
-	HashMap<Variant, Variant, VariantHasher, VariantComparator>::Iterator E = _p->variant_map.find(*p_key);
-
-	if (!E) {
-		return nullptr;
+		E = storage.begin();
+	} else {
+		E = storage.next(*p_key);
 	}
 
-	++E;
-
-	if (E) {
+	if (E != storage.end()) {
 		return &E->key;
 	}
 
@@ -37,6 +37,7 @@
 #include "core/io/resource.h"
 #include "core/math/math_funcs.h"
 #include "core/string/print_string.h"
+#include "core/variant/variant_internal.h"
 #include "core/variant/variant_parser.h"
 
 String Variant::get_type_name(Variant::Type p_type) {
@@ -2055,15 +2056,41 @@ Variant::operator Signal() const {
 }
 
 template <class DA, class SA>
-inline DA _convert_array(const SA &p_array) {
-	DA da;
-	da.resize(p_array.size());
+struct VariantArrayConverter {
+	static DA convert(const SA &p_array) {
+		DA da;
+		da.resize(p_array.size());
 
-	for (int i = 0; i < p_array.size(); i++) {
-		da.set(i, Variant(p_array.get(i)));
+		for (int i = 0; i < p_array.size(); i++) {
+			da.set(i, Variant(p_array.get(i)));
+		}
+
+		return da;
 	}
+};
 
-	return da;
+// Conversions between Array and packed arrays work on the elements in bulk.
+template <class T>
+struct VariantArrayConverter<Array, Vector<T>> {
+	static Array convert(const Vector<T> &p_array) {
+		Array da;
+		_convert_packed_to_array(p_array, da);
+		return da;
+	}
+};
+
+template <class T>
+struct VariantArrayConverter<Vector<T>, Array> {
+	static Vector<T> convert(const Array &p_array) {
+		Vector<T> da;
+		_convert_array_to_packed(p_array, da);
+		return da;
+	}
+};
+
+template <class DA, class SA>
+inline DA _convert_array(const SA &p_array) {
+	return VariantArrayConverter<DA, SA>::convert(p_array);
 }
 
 template <class DA>
@@ -348,11 +348,7 @@ public:
 		Array &dst_arr = *VariantGetInternalPtr<Array>::get_ptr(&r_ret);
 		const T &src_arr = *VariantGetInternalPtr<T>::get_ptr(p_args[0]);
 
-		int size = src_arr.size();
-		dst_arr.resize(size);
-		for (int i = 0; i < size; i++) {
-			dst_arr[i] = src_arr[i];
-		}
+		_convert_packed_to_array(src_arr, dst_arr);
 	}
 
 	static inline void validated_construct(Variant *r_ret, const Variant **p_args) {
@@ -360,21 +356,13 @@ public:
 		Array &dst_arr = *VariantGetInternalPtr<Array>::get_ptr(r_ret);
 		const T &src_arr = *VariantGetInternalPtr<T>::get_ptr(p_args[0]);
 
-		int size = src_arr.size();
-		dst_arr.resize(size);
-		for (int i = 0; i < size; i++) {
-			dst_arr[i] = src_arr[i];
-		}
+		_convert_packed_to_array(src_arr, dst_arr);
 	}
 	static void ptr_construct(void *base, const void **p_args) {
 		Array dst_arr;
 		T src_arr = PtrToArg<T>::convert(p_args[0]);
 
-		int size = src_arr.size();
-		dst_arr.resize(size);
-		for (int i = 0; i < size; i++) {
-			dst_arr[i] = src_arr[i];
-		}
+		_convert_packed_to_array(src_arr, dst_arr);
 
 		PtrConstruct<Array>::construct(dst_arr, base);
 	}
@@ -407,11 +395,7 @@ public:
 		const Array &src_arr = *VariantGetInternalPtr<Array>::get_ptr(p_args[0]);
 		T &dst_arr = *VariantGetInternalPtr<T>::get_ptr(&r_ret);
 
-		int size = src_arr.size();
-		dst_arr.resize(size);
-		for (int i = 0; i < size; i++) {
-			dst_arr.write[i] = src_arr[i];
-		}
+		_convert_array_to_packed(src_arr, dst_arr);
 	}
 
 	static inline void validated_construct(Variant *r_ret, const Variant **p_args) {
@@ -419,21 +403,13 @@ public:
 		const Array &src_arr = *VariantGetInternalPtr<Array>::get_ptr(p_args[0]);
 		T &dst_arr = *VariantGetInternalPtr<T>::get_ptr(r_ret);
 
-		int size = src_arr.size();
-		dst_arr.resize(size);
-		for (int i = 0; i < size; i++) {
-			dst_arr.write[i] = src_arr[i];
-		}
+		_convert_array_to_packed(src_arr, dst_arr);
 	}
 	static void ptr_construct(void *base, const void **p_args) {
 		Array src_arr = PtrToArg<Array>::convert(p_args[0]);
 		T dst_arr;
 
-		int size = src_arr.size();
-		dst_arr.resize(size);
-		for (int i = 0; i < size; i++) {
-			dst_arr.write[i] = src_arr[i];
-		}
+		_convert_array_to_packed(src_arr, dst_arr);
 
 		PtrConstruct<T>::construct(dst_arr, base);
 	}
@@ -1459,4 +1459,60 @@ struct VariantTypeConstructor<Object *> {
 	}
 };
 
+// Variant type storing the elements of a packed array.
+template <class T>
+struct PackedArrayElementStorage {};
+
+#define MAKE_PACKED_ARRAY_ELEMENT_STORAGE(m_type, m_storage, m_variant_type) \
+	template <>                                                            \
+	struct PackedArrayElementStorage<m_type> {                             \
+		typedef m_storage Type;                                            \
+		static const Variant::Type VARIANT_TYPE = m_variant_type;          \
+	};
+
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(uint8_t, int64_t, Variant::INT);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(int32_t, int64_t, Variant::INT);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(int64_t, int64_t, Variant::INT);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(float, double, Variant::FLOAT);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(double, double, Variant::FLOAT);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(String, String, Variant::STRING);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(Vector2, Vector2, Variant::VECTOR2);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(Vector3, Vector3, Variant::VECTOR3);
+MAKE_PACKED_ARRAY_ELEMENT_STORAGE(Color, Color, Variant::COLOR);
+
+template <class T>
+_FORCE_INLINE_ void _convert_packed_to_array(const Vector<T> &p_src, Array &r_dst) {
+	int size = p_src.size();
+	r_dst.resize(size);
+	if (size == 0) {
+		return;
+	}
+	Variant *w = r_dst.ptrw();
+	const T *r = p_src.ptr();
+	for (int i = 0; i < size; i++) {
+		w[i] = r[i];
+	}
+}
+
+template <class T>
+_FORCE_INLINE_ void _convert_array_to_packed(const Array &p_src, Vector<T> &r_dst) {
+	typedef PackedArrayElementStorage<T> E;
+
+	int size = p_src.size();
+	r_dst.resize(size);
+	if (size == 0) {
+		return;
+	}
+	T *w = r_dst.ptrw();
+	const Variant *r = p_src.ptr();
+	for (int i = 0; i < size; i++) {
+		// Elements already of the packed type, as in a matching typed array, are read in place.
+		if (r[i].get_type() == E::VARIANT_TYPE) {
+			w[i] = T(*VariantGetInternalPtr<typename E::Type>::get_ptr(&r[i]));
+		} else {
+			w[i] = r[i];
+		}
+	}
+}
+
 #endif // VARIANT_INTERNAL_H
@@ -0,0 +1,258 @@
+/*************************************************************************/
+/*  file_access_unix_mapped.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_access_unix_mapped.h"
+
+#if defined(UNIX_ENABLED)
+
+#include "core/io/marshalls.h"
+#include "core/string/print_string.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+Error FileAccessUnixMapped::_open(const String &p_path, int p_mode_flags) {
+	_close();
+
+	ERR_FAIL_COND_V_MSG(p_mode_flags != READ, ERR_UNAVAILABLE, "Memory-mapped files can only be opened for reading.");
+
+	path_src = p_path;
+	path = fix_path(p_path);
+
+	int fd = ::open(path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return errno == ENOENT ? ERR_FILE_NOT_FOUND : ERR_FILE_CANT_OPEN;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		return ERR_FILE_CANT_OPEN;
+	}
+
+	// mmap() refuses empty ranges, an empty file is simply open with no data.
+	if (st.st_size > 0) {
+		void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			::close(fd);
+			return ERR_FILE_CANT_OPEN;
+		}
+		data = (const uint8_t *)mapping;
+		length = st.st_size;
+	}
+
+	// The mapping keeps the file contents alive, the descriptor is no longer needed.
+	::close(fd);
+
+	pos = 0;
+	eof = false;
+	opened = true;
+	return OK;
+}
+
+void FileAccessUnixMapped::_close() {
+	if (data) {
+		munmap((void *)data, length);
+	}
+	data = nullptr;
+	length = 0;
+	opened = false;
+}
+
+bool FileAccessUnixMapped::is_open() const {
+	return opened;
+}
+
+String FileAccessUnixMapped::get_path() const {
+	return path_src;
+}
+
+String FileAccessUnixMapped::get_path_absolute() const {
+	return path;
+}
+
+void FileAccessUnixMapped::seek(uint64_t p_position) {
+	ERR_FAIL_COND_MSG(!opened, "File must be opened before use.");
+
+	pos = p_position;
+	eof = false;
+}
+
+void FileAccessUnixMapped::seek_end(int64_t p_position) {
+	ERR_FAIL_COND_MSG(!opened, "File must be opened before use.");
+
+	int64_t new_pos = (int64_t)length + p_position;
+	ERR_FAIL_COND(new_pos < 0);
+	seek(new_pos);
+}
+
+uint64_t FileAccessUnixMapped::get_position() const {
+	ERR_FAIL_COND_V_MSG(!opened, 0, "File must be opened before use.");
+	return pos;
+}
+
+uint64_t FileAccessUnixMapped::get_length() const {
+	ERR_FAIL_COND_V_MSG(!opened, 0, "File must be opened before use.");
+	return length;
+}
+
+bool FileAccessUnixMapped::eof_reached() const {
+	return eof;
+}
+
+uint8_t FileAccessUnixMapped::get_8() const {
+	ERR_FAIL_COND_V_MSG(!opened, 0, "File must be opened before use.");
+	if (pos >= length) {
+		eof = true;
+		return 0;
+	}
+	return data[pos++];
+}
+
+uint16_t FileAccessUnixMapped::get_16() const {
+	if (pos + 2 > length) {
+		return FileAccess::get_16();
+	}
+	uint16_t res = decode_uint16(data + pos);
+	pos += 2;
+	return big_endian ? BSWAP16(res) : res;
+}
+
+uint32_t FileAccessUnixMapped::get_32() const {
+	if (pos + 4 > length) {
+		return FileAccess::get_32();
+	}
+	uint32_t res = decode_uint32(data + pos);
+	pos += 4;
+	return big_endian ? BSWAP32(res) : res;
+}
+
+uint64_t FileAccessUnixMapped::get_64() const {
+	if (pos + 8 > length) {
+		return FileAccess::get_64();
+	}
+	uint64_t res = decode_uint64(data + pos);
+	pos += 8;
+	return big_endian ? BSWAP64(res) : res;
+}
+
+uint64_t FileAccessUnixMapped::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
+	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
+	ERR_FAIL_COND_V_MSG(!opened, -1, "File must be opened before use.");
+
+	uint64_t to_read = p_length;
+	if (pos >= length) {
+		to_read = 0;
+	} else if (to_read > length - pos) {
+		to_read = length - pos;
+	}
+	if (to_read < p_length) {
+		eof = true;
+	}
+
+	if (to_read > 0) {
+		memcpy(p_dst, data + pos, to_read);
+		pos += to_read;
+	}
+	return to_read;
+}
+
+const uint8_t *FileAccessUnixMapped::get_mapped_span(uint64_t p_offset, uint64_t p_length) const {
+	if (!data || p_offset > length || p_length > length - p_offset) {
+		return nullptr;
+	}
+	return data + p_offset;
+}
+
+Error FileAccessUnixMapped::get_error() const {
+	return eof ? ERR_FILE_EOF : OK;
+}
+
+void FileAccessUnixMapped::flush() {
+	ERR_FAIL();
+}
+
+void FileAccessUnixMapped::store_8(uint8_t p_dest) {
+	ERR_FAIL();
+}
+
+void FileAccessUnixMapped::store_buffer(const uint8_t *p_src, uint64_t p_length) {
+	ERR_FAIL();
+}
+
+bool FileAccessUnixMapped::file_exists(const String &p_path) {
+	struct stat st;
+	String filename = fix_path(p_path);
+
+	if (stat(filename.utf8().get_data(), &st) != 0) {
+		return false;
+	}
+	return S_ISREG(st.st_mode) && access(filename.utf8().get_data(), R_OK) == 0;
+}
+
+uint64_t FileAccessUnixMapped::_get_modified_time(const String &p_file) {
+	String file = fix_path(p_file);
+	struct stat flags;
+	int err = stat(file.utf8().get_data(), &flags);
+
+	if (!err) {
+		return flags.st_mtime;
+	} else {
+		print_verbose("Failed to get modified time for: " + p_file + "");
+		return 0;
+	}
+}
+
+uint32_t FileAccessUnixMapped::_get_unix_permissions(const String &p_file) {
+	String file = fix_path(p_file);
+	struct stat flags;
+	int err = stat(file.utf8().get_data(), &flags);
+
+	if (!err) {
+		return flags.st_mode & 0x7FF; //only permissions
+	} else {
+		ERR_FAIL_V_MSG(0, "Failed to get unix permissions for: " + p_file + ".");
+	}
+}
+
+Error FileAccessUnixMapped::_set_unix_permissions(const String &p_file, uint32_t p_permissions) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Memory-mapped files are read-only.");
+}
+
+FileAccessUnixMapped::~FileAccessUnixMapped() {
+	_close();
+}
+
+#endif
@@ -0,0 +1,92 @@
+/*************************************************************************/
+/*  file_access_unix_mapped.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_ACCESS_UNIX_MAPPED_H
+#define FILE_ACCESS_UNIX_MAPPED_H
+
+#include "core/io/file_access.h"
+
+#if defined(UNIX_ENABLED)
+
+// Read-only file access backed by mmap(). Reads are plain memory copies out of
+// the page cache, and get_mapped_span() exposes the mapping without copying.
+// If the file is truncated while mapped, touching the lost pages raises SIGBUS,
+// FileAccess::open_mapped() only picks this for files that shouldn't change.
+class FileAccessUnixMapped : public FileAccess {
+	const uint8_t *data = nullptr;
+	uint64_t length = 0;
+	mutable uint64_t pos = 0;
+	mutable bool eof = false;
+	bool opened = false;
+	String path;
+	String path_src;
+
+	void _close();
+
+public:
+	virtual Error _open(const String &p_path, int p_mode_flags); ///< open a file
+	virtual bool is_open() const; ///< true when file is open
+
+	virtual String get_path() const; /// returns the path for the current open file
+	virtual String get_path_absolute() const; /// returns the absolute path for the current open file
+
+	virtual void seek(uint64_t p_position); ///< seek to a given position
+	virtual void seek_end(int64_t p_position = 0); ///< seek from the end of file
+	virtual uint64_t get_position() const; ///< get position in the file
+	virtual uint64_t get_length() const; ///< get size of the file
+
+	virtual bool eof_reached() const; ///< reading passed EOF
+
+	virtual uint8_t get_8() const; ///< get a byte
+	virtual uint16_t get_16() const;
+	virtual uint32_t get_32() const;
+	virtual uint64_t get_64() const;
+	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+
+	virtual const uint8_t *get_mapped_span(uint64_t p_offset, uint64_t p_length) const;
+
+	virtual Error get_error() const; ///< get last error
+
+	virtual void flush();
+	virtual void store_8(uint8_t p_dest); ///< store a byte
+	virtual void store_buffer(const uint8_t *p_src, uint64_t p_length); ///< store an array of bytes
+
+	virtual bool file_exists(const String &p_path); ///< return true if a file exists
+
+	virtual uint64_t _get_modified_time(const String &p_file);
+	virtual uint32_t _get_unix_permissions(const String &p_file);
+	virtual Error _set_unix_permissions(const String &p_file, uint32_t p_permissions);
+
+	FileAccessUnixMapped() {}
+	virtual ~FileAccessUnixMapped();
+};
+
+#endif
+#endif // FILE_ACCESS_UNIX_MAPPED_H
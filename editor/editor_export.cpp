@@ -42,6 +42,7 @@
 #include "core/io/resource_saver.h"
 #include "core/io/zip_io.h"
 #include "core/object/script_language.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/version.h"
 #include "editor/editor_file_system.h"
 #include "editor/editor_node.h"
@@ -62,6 +63,7 @@ static int _get_pad(int p_alignment, int p_n) {
 }
 
 #define PCK_PADDING 16
+#define PCK_COMPRESSION_BATCH_SIZE (64 * 1024 * 1024)
 
 bool EditorExportPreset::_set(const StringName &p_name, const Variant &p_value) {
 	if (values.has(p_name)) {
@@ -380,35 +382,21 @@ void EditorExportPlatform::gen_debug_flags(Vector<String> &r_flags, int p_flags)
 	}
 }
 
-Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total, const Vector<String> &p_enc_in_filters, const Vector<String> &p_enc_ex_filters, const Vector<uint8_t> &p_key) {
-	ERR_FAIL_COND_V_MSG(p_total < 1, ERR_PARAMETER_RANGE_ERROR, "Must select at least one file to export.");
-
-	PackData *pd = (PackData *)p_userdata;
-
-	SavedData sd;
-	sd.path_utf8 = p_path.utf8();
-	sd.ofs = pd->f->get_position();
-	sd.size = p_data.size();
-	sd.encrypted = false;
-
-	for (int i = 0; i < p_enc_in_filters.size(); ++i) {
-		if (p_path.matchn(p_enc_in_filters[i]) || p_path.replace("res://", "").matchn(p_enc_in_filters[i])) {
-			sd.encrypted = true;
-			break;
-		}
+void EditorExportPlatform::PackData::compress_pending(uint32_t p_index, void *p_userdata) {
+	PendingFile &pf = pending.write[p_index];
+	if (!PackedData::compress_file(pf.data, compression_mode, compression_max_ratio, pf.compressed, zstd_dict)) {
+		pf.compressed.clear();
 	}
+}
 
-	for (int i = 0; i < p_enc_ex_filters.size(); ++i) {
-		if (p_path.matchn(p_enc_ex_filters[i]) || p_path.replace("res://", "").matchn(p_enc_ex_filters[i])) {
-			sd.encrypted = false;
-			break;
-		}
-	}
+Error EditorExportPlatform::_store_pack_file(PackData *p_pd, SavedData &p_sd, const Vector<uint8_t> &p_stored, const Vector<uint8_t> &p_key) {
+	p_sd.ofs = p_pd->f->get_position();
+	p_sd.size = p_stored.size();
 
 	Ref<FileAccessEncrypted> fae;
-	Ref<FileAccess> ftmp = pd->f;
+	Ref<FileAccess> ftmp = p_pd->f;
 
-	if (sd.encrypted) {
+	if (p_sd.encrypted) {
 		fae.instantiate();
 		ERR_FAIL_COND_V(fae.is_null(), ERR_SKIP);
 
@@ -418,16 +406,94 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 	}
 
 	// Store file content.
-	ftmp->store_buffer(p_data.ptr(), p_data.size());
+	ftmp->store_buffer(p_stored.ptr(), p_stored.size());
 
 	if (fae.is_valid()) {
 		ftmp.unref();
 		fae.unref();
 	}
 
-	int pad = _get_pad(PCK_PADDING, pd->f->get_position());
+	int pad = _get_pad(PCK_PADDING, p_pd->f->get_position());
 	for (int i = 0; i < pad; i++) {
-		pd->f->store_8(Math::rand() % 256);
+		p_pd->f->store_8(Math::rand() % 256);
+	}
+
+	p_pd->file_ofs.push_back(p_sd);
+	return OK;
+}
+
+Error EditorExportPlatform::_flush_pending_pack_files(PackData *p_pd) {
+	if (p_pd->pending.is_empty()) {
+		return OK;
+	}
+
+	if (p_pd->zstd_dictionary && !p_pd->zstd_dictionary_trained && p_pd->compression_mode == Compression::MODE_ZSTD) {
+		p_pd->zstd_dictionary_trained = true;
+		Vector<Vector<uint8_t>> files;
+		for (int i = 0; i < p_pd->pending.size(); i++) {
+			files.push_back(p_pd->pending[i].data);
+		}
+		Vector<uint8_t> dict_data = PackedData::build_zstd_dictionary(files);
+		if (!dict_data.is_empty()) {
+			p_pd->zstd_dict = Compression::zstd_dictionary_create(dict_data);
+		}
+		if (p_pd->zstd_dict) {
+			SavedData sd;
+			sd.path_utf8 = String(PACK_ZSTD_DICTIONARY_PATH).utf8();
+			sd.zstd_dictionary = true;
+			sd.md5.resize(16);
+			CryptoCore::md5(dict_data.ptr(), dict_data.size(), sd.md5.ptrw());
+			Error err = _store_pack_file(p_pd, sd, dict_data, p_pd->key);
+			if (err != OK) {
+				return err;
+			}
+		}
+	}
+
+	if (p_pd->pending.size() > 1 && OS::get_singleton()->get_processor_count() > 1) {
+		ThreadWorkPool pool;
+		pool.init();
+		pool.do_work(p_pd->pending.size(), p_pd, &PackData::compress_pending, nullptr);
+		pool.finish();
+	} else {
+		for (int i = 0; i < p_pd->pending.size(); i++) {
+			p_pd->compress_pending(i, nullptr);
+		}
+	}
+
+	Error err = OK;
+	for (int i = 0; i < p_pd->pending.size() && err == OK; i++) {
+		PackData::PendingFile &pf = p_pd->pending.write[i];
+		pf.sd.compressed = !pf.compressed.is_empty();
+		err = _store_pack_file(p_pd, pf.sd, pf.sd.compressed ? pf.compressed : pf.data, p_pd->key);
+	}
+
+	p_pd->pending.clear();
+	p_pd->pending_size = 0;
+	return err;
+}
+
+Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total, const Vector<String> &p_enc_in_filters, const Vector<String> &p_enc_ex_filters, const Vector<uint8_t> &p_key) {
+	ERR_FAIL_COND_V_MSG(p_total < 1, ERR_PARAMETER_RANGE_ERROR, "Must select at least one file to export.");
+
+	PackData *pd = (PackData *)p_userdata;
+
+	SavedData sd;
+	sd.path_utf8 = p_path.utf8();
+	sd.encrypted = false;
+
+	for (int i = 0; i < p_enc_in_filters.size(); ++i) {
+		if (p_path.matchn(p_enc_in_filters[i]) || p_path.replace("res://", "").matchn(p_enc_in_filters[i])) {
+			sd.encrypted = true;
+			break;
+		}
+	}
+
+	for (int i = 0; i < p_enc_ex_filters.size(); ++i) {
+		if (p_path.matchn(p_enc_ex_filters[i]) || p_path.replace("res://", "").matchn(p_enc_ex_filters[i])) {
+			sd.encrypted = false;
+			break;
+		}
 	}
 
 	// Store MD5 of original file.
@@ -440,7 +506,23 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 		}
 	}
 
-	pd->file_ofs.push_back(sd);
+	Error err;
+	if (pd->compress) {
+		PackData::PendingFile pf;
+		pf.sd = sd;
+		pf.data = p_data;
+		pd->pending.push_back(pf);
+		pd->pending_size += p_data.size();
+		pd->key = p_key;
+
+		// Bound the memory held by the batch, the data of every file is kept until it's stored.
+		err = pd->pending_size >= PCK_COMPRESSION_BATCH_SIZE ? _flush_pending_pack_files(pd) : OK;
+	} else {
+		err = _store_pack_file(pd, sd, p_data, p_key);
+	}
+	if (err != OK) {
+		return err;
+	}
 
 	if (pd->ep->step(TTR("Storing File:") + " " + p_path, 2 + p_file * 100 / p_total, false)) {
 		return ERR_SKIP;
@@ -1221,8 +1303,19 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 	pd.ep = &ep;
 	pd.f = ftmp;
 	pd.so_files = p_so_files;
+	pd.compress = GLOBAL_GET("editor/export/compress_pck");
+	pd.compression_mode = (Compression::Mode)(int)GLOBAL_GET("editor/export/pck_compression_mode");
+	pd.compression_max_ratio = GLOBAL_GET("editor/export/pck_compression_max_ratio");
+	pd.zstd_dictionary = GLOBAL_GET("editor/export/pck_compression_zstd_dictionary");
 
 	Error err = export_project_files(p_preset, p_debug, _save_pack_file, &pd, _add_shared_object);
+	if (err == OK) {
+		err = _flush_pending_pack_files(&pd);
+	}
+	if (pd.zstd_dict) {
+		Compression::zstd_dictionary_free(pd.zstd_dict);
+		pd.zstd_dict = nullptr;
+	}
 
 	// Close temp file.
 	pd.f.unref();
@@ -1359,6 +1452,12 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		if (pd.file_ofs[i].encrypted) {
 			flags |= PACK_FILE_ENCRYPTED;
 		}
+		if (pd.file_ofs[i].compressed) {
+			flags |= PACK_FILE_COMPRESSED;
+		}
+		if (pd.file_ofs[i].zstd_dictionary) {
+			flags |= PACK_FILE_ZSTD_DICTIONARY;
+		}
 		fhead->store_32(flags);
 	}
 
@@ -1813,6 +1912,13 @@ bool EditorExport::poll_export_platforms() {
 }
 
 EditorExport::EditorExport() {
+	GLOBAL_DEF("editor/export/compress_pck", false);
+	GLOBAL_DEF("editor/export/pck_compression_mode", Compression::MODE_ZSTD);
+	ProjectSettings::get_singleton()->set_custom_property_info("editor/export/pck_compression_mode", PropertyInfo(Variant::INT, "editor/export/pck_compression_mode", PROPERTY_HINT_ENUM, "FastLZ,Deflate,Zstd,GZip"));
+	GLOBAL_DEF("editor/export/pck_compression_max_ratio", 0.9);
+	ProjectSettings::get_singleton()->set_custom_property_info("editor/export/pck_compression_max_ratio", PropertyInfo(Variant::FLOAT, "editor/export/pck_compression_max_ratio", PROPERTY_HINT_RANGE, "0.1,1,0.01"));
+	GLOBAL_DEF("editor/export/pck_compression_zstd_dictionary", false);
+
 	save_timer = memnew(Timer);
 	add_child(save_timer);
 	save_timer->set_wait_time(0.8);
@@ -31,6 +31,7 @@
 #ifndef EDITOR_EXPORT_H
 #define EDITOR_EXPORT_H
 
+#include "core/io/compression.h"
 #include "core/io/dir_access.h"
 #include "core/io/resource.h"
 #include "scene/gui/rich_text_label.h"
@@ -189,6 +190,8 @@ private:
 		uint64_t ofs = 0;
 		uint64_t size = 0;
 		bool encrypted = false;
+		bool compressed = false;
+		bool zstd_dictionary = false;
 		Vector<uint8_t> md5;
 		CharString path_utf8;
 
@@ -202,6 +205,25 @@ private:
 		Vector<SavedData> file_ofs;
 		EditorProgress *ep = nullptr;
 		Vector<SharedObject> *so_files = nullptr;
+
+		// Files waiting to be compressed as a batch, in parallel, before being stored in order.
+		struct PendingFile {
+			SavedData sd;
+			Vector<uint8_t> data;
+			Vector<uint8_t> compressed;
+		};
+
+		bool compress = false;
+		Compression::Mode compression_mode = Compression::MODE_ZSTD;
+		float compression_max_ratio = 0.9;
+		bool zstd_dictionary = false; // Train a dictionary on the first batch.
+		bool zstd_dictionary_trained = false;
+		Compression::ZstdDictionary *zstd_dict = nullptr;
+		Vector<PendingFile> pending;
+		uint64_t pending_size = 0;
+		Vector<uint8_t> key;
+
+		void compress_pending(uint32_t p_index, void *p_userdata);
 	};
 
 	struct ZipData {
@@ -220,6 +242,8 @@ private:
 	void _export_find_dependencies(const String &p_path, HashSet<String> &p_paths);
 
 	void gen_debug_flags(Vector<String> &r_flags, int p_flags);
+	static Error _store_pack_file(PackData *p_pd, SavedData &p_sd, const Vector<uint8_t> &p_stored, const Vector<uint8_t> &p_key);
+	static Error _flush_pending_pack_files(PackData *p_pd);
 	static Error _save_pack_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total, const Vector<String> &p_enc_in_filters, const Vector<String> &p_enc_ex_filters, const Vector<uint8_t> &p_key);
 	static Error _save_zip_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total, const Vector<String> &p_enc_in_filters, const Vector<String> &p_enc_ex_filters, const Vector<uint8_t> &p_key);
 
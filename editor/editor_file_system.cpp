@@ -32,15 +32,19 @@
 
 #include "core/config/project_settings.h"
 #include "core/extension/native_extension_manager.h"
+#include "core/io/config_file.h"
 #include "core/io/file_access.h"
 #include "core/io/resource_importer.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/object/message_queue.h"
 #include "core/os/os.h"
 #include "core/variant/variant_parser.h"
+#include "core/version.h"
 #include "editor/editor_node.h"
 #include "editor/editor_resource_preview.h"
 #include "editor/editor_settings.h"
+#include "servers/rendering_server.h"
 
 EditorFileSystem *EditorFileSystem::singleton = nullptr;
 //the name is the version, to keep compatibility with different versions of Godot
@@ -1808,6 +1812,122 @@ Error EditorFileSystem::_reimport_group(const String &p_group_file, const Vector
 	return err;
 }
 
+String EditorFileSystem::_get_import_cache_dir(const String &p_file, const Ref<ResourceImporter> &p_importer, const List<ResourceImporter::ImportOption> &p_options, const HashMap<StringName, Variant> &p_params) const {
+	String cache_path = EditorSettings::get_singleton()->get("filesystem/import/shared_cache_path");
+	if (cache_path.is_empty()) {
+		return String();
+	}
+
+	String source_hash = FileAccess::get_sha256(p_file);
+	if (source_hash.is_empty()) {
+		return String();
+	}
+
+	// Everything the imported files depend on, as declared by ResourceImporter::can_import_cached().
+	String key = String(VERSION_FULL_BUILD) + "\n" + source_hash + "\n" + p_importer->get_importer_name() + "\n" + itos(p_importer->get_format_version()) + "\n" + p_importer->get_import_settings_string() + "\n";
+	for (const ResourceImporter::ImportOption &E : p_options) {
+		String value;
+		VariantWriter::write_to_string(p_params[E.option.name], value);
+		key += String(E.option.name) + "=" + value + "\n";
+	}
+	key = key.sha256_text();
+
+	return cache_path.plus_file(key.substr(0, 2)).plus_file(key);
+}
+
+static Error _copy_import_cache_file(const String &p_from, const String &p_to) {
+	Error err;
+	Vector<uint8_t> data = FileAccess::get_file_as_array(p_from, &err);
+	if (err != OK) {
+		return err;
+	}
+
+	Ref<FileAccess> f = FileAccess::open(p_to, FileAccess::WRITE, &err);
+	if (f.is_null()) {
+		return err;
+	}
+	f->store_buffer(data.ptr(), data.size());
+
+	return f->get_error();
+}
+
+bool EditorFileSystem::_import_from_cache(const String &p_cache_dir, const String &p_base_path, List<String> *r_import_variants, Variant *r_metadata) const {
+	Ref<ConfigFile> entry;
+	entry.instantiate();
+	if (entry->load(p_cache_dir.plus_file("entry.cfg")) != OK) {
+		return false;
+	}
+
+	Vector<String> files = entry->get_value("import", "files", Vector<String>());
+	for (int i = 0; i < files.size(); i++) {
+		if (_copy_import_cache_file(p_cache_dir.plus_file(files[i]), p_base_path + "." + files[i]) != OK) {
+			return false;
+		}
+	}
+
+	Vector<String> variants = entry->get_value("import", "variants", Vector<String>());
+	for (int i = 0; i < variants.size(); i++) {
+		r_import_variants->push_back(variants[i]);
+	}
+	*r_metadata = entry->get_value("import", "metadata", Variant());
+
+	return true;
+}
+
+void EditorFileSystem::_store_in_import_cache(const String &p_cache_dir, const String &p_base_path, const String &p_save_extension, const List<String> &p_import_variants, const Variant &p_metadata) const {
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->dir_exists(p_cache_dir)) {
+		return;
+	}
+
+	// Fill a private directory first and move it in place, so other editors sharing the cache never see a partial entry.
+	String tmp_dir = p_cache_dir + vformat(".%d-%d.tmp", OS::get_singleton()->get_process_id(), Thread::get_caller_id());
+	if (da->make_dir_recursive(tmp_dir) != OK) {
+		return;
+	}
+
+	Vector<String> files;
+	if (p_import_variants.size()) {
+		for (const String &E : p_import_variants) {
+			files.push_back(E + "." + p_save_extension);
+		}
+	} else {
+		files.push_back(p_save_extension);
+	}
+
+	Error err = OK;
+	for (int i = 0; i < files.size() && err == OK; i++) {
+		err = _copy_import_cache_file(p_base_path + "." + files[i], tmp_dir.plus_file(files[i]));
+	}
+
+	if (err == OK) {
+		Vector<String> variants;
+		for (const String &E : p_import_variants) {
+			variants.push_back(E);
+		}
+
+		Ref<ConfigFile> entry;
+		entry.instantiate();
+		entry->set_value("import", "files", files);
+		entry->set_value("import", "variants", variants);
+		entry->set_value("import", "metadata", p_metadata);
+		err = entry->save(tmp_dir.plus_file("entry.cfg"));
+	}
+
+	if (err == OK) {
+		err = da->rename(tmp_dir, p_cache_dir);
+	}
+
+	if (err != OK) {
+		// Failed, or another editor stored the same entry meanwhile.
+		Ref<DirAccess> tmp = DirAccess::open(tmp_dir);
+		if (tmp.is_valid()) {
+			tmp->erase_contents_recursive();
+		}
+		da->remove(tmp_dir);
+	}
+}
+
 void EditorFileSystem::_reimport_file(const String &p_file, const HashMap<StringName, Variant> *p_custom_options, const String &p_custom_importer) {
 	EditorFileSystemDirectory *fs = nullptr;
 	int cpos = -1;
@@ -1911,7 +2031,19 @@ void EditorFileSystem::_reimport_file(const String &p_file, const HashMap<String
 	List<String> import_variants;
 	List<String> gen_files;
 	Variant metadata;
-	Error err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &metadata);
+	Error err = OK;
+
+	String import_cache_dir;
+	if (!importer->get_save_extension().is_empty() && importer->can_import_cached(params)) {
+		import_cache_dir = _get_import_cache_dir(p_file, importer, opts, params);
+	}
+
+	if (import_cache_dir.is_empty() || !_import_from_cache(import_cache_dir, base_path, &import_variants, &metadata)) {
+		err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &metadata);
+		if (err == OK && !import_cache_dir.is_empty() && gen_files.is_empty()) {
+			_store_in_import_cache(import_cache_dir, base_path, importer->get_save_extension(), import_variants, metadata);
+		}
+	}
 
 	if (err != OK) {
 		ERR_PRINT("Error importing '" + p_file + "'.");
@@ -2144,8 +2276,12 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 							current_index = data.max_index;
 							pr.step(reimport_files[current_index].path.get_file(), current_index);
 						}
+						// Importers creating meshes or other server resources may wait on the main thread to process them,
+						// and run post-import scripts there through the message queue.
+						RenderingServer::get_singleton()->sync();
+						MessageQueue::get_singleton()->flush();
 						OS::get_singleton()->delay_usec(1);
-					} while (!import_threads.is_done_dispatching());
+					} while (!import_threads.is_done_working());
 
 					import_threads.end_work();
 
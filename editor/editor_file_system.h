@@ -32,6 +32,7 @@
 #define EDITOR_FILE_SYSTEM_H
 
 #include "core/io/dir_access.h"
+#include "core/io/resource_importer.h"
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/hash_set.h"
@@ -241,6 +242,9 @@ class EditorFileSystem : public Node {
 	void _update_extensions();
 
 	void _reimport_file(const String &p_file, const HashMap<StringName, Variant> *p_custom_options = nullptr, const String &p_custom_importer = String());
+	String _get_import_cache_dir(const String &p_file, const Ref<ResourceImporter> &p_importer, const List<ResourceImporter::ImportOption> &p_options, const HashMap<StringName, Variant> &p_params) const;
+	bool _import_from_cache(const String &p_cache_dir, const String &p_base_path, List<String> *r_import_variants, Variant *r_metadata) const;
+	void _store_in_import_cache(const String &p_cache_dir, const String &p_base_path, const String &p_save_extension, const List<String> &p_import_variants, const Variant &p_metadata) const;
 	Error _reimport_group(const String &p_group_file, const Vector<String> &p_files);
 
 	bool _test_for_reimport(const String &p_path, bool p_only_imported_files);
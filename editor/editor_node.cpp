@@ -3878,6 +3878,11 @@ void EditorNode::notify_all_debug_sessions_exited() {
 }
 
 void EditorNode::add_io_error(const String &p_error) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		// Importers may run on several threads, the error dialog must be updated from the main one.
+		MessageQueue::get_singleton()->push_callable(callable_mp_static(&EditorNode::add_io_error), p_error);
+		return;
+	}
 	_load_error_notify(singleton, p_error);
 }
 
@@ -4176,6 +4181,10 @@ Ref<Texture2D> EditorNode::get_class_icon(const String &p_class, const String &p
 }
 
 void EditorNode::progress_add_task(const String &p_task, const String &p_label, int p_steps, bool p_can_cancel) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		// Tasks running on worker threads (such as threaded imports) are reported by whoever dispatched them.
+		return;
+	}
 	if (singleton->cmdline_export_mode) {
 		print_line(p_task + ": begin: " + p_label + " steps: " + itos(p_steps));
 	} else {
@@ -4184,6 +4193,9 @@ void EditorNode::progress_add_task(const String &p_task, const String &p_label,
 }
 
 bool EditorNode::progress_task_step(const String &p_task, const String &p_state, int p_step, bool p_force_refresh) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return false;
+	}
 	if (singleton->cmdline_export_mode) {
 		print_line("\t" + p_task + ": step " + itos(p_step) + ": " + p_state);
 		return false;
@@ -4193,6 +4205,9 @@ bool EditorNode::progress_task_step(const String &p_task, const String &p_state,
 }
 
 void EditorNode::progress_end_task(const String &p_task) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return;
+	}
 	if (singleton->cmdline_export_mode) {
 		print_line(p_task + ": end");
 	} else {
@@ -5718,7 +5733,12 @@ void EditorNode::_rendering_driver_selected(int p_which) {
 
 void EditorNode::_resource_saved(Ref<Resource> p_resource, const String &p_path) {
 	if (EditorFileSystem::get_singleton()) {
-		EditorFileSystem::get_singleton()->update_file(p_path);
+		if (Thread::get_caller_id() != Thread::get_main_id()) {
+			// Saved by a threaded import, the file system tree may only be changed from the main thread.
+			MessageQueue::get_singleton()->push_callable(callable_mp(EditorFileSystem::get_singleton(), &EditorFileSystem::update_file), p_path);
+		} else {
+			EditorFileSystem::get_singleton()->update_file(p_path);
+		}
 	}
 
 	singleton->editor_folding.save_resource_folding(p_resource, p_path);
@@ -32,6 +32,7 @@
 
 #include "core/io/file_access.h"
 #include "core/io/resource_saver.h"
+#include "editor/editor_settings.h"
 #include "scene/3d/importer_mesh_instance_3d.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/3d/node_3d.h"
@@ -528,5 +529,9 @@ Error ResourceImporterOBJ::import(const String &p_source_file, const String &p_s
 	return OK;
 }
 
+bool ResourceImporterOBJ::can_import_threaded() const {
+	return EDITOR_GET("filesystem/import/threaded_scene_import");
+}
+
 ResourceImporterOBJ::ResourceImporterOBJ() {
 }
@@ -32,7 +32,9 @@
 
 #include "core/error/error_macros.h"
 #include "core/io/resource_saver.h"
+#include "core/object/message_queue.h"
 #include "editor/editor_node.h"
+#include "editor/editor_settings.h"
 #include "editor/import/scene_import_settings.h"
 #include "scene/3d/area_3d.h"
 #include "scene/3d/collision_shape_3d.h"
@@ -80,6 +82,7 @@ Node *EditorSceneFormatImporter::import_scene(const String &p_path, uint32_t p_f
 		options_dict[elem.key] = elem.value;
 	}
 	Object *ret = nullptr;
+	MutexLock lock(mutex);
 	if (GDVIRTUAL_CALL(_import_scene, p_path, p_flags, options_dict, p_bake_fps, ret)) {
 		return Object::cast_to<Node>(ret);
 	}
@@ -162,11 +165,13 @@ void EditorScenePostImportPlugin::add_import_option_advanced(Variant::Type p_typ
 }
 
 void EditorScenePostImportPlugin::get_internal_import_options(InternalImportCategory p_category, List<ResourceImporter::ImportOption> *r_options) {
+	MutexLock lock(mutex);
 	current_option_list = r_options;
 	GDVIRTUAL_CALL(_get_internal_import_options, p_category);
 	current_option_list = nullptr;
 }
 Variant EditorScenePostImportPlugin::get_internal_option_visibility(InternalImportCategory p_category, bool p_for_animation, const String &p_option, const HashMap<StringName, Variant> &p_options) const {
+	MutexLock lock(mutex);
 	current_options = &p_options;
 	Variant ret;
 	GDVIRTUAL_CALL(_get_internal_option_visibility, p_category, p_for_animation, p_option, ret);
@@ -174,6 +179,7 @@ Variant EditorScenePostImportPlugin::get_internal_option_visibility(InternalImpo
 	return ret;
 }
 Variant EditorScenePostImportPlugin::get_internal_option_update_view_required(InternalImportCategory p_category, const String &p_option, const HashMap<StringName, Variant> &p_options) const {
+	MutexLock lock(mutex);
 	current_options = &p_options;
 	Variant ret;
 	GDVIRTUAL_CALL(_get_internal_option_update_view_required, p_category, p_option, ret);
@@ -182,17 +188,20 @@ Variant EditorScenePostImportPlugin::get_internal_option_update_view_required(In
 }
 
 void EditorScenePostImportPlugin::internal_process(InternalImportCategory p_category, Node *p_base_scene, Node *p_node, Ref<Resource> p_resource, const Dictionary &p_options) {
+	MutexLock lock(mutex);
 	current_options_dict = &p_options;
 	GDVIRTUAL_CALL(_internal_process, p_category, p_base_scene, p_node, p_resource);
 	current_options_dict = nullptr;
 }
 
 void EditorScenePostImportPlugin::get_import_options(const String &p_path, List<ResourceImporter::ImportOption> *r_options) {
+	MutexLock lock(mutex);
 	current_option_list = r_options;
 	GDVIRTUAL_CALL(_get_import_options, p_path);
 	current_option_list = nullptr;
 }
 Variant EditorScenePostImportPlugin::get_option_visibility(const String &p_path, bool p_for_animation, const String &p_option, const HashMap<StringName, Variant> &p_options) const {
+	MutexLock lock(mutex);
 	current_options = &p_options;
 	Variant ret;
 	GDVIRTUAL_CALL(_get_option_visibility, p_path, p_for_animation, p_option, ret);
@@ -201,11 +210,13 @@ Variant EditorScenePostImportPlugin::get_option_visibility(const String &p_path,
 }
 
 void EditorScenePostImportPlugin::pre_process(Node *p_scene, const HashMap<StringName, Variant> &p_options) {
+	MutexLock lock(mutex);
 	current_options = &p_options;
 	GDVIRTUAL_CALL(_pre_process, p_scene);
 	current_options = nullptr;
 }
 void EditorScenePostImportPlugin::post_process(Node *p_scene, const HashMap<StringName, Variant> &p_options) {
+	MutexLock lock(mutex);
 	current_options = &p_options;
 	GDVIRTUAL_CALL(_post_process, p_scene);
 	current_options = nullptr;
@@ -2182,32 +2193,26 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 	progress.step(TTR("Running Custom Script..."), 2);
 
 	String post_import_script_path = p_options["import_script/path"];
-	Ref<EditorScenePostImport> post_import_script;
-
 	if (!post_import_script_path.is_empty()) {
-		Ref<Script> scr = ResourceLoader::load(post_import_script_path);
-		if (!scr.is_valid()) {
-			EditorNode::add_io_error(TTR("Couldn't load post-import script:") + " " + post_import_script_path);
+		if (Thread::get_caller_id() == Thread::get_main_id()) {
+			err = _run_post_import_script(post_import_script_path, p_source_file, scene);
 		} else {
-			post_import_script = Ref<EditorScenePostImport>(memnew(EditorScenePostImport));
-			post_import_script->set_script(scr);
-			if (!post_import_script->get_script_instance()) {
-				EditorNode::add_io_error(TTR("Invalid/broken script for post-import (check console):") + " " + post_import_script_path);
-				post_import_script.unref();
-				return ERR_CANT_CREATE;
-			}
+			// Scripts run on the main thread, which flushes the message queue while it waits for threaded imports.
+			PostImportScriptCall call;
+			call.script_path = post_import_script_path;
+			call.source_file = p_source_file;
+			call.scene = scene;
+			MessageQueue::get_singleton()->push_callable(callable_mp(&call, &PostImportScriptCall::run));
+			call.done.wait();
+			err = call.error;
+			scene = call.scene;
 		}
-	}
-
-	if (post_import_script.is_valid()) {
-		post_import_script->init(p_source_file);
-		scene = post_import_script->post_import(scene);
-		if (!scene) {
-			EditorNode::add_io_error(
-					TTR("Error running post-import script:") + " " + post_import_script_path + "\n" +
-					TTR("Did you return a Node-derived object in the `_post_import()` method?"));
+		if (err != OK) {
 			return err;
 		}
+		if (!scene) {
+			return OK;
+		}
 	}
 
 	for (int i = 0; i < post_importer_plugins.size(); i++) {
@@ -2254,6 +2259,54 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 	return OK;
 }
 
+Error ResourceImporterScene::_run_post_import_script(const String &p_script_path, const String &p_source_file, Node *&r_scene) {
+	Ref<Script> scr = ResourceLoader::load(p_script_path);
+	if (!scr.is_valid()) {
+		EditorNode::add_io_error(TTR("Couldn't load post-import script:") + " " + p_script_path);
+		return OK;
+	}
+
+	Ref<EditorScenePostImport> post_import_script = Ref<EditorScenePostImport>(memnew(EditorScenePostImport));
+	post_import_script->set_script(scr);
+	if (!post_import_script->get_script_instance()) {
+		EditorNode::add_io_error(TTR("Invalid/broken script for post-import (check console):") + " " + p_script_path);
+		return ERR_CANT_CREATE;
+	}
+
+	post_import_script->init(p_source_file);
+	r_scene = post_import_script->post_import(r_scene);
+	if (!r_scene) {
+		EditorNode::add_io_error(
+				TTR("Error running post-import script:") + " " + p_script_path + "\n" +
+				TTR("Did you return a Node-derived object in the `_post_import()` method?"));
+	}
+	return OK;
+}
+
+void ResourceImporterScene::PostImportScriptCall::run() {
+	error = _run_post_import_script(script_path, source_file, scene);
+	done.post();
+}
+
+bool ResourceImporterScene::can_import_threaded() const {
+	if (!EDITOR_GET("filesystem/import/threaded_scene_import")) {
+		return false;
+	}
+
+	// Script implementations run on the main thread only.
+	for (int i = 0; i < importers.size(); i++) {
+		if (importers[i]->get_script_instance()) {
+			return false;
+		}
+	}
+	for (int i = 0; i < post_importer_plugins.size(); i++) {
+		if (post_importer_plugins[i]->get_script_instance()) {
+			return false;
+		}
+	}
+	return true;
+}
+
 ResourceImporterScene *ResourceImporterScene::scene_singleton = nullptr;
 ResourceImporterScene *ResourceImporterScene::animation_singleton = nullptr;
 
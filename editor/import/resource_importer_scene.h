@@ -33,6 +33,7 @@
 
 #include "core/error/error_macros.h"
 #include "core/io/resource_importer.h"
+#include "core/os/semaphore.h"
 #include "core/variant/dictionary.h"
 #include "scene/3d/node_3d.h"
 #include "scene/resources/animation.h"
@@ -47,6 +48,8 @@ class ImporterMesh;
 class EditorSceneFormatImporter : public RefCounted {
 	GDCLASS(EditorSceneFormatImporter, RefCounted);
 
+	Mutex mutex; // Serializes script implementations, which may be called from several import threads.
+
 protected:
 	static void _bind_methods();
 
@@ -111,6 +114,8 @@ public:
 	};
 
 private:
+	// Scenes may be imported on several threads, but a plugin handles one call at a time.
+	mutable Mutex mutex;
 	mutable const HashMap<StringName, Variant> *current_options = nullptr;
 	mutable const Dictionary *current_options_dict = nullptr;
 	List<ResourceImporter::ImportOption> *current_option_list = nullptr;
@@ -227,6 +232,19 @@ class ResourceImporterScene : public ResourceImporter {
 
 	void _optimize_track_usage(AnimationPlayer *p_player, AnimationImportTracks *p_track_actions);
 
+	static Error _run_post_import_script(const String &p_script_path, const String &p_source_file, Node *&r_scene);
+
+	// Post-import script run on the main thread for an import running on another one.
+	struct PostImportScriptCall : public Object {
+		String script_path;
+		String source_file;
+		Node *scene = nullptr;
+		Error error = OK;
+		Semaphore done;
+
+		void run();
+	};
+
 	bool animation_importer = false;
 
 public:
@@ -287,7 +305,7 @@ public:
 	virtual bool has_advanced_options() const override;
 	virtual void show_advanced_options(const String &p_path) override;
 
-	virtual bool can_import_threaded() const override { return false; }
+	virtual bool can_import_threaded() const override;
 
 	ResourceImporterScene(bool p_animation_import = false);
 
@@ -615,6 +615,11 @@ Error ResourceImporterTexture::import(const String &p_source_file, const String
 	return OK;
 }
 
+bool ResourceImporterTexture::can_import_cached(const HashMap<StringName, Variant> &p_options) const {
+	// Roughness may be computed from a separate normal map, whose contents are not part of the cache key.
+	return int(p_options["roughness/mode"]) <= 1 || String(p_options["roughness/src_normal"]).is_empty();
+}
+
 const char *ResourceImporterTexture::compression_formats[] = {
 	"bptc",
 	"s3tc",
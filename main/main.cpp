@@ -45,7 +45,9 @@
 #include "core/io/image_loader.h"
 #include "core/io/ip.h"
 #include "core/io/resource_loader.h"
+#include "core/io/resource_streamer.h"
 #include "core/object/message_queue.h"
+#include "core/os/allocation_tracker.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/register_core_types.h"
@@ -185,6 +187,11 @@ static String write_movie_path;
 static MovieWriter *movie_writer = nullptr;
 static bool disable_vsync = false;
 static bool print_fps = false;
+static String script_samples_path;
+static uint32_t script_sample_interval = 1000;
+#ifdef ALLOCATION_TRACKING_ENABLED
+static String allocation_dump_path;
+#endif
 #ifdef TOOLS_ENABLED
 static bool dump_extension_api = false;
 #endif
@@ -368,6 +375,11 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  --disable-crash-handler                      Disable crash handler when supported by the platform code.\n");
 	OS::get_singleton()->print("  --fixed-fps <fps>                            Force a fixed number of frames per second. This setting disables real-time synchronization.\n");
 	OS::get_singleton()->print("  --print-fps                                  Print the frames per second to the stdout.\n");
+	OS::get_singleton()->print("  --sample-scripts <file>                      Sample script call stacks and write them to <file> (folded stacks, for flame graphs) when the engine quits.\n");
+	OS::get_singleton()->print("  --sample-scripts-interval <usec>             Time between script call stack samples (default: 1000).\n");
+#ifdef ALLOCATION_TRACKING_ENABLED
+	OS::get_singleton()->print("  --dump-allocations <file>                    Write allocation counts and sizes per call site to <file> (CSV) when the engine quits.\n");
+#endif
 	OS::get_singleton()->print("\n");
 
 	OS::get_singleton()->print("Standalone tools:\n");
@@ -1175,6 +1187,32 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			disable_vsync = true;
 		} else if (I->get() == "--print-fps") {
 			print_fps = true;
+		} else if (I->get() == "--sample-scripts") {
+			if (I->next()) {
+				script_samples_path = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing script samples path argument, aborting.\n");
+				goto error;
+			}
+		} else if (I->get() == "--sample-scripts-interval") {
+			if (I->next()) {
+				script_sample_interval = MAX(I->next()->get().to_int(), 1);
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing script sample interval argument, aborting.\n");
+				goto error;
+			}
+#ifdef ALLOCATION_TRACKING_ENABLED
+		} else if (I->get() == "--dump-allocations") {
+			if (I->next()) {
+				allocation_dump_path = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing allocation dump path argument, aborting.\n");
+				goto error;
+			}
+#endif
 		} else if (I->get() == "--profile-gpu") {
 			profile_gpu = true;
 		} else if (I->get() == "--disable-crash-handler") {
@@ -2065,6 +2103,10 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 	// This loads global classes, so it must happen before custom loaders and savers are registered
 	ScriptServer::init_languages();
 
+	if (!script_samples_path.is_empty()) {
+		ScriptServer::sampling_profiler_start(script_sample_interval);
+	}
+
 	audio_server->load_default_bus_layout();
 
 	if (use_debug_profiler && EngineDebugger::is_active()) {
@@ -2084,6 +2126,7 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 	_start_success = true;
 
 	ClassDB::set_current_api(ClassDB::API_NONE); //no more APIs are registered at this point
+	ClassDB::enable_lookup_tables();
 
 	print_verbose("CORE API HASH: " + uitos(ClassDB::get_api_hash(ClassDB::API_CORE)));
 	print_verbose("EDITOR API HASH: " + uitos(ClassDB::get_api_hash(ClassDB::API_EDITOR)));
@@ -2438,6 +2481,18 @@ bool Main::start() {
 					}
 				}
 
+				if (GLOBAL_GET("application/run/prewarm_scripts")) {
+					//compile the scripts of the autoloads and main scene before loading them
+					Vector<String> startup_paths;
+					for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : autoloads) {
+						startup_paths.push_back(E.value.path);
+					}
+					if (game_path.begins_with("res://")) {
+						startup_paths.push_back(game_path);
+					}
+					ScriptServer::prewarm_languages(startup_paths);
+				}
+
 				//second pass, load into global constants
 				List<Node *> to_add;
 				for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : autoloads) {
@@ -2856,6 +2911,8 @@ bool Main::iteration() {
 	}
 	message_queue->flush();
 
+	ResourceStreamer::get_singleton()->poll();
+
 	RenderingServer::get_singleton()->sync(); //sync if still drawing from previous frames.
 
 	if (DisplayServer::get_singleton()->can_any_window_draw() &&
@@ -2882,6 +2939,10 @@ bool Main::iteration() {
 
 	AudioServer::get_singleton()->update();
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+	AllocationTracker::frame_end();
+#endif
+
 	if (EngineDebugger::is_active()) {
 		EngineDebugger::get_singleton()->iteration(frame_time, process_ticks, physics_process_ticks, physics_step);
 	}
@@ -2970,12 +3031,21 @@ void Main::cleanup(bool p_force) {
 		movie_writer->end();
 	}
 
+#ifdef ALLOCATION_TRACKING_ENABLED
+	if (!allocation_dump_path.is_empty()) {
+		AllocationTracker::dump(allocation_dump_path);
+	}
+#endif
+
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 
 	// Flush before uninitializing the scene, but delete the MessageQueue as late as possible.
 	message_queue->flush();
 
+	// Streamed resources may be of scene types, release them while those still exist.
+	ResourceStreamer::get_singleton()->clear();
+
 	OS::get_singleton()->delete_main_loop();
 
 	OS::get_singleton()->_cmdline.clear();
@@ -2985,6 +3055,11 @@ void Main::cleanup(bool p_force) {
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
+	if (!script_samples_path.is_empty()) {
+		ScriptServer::sampling_profiler_stop();
+		ScriptServer::sampling_profiler_dump(script_samples_path);
+	}
+
 	ScriptServer::finish_languages();
 
 	// Sync pending commands that may have been queued from a different thread during ScriptServer finalization
@@ -86,6 +86,8 @@ complete -c godot -l disable-render-loop -d "Disable render loop so rendering on
 complete -c godot -l disable-crash-handler -d "Disable crash handler when supported by the platform code"
 complete -c godot -l fixed-fps -d "Force a fixed number of frames per second (this setting disables real-time synchronization)" -x
 complete -c godot -l print-fps -d "Print the frames per second to the stdout"
+complete -c godot -l sample-scripts -d "Sample script call stacks and write them to a file when quitting" -r
+complete -c godot -l sample-scripts-interval -d "Time between script call stack samples" -x
 
 # Standalone tools:
 complete -c godot -s s -l script -d "Run a script" -r
@@ -40,10 +40,12 @@
 #include "core/io/file_access_encrypted.h"
 #include "core/os/os.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_byte_code_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_warning.h"
 
 #ifdef TESTS_ENABLED
@@ -141,6 +143,9 @@ GDScriptInstance *GDScript::_create_instance(const Variant **p_args, int p_argco
 	instance->script = Ref<GDScript>(this);
 	instance->owner = p_owner;
 	instance->owner_id = p_owner->get_instance_id();
+	if (thread_safe) {
+		instance->mutex = memnew(Mutex);
+	}
 #ifdef DEBUG_ENABLED
 	//needed for hot reloading
 	for (const KeyValue<StringName, MemberInfo> &E : member_indices) {
@@ -861,7 +866,22 @@ Error GDScript::reload(bool p_keep_state) {
 		}
 	}
 
+	// Inline caches may point to functions and members that are about to be replaced.
+	GDScriptFunction::invalidate_inline_caches();
+
 	valid = false;
+
+	if (!p_keep_state && GDScriptByteCodeCache::is_enabled()) {
+		// Exported projects ship the compiled form next to the source.
+		String source_path = path.is_empty() ? get_path() : path;
+		String byte_code_path = source_path.is_empty() ? String() : GDScriptByteCodeCache::get_cache_path(source_path);
+		if (!byte_code_path.is_empty() && FileAccess::exists(byte_code_path)) {
+			if (load_byte_code(byte_code_path) == OK) {
+				return OK;
+			}
+		}
+	}
+
 	GDScriptParser parser;
 	Error err = parser.parse(source, path, false);
 	if (err) {
@@ -1023,12 +1043,49 @@ void GDScript::_bind_methods() {
 }
 
 Vector<uint8_t> GDScript::get_as_byte_code() const {
-	return Vector<uint8_t>();
+	Vector<uint8_t> byte_code;
+#ifdef DEBUG_ENABLED
+	Error err = GDScriptByteCodeCache::serialize(this, true, byte_code);
+#else
+	Error err = GDScriptByteCodeCache::serialize(this, false, byte_code);
+#endif
+	if (err != OK) {
+		return Vector<uint8_t>();
+	}
+	return byte_code;
 };
 
-// TODO: Fully remove this. There's not this kind of "bytecode" anymore.
 Error GDScript::load_byte_code(const String &p_path) {
-	return ERR_COMPILATION_FAILED;
+	Error err;
+	Vector<uint8_t> byte_code = FileAccess::get_file_as_array(p_path, &err);
+	if (err != OK) {
+		return err;
+	}
+
+	return load_byte_code_from_buffer(byte_code);
+}
+
+Error GDScript::load_byte_code_from_buffer(const Vector<uint8_t> &p_byte_code) {
+	Error err = GDScriptByteCodeCache::deserialize(this, p_byte_code);
+	if (err != OK) {
+		return err;
+	}
+
+	String source_path = path.is_empty() ? get_path() : path;
+	err = GDScriptCache::finish_compiling(source_path);
+	if (err != OK) {
+		return err;
+	}
+
+	valid = true;
+
+	for (KeyValue<StringName, Ref<GDScript>> &E : subclasses) {
+		_set_subclass_path(E.value, path);
+	}
+
+	_init_rpc_methods_properties();
+
+	return OK;
 }
 
 Error GDScript::load_source_code(const String &p_path) {
@@ -1242,6 +1299,9 @@ void GDScript::_init_rpc_methods_properties() {
 }
 
 GDScript::~GDScript() {
+	// A new script could be allocated at the same address.
+	GDScriptFunction::invalidate_inline_caches();
+
 	{
 		MutexLock lock(GDScriptLanguage::get_singleton()->lock);
 
@@ -1266,7 +1326,8 @@ GDScript::~GDScript() {
 	}
 
 	if (GDScriptCache::singleton) { // Cache may have been already destroyed at engine shutdown.
-		GDScriptCache::remove_script(get_path());
+		// Same key as GDScriptCompiler::compile() used when finishing compilation.
+		GDScriptCache::remove_script(get_path().is_empty() ? path : get_path());
 	}
 
 	_save_orphaned_subclasses();
@@ -1292,6 +1353,8 @@ GDScript::~GDScript() {
 //////////////////////////////
 
 bool GDScriptInstance::set(const StringName &p_name, const Variant &p_value) {
+	MutexLockIfThreadSafe lock(mutex);
+
 	//member
 	{
 		HashMap<StringName, GDScript::MemberInfo>::Iterator E = script->member_indices.find(p_name);
@@ -1355,6 +1418,8 @@ bool GDScriptInstance::set(const StringName &p_name, const Variant &p_value) {
 }
 
 bool GDScriptInstance::get(const StringName &p_name, Variant &r_ret) const {
+	MutexLockIfThreadSafe lock(mutex);
+
 	const GDScript *sptr = script.ptr();
 	while (sptr) {
 		{
@@ -1654,6 +1719,10 @@ void GDScriptInstance::reload_members() {
 	}
 
 #endif
+
+	if (script->thread_safe && !mutex) {
+		mutex = memnew(Mutex);
+	}
 }
 
 GDScriptInstance::GDScriptInstance() {
@@ -1661,6 +1730,8 @@ GDScriptInstance::GDScriptInstance() {
 	base_ref_counted = false;
 }
 
+thread_local uint32_t GDScriptInstance::MutexLockIfThreadSafe::held_count = 0;
+
 GDScriptInstance::~GDScriptInstance() {
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
 
@@ -1674,12 +1745,23 @@ GDScriptInstance::~GDScriptInstance() {
 	if (script.is_valid() && owner) {
 		script->instances.erase(owner);
 	}
+
+	if (mutex) {
+		memdelete(mutex);
+	}
 }
 
 /************* SCRIPT LANGUAGE **************/
 
 GDScriptLanguage *GDScriptLanguage::singleton = nullptr;
 
+thread_local GDScriptLanguage::ThreadDebugState *GDScriptLanguage::thread_debug_state = nullptr;
+
+GDScriptLanguage::ThreadDebugState *GDScriptLanguage::_create_thread_debug_state() {
+	thread_debug_state = memnew(ThreadDebugState);
+	return thread_debug_state;
+}
+
 String GDScriptLanguage::get_name() const {
 	return "GDScript";
 }
@@ -1761,6 +1843,38 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 }
 
 void GDScriptLanguage::finish() {
+	GDScriptSamplingProfiler::finish();
+
+	MutexLock lock(task_pool_mutex);
+	task_pool.finish();
+}
+
+void GDScriptLanguage::_run_task(uint32_t p_index, const Callable *p_task) {
+	Variant index = p_index;
+	const Variant *args[1] = { &index };
+	Variant ret;
+	Callable::CallError ce;
+	p_task->call(args, 1, ret, ce);
+	if (ce.error != Callable::CallError::CALL_OK) {
+		ERR_PRINT("Error calling parallel_for() task: " + Variant::get_callable_error_text(*p_task, args, 1, ce) + ".");
+	}
+}
+
+void GDScriptLanguage::run_parallel(int p_count, const Callable &p_task) {
+	// The workers take one batch at a time, nested and concurrent batches run on the calling thread instead.
+	// So do batches started while holding an instance mutex, tasks using that instance would wait for it forever.
+	if (p_count > 1 && GDScriptInstance::MutexLockIfThreadSafe::held_count == 0 && task_pool_mutex.try_lock() == OK) {
+		if (task_pool.get_thread_count() == 0) {
+			task_pool.init();
+		}
+		task_pool.do_work(p_count, this, &GDScriptLanguage::_run_task, &p_task);
+		task_pool_mutex.unlock();
+		return;
+	}
+
+	for (int i = 0; i < p_count; i++) {
+		_run_task(i, &p_task);
+	}
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -1769,12 +1883,12 @@ void GDScriptLanguage::profiling_start() {
 
 	SelfList<GDScriptFunction> *elem = function_list.first();
 	while (elem) {
-		elem->self()->profile.call_count = 0;
-		elem->self()->profile.self_time = 0;
-		elem->self()->profile.total_time = 0;
-		elem->self()->profile.frame_call_count = 0;
-		elem->self()->profile.frame_self_time = 0;
-		elem->self()->profile.frame_total_time = 0;
+		elem->self()->profile.call_count.set(0);
+		elem->self()->profile.self_time.set(0);
+		elem->self()->profile.total_time.set(0);
+		elem->self()->profile.frame_call_count.set(0);
+		elem->self()->profile.frame_self_time.set(0);
+		elem->self()->profile.frame_total_time.set(0);
 		elem->self()->profile.last_frame_call_count = 0;
 		elem->self()->profile.last_frame_self_time = 0;
 		elem->self()->profile.last_frame_total_time = 0;
@@ -1793,6 +1907,18 @@ void GDScriptLanguage::profiling_stop() {
 #endif
 }
 
+void GDScriptLanguage::sampling_profiler_start(uint32_t p_interval_usec) {
+	GDScriptSamplingProfiler::start(p_interval_usec);
+}
+
+void GDScriptLanguage::sampling_profiler_stop() {
+	GDScriptSamplingProfiler::stop();
+}
+
+void GDScriptLanguage::sampling_profiler_get_samples(HashMap<String, uint64_t> &r_samples) {
+	GDScriptSamplingProfiler::get_samples(r_samples);
+}
+
 int GDScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_arr, int p_info_max) {
 	int current = 0;
 #ifdef DEBUG_ENABLED
@@ -1804,9 +1930,9 @@ int GDScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_arr,
 		if (current >= p_info_max) {
 			break;
 		}
-		p_info_arr[current].call_count = elem->self()->profile.call_count;
-		p_info_arr[current].self_time = elem->self()->profile.self_time;
-		p_info_arr[current].total_time = elem->self()->profile.total_time;
+		p_info_arr[current].call_count = elem->self()->profile.call_count.get();
+		p_info_arr[current].self_time = elem->self()->profile.self_time.get();
+		p_info_arr[current].total_time = elem->self()->profile.total_time.get();
 		p_info_arr[current].signature = elem->self()->profile.signature;
 		elem = elem->next();
 		current++;
@@ -2013,21 +2139,35 @@ void GDScriptLanguage::reload_tool_script(const Ref<Script> &p_script, bool p_so
 #endif
 }
 
+void GDScriptLanguage::thread_exit() {
+	if (thread_debug_state) {
+		memdelete(thread_debug_state);
+		thread_debug_state = nullptr;
+	}
+	GDScriptFunction::thread_exit();
+	GDScriptSamplingProfiler::thread_exit();
+}
+
 void GDScriptLanguage::frame() {
 	calls = 0;
 
+	// By now the scripts compiled at startup are referenced by whatever loaded them.
+	GDScriptCache::release_prewarmed_scripts();
+
+	GDScriptFunction::free_retired_inline_caches();
+
 #ifdef DEBUG_ENABLED
 	if (profiling) {
 		MutexLock lock(this->lock);
 
 		SelfList<GDScriptFunction> *elem = function_list.first();
 		while (elem) {
-			elem->self()->profile.last_frame_call_count = elem->self()->profile.frame_call_count;
-			elem->self()->profile.last_frame_self_time = elem->self()->profile.frame_self_time;
-			elem->self()->profile.last_frame_total_time = elem->self()->profile.frame_total_time;
-			elem->self()->profile.frame_call_count = 0;
-			elem->self()->profile.frame_self_time = 0;
-			elem->self()->profile.frame_total_time = 0;
+			elem->self()->profile.last_frame_call_count = elem->self()->profile.frame_call_count.get();
+			elem->self()->profile.last_frame_self_time = elem->self()->profile.frame_self_time.get();
+			elem->self()->profile.last_frame_total_time = elem->self()->profile.frame_total_time.get();
+			elem->self()->profile.frame_call_count.set(0);
+			elem->self()->profile.frame_self_time.set(0);
+			elem->self()->profile.frame_total_time.set(0);
 			elem = elem->next();
 		}
 	}
@@ -2035,6 +2175,10 @@ void GDScriptLanguage::frame() {
 #endif
 }
 
+void GDScriptLanguage::prewarm_scripts(const Vector<String> &p_paths) {
+	GDScriptCache::prewarm(p_paths);
+}
+
 /* EDITOR FUNCTIONS */
 void GDScriptLanguage::get_reserved_words(List<String> *p_words) const {
 	// TODO: Add annotations here?
@@ -2232,13 +2376,9 @@ GDScriptLanguage::GDScriptLanguage() {
 	strings._get = StaticCString::create("_get");
 	strings._get_property_list = StaticCString::create("_get_property_list");
 	strings._script_source = StaticCString::create("script/source");
-	_debug_parse_err_line = -1;
-	_debug_parse_err_file = "";
-
 	profiling = false;
-	script_frame_time = 0;
+	script_frame_time.set(0);
 
-	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/gdscript/max_call_stack", PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater")); //minimum is 1024
 
@@ -2246,13 +2386,17 @@ GDScriptLanguage::GDScriptLanguage() {
 		//debugging enabled!
 
 		_debug_max_call_stack = dmcs;
-		_call_stack = memnew_arr(CallLevel, _debug_max_call_stack + 1);
 
 	} else {
 		_debug_max_call_stack = 0;
-		_call_stack = nullptr;
 	}
 
+	GDScriptCompiler::set_optimization_level(GLOBAL_DEF("gdscript/compiler/optimization_level", GDScriptCompiler::OPTIMIZATION_BASIC));
+	ProjectSettings::get_singleton()->set_custom_property_info("gdscript/compiler/optimization_level", PropertyInfo(Variant::INT, "gdscript/compiler/optimization_level", PROPERTY_HINT_ENUM, "None,Basic,Inline"));
+	GDScriptJIT::set_enabled(GLOBAL_DEF("gdscript/jit/enabled", false));
+	GDScriptJIT::set_call_threshold(GLOBAL_DEF("gdscript/jit/call_threshold", 1000));
+	ProjectSettings::get_singleton()->set_custom_property_info("gdscript/jit/call_threshold", PropertyInfo(Variant::INT, "gdscript/jit/call_threshold", PROPERTY_HINT_RANGE, "1,100000,1,or_greater"));
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/treat_warnings_as_errors", false);
@@ -2270,8 +2414,9 @@ GDScriptLanguage::GDScriptLanguage() {
 }
 
 GDScriptLanguage::~GDScriptLanguage() {
-	if (_call_stack) {
-		memdelete_arr(_call_stack);
+	if (thread_debug_state) {
+		memdelete(thread_debug_state);
+		thread_debug_state = nullptr;
 	}
 
 	// Clear dependencies between scripts, to ensure cyclic references are broken (to avoid leaks at exit).
@@ -2299,14 +2444,19 @@ GDScriptLanguage::~GDScriptLanguage() {
 		script->unreference();
 	}
 
+	GDScriptFunction::free_retired_inline_caches();
+	GDScriptFunction::thread_exit();
+
 	singleton = nullptr;
 }
 
 void GDScriptLanguage::add_orphan_subclass(const String &p_qualified_name, const ObjectID &p_subclass) {
+	MutexLock lock(this->lock);
 	orphan_subclasses[p_qualified_name] = p_subclass;
 }
 
 Ref<GDScript> GDScriptLanguage::get_orphan_subclass(const String &p_qualified_name) {
+	MutexLock lock(this->lock);
 	HashMap<String, ObjectID>::Iterator orphan_subclass_element = orphan_subclasses.find(p_qualified_name);
 	if (!orphan_subclass_element) {
 		return Ref<GDScript>();
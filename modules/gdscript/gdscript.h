@@ -38,6 +38,7 @@
 #include "core/io/resource_saver.h"
 #include "core/object/script_language.h"
 #include "core/templates/rb_set.h"
+#include "core/templates/thread_work_pool.h"
 #include "gdscript_function.h"
 
 class GDScriptNativeClass : public RefCounted {
@@ -60,6 +61,7 @@ public:
 class GDScript : public Script {
 	GDCLASS(GDScript, Script);
 	bool tool = false;
+	bool thread_safe = false;
 	bool valid = false;
 
 	struct MemberInfo {
@@ -74,6 +76,7 @@ class GDScript : public Script {
 	friend class GDScriptAnalyzer;
 	friend class GDScriptCompiler;
 	friend class GDScriptLanguage;
+	friend class GDScriptByteCodeCache;
 	friend struct GDScriptUtilityFunctionsDefinitions;
 
 	Ref<GDScriptNativeClass> native;
@@ -193,6 +196,7 @@ public:
 	virtual void get_script_signal_list(List<MethodInfo> *r_signals) const override;
 
 	bool is_tool() const override { return tool; }
+	bool is_thread_safe() const { return thread_safe; }
 	Ref<GDScript> get_base() const;
 
 	const HashMap<StringName, MemberInfo> &debug_get_member_indices() const { return member_indices; }
@@ -225,6 +229,8 @@ public:
 	void set_script_path(const String &p_path) { path = p_path; } //because subclasses need a path too...
 	Error load_source_code(const String &p_path);
 	Error load_byte_code(const String &p_path);
+	// Same as load_byte_code(), for the compiled form already in memory (e.g. from get_as_byte_code()).
+	Error load_byte_code_from_buffer(const Vector<uint8_t> &p_byte_code);
 
 	Vector<uint8_t> get_as_byte_code() const;
 
@@ -276,10 +282,33 @@ class GDScriptInstance : public ScriptInstance {
 #endif
 	Vector<Variant> members;
 	bool base_ref_counted;
+	Mutex *mutex = nullptr; // Only for thread-safe scripts, held while a function runs on this instance.
 
 	SelfList<GDScriptFunctionState>::List pending_func_states;
 
 public:
+	// Holds the instance mutex while in scope, if there is one.
+	// Nested calls lock instances in call order, so A calling B on one thread while
+	// B calls A on another deadlocks. There's no lock ordering to prevent that.
+	struct MutexLockIfThreadSafe {
+		static thread_local uint32_t held_count; // Instance mutexes held by this thread.
+		Mutex *mutex = nullptr;
+
+		explicit MutexLockIfThreadSafe(Mutex *p_mutex) :
+				mutex(p_mutex) {
+			if (mutex) {
+				mutex->lock();
+				held_count++;
+			}
+		}
+		~MutexLockIfThreadSafe() {
+			if (mutex) {
+				held_count--;
+				mutex->unlock();
+			}
+		}
+	};
+
 	virtual Object *get_owner() { return owner; }
 
 	virtual bool set(const StringName &p_name, const Variant &p_value);
@@ -328,12 +357,47 @@ class GDScriptLanguage : public ScriptLanguage {
 		int *line = nullptr;
 	};
 
-	int _debug_parse_err_line;
-	String _debug_parse_err_file;
-	String _debug_error;
-	int _debug_call_stack_pos;
-	int _debug_max_call_stack;
-	CallLevel *_call_stack = nullptr;
+	struct CallStack {
+		CallLevel *levels = nullptr;
+		int stack_pos = 0;
+
+		void free() {
+			if (levels) {
+				memdelete_arr(levels);
+				levels = nullptr;
+			}
+		}
+		~CallStack() {
+			free();
+		}
+	};
+
+	// Each thread running scripts tracks its own calls, the debugger only breaks on the main one.
+	struct ThreadDebugState {
+		int parse_err_line = -1;
+		String parse_err_file;
+		String error;
+		CallStack call_stack;
+	};
+
+	// Only a plain pointer is thread_local, as MinGW and Web builds don't reliably
+	// run destructors of thread_local objects. Freed in thread_exit().
+	static thread_local ThreadDebugState *thread_debug_state;
+	int _debug_max_call_stack = 0;
+
+	static ThreadDebugState *_create_thread_debug_state();
+	static _FORCE_INLINE_ ThreadDebugState &_get_thread_debug_state() {
+		if (unlikely(!thread_debug_state)) {
+			return *_create_thread_debug_state();
+		}
+		return *thread_debug_state;
+	}
+
+	// Workers for parallel_for(), started on first use.
+	ThreadWorkPool task_pool;
+	BinaryMutex task_pool_mutex;
+
+	void _run_task(uint32_t p_index, const Callable *p_task);
 
 	void _add_global(const StringName &p_name, const Variant &p_value);
 
@@ -348,7 +412,7 @@ class GDScriptLanguage : public ScriptLanguage {
 
 	SelfList<GDScriptFunction>::List function_list;
 	bool profiling;
-	uint64_t script_frame_time;
+	SafeNumeric<uint64_t> script_frame_time;
 
 	HashMap<String, ObjectID> orphan_subclasses;
 
@@ -359,64 +423,72 @@ public:
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
 	_FORCE_INLINE_ void enter_function(GDScriptInstance *p_instance, GDScriptFunction *p_function, Variant *p_stack, int *p_ip, int *p_line) {
-		if (Thread::get_main_id() != Thread::get_caller_id()) {
-			return; //no support for other threads than main for now
-		}
-
-		if (EngineDebugger::get_script_debugger()->get_lines_left() > 0 && EngineDebugger::get_script_debugger()->get_depth() >= 0) {
+		bool is_main_thread = Thread::get_main_id() == Thread::get_caller_id();
+		if (is_main_thread && EngineDebugger::get_script_debugger()->get_lines_left() > 0 && EngineDebugger::get_script_debugger()->get_depth() >= 0) {
 			EngineDebugger::get_script_debugger()->set_depth(EngineDebugger::get_script_debugger()->get_depth() + 1);
 		}
 
-		if (_debug_call_stack_pos >= _debug_max_call_stack) {
+		ThreadDebugState &debug_state = _get_thread_debug_state();
+		CallStack &call_stack = debug_state.call_stack;
+		if (call_stack.stack_pos >= _debug_max_call_stack) {
 			//stack overflow
-			_debug_error = vformat("Stack overflow (stack size: %s). Check for infinite recursion in your script.", _debug_max_call_stack);
-			EngineDebugger::get_script_debugger()->debug(this);
+			debug_state.error = vformat("Stack overflow (stack size: %s). Check for infinite recursion in your script.", _debug_max_call_stack);
+			if (is_main_thread) {
+				EngineDebugger::get_script_debugger()->debug(this);
+			} else {
+				ERR_PRINT(debug_state.error);
+			}
 			return;
 		}
 
-		_call_stack[_debug_call_stack_pos].stack = p_stack;
-		_call_stack[_debug_call_stack_pos].instance = p_instance;
-		_call_stack[_debug_call_stack_pos].function = p_function;
-		_call_stack[_debug_call_stack_pos].ip = p_ip;
-		_call_stack[_debug_call_stack_pos].line = p_line;
-		_debug_call_stack_pos++;
+		if (unlikely(!call_stack.levels)) {
+			call_stack.levels = memnew_arr(CallLevel, _debug_max_call_stack + 1);
+		}
+
+		call_stack.levels[call_stack.stack_pos].stack = p_stack;
+		call_stack.levels[call_stack.stack_pos].instance = p_instance;
+		call_stack.levels[call_stack.stack_pos].function = p_function;
+		call_stack.levels[call_stack.stack_pos].ip = p_ip;
+		call_stack.levels[call_stack.stack_pos].line = p_line;
+		call_stack.stack_pos++;
 	}
 
 	_FORCE_INLINE_ void exit_function() {
-		if (Thread::get_main_id() != Thread::get_caller_id()) {
-			return; //no support for other threads than main for now
-		}
-
-		if (EngineDebugger::get_script_debugger()->get_lines_left() > 0 && EngineDebugger::get_script_debugger()->get_depth() >= 0) {
+		bool is_main_thread = Thread::get_main_id() == Thread::get_caller_id();
+		if (is_main_thread && EngineDebugger::get_script_debugger()->get_lines_left() > 0 && EngineDebugger::get_script_debugger()->get_depth() >= 0) {
 			EngineDebugger::get_script_debugger()->set_depth(EngineDebugger::get_script_debugger()->get_depth() - 1);
 		}
 
-		if (_debug_call_stack_pos == 0) {
-			_debug_error = "Stack Underflow (Engine Bug)";
-			EngineDebugger::get_script_debugger()->debug(this);
+		ThreadDebugState &debug_state = _get_thread_debug_state();
+		if (debug_state.call_stack.stack_pos == 0) {
+			debug_state.error = "Stack Underflow (Engine Bug)";
+			if (is_main_thread) {
+				EngineDebugger::get_script_debugger()->debug(this);
+			} else {
+				ERR_PRINT(debug_state.error);
+			}
 			return;
 		}
 
-		_debug_call_stack_pos--;
+		debug_state.call_stack.stack_pos--;
 	}
 
 	virtual Vector<StackInfo> debug_get_current_stack_info() override {
-		if (Thread::get_main_id() != Thread::get_caller_id()) {
-			return Vector<StackInfo>();
-		}
-
+		const CallStack &call_stack = _get_thread_debug_state().call_stack;
 		Vector<StackInfo> csi;
-		csi.resize(_debug_call_stack_pos);
-		for (int i = 0; i < _debug_call_stack_pos; i++) {
-			csi.write[_debug_call_stack_pos - i - 1].line = _call_stack[i].line ? *_call_stack[i].line : 0;
-			if (_call_stack[i].function) {
-				csi.write[_debug_call_stack_pos - i - 1].func = _call_stack[i].function->get_name();
-				csi.write[_debug_call_stack_pos - i - 1].file = _call_stack[i].function->get_script()->get_path();
+		csi.resize(call_stack.stack_pos);
+		for (int i = 0; i < call_stack.stack_pos; i++) {
+			csi.write[call_stack.stack_pos - i - 1].line = call_stack.levels[i].line ? *call_stack.levels[i].line : 0;
+			if (call_stack.levels[i].function) {
+				csi.write[call_stack.stack_pos - i - 1].func = call_stack.levels[i].function->get_name();
+				csi.write[call_stack.stack_pos - i - 1].file = call_stack.levels[i].function->get_script()->get_path();
 			}
 		}
 		return csi;
 	}
 
+	void run_parallel(int p_count, const Callable &p_task);
+
 	struct {
 		StringName _init;
 		StringName _notification;
@@ -486,6 +558,8 @@ public:
 	virtual void reload_tool_script(const Ref<Script> &p_script, bool p_soft_reload) override;
 
 	virtual void frame() override;
+	virtual void thread_exit() override;
+	virtual void prewarm_scripts(const Vector<String> &p_paths) override;
 
 	virtual void get_public_functions(List<MethodInfo> *p_functions) const override;
 	virtual void get_public_constants(List<Pair<String, Variant>> *p_constants) const override;
@@ -497,6 +571,10 @@ public:
 	virtual int profiling_get_accumulated_data(ProfilingInfo *p_info_arr, int p_info_max) override;
 	virtual int profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_info_max) override;
 
+	virtual void sampling_profiler_start(uint32_t p_interval_usec) override;
+	virtual void sampling_profiler_stop() override;
+	virtual void sampling_profiler_get_samples(HashMap<String, uint64_t> &r_samples) override;
+
 	/* LOADER FUNCTIONS */
 
 	virtual void get_recognized_extensions(List<String> *p_extensions) const override;
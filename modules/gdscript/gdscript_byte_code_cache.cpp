@@ -0,0 +1,1795 @@
+/*************************************************************************/
+/*  gdscript_byte_code_cache.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_byte_code_cache.h"
+
+#include "core/config/engine.h"
+#include "core/debugger/engine_debugger.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/version.h"
+#include "gdscript_analyzer.h"
+#include "gdscript_cache.h"
+#include "gdscript_compiler.h"
+#include "gdscript_parser.h"
+
+enum {
+	FLAG_DEBUG = 1,
+};
+
+enum ScriptRefType {
+	SCRIPT_REF_NONE,
+	SCRIPT_REF_LOCAL, // Same file, stored as the inner class names from the root.
+	SCRIPT_REF_EXTERNAL, // Another GDScript file, plus inner class names.
+	SCRIPT_REF_RESOURCE, // Any other script resource.
+};
+
+enum VariantTag {
+	VARIANT_TAG_VALUE,
+	VARIANT_TAG_EMPTY, // Default value of a type that can't be encoded otherwise.
+	VARIANT_TAG_NULL_OBJECT,
+	VARIANT_TAG_SCRIPT,
+	VARIANT_TAG_GLOBAL,
+	VARIANT_TAG_RESOURCE,
+	VARIANT_TAG_ARRAY,
+	VARIANT_TAG_DICTIONARY,
+	VARIANT_TAG_SHARED, // Array or dictionary already stored, shared by reference.
+};
+
+static String _get_engine_key() {
+	// Opcodes, addresses and engine enums are stored as plain integers,
+	// so only the exact same engine build can use the cache. Byte code
+	// compiled at another optimization level is recompiled as well.
+	return String(VERSION_FULL_CONFIG) + "-" + String(VERSION_HASH) + "-" + itos(GDScriptFunction::OPCODE_END) + "-" + itos(Variant::VARIANT_MAX) + "-" + itos(Variant::OP_MAX) + "-O" + itos(GDScriptCompiler::get_optimization_level());
+}
+
+String GDScriptByteCodeCache::_get_script_root_path(const GDScript *p_script) {
+	return p_script->path.is_empty() ? p_script->get_path() : p_script->path;
+}
+
+/* Writer */
+
+struct FunctionPointerHasher {
+	template <class T>
+	static _FORCE_INLINE_ uint32_t hash(T p_function) { return hash_one_uint64((uint64_t)p_function); }
+};
+
+class GDScriptByteCodeCache::Writer {
+	struct OperatorKey {
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type type_a = Variant::NIL;
+		Variant::Type type_b = Variant::NIL;
+	};
+
+	struct MemberKey {
+		Variant::Type type = Variant::NIL;
+		StringName name;
+	};
+
+	struct ConstructorKey {
+		Variant::Type type = Variant::NIL;
+		int index = 0;
+	};
+
+	bool tables_built = false;
+	HashMap<Variant::ValidatedOperatorEvaluator, OperatorKey, FunctionPointerHasher> operators;
+	HashMap<Variant::ValidatedSetter, MemberKey, FunctionPointerHasher> setters;
+	HashMap<Variant::ValidatedGetter, MemberKey, FunctionPointerHasher> getters;
+	HashMap<Variant::ValidatedKeyedSetter, Variant::Type, FunctionPointerHasher> keyed_setters;
+	HashMap<Variant::ValidatedKeyedGetter, Variant::Type, FunctionPointerHasher> keyed_getters;
+	HashMap<Variant::ValidatedIndexedSetter, Variant::Type, FunctionPointerHasher> indexed_setters;
+	HashMap<Variant::ValidatedIndexedGetter, Variant::Type, FunctionPointerHasher> indexed_getters;
+	HashMap<Variant::ValidatedBuiltInMethod, MemberKey, FunctionPointerHasher> builtin_methods;
+	HashMap<Variant::ValidatedConstructor, ConstructorKey, FunctionPointerHasher> constructors;
+	HashMap<Variant::ValidatedUtilityFunction, StringName, FunctionPointerHasher> utilities;
+	HashMap<GDScriptUtilityFunctions::FunctionPtr, StringName, FunctionPointerHasher> gds_utilities;
+
+	HashMap<int, StringName> global_names;
+	HashMap<Object *, StringName> global_objects;
+	HashMap<const void *, int> shared_containers;
+
+	const GDScript *root = nullptr;
+	String root_path;
+
+	void _build_tables();
+	void _fail(const String &p_reason);
+
+public:
+	Vector<uint8_t> data;
+	Error error = OK;
+
+	void put_8(uint8_t p_value);
+	void put_32(uint32_t p_value);
+	void put_string(const String &p_string);
+	void put_variant(const Variant &p_variant);
+	void put_script(const Script *p_script);
+	void put_data_type(const GDScriptDataType &p_type);
+	void put_function(const GDScriptFunction *p_function);
+	void put_class_tree(const GDScript *p_script);
+	void put_class(const GDScript *p_script);
+
+	Writer(const GDScript *p_root);
+};
+
+GDScriptByteCodeCache::Writer::Writer(const GDScript *p_root) {
+	root = p_root;
+	root_path = _get_script_root_path(p_root);
+
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	for (const KeyValue<StringName, int> &E : language->get_global_map()) {
+		global_names[E.value] = E.key;
+		Object *obj = language->get_global_array()[E.value].get_validated_object();
+		if (obj && !global_objects.has(obj)) {
+			global_objects[obj] = E.key;
+		}
+	}
+}
+
+void GDScriptByteCodeCache::Writer::_build_tables() {
+	if (tables_built) {
+		return;
+	}
+	tables_built = true;
+
+	// The compiled code only keeps pointers to the validated calls, so look up which name they were obtained from.
+	// Several names may share one implementation, any of them resolves to the same function when loading.
+	for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+		Variant::Type type = Variant::Type(i);
+
+		for (int op = 0; op < Variant::OP_MAX; op++) {
+			for (int j = 0; j < Variant::VARIANT_MAX; j++) {
+				Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator(Variant::Operator(op), type, Variant::Type(j));
+				if (evaluator && !operators.has(evaluator)) {
+					OperatorKey key;
+					key.op = Variant::Operator(op);
+					key.type_a = type;
+					key.type_b = Variant::Type(j);
+					operators.insert(evaluator, key);
+				}
+			}
+		}
+
+		List<StringName> members;
+		Variant::get_member_list(type, &members);
+		for (const StringName &E : members) {
+			MemberKey key;
+			key.type = type;
+			key.name = E;
+			Variant::ValidatedSetter setter = Variant::get_member_validated_setter(type, E);
+			if (setter && !setters.has(setter)) {
+				setters.insert(setter, key);
+			}
+			Variant::ValidatedGetter getter = Variant::get_member_validated_getter(type, E);
+			if (getter && !getters.has(getter)) {
+				getters.insert(getter, key);
+			}
+		}
+
+		Variant::ValidatedKeyedSetter keyed_setter = Variant::get_member_validated_keyed_setter(type);
+		if (keyed_setter && !keyed_setters.has(keyed_setter)) {
+			keyed_setters.insert(keyed_setter, type);
+		}
+		Variant::ValidatedKeyedGetter keyed_getter = Variant::get_member_validated_keyed_getter(type);
+		if (keyed_getter && !keyed_getters.has(keyed_getter)) {
+			keyed_getters.insert(keyed_getter, type);
+		}
+		Variant::ValidatedIndexedSetter indexed_setter = Variant::get_member_validated_indexed_setter(type);
+		if (indexed_setter && !indexed_setters.has(indexed_setter)) {
+			indexed_setters.insert(indexed_setter, type);
+		}
+		Variant::ValidatedIndexedGetter indexed_getter = Variant::get_member_validated_indexed_getter(type);
+		if (indexed_getter && !indexed_getters.has(indexed_getter)) {
+			indexed_getters.insert(indexed_getter, type);
+		}
+
+		List<StringName> methods;
+		Variant::get_builtin_method_list(type, &methods);
+		for (const StringName &E : methods) {
+			Variant::ValidatedBuiltInMethod method = Variant::get_validated_builtin_method(type, E);
+			if (method && !builtin_methods.has(method)) {
+				MemberKey key;
+				key.type = type;
+				key.name = E;
+				builtin_methods.insert(method, key);
+			}
+		}
+
+		for (int j = 0; j < Variant::get_constructor_count(type); j++) {
+			Variant::ValidatedConstructor constructor = Variant::get_validated_constructor(type, j);
+			if (constructor && !constructors.has(constructor)) {
+				ConstructorKey key;
+				key.type = type;
+				key.index = j;
+				constructors.insert(constructor, key);
+			}
+		}
+	}
+
+	List<StringName> functions;
+	Variant::get_utility_function_list(&functions);
+	for (const StringName &E : functions) {
+		Variant::ValidatedUtilityFunction function = Variant::get_validated_utility_function(E);
+		if (function && !utilities.has(function)) {
+			utilities.insert(function, E);
+		}
+	}
+
+	functions.clear();
+	GDScriptUtilityFunctions::get_function_list(&functions);
+	for (const StringName &E : functions) {
+		GDScriptUtilityFunctions::FunctionPtr function = GDScriptUtilityFunctions::get_function(E);
+		if (function && !gds_utilities.has(function)) {
+			gds_utilities.insert(function, E);
+		}
+	}
+}
+
+void GDScriptByteCodeCache::Writer::_fail(const String &p_reason) {
+	if (error == OK) {
+		print_verbose(vformat("GDScript: Can't store the compiled form of '%s': %s", root_path, p_reason));
+		error = ERR_UNAVAILABLE;
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_8(uint8_t p_value) {
+	data.push_back(p_value);
+}
+
+void GDScriptByteCodeCache::Writer::put_32(uint32_t p_value) {
+	int pos = data.size();
+	data.resize(pos + 4);
+	encode_uint32(p_value, data.ptrw() + pos);
+}
+
+void GDScriptByteCodeCache::Writer::put_string(const String &p_string) {
+	CharString utf8 = p_string.utf8();
+	put_32(utf8.length());
+	int pos = data.size();
+	data.resize(pos + utf8.length());
+	memcpy(data.ptrw() + pos, utf8.get_data(), utf8.length());
+}
+
+void GDScriptByteCodeCache::Writer::put_variant(const Variant &p_variant) {
+	switch (p_variant.get_type()) {
+		case Variant::OBJECT: {
+			Object *obj = p_variant.get_validated_object();
+			if (!obj) {
+				put_8(VARIANT_TAG_NULL_OBJECT);
+				return;
+			}
+
+			GDScript *script = Object::cast_to<GDScript>(obj);
+			if (script) {
+				put_8(VARIANT_TAG_SCRIPT);
+				put_script(script);
+				return;
+			}
+
+			HashMap<Object *, StringName>::Iterator E = global_objects.find(obj);
+			if (E) {
+				// Native classes and engine singletons.
+				put_8(VARIANT_TAG_GLOBAL);
+				put_string(E->value);
+				return;
+			}
+
+			Resource *res = Object::cast_to<Resource>(obj);
+			if (res && res->get_path().is_resource_file()) {
+				put_8(VARIANT_TAG_RESOURCE);
+				put_string(res->get_path());
+				put_string(res->get_class());
+				return;
+			}
+
+			_fail("Constant of type '" + obj->get_class() + "' is not a global or a resource file.");
+		} break;
+		case Variant::ARRAY: {
+			Array array = p_variant;
+			HashMap<const void *, int>::Iterator E = shared_containers.find(array.id());
+			if (E) {
+				put_8(VARIANT_TAG_SHARED);
+				put_32(E->value);
+				return;
+			}
+			shared_containers.insert(array.id(), shared_containers.size());
+
+			put_8(VARIANT_TAG_ARRAY);
+			put_8(array.is_typed());
+			if (array.is_typed()) {
+				put_32(array.get_typed_builtin());
+				put_string(array.get_typed_class_name());
+				put_variant(array.get_typed_script());
+			}
+			put_8(array.is_read_only());
+			put_32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				put_variant(array[i]);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary dict = p_variant;
+			HashMap<const void *, int>::Iterator E = shared_containers.find(dict.id());
+			if (E) {
+				put_8(VARIANT_TAG_SHARED);
+				put_32(E->value);
+				return;
+			}
+			shared_containers.insert(dict.id(), shared_containers.size());
+
+			put_8(VARIANT_TAG_DICTIONARY);
+			put_8(dict.is_read_only());
+			put_32(dict.size());
+			List<Variant> keys;
+			dict.get_key_list(&keys);
+			for (const Variant &F : keys) {
+				put_variant(F);
+				put_variant(dict[F]);
+			}
+		} break;
+		case Variant::RID:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL: {
+			if (p_variant.is_zero()) {
+				// Default constructed values can be folded into constants.
+				put_8(VARIANT_TAG_EMPTY);
+				put_32(p_variant.get_type());
+				return;
+			}
+			_fail("Constant of type '" + Variant::get_type_name(p_variant.get_type()) + "' can't be stored.");
+		} break;
+		default: {
+			int len = 0;
+			Error err = encode_variant(p_variant, nullptr, len, false);
+			if (err != OK) {
+				_fail("Can't encode constant of type '" + Variant::get_type_name(p_variant.get_type()) + "'.");
+				return;
+			}
+			put_8(VARIANT_TAG_VALUE);
+			put_32(len);
+			int pos = data.size();
+			data.resize(pos + len);
+			encode_variant(p_variant, data.ptrw() + pos, len, false);
+		} break;
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_script(const Script *p_script) {
+	if (!p_script) {
+		put_8(SCRIPT_REF_NONE);
+		return;
+	}
+
+	const GDScript *gdscript = Object::cast_to<GDScript>(p_script);
+	if (!gdscript) {
+		if (!p_script->get_path().is_resource_file()) {
+			_fail("Script '" + p_script->get_path() + "' is not a resource file.");
+			return;
+		}
+		put_8(SCRIPT_REF_RESOURCE);
+		put_string(p_script->get_path());
+		return;
+	}
+
+	Vector<StringName> names;
+	const GDScript *top = gdscript;
+	while (top->_owner) {
+		names.insert(0, top->name);
+		top = top->_owner;
+	}
+
+	String top_path = _get_script_root_path(top);
+	if (top == root || (!root_path.is_empty() && top_path == root_path)) {
+		put_8(SCRIPT_REF_LOCAL);
+	} else {
+		if (!top_path.is_resource_file()) {
+			_fail("Script '" + top_path + "' is not a resource file.");
+			return;
+		}
+		put_8(SCRIPT_REF_EXTERNAL);
+		put_string(top_path);
+	}
+	put_32(names.size());
+	for (int i = 0; i < names.size(); i++) {
+		put_string(names[i]);
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_data_type(const GDScriptDataType &p_type) {
+	put_8(p_type.has_type);
+	put_8(p_type.kind);
+	put_32(p_type.builtin_type);
+	put_string(p_type.native_type);
+	if (p_type.kind == GDScriptDataType::SCRIPT || p_type.kind == GDScriptDataType::GDSCRIPT) {
+		put_script(p_type.script_type);
+		put_8(p_type.script_type_ref.is_valid());
+	}
+	put_8(p_type.has_container_element_type());
+	if (p_type.has_container_element_type()) {
+		put_data_type(p_type.get_container_element_type());
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_function(const GDScriptFunction *p_function) {
+	put_string(p_function->name);
+	put_8(p_function->_static);
+	put_string(p_function->rpc_config.name);
+	put_32(p_function->rpc_config.rpc_mode);
+	put_8(p_function->rpc_config.call_local);
+	put_32(p_function->rpc_config.transfer_mode);
+	put_32(p_function->rpc_config.channel);
+
+	put_data_type(p_function->return_type);
+	put_32(p_function->argument_types.size());
+	for (int i = 0; i < p_function->argument_types.size(); i++) {
+		put_data_type(p_function->argument_types[i]);
+	}
+#ifdef TOOLS_ENABLED
+	put_32(p_function->arg_names.size());
+	for (int i = 0; i < p_function->arg_names.size(); i++) {
+		put_string(p_function->arg_names[i]);
+	}
+	put_32(p_function->default_arg_values.size());
+	for (int i = 0; i < p_function->default_arg_values.size(); i++) {
+		put_variant(p_function->default_arg_values[i]);
+	}
+#else
+	put_32(0);
+	put_32(0);
+#endif
+
+	put_32(p_function->_stack_size);
+	put_32(p_function->_instruction_args_size);
+	put_32(p_function->_ptrcall_args_size);
+	put_32(p_function->_initial_line);
+	put_32(p_function->_inline_caches_count);
+
+	put_32(p_function->code.size());
+	for (int i = 0; i < p_function->code.size(); i++) {
+		put_32(p_function->code[i]);
+	}
+	put_32(p_function->default_arguments.size());
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		put_32(p_function->default_arguments[i]);
+	}
+
+	put_32(p_function->store_global_positions.size());
+	for (int i = 0; i < p_function->store_global_positions.size(); i++) {
+		int pos = p_function->store_global_positions[i];
+		ERR_FAIL_INDEX(pos + 2, p_function->code.size());
+		int opcode = p_function->code[pos] & GDScriptFunction::INSTR_MASK;
+		int index = p_function->code[pos + 2];
+		StringName global;
+		if (opcode == GDScriptFunction::OPCODE_STORE_GLOBAL && global_names.has(index)) {
+			global = global_names[index];
+		} else if (opcode == GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL && index >= 0 && index < p_function->global_names.size()) {
+			global = p_function->global_names[index];
+		} else {
+			_fail("Invalid global access in '" + p_function->name + "'.");
+		}
+		put_32(pos);
+		put_string(global);
+	}
+
+	put_32(p_function->constants.size());
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		put_variant(p_function->constants[i]);
+	}
+	put_32(p_function->global_names.size());
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		put_string(p_function->global_names[i]);
+	}
+
+	if (p_function->operator_funcs.size() || p_function->setters.size() || p_function->getters.size() || p_function->keyed_setters.size() || p_function->keyed_getters.size() || p_function->indexed_setters.size() || p_function->indexed_getters.size() || p_function->builtin_methods.size() || p_function->constructors.size() || p_function->utilities.size() || p_function->gds_utilities.size()) {
+		_build_tables();
+	}
+
+	put_32(p_function->operator_funcs.size());
+	for (int i = 0; i < p_function->operator_funcs.size(); i++) {
+		HashMap<Variant::ValidatedOperatorEvaluator, OperatorKey, FunctionPointerHasher>::Iterator E = operators.find(p_function->operator_funcs[i]);
+		if (!E) {
+			_fail("Unknown operator in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value.op);
+		put_32(E->value.type_a);
+		put_32(E->value.type_b);
+	}
+
+	put_32(p_function->setters.size());
+	for (int i = 0; i < p_function->setters.size(); i++) {
+		HashMap<Variant::ValidatedSetter, MemberKey, FunctionPointerHasher>::Iterator E = setters.find(p_function->setters[i]);
+		if (!E) {
+			_fail("Unknown setter in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value.type);
+		put_string(E->value.name);
+	}
+
+	put_32(p_function->getters.size());
+	for (int i = 0; i < p_function->getters.size(); i++) {
+		HashMap<Variant::ValidatedGetter, MemberKey, FunctionPointerHasher>::Iterator E = getters.find(p_function->getters[i]);
+		if (!E) {
+			_fail("Unknown getter in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value.type);
+		put_string(E->value.name);
+	}
+
+	put_32(p_function->keyed_setters.size());
+	for (int i = 0; i < p_function->keyed_setters.size(); i++) {
+		HashMap<Variant::ValidatedKeyedSetter, Variant::Type, FunctionPointerHasher>::Iterator E = keyed_setters.find(p_function->keyed_setters[i]);
+		if (!E) {
+			_fail("Unknown keyed setter in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value);
+	}
+
+	put_32(p_function->keyed_getters.size());
+	for (int i = 0; i < p_function->keyed_getters.size(); i++) {
+		HashMap<Variant::ValidatedKeyedGetter, Variant::Type, FunctionPointerHasher>::Iterator E = keyed_getters.find(p_function->keyed_getters[i]);
+		if (!E) {
+			_fail("Unknown keyed getter in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value);
+	}
+
+	put_32(p_function->indexed_setters.size());
+	for (int i = 0; i < p_function->indexed_setters.size(); i++) {
+		HashMap<Variant::ValidatedIndexedSetter, Variant::Type, FunctionPointerHasher>::Iterator E = indexed_setters.find(p_function->indexed_setters[i]);
+		if (!E) {
+			_fail("Unknown indexed setter in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value);
+	}
+
+	put_32(p_function->indexed_getters.size());
+	for (int i = 0; i < p_function->indexed_getters.size(); i++) {
+		HashMap<Variant::ValidatedIndexedGetter, Variant::Type, FunctionPointerHasher>::Iterator E = indexed_getters.find(p_function->indexed_getters[i]);
+		if (!E) {
+			_fail("Unknown indexed getter in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value);
+	}
+
+	put_32(p_function->builtin_methods.size());
+	for (int i = 0; i < p_function->builtin_methods.size(); i++) {
+		HashMap<Variant::ValidatedBuiltInMethod, MemberKey, FunctionPointerHasher>::Iterator E = builtin_methods.find(p_function->builtin_methods[i]);
+		if (!E) {
+			_fail("Unknown built-in method in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value.type);
+		put_string(E->value.name);
+	}
+
+	put_32(p_function->constructors.size());
+	for (int i = 0; i < p_function->constructors.size(); i++) {
+		HashMap<Variant::ValidatedConstructor, ConstructorKey, FunctionPointerHasher>::Iterator E = constructors.find(p_function->constructors[i]);
+		if (!E) {
+			_fail("Unknown constructor in '" + p_function->name + "'.");
+			return;
+		}
+		put_32(E->value.type);
+		put_32(E->value.index);
+	}
+
+	put_32(p_function->utilities.size());
+	for (int i = 0; i < p_function->utilities.size(); i++) {
+		HashMap<Variant::ValidatedUtilityFunction, StringName, FunctionPointerHasher>::Iterator E = utilities.find(p_function->utilities[i]);
+		if (!E) {
+			_fail("Unknown utility function in '" + p_function->name + "'.");
+			return;
+		}
+		put_string(E->value);
+	}
+
+	put_32(p_function->gds_utilities.size());
+	for (int i = 0; i < p_function->gds_utilities.size(); i++) {
+		HashMap<GDScriptUtilityFunctions::FunctionPtr, StringName, FunctionPointerHasher>::Iterator E = gds_utilities.find(p_function->gds_utilities[i]);
+		if (!E) {
+			_fail("Unknown GDScript utility function in '" + p_function->name + "'.");
+			return;
+		}
+		put_string(E->value);
+	}
+
+	put_32(p_function->methods.size());
+	for (int i = 0; i < p_function->methods.size(); i++) {
+		put_string(p_function->methods[i]->get_instance_class());
+		put_string(p_function->methods[i]->get_name());
+	}
+
+	put_32(p_function->lambdas.size());
+	for (int i = 0; i < p_function->lambdas.size(); i++) {
+		put_function(p_function->lambdas[i]);
+	}
+
+	put_32(p_function->temporary_slots.size());
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		put_32(E.key);
+		put_32(E.value);
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_class_tree(const GDScript *p_script) {
+	put_32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		put_string(E.key);
+		put_class_tree(E.value.ptr());
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_class(const GDScript *p_script) {
+	put_string(p_script->name);
+	put_8(p_script->tool);
+	put_8(p_script->thread_safe);
+	put_string(p_script->native.is_valid() ? String(p_script->native->get_name()) : String());
+	put_script(p_script->base.ptr());
+
+	put_32(p_script->members.size());
+	for (const StringName &E : p_script->members) {
+		put_string(E);
+	}
+
+	put_32(p_script->member_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->member_indices) {
+		put_string(E.key);
+		put_32(E.value.index);
+		put_string(E.value.setter);
+		put_string(E.value.getter);
+		put_data_type(E.value.data_type);
+	}
+
+	put_32(p_script->member_info.size());
+	for (const KeyValue<StringName, PropertyInfo> &E : p_script->member_info) {
+		put_string(E.key);
+		put_variant(Dictionary(E.value));
+	}
+
+	put_32(p_script->constants.size());
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		put_string(E.key);
+		put_variant(E.value);
+	}
+
+	put_32(p_script->_signals.size());
+	for (const KeyValue<StringName, Vector<StringName>> &E : p_script->_signals) {
+		put_string(E.key);
+		put_32(E.value.size());
+		for (int i = 0; i < E.value.size(); i++) {
+			put_string(E.value[i]);
+		}
+	}
+
+	put_32(p_script->member_functions.size());
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		put_string(E.key);
+		put_function(E.value);
+	}
+	put_8(p_script->initializer != nullptr);
+	if (p_script->initializer) {
+		put_string(p_script->initializer->name);
+	}
+	put_8(p_script->implicit_initializer != nullptr);
+	if (p_script->implicit_initializer) {
+		put_function(p_script->implicit_initializer);
+	}
+	put_8(p_script->implicit_ready != nullptr);
+	if (p_script->implicit_ready) {
+		put_function(p_script->implicit_ready);
+	}
+
+	put_32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		put_string(E.key);
+		put_class(E.value.ptr());
+	}
+}
+
+/* Reader */
+
+class GDScriptByteCodeCache::Reader {
+	const uint8_t *data = nullptr;
+	int size = 0;
+	int pos = 0;
+
+	GDScript *root = nullptr;
+	Vector<Variant> shared_containers;
+
+	GDScript *_get_local_script(const Vector<StringName> &p_names);
+	bool _verify_address(const GDScriptFunction *p_function, const GDScript *p_script, int p_address);
+	void _verify_code(const GDScriptFunction *p_function, const GDScript *p_script, int p_inline_caches_count);
+	void _fail(const String &p_reason);
+
+public:
+	enum ScriptUsage {
+		SCRIPT_USAGE_TYPE, // Compiled types only need a shallow script.
+		SCRIPT_USAGE_BASE,
+		SCRIPT_USAGE_CONSTANT,
+	};
+
+	Error error = OK;
+
+	uint8_t get_8();
+	uint32_t get_32();
+	String get_string();
+	Variant get_variant();
+	Ref<Script> get_script(ScriptUsage p_usage, GDScript **r_local = nullptr);
+	GDScriptDataType get_data_type(GDScript *p_owner);
+	GDScriptFunction *get_function(GDScript *p_script);
+	void get_class_tree(GDScript *p_script);
+	void get_class(GDScript *p_script);
+
+	Reader(GDScript *p_root, const Vector<uint8_t> &p_buffer);
+};
+
+GDScriptByteCodeCache::Reader::Reader(GDScript *p_root, const Vector<uint8_t> &p_buffer) {
+	root = p_root;
+	data = p_buffer.ptr();
+	size = p_buffer.size();
+}
+
+void GDScriptByteCodeCache::Reader::_fail(const String &p_reason) {
+	if (error == OK) {
+		print_verbose(vformat("GDScript: Can't load the compiled form of '%s', compiling from source: %s", _get_script_root_path(root), p_reason));
+		error = ERR_INVALID_DATA;
+	}
+	// Stop reading, so the remaining calls are no-ops.
+	pos = size;
+}
+
+uint8_t GDScriptByteCodeCache::Reader::get_8() {
+	if (pos + 1 > size) {
+		_fail("Unexpected end of data.");
+		return 0;
+	}
+	return data[pos++];
+}
+
+uint32_t GDScriptByteCodeCache::Reader::get_32() {
+	if (pos + 4 > size) {
+		_fail("Unexpected end of data.");
+		return 0;
+	}
+	uint32_t value = decode_uint32(data + pos);
+	pos += 4;
+	return value;
+}
+
+String GDScriptByteCodeCache::Reader::get_string() {
+	uint32_t len = get_32();
+	if (len > uint32_t(size - pos)) {
+		_fail("Unexpected end of data.");
+		return String();
+	}
+	String string;
+	string.parse_utf8((const char *)data + pos, len);
+	pos += len;
+	return string;
+}
+
+Variant GDScriptByteCodeCache::Reader::get_variant() {
+	switch (get_8()) {
+		case VARIANT_TAG_VALUE: {
+			uint32_t len = get_32();
+			if (len > uint32_t(size - pos)) {
+				_fail("Unexpected end of data.");
+				return Variant();
+			}
+			Variant value;
+			if (decode_variant(value, data + pos, len, nullptr, false) != OK) {
+				_fail("Invalid constant.");
+				return Variant();
+			}
+			pos += len;
+			return value;
+		} break;
+		case VARIANT_TAG_EMPTY: {
+			uint32_t type = get_32();
+			if (type >= Variant::VARIANT_MAX) {
+				_fail("Invalid constant.");
+				return Variant();
+			}
+			Variant value;
+			Callable::CallError ce;
+			Variant::construct(Variant::Type(type), value, nullptr, 0, ce);
+			return value;
+		} break;
+		case VARIANT_TAG_NULL_OBJECT: {
+			return Variant((Object *)nullptr);
+		} break;
+		case VARIANT_TAG_SCRIPT: {
+			return get_script(SCRIPT_USAGE_CONSTANT);
+		} break;
+		case VARIANT_TAG_GLOBAL: {
+			StringName name = get_string();
+			GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+			HashMap<StringName, int>::ConstIterator E = language->get_global_map().find(name);
+			if (!E) {
+				_fail("Global '" + String(name) + "' doesn't exist.");
+				return Variant();
+			}
+			return language->get_global_array()[E->value];
+		} break;
+		case VARIANT_TAG_RESOURCE: {
+			String path = get_string();
+			String type = get_string();
+			if (error != OK) {
+				return Variant();
+			}
+			Ref<Resource> res = ResourceLoader::load(path, type);
+			if (res.is_null()) {
+				_fail("Can't load resource '" + path + "'.");
+				return Variant();
+			}
+			return res;
+		} break;
+		case VARIANT_TAG_ARRAY: {
+			Array array;
+			shared_containers.push_back(array);
+			if (get_8()) {
+				uint32_t builtin_type = get_32();
+				StringName class_name = get_string();
+				Variant script = get_variant();
+				if (error != OK || builtin_type >= Variant::VARIANT_MAX) {
+					_fail("Invalid typed array.");
+					return Variant();
+				}
+				array.set_typed(builtin_type, class_name, script);
+			}
+			bool read_only = get_8();
+			uint32_t count = get_32();
+			for (uint32_t i = 0; i < count && error == OK; i++) {
+				array.push_back(get_variant());
+			}
+			array.set_read_only(read_only);
+			return array;
+		} break;
+		case VARIANT_TAG_DICTIONARY: {
+			Dictionary dict;
+			shared_containers.push_back(dict);
+			bool read_only = get_8();
+			uint32_t count = get_32();
+			for (uint32_t i = 0; i < count && error == OK; i++) {
+				Variant key = get_variant();
+				dict[key] = get_variant();
+			}
+			dict.set_read_only(read_only);
+			return dict;
+		} break;
+		case VARIANT_TAG_SHARED: {
+			uint32_t index = get_32();
+			if (index >= uint32_t(shared_containers.size())) {
+				_fail("Invalid shared constant.");
+				return Variant();
+			}
+			return shared_containers[index];
+		} break;
+	}
+
+	_fail("Invalid constant.");
+	return Variant();
+}
+
+GDScript *GDScriptByteCodeCache::Reader::_get_local_script(const Vector<StringName> &p_names) {
+	GDScript *script = root;
+	for (int i = 0; i < p_names.size(); i++) {
+		HashMap<StringName, Ref<GDScript>>::Iterator E = script->subclasses.find(p_names[i]);
+		if (!E) {
+			_fail("Inner class '" + String(p_names[i]) + "' doesn't exist.");
+			return nullptr;
+		}
+		script = E->value.ptr();
+	}
+	return script;
+}
+
+Ref<Script> GDScriptByteCodeCache::Reader::get_script(ScriptUsage p_usage, GDScript **r_local) {
+	if (r_local) {
+		*r_local = nullptr;
+	}
+
+	uint8_t type = get_8();
+	String path;
+	if (type == SCRIPT_REF_EXTERNAL || type == SCRIPT_REF_RESOURCE) {
+		path = get_string();
+	}
+	Vector<StringName> names;
+	if (type == SCRIPT_REF_LOCAL || type == SCRIPT_REF_EXTERNAL) {
+		uint32_t count = get_32();
+		for (uint32_t i = 0; i < count && error == OK; i++) {
+			names.push_back(get_string());
+		}
+	}
+	if (error != OK) {
+		return Ref<Script>();
+	}
+
+	switch (type) {
+		case SCRIPT_REF_NONE: {
+			return Ref<Script>();
+		} break;
+		case SCRIPT_REF_LOCAL: {
+			GDScript *script = _get_local_script(names);
+			if (r_local) {
+				*r_local = script;
+			}
+			return Ref<Script>(script);
+		} break;
+		case SCRIPT_REF_EXTERNAL: {
+			Ref<GDScript> script;
+			String owner = _get_script_root_path(root);
+			if (p_usage == SCRIPT_USAGE_TYPE) {
+				// Inner classes of a script that isn't compiled yet are missing, which fails below instead
+				// of compiling it here, as that could recurse back into this script.
+				script = GDScriptCache::get_shallow_script(path, owner);
+			} else if (p_usage == SCRIPT_USAGE_CONSTANT) {
+				script = ResourceLoader::load(path);
+			} else {
+				Error err = OK;
+				script = GDScriptCache::get_full_script(path, err, owner);
+				if (err != OK) {
+					script = Ref<GDScript>();
+				}
+			}
+			if (script.is_null()) {
+				_fail("Can't load script '" + path + "'.");
+				return Ref<Script>();
+			}
+			for (int i = 0; i < names.size(); i++) {
+				HashMap<StringName, Ref<GDScript>>::Iterator E = script->subclasses.find(names[i]);
+				if (!E) {
+					_fail("Inner class '" + String(names[i]) + "' doesn't exist in '" + path + "'.");
+					return Ref<Script>();
+				}
+				script = E->value;
+			}
+			return script;
+		} break;
+		case SCRIPT_REF_RESOURCE: {
+			Ref<Script> script = ResourceLoader::load(path);
+			if (script.is_null()) {
+				_fail("Can't load script '" + path + "'.");
+			}
+			return script;
+		} break;
+	}
+
+	_fail("Invalid script reference.");
+	return Ref<Script>();
+}
+
+GDScriptDataType GDScriptByteCodeCache::Reader::get_data_type(GDScript *p_owner) {
+	GDScriptDataType type;
+	type.has_type = get_8();
+	type.kind = GDScriptDataType::Kind(get_8());
+	type.builtin_type = Variant::Type(get_32());
+	type.native_type = get_string();
+	if (type.kind > GDScriptDataType::GDSCRIPT || type.builtin_type >= Variant::VARIANT_MAX) {
+		_fail("Invalid data type.");
+		return GDScriptDataType();
+	}
+	if (type.kind == GDScriptDataType::SCRIPT || type.kind == GDScriptDataType::GDSCRIPT) {
+		Ref<Script> script = get_script(SCRIPT_USAGE_TYPE);
+		bool keep_reference = get_8();
+		type.script_type = script.ptr();
+		// Like the compiler, don't keep references to local classes, which would be cyclic.
+		if (keep_reference && script.ptr() != p_owner) {
+			type.script_type_ref = script;
+		}
+	}
+	if (get_8()) {
+		type.set_container_element_type(get_data_type(nullptr));
+	}
+	return type;
+}
+
+bool GDScriptByteCodeCache::Reader::_verify_address(const GDScriptFunction *p_function, const GDScript *p_script, int p_address) {
+	int index = p_address & GDScriptFunction::ADDR_MASK;
+	switch ((uint32_t(p_address) & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+		case GDScriptFunction::ADDR_TYPE_STACK:
+			return index < p_function->_stack_size;
+		case GDScriptFunction::ADDR_TYPE_CONSTANT:
+			return index < p_function->constants.size();
+		case GDScriptFunction::ADDR_TYPE_MEMBER:
+			// Instances of derived classes only add members after these.
+			return index < p_script->member_indices.size();
+	}
+	return false;
+}
+
+void GDScriptByteCodeCache::Reader::_verify_code(const GDScriptFunction *p_function, const GDScript *p_script, int p_inline_caches_count) {
+	// The VM doesn't check operands in release builds, so check everything it reads
+	// from the code before running it: instruction sizes, addresses, table indices
+	// and jump targets. The layouts match what GDScriptByteCodeGenerator writes.
+	const Vector<int> &code = p_function->code;
+	const int code_size = code.size();
+	Vector<bool> instruction_starts;
+	instruction_starts.resize(code_size + 1);
+	instruction_starts.fill(false);
+	Vector<int> jump_targets;
+
+#define VERIFY(m_cond)                                                                   \
+	if (unlikely(!(m_cond))) {                                                           \
+		_fail(vformat("Invalid code in function '%s' at %d.", p_function->name, ip)); \
+		return;                                                                          \
+	}
+
+	int ip = 0;
+	while (ip < code_size) {
+		instruction_starts.write[ip] = true;
+
+		const GDScriptFunction::Opcode opcode = GDScriptFunction::Opcode(code[ip] & GDScriptFunction::INSTR_MASK);
+		const int address_count = uint32_t(code[ip]) >> GDScriptFunction::INSTR_BITS;
+		VERIFY(opcode <= GDScriptFunction::OPCODE_END);
+		VERIFY(address_count <= p_function->_instruction_args_size);
+
+		GDScriptFunction::InstructionLayout layout;
+		VERIFY(GDScriptFunction::get_instruction_layout(opcode, layout));
+		const int addresses = layout.addresses;
+		const int extra = layout.extra;
+		const int argc_pos = layout.argc_pos;
+		const int addresses_per_argument = layout.addresses_per_argument;
+
+		VERIFY(ip + 1 + address_count + extra <= code_size);
+		const int *extra_ptr = code.ptr() + ip + 1 + address_count;
+		if (argc_pos == -1) {
+			VERIFY(address_count == addresses);
+		} else {
+			int argc = extra_ptr[argc_pos];
+			VERIFY(argc >= 0 && address_count == -addresses + argc * addresses_per_argument);
+		}
+		for (int i = 0; i < address_count; i++) {
+			VERIFY(_verify_address(p_function, p_script, code[ip + 1 + i]));
+		}
+
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < Variant::OP_MAX);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->operator_funcs.size());
+				break;
+			case GDScriptFunction::OPCODE_IS_BUILTIN:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+			case GDScriptFunction::OPCODE_CAST_TO_BUILTIN:
+			case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < Variant::VARIANT_MAX);
+				break;
+			case GDScriptFunction::OPCODE_SET_KEYED_VALIDATED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->keyed_setters.size());
+				break;
+			case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->indexed_setters.size());
+				break;
+			case GDScriptFunction::OPCODE_GET_KEYED_VALIDATED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->keyed_getters.size());
+				break;
+			case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->indexed_getters.size());
+				break;
+			case GDScriptFunction::OPCODE_SET_NAMED:
+			case GDScriptFunction::OPCODE_GET_NAMED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->global_names.size());
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_inline_caches_count);
+				break;
+			case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->setters.size());
+				break;
+			case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->getters.size());
+				break;
+			case GDScriptFunction::OPCODE_SET_MEMBER:
+			case GDScriptFunction::OPCODE_GET_MEMBER:
+			case GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->global_names.size());
+				break;
+			case GDScriptFunction::OPCODE_STORE_GLOBAL:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < GDScriptLanguage::get_singleton()->get_global_array_size());
+				break;
+			case GDScriptFunction::OPCODE_CONSTRUCT:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < Variant::VARIANT_MAX);
+				break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->constructors.size());
+				break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < Variant::VARIANT_MAX);
+				VERIFY(extra_ptr[2] >= 0 && extra_ptr[2] < p_function->global_names.size());
+				break;
+			case GDScriptFunction::OPCODE_RETURN_TYPED_ARRAY:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < Variant::VARIANT_MAX);
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->global_names.size());
+				break;
+			case GDScriptFunction::OPCODE_CALL:
+			case GDScriptFunction::OPCODE_CALL_RETURN:
+			case GDScriptFunction::OPCODE_CALL_ASYNC:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->global_names.size());
+				VERIFY(extra_ptr[2] >= 0 && extra_ptr[2] < p_inline_caches_count);
+				break;
+			case GDScriptFunction::OPCODE_CALL_UTILITY:
+			case GDScriptFunction::OPCODE_CALL_SELF_BASE:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->global_names.size());
+				break;
+			case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->utilities.size());
+				break;
+			case GDScriptFunction::OPCODE_CALL_GDSCRIPT_UTILITY:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->gds_utilities.size());
+				break;
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->builtin_methods.size());
+				break;
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->methods.size());
+				break;
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < Variant::VARIANT_MAX);
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->global_names.size());
+				break;
+			case GDScriptFunction::OPCODE_CALL_NATIVE_STATIC:
+				VERIFY(extra_ptr[0] >= 0 && extra_ptr[0] < p_function->methods.size());
+				break;
+			case GDScriptFunction::OPCODE_CREATE_LAMBDA:
+			case GDScriptFunction::OPCODE_CREATE_SELF_LAMBDA:
+				VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->lambdas.size());
+				break;
+			case GDScriptFunction::OPCODE_AWAIT:
+				// Resuming skips the instruction that follows.
+				VERIFY(ip + 2 < code_size && (code[ip + 2] & GDScriptFunction::INSTR_MASK) == GDScriptFunction::OPCODE_AWAIT_RESUME);
+				break;
+			case GDScriptFunction::OPCODE_JUMP:
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT:
+			case GDScriptFunction::OPCODE_JUMP_IF_BOOL:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT_BOOL:
+			case GDScriptFunction::OPCODE_JUMP_IF_SHARED:
+				jump_targets.push_back(extra_ptr[0]);
+				break;
+			default:
+				if (opcode >= GDScriptFunction::OPCODE_CALL_PTRCALL_NO_RETURN && opcode <= GDScriptFunction::OPCODE_CALL_PTRCALL_PACKED_COLOR_ARRAY) {
+					VERIFY(extra_ptr[0] <= p_function->_ptrcall_args_size);
+					VERIFY(extra_ptr[1] >= 0 && extra_ptr[1] < p_function->methods.size());
+				} else if (opcode >= GDScriptFunction::OPCODE_ITERATE_BEGIN && opcode <= GDScriptFunction::OPCODE_ITERATE_OBJECT) {
+					jump_targets.push_back(extra_ptr[0]);
+				}
+				break;
+		}
+
+		ip += 1 + address_count + extra;
+	}
+	instruction_starts.write[code_size] = true;
+
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		jump_targets.push_back(p_function->default_arguments[i]);
+	}
+	for (int i = 0; i < jump_targets.size(); i++) {
+		VERIFY(jump_targets[i] >= 0 && jump_targets[i] <= code_size && instruction_starts[jump_targets[i]]);
+	}
+
+#undef VERIFY
+}
+
+GDScriptFunction *GDScriptByteCodeCache::Reader::get_function(GDScript *p_script) {
+	GDScriptFunction *function = memnew(GDScriptFunction);
+	function->name = get_string();
+	function->_script = p_script;
+	function->source = p_script->get_path();
+#ifdef DEBUG_ENABLED
+	function->func_cname = (String(function->source) + " - " + String(function->name)).utf8();
+	function->_func_cname = function->func_cname.get_data();
+#endif
+	function->_static = get_8();
+	function->rpc_config.name = get_string();
+	function->rpc_config.rpc_mode = Multiplayer::RPCMode(get_32());
+	function->rpc_config.call_local = get_8();
+	function->rpc_config.transfer_mode = Multiplayer::TransferMode(get_32());
+	function->rpc_config.channel = get_32();
+
+	function->return_type = get_data_type(p_script);
+	uint32_t count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		function->argument_types.push_back(get_data_type(p_script));
+	}
+	function->_argument_count = function->argument_types.size();
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName arg_name = get_string();
+#ifdef TOOLS_ENABLED
+		function->arg_names.push_back(arg_name);
+#endif
+	}
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant value = get_variant();
+#ifdef TOOLS_ENABLED
+		function->default_arg_values.push_back(value);
+#endif
+	}
+
+	function->_stack_size = get_32();
+	function->_instruction_args_size = get_32();
+	function->_ptrcall_args_size = get_32();
+	function->_initial_line = get_32();
+	int inline_caches_count = get_32();
+
+	count = get_32();
+	if (count > uint32_t(size - pos) / 4) {
+		_fail("Unexpected end of data.");
+		return function;
+	}
+	function->code.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		function->code.write[i] = get_32();
+	}
+	if (inline_caches_count < 0 || inline_caches_count > function->code.size()) {
+		_fail("Invalid inline cache count.");
+		return function;
+	}
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		function->default_arguments.push_back(get_32());
+	}
+
+	Vector<Pair<int, StringName>> globals;
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		int global_pos = get_32();
+		globals.push_back(Pair<int, StringName>(global_pos, get_string()));
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		function->constants.push_back(get_variant());
+	}
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		function->global_names.push_back(get_string());
+	}
+
+	// Global indices depend on the classes and singletons of the running engine, look them up by name.
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	for (int i = 0; i < globals.size() && error == OK; i++) {
+		int global_pos = globals[i].first;
+		const StringName &global = globals[i].second;
+		if (global_pos < 0 || global_pos + 2 >= function->code.size()) {
+			_fail("Invalid global access.");
+			break;
+		}
+		int instruction = function->code[global_pos] & ~GDScriptFunction::INSTR_MASK;
+		HashMap<StringName, int>::ConstIterator E = language->get_global_map().find(global);
+		if (E) {
+			function->code.write[global_pos] = instruction | GDScriptFunction::OPCODE_STORE_GLOBAL;
+			function->code.write[global_pos + 2] = E->value;
+		} else if (language->get_named_globals_map().has(global)) {
+			int index = function->global_names.find(global);
+			if (index == -1) {
+				index = function->global_names.size();
+				function->global_names.push_back(global);
+			}
+			function->code.write[global_pos] = instruction | GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL;
+			function->code.write[global_pos + 2] = index;
+		} else {
+			_fail("Global '" + String(global) + "' doesn't exist.");
+			break;
+		}
+		function->store_global_positions.push_back(global_pos);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Operator op = Variant::Operator(get_32());
+		Variant::Type type_a = Variant::Type(get_32());
+		Variant::Type type_b = Variant::Type(get_32());
+		Variant::ValidatedOperatorEvaluator evaluator = nullptr;
+		if (op < Variant::OP_MAX && type_a < Variant::VARIANT_MAX && type_b < Variant::VARIANT_MAX) {
+			evaluator = Variant::get_validated_operator_evaluator(op, type_a, type_b);
+		}
+		if (!evaluator) {
+			_fail("Unknown operator.");
+			break;
+		}
+		function->operator_funcs.push_back(evaluator);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		StringName member = get_string();
+		Variant::ValidatedSetter setter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_setter(type, member) : nullptr;
+		if (!setter) {
+			_fail("Unknown setter '" + String(member) + "'.");
+			break;
+		}
+		function->setters.push_back(setter);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		StringName member = get_string();
+		Variant::ValidatedGetter getter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_getter(type, member) : nullptr;
+		if (!getter) {
+			_fail("Unknown getter '" + String(member) + "'.");
+			break;
+		}
+		function->getters.push_back(getter);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		Variant::ValidatedKeyedSetter setter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_keyed_setter(type) : nullptr;
+		if (!setter) {
+			_fail("Unknown keyed setter.");
+			break;
+		}
+		function->keyed_setters.push_back(setter);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		Variant::ValidatedKeyedGetter getter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_keyed_getter(type) : nullptr;
+		if (!getter) {
+			_fail("Unknown keyed getter.");
+			break;
+		}
+		function->keyed_getters.push_back(getter);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		Variant::ValidatedIndexedSetter setter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_indexed_setter(type) : nullptr;
+		if (!setter) {
+			_fail("Unknown indexed setter.");
+			break;
+		}
+		function->indexed_setters.push_back(setter);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		Variant::ValidatedIndexedGetter getter = type < Variant::VARIANT_MAX ? Variant::get_member_validated_indexed_getter(type) : nullptr;
+		if (!getter) {
+			_fail("Unknown indexed getter.");
+			break;
+		}
+		function->indexed_getters.push_back(getter);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		StringName method = get_string();
+		Variant::ValidatedBuiltInMethod builtin_method = type < Variant::VARIANT_MAX ? Variant::get_validated_builtin_method(type, method) : nullptr;
+		if (!builtin_method) {
+			_fail("Unknown built-in method '" + String(method) + "'.");
+			break;
+		}
+		function->builtin_methods.push_back(builtin_method);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		Variant::Type type = Variant::Type(get_32());
+		int index = get_32();
+		Variant::ValidatedConstructor constructor = nullptr;
+		if (type < Variant::VARIANT_MAX && index >= 0 && index < Variant::get_constructor_count(type)) {
+			constructor = Variant::get_validated_constructor(type, index);
+		}
+		if (!constructor) {
+			_fail("Unknown constructor.");
+			break;
+		}
+		function->constructors.push_back(constructor);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName utility = get_string();
+		Variant::ValidatedUtilityFunction utility_function = Variant::get_validated_utility_function(utility);
+		if (!utility_function) {
+			_fail("Unknown utility function '" + String(utility) + "'.");
+			break;
+		}
+		function->utilities.push_back(utility_function);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName utility = get_string();
+		GDScriptUtilityFunctions::FunctionPtr utility_function = GDScriptUtilityFunctions::get_function(utility);
+		if (!utility_function) {
+			_fail("Unknown GDScript utility function '" + String(utility) + "'.");
+			break;
+		}
+		function->gds_utilities.push_back(utility_function);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName class_name = get_string();
+		StringName method = get_string();
+		MethodBind *method_bind = ClassDB::get_method(class_name, method);
+		if (!method_bind) {
+			_fail("Unknown method '" + String(class_name) + "::" + String(method) + "'.");
+			break;
+		}
+		function->methods.push_back(method_bind);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		function->lambdas.push_back(get_function(p_script));
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		int slot = get_32();
+		Variant::Type type = Variant::Type(get_32());
+		if (slot < 0 || slot >= function->_stack_size || type >= Variant::VARIANT_MAX) {
+			_fail("Invalid temporary slot.");
+			break;
+		}
+		function->temporary_slots[slot] = type;
+	}
+
+	// Arguments and the fixed addresses (self, class and nil) come first on the stack.
+	if (function->_stack_size < 3 + function->_argument_count || function->_instruction_args_size < 0 || function->_ptrcall_args_size < 0 || function->default_arguments.size() > function->_argument_count + 1) {
+		_fail("Invalid function layout.");
+	}
+	if (error == OK) {
+		_verify_code(function, p_script, inline_caches_count);
+	}
+
+	// Same as GDScriptByteCodeGenerator::write_end().
+	function->_constants_ptr = function->constants.is_empty() ? nullptr : function->constants.ptrw();
+	function->_constant_count = function->constants.size();
+	function->_global_names_ptr = function->global_names.is_empty() ? nullptr : function->global_names.ptr();
+	function->_global_names_count = function->global_names.size();
+	function->_code_ptr = function->code.is_empty() ? nullptr : function->code.ptr();
+	function->_code_size = function->code.size();
+	if (inline_caches_count > 0) {
+		function->_inline_caches_count = inline_caches_count;
+		function->_inline_caches_ptr = memnew_arr(GDScriptInlineCache, inline_caches_count);
+	}
+	function->_default_arg_ptr = function->default_arguments.is_empty() ? nullptr : function->default_arguments.ptr();
+	function->_default_arg_count = function->default_arguments.is_empty() ? 0 : function->default_arguments.size() - 1;
+	function->_operator_funcs_ptr = function->operator_funcs.is_empty() ? nullptr : function->operator_funcs.ptr();
+	function->_operator_funcs_count = function->operator_funcs.size();
+	function->_setters_ptr = function->setters.is_empty() ? nullptr : function->setters.ptr();
+	function->_setters_count = function->setters.size();
+	function->_getters_ptr = function->getters.is_empty() ? nullptr : function->getters.ptr();
+	function->_getters_count = function->getters.size();
+	function->_keyed_setters_ptr = function->keyed_setters.is_empty() ? nullptr : function->keyed_setters.ptr();
+	function->_keyed_setters_count = function->keyed_setters.size();
+	function->_keyed_getters_ptr = function->keyed_getters.is_empty() ? nullptr : function->keyed_getters.ptr();
+	function->_keyed_getters_count = function->keyed_getters.size();
+	function->_indexed_setters_ptr = function->indexed_setters.is_empty() ? nullptr : function->indexed_setters.ptr();
+	function->_indexed_setters_count = function->indexed_setters.size();
+	function->_indexed_getters_ptr = function->indexed_getters.is_empty() ? nullptr : function->indexed_getters.ptr();
+	function->_indexed_getters_count = function->indexed_getters.size();
+	function->_builtin_methods_ptr = function->builtin_methods.is_empty() ? nullptr : function->builtin_methods.ptr();
+	function->_builtin_methods_count = function->builtin_methods.size();
+	function->_constructors_ptr = function->constructors.is_empty() ? nullptr : function->constructors.ptr();
+	function->_constructors_count = function->constructors.size();
+	function->_utilities_ptr = function->utilities.is_empty() ? nullptr : function->utilities.ptr();
+	function->_utilities_count = function->utilities.size();
+	function->_gds_utilities_ptr = function->gds_utilities.is_empty() ? nullptr : function->gds_utilities.ptr();
+	function->_gds_utilities_count = function->gds_utilities.size();
+	function->_methods_ptr = function->methods.is_empty() ? nullptr : function->methods.ptrw();
+	function->_methods_count = function->methods.size();
+	function->_lambdas_ptr = function->lambdas.is_empty() ? nullptr : function->lambdas.ptrw();
+	function->_lambdas_count = function->lambdas.size();
+
+	return function;
+}
+
+void GDScriptByteCodeCache::Reader::get_class_tree(GDScript *p_script) {
+	uint32_t count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName name = get_string();
+		String fully_qualified_name = p_script->fully_qualified_name + "::" + name;
+
+		// Same as GDScriptCompiler::_make_scripts().
+		Ref<GDScript> subclass = GDScriptLanguage::get_singleton()->get_orphan_subclass(fully_qualified_name);
+		if (subclass.is_null()) {
+			subclass.instantiate();
+		}
+		subclass->_owner = p_script;
+		subclass->fully_qualified_name = fully_qualified_name;
+		p_script->subclasses.insert(name, subclass);
+
+		get_class_tree(subclass.ptr());
+	}
+}
+
+void GDScriptByteCodeCache::Reader::get_class(GDScript *p_script) {
+	p_script->name = get_string();
+	p_script->tool = get_8();
+	p_script->thread_safe = get_8();
+
+	StringName native = get_string();
+	if (native != StringName()) {
+		GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+		HashMap<StringName, int>::ConstIterator E = language->get_global_map().find(native);
+		if (E) {
+			p_script->native = language->get_global_array()[E->value];
+		}
+		if (p_script->native.is_null()) {
+			_fail("Native class '" + String(native) + "' doesn't exist.");
+			return;
+		}
+	}
+
+	GDScript *local_base = nullptr;
+	Ref<GDScript> base = get_script(SCRIPT_USAGE_BASE, &local_base);
+	p_script->base = base;
+	p_script->_base = base.ptr();
+
+	uint32_t count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		p_script->members.insert(get_string());
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName member = get_string();
+		GDScript::MemberInfo info;
+		info.index = get_32();
+		info.setter = get_string();
+		info.getter = get_string();
+		info.data_type = get_data_type(p_script);
+		p_script->member_indices.insert(member, info);
+	}
+	if (base.is_valid() && local_base == nullptr) {
+		// Member indices are inherited, an external base compiled from a different source would break them.
+		for (const KeyValue<StringName, GDScript::MemberInfo> &E : base->member_indices) {
+			HashMap<StringName, GDScript::MemberInfo>::Iterator F = p_script->member_indices.find(E.key);
+			if (!F || F->value.index != E.value.index) {
+				_fail("Base class '" + _get_script_root_path(base.ptr()) + "' doesn't match.");
+				return;
+			}
+		}
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName member = get_string();
+		p_script->member_info.insert(member, PropertyInfo::from_dict(get_variant()));
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName constant = get_string();
+		p_script->constants.insert(constant, get_variant());
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName signal = get_string();
+		Vector<StringName> parameters;
+		uint32_t parameter_count = get_32();
+		for (uint32_t j = 0; j < parameter_count && error == OK; j++) {
+			parameters.push_back(get_string());
+		}
+		p_script->_signals.insert(signal, parameters);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName function_name = get_string();
+		p_script->member_functions.insert(function_name, get_function(p_script));
+	}
+	if (get_8()) {
+		StringName initializer = get_string();
+		if (!p_script->member_functions.has(initializer)) {
+			_fail("Missing initializer.");
+			return;
+		}
+		p_script->initializer = p_script->member_functions[initializer];
+	}
+	if (get_8()) {
+		p_script->implicit_initializer = get_function(p_script);
+	}
+	if (get_8()) {
+		p_script->implicit_ready = get_function(p_script);
+	}
+
+	count = get_32();
+	for (uint32_t i = 0; i < count && error == OK; i++) {
+		StringName name = get_string();
+		HashMap<StringName, Ref<GDScript>>::Iterator E = p_script->subclasses.find(name);
+		if (!E) {
+			_fail("Inner class '" + String(name) + "' doesn't exist.");
+			return;
+		}
+		get_class(E->value.ptr());
+	}
+
+	p_script->valid = error == OK;
+}
+
+/* GDScriptByteCodeCache */
+
+void GDScriptByteCodeCache::_clear_script(GDScript *p_script) {
+	// Same as what GDScriptCompiler does before compiling a class.
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		memdelete(E.value);
+	}
+	if (p_script->implicit_initializer) {
+		memdelete(p_script->implicit_initializer);
+	}
+	if (p_script->implicit_ready) {
+		memdelete(p_script->implicit_ready);
+	}
+	p_script->native = Ref<GDScriptNativeClass>();
+	p_script->base = Ref<GDScript>();
+	p_script->_base = nullptr;
+	p_script->members.clear();
+	p_script->constants.clear();
+	p_script->member_functions.clear();
+	p_script->member_indices.clear();
+	p_script->member_info.clear();
+	p_script->_signals.clear();
+	p_script->subclasses.clear();
+	p_script->initializer = nullptr;
+	p_script->implicit_initializer = nullptr;
+	p_script->implicit_ready = nullptr;
+	p_script->valid = false;
+}
+
+Error GDScriptByteCodeCache::serialize(const GDScript *p_script, bool p_debug, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(p_script->_owner, ERR_INVALID_PARAMETER, "Only the outermost class of a script can be serialized.");
+	ERR_FAIL_COND_V_MSG(!p_script->valid, ERR_INVALID_PARAMETER, "Can't serialize a script that failed to compile.");
+
+	Writer writer(p_script);
+	writer.put_8('G');
+	writer.put_8('D');
+	writer.put_8('B');
+	writer.put_8('C');
+	writer.put_32(FORMAT_VERSION);
+	writer.put_string(_get_engine_key());
+	writer.put_32(p_debug ? FLAG_DEBUG : 0);
+
+	// The source still ships next to the compiled form, loading checks that they match.
+	Vector<uint8_t> source_hash = p_script->source.sha256_buffer();
+	for (int i = 0; i < source_hash.size(); i++) {
+		writer.put_8(source_hash[i]);
+	}
+
+	writer.put_class_tree(p_script);
+	writer.put_class(p_script);
+	if (writer.error != OK) {
+		return writer.error;
+	}
+
+	r_buffer = writer.data;
+	return OK;
+}
+
+Error GDScriptByteCodeCache::deserialize(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+
+	Reader reader(p_script, p_buffer);
+	if (reader.get_8() != 'G' || reader.get_8() != 'D' || reader.get_8() != 'B' || reader.get_8() != 'C') {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	if (reader.get_32() != FORMAT_VERSION || reader.get_string() != _get_engine_key()) {
+		print_verbose(vformat("GDScript: Compiled form of '%s' was made by a different engine build, compiling from source.", _get_script_root_path(p_script)));
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	uint32_t flags = reader.get_32();
+#ifdef DEBUG_ENABLED
+	const bool debug = true;
+#else
+	const bool debug = false;
+#endif
+	if (bool(flags & FLAG_DEBUG) != debug) {
+		// Debug code has line markers the debugger relies on, release code doesn't.
+		print_verbose(vformat("GDScript: Compiled form of '%s' doesn't match the build type, compiling from source.", _get_script_root_path(p_script)));
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	Vector<uint8_t> source_hash = p_script->source.sha256_buffer();
+	for (int i = 0; i < source_hash.size(); i++) {
+		if (reader.get_8() != source_hash[i]) {
+			print_verbose(vformat("GDScript: Compiled form of '%s' is out of date, compiling from source.", _get_script_root_path(p_script)));
+			return ERR_FILE_UNRECOGNIZED;
+		}
+	}
+	if (reader.error != OK) {
+		return reader.error;
+	}
+
+	_clear_script(p_script);
+	p_script->fully_qualified_name = p_script->path;
+	p_script->_owner = nullptr;
+
+	reader.get_class_tree(p_script);
+	reader.get_class(p_script);
+	if (reader.error != OK) {
+		_clear_script(p_script);
+		return reader.error;
+	}
+
+	return OK;
+}
+
+Error GDScriptByteCodeCache::compile(const String &p_path, bool p_debug, Vector<uint8_t> &r_buffer) {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_script_path(p_path);
+	Error err = script->load_source_code(p_path);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	GDScriptParser parser;
+	err = parser.parse(script->get_source_code(), p_path, false);
+	if (err != OK) {
+		return err;
+	}
+	GDScriptAnalyzer analyzer(&parser);
+	err = analyzer.analyze();
+	if (err != OK) {
+		return err;
+	}
+
+	GDScriptCompiler compiler;
+	compiler.set_debug_codegen(p_debug);
+	err = compiler.compile(&parser, script.ptr(), false);
+	if (err != OK) {
+		return err;
+	}
+	script->valid = true;
+
+	return serialize(script.ptr(), p_debug, r_buffer);
+}
+
+String GDScriptByteCodeCache::get_cache_path(const String &p_script_path) {
+	return p_script_path.get_basename() + ".gdc";
+}
+
+bool GDScriptByteCodeCache::is_enabled() {
+	// The editor always works on the source, and the debugger needs the debug code it's compiled with.
+	return !Engine::get_singleton()->is_editor_hint() && !EngineDebugger::is_active();
+}
@@ -0,0 +1,67 @@
+/*************************************************************************/
+/*  gdscript_byte_code_cache.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_BYTE_CODE_CACHE_H
+#define GDSCRIPT_BYTE_CODE_CACHE_H
+
+#include "core/templates/vector.h"
+#include "gdscript.h"
+
+// Serialized form of a compiled GDScript, so exported projects can skip the
+// parser, analyzer and compiler at startup. Engine pointers (validated calls,
+// method binds, global indices) are stored by name and resolved when loading.
+// Anything that can't be resolved makes loading fail, and the caller falls
+// back to compiling the source code. This includes types that are inner
+// classes of another script which isn't compiled yet, as compiling it from
+// here could recurse back into this script. Such scripts load from source
+// unless the other script happens to be loaded first.
+class GDScriptByteCodeCache {
+	class Writer;
+	class Reader;
+
+	static String _get_script_root_path(const GDScript *p_script);
+	static void _clear_script(GDScript *p_script);
+
+public:
+	enum {
+		FORMAT_VERSION = 3,
+	};
+
+	static Error serialize(const GDScript *p_script, bool p_debug, Vector<uint8_t> &r_buffer);
+	static Error deserialize(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+
+	// Compiles the script at the given path with debug or release codegen and serializes it.
+	static Error compile(const String &p_path, bool p_debug, Vector<uint8_t> &r_buffer);
+
+	static String get_cache_path(const String &p_script_path);
+	static bool is_enabled();
+};
+
+#endif // GDSCRIPT_BYTE_CODE_CACHE_H
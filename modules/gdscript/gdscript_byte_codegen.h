@@ -53,6 +53,8 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	bool debug_stack = false;
 
 	Vector<int> opcodes;
+	int last_instruction_pos = -1;
+	int last_jump_target = -1; // Latest position a forward jump was patched to land on.
 	List<RBMap<StringName, int>> stack_id_stack;
 	RBMap<StringName, int> stack_identifiers;
 	List<int> stack_identifiers_counts;
@@ -71,6 +73,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int current_line = 0;
 	int instr_args_max = 0;
 	int ptrcall_max = 0;
+	int inline_cache_count = 0;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -332,6 +335,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	}
 
 	void append(GDScriptFunction::Opcode p_code, int p_argument_count) {
+		last_instruction_pos = opcodes.size();
 		opcodes.push_back((p_code & GDScriptFunction::INSTR_MASK) | (p_argument_count << GDScriptFunction::INSTR_BITS));
 		instr_args_max = MAX(instr_args_max, p_argument_count);
 	}
@@ -402,6 +406,18 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	void patch_jump(int p_address) {
 		opcodes.write[p_address] = opcodes.size();
+		last_jump_target = opcodes.size();
+	}
+
+	void append_conditional_jump(const Address &p_condition, bool p_jump_if_true) {
+		// Bool temporaries always hold a bool, so they can be tested without converting them.
+		bool is_bool = p_condition.mode == Address::TEMPORARY && temporaries[p_condition.address].type == Variant::BOOL;
+		if (p_jump_if_true) {
+			append(is_bool ? GDScriptFunction::OPCODE_JUMP_IF_BOOL : GDScriptFunction::OPCODE_JUMP_IF, 1);
+		} else {
+			append(is_bool ? GDScriptFunction::OPCODE_JUMP_IF_NOT_BOOL : GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
+		}
+		append(p_condition);
 	}
 
 public:
@@ -450,6 +466,7 @@ public:
 	virtual void write_set_member(const Address &p_value, const StringName &p_name) override;
 	virtual void write_get_member(const Address &p_target, const StringName &p_name) override;
 	virtual void write_assign(const Address &p_target, const Address &p_source) override;
+	virtual void write_assign_from_result(const Address &p_target, const Address &p_source) override;
 	virtual void write_assign_with_conversion(const Address &p_target, const Address &p_source) override;
 	virtual void write_assign_true(const Address &p_target) override;
 	virtual void write_assign_false(const Address &p_target) override;
@@ -30,11 +30,16 @@
 
 #include "gdscript_cache.h"
 
+#include "core/config/project_settings.h"
 #include "core/io/file_access.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_uid.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/templates/vector.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
 #include "gdscript_parser.h"
+#include "gdscript_tokenizer.h"
 
 bool GDScriptParserRef::is_valid() const {
 	return parser != nullptr;
@@ -51,6 +56,18 @@ GDScriptParser *GDScriptParserRef::get_parser() const {
 Error GDScriptParserRef::raise_status(Status p_new_status) {
 	ERR_FAIL_COND_V(parser == nullptr, ERR_INVALID_DATA);
 
+	if (p_new_status > EMPTY) {
+		// Parsing doesn't touch other scripts, so it's done outside of the cache lock.
+		MutexLock parse_guard(parse_lock);
+		if (!parsed) {
+			parse_result = parser->parse(GDScriptCache::get_source_code(path), path, false);
+			parsed = true;
+		}
+	}
+
+	// The analyzer resolves other scripts' trees as well, so only one thread analyzes at a time.
+	MutexLock lock(GDScriptCache::singleton->lock);
+
 	if (result != OK) {
 		return result;
 	}
@@ -59,7 +76,7 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 		switch (status) {
 			case EMPTY:
 				status = PARSED;
-				result = parser->parse(GDScriptCache::get_source_code(path), path, false);
+				result = parse_result;
 				break;
 			case PARSED: {
 				analyzer = memnew(GDScriptAnalyzer(parser));
@@ -106,6 +123,8 @@ GDScriptParserRef::~GDScriptParserRef() {
 	GDScriptCache::singleton->parser_map.erase(path);
 }
 
+thread_local int GDScriptCacheLock::depth = 0;
+
 GDScriptCache *GDScriptCache::singleton = nullptr;
 
 void GDScriptCache::remove_script(const String &p_path) {
@@ -115,27 +134,29 @@ void GDScriptCache::remove_script(const String &p_path) {
 }
 
 Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
-	MutexLock lock(singleton->lock);
 	Ref<GDScriptParserRef> ref;
-	if (!p_owner.is_empty()) {
-		singleton->dependencies[p_owner].insert(p_path);
-	}
-	if (singleton->parser_map.has(p_path)) {
-		ref = Ref<GDScriptParserRef>(singleton->parser_map[p_path]);
-		if (ref.is_null()) {
-			r_error = ERR_INVALID_DATA;
-			return ref;
+	{
+		MutexLock lock(singleton->lock);
+		if (!p_owner.is_empty()) {
+			singleton->dependencies[p_owner].insert(p_path);
 		}
-	} else {
-		if (!FileAccess::exists(p_path)) {
-			r_error = ERR_FILE_NOT_FOUND;
-			return ref;
+		if (singleton->parser_map.has(p_path)) {
+			ref = Ref<GDScriptParserRef>(singleton->parser_map[p_path]);
+			if (ref.is_null()) {
+				r_error = ERR_INVALID_DATA;
+				return ref;
+			}
+		} else {
+			if (!FileAccess::exists(p_path)) {
+				r_error = ERR_FILE_NOT_FOUND;
+				return ref;
+			}
+			GDScriptParser *parser = memnew(GDScriptParser);
+			ref.instantiate();
+			ref->parser = parser;
+			ref->path = p_path;
+			singleton->parser_map[p_path] = ref.ptr();
 		}
-		GDScriptParser *parser = memnew(GDScriptParser);
-		ref.instantiate();
-		ref->parser = parser;
-		ref->path = p_path;
-		singleton->parser_map[p_path] = ref.ptr();
 	}
 	r_error = ref->raise_status(p_status);
 
@@ -168,6 +189,7 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const Stri
 	if (!p_owner.is_empty()) {
 		singleton->dependencies[p_owner].insert(p_path);
 	}
+	singleton->_wait_for_compile(p_path);
 	if (singleton->full_gdscript_cache.has(p_path)) {
 		return singleton->full_gdscript_cache[p_path];
 	}
@@ -193,9 +215,14 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 	}
 
 	r_error = OK;
+	singleton->_wait_for_compile(p_path);
 	if (singleton->full_gdscript_cache.has(p_path)) {
 		return singleton->full_gdscript_cache[p_path];
 	}
+	if (singleton->compiling.has(p_path)) {
+		// A cyclic reference, compiled further up the stack of the calling thread or of a thread waiting for it.
+		return singleton->shallow_gdscript_cache[p_path];
+	}
 
 	Ref<GDScript> script = get_shallow_script(p_path);
 	ERR_FAIL_COND_V(script.is_null(), Ref<GDScript>());
@@ -206,7 +233,9 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 		return script;
 	}
 
+	singleton->_begin_compile(p_path);
 	r_error = script->reload();
+	singleton->_end_compile(p_path);
 	if (r_error) {
 		return script;
 	}
@@ -218,6 +247,8 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 }
 
 Error GDScriptCache::finish_compiling(const String &p_owner) {
+	MutexLock lock(singleton->lock);
+
 	// Mark this as compiled.
 	Ref<GDScript> script = get_shallow_script(p_owner);
 	singleton->full_gdscript_cache[p_owner] = script.ptr();
@@ -241,6 +272,316 @@ Error GDScriptCache::finish_compiling(const String &p_owner) {
 	return err;
 }
 
+// Marks a script as being compiled by the calling thread, so other threads wait for it instead of compiling it too.
+void GDScriptCache::_begin_compile(const String &p_path) {
+	Compiling *state = memnew(Compiling);
+	state->thread = Thread::get_caller_id();
+	compiling.insert(p_path, state);
+}
+
+void GDScriptCache::_end_compile(const String &p_path) {
+	Compiling *state = compiling[p_path];
+	compiling.erase(p_path);
+	state->finished = true;
+	if (state->waiters == 0) {
+		memdelete(state);
+	} else {
+		for (int i = 0; i < state->waiters; i++) {
+			state->done.post();
+		}
+	}
+}
+
+// Makes sure no other thread is compiling the script when it's used. The cache lock is given up while waiting, as the
+// other thread needs it to go on, and the scripts the calling thread is compiling are marked so nobody else starts them
+// meanwhile. If the other thread waits for the calling one, directly or through others, all of them are blocked: the
+// script is then used as it is, the same as a cyclic reference compiled on a single thread.
+void GDScriptCache::_wait_for_compile(const String &p_path) {
+	Thread::ID caller = Thread::get_caller_id();
+	while (compiling.has(p_path)) {
+		Compiling *state = compiling[p_path];
+		bool waits_for_caller = state->thread == caller;
+		for (Thread::ID thread = state->thread; !waits_for_caller && compile_waiting.has(thread);) {
+			thread = compile_waiting[thread]->thread;
+			waits_for_caller = thread == caller;
+		}
+		if (waits_for_caller) {
+			return;
+		}
+
+		state->waiters++;
+		compile_waiting.insert(caller, state);
+		int depth = lock.get_depth();
+		for (int i = 0; i < depth; i++) {
+			lock.unlock();
+		}
+		state->done.wait();
+		for (int i = 0; i < depth; i++) {
+			lock.lock();
+		}
+		compile_waiting.erase(caller);
+		state->waiters--;
+		if (state->finished && state->waiters == 0) {
+			memdelete(state);
+		}
+	}
+}
+
+// Returns the file a resource dependency refers to, or an empty string if there is none.
+static String _prewarm_dependency_path(const String &p_dependency) {
+	String path = p_dependency.get_slice("::", 0);
+	if (path.begins_with("uid://")) {
+		ResourceUID::ID id = ResourceUID::get_singleton()->text_to_id(path);
+		if (!ResourceUID::get_singleton()->has_id(id)) {
+			return String();
+		}
+		path = ResourceUID::get_singleton()->get_id_path(id);
+	}
+	if (!ResourceLoader::exists(path)) {
+		return String();
+	}
+	return path;
+}
+
+static bool _prewarm_is_script(const String &p_path) {
+	return p_path.get_extension() == "gd";
+}
+
+// Finds the scripts a resource depends on, looking through the scenes and resources in between.
+static void _prewarm_collect_scripts(const String &p_path, const HashMap<String, Vector<String>> &p_graph, HashSet<String> &r_visited, Vector<String> &r_scripts) {
+	for (const String &E : p_graph[p_path]) {
+		if (r_visited.has(E)) {
+			continue;
+		}
+		r_visited.insert(E);
+		if (_prewarm_is_script(E)) {
+			r_scripts.push_back(E);
+		} else {
+			_prewarm_collect_scripts(E, p_graph, r_visited, r_scripts);
+		}
+	}
+}
+
+// Groups scripts that depend on each other (Tarjan's algorithm). A group is added after all the groups it depends on.
+struct GDScriptPrewarmSorter {
+	HashMap<String, Vector<String>> edges;
+	HashMap<String, int> index;
+	HashMap<String, int> low;
+	LocalVector<String> stack;
+	HashSet<String> on_stack;
+	Vector<Vector<String>> groups;
+
+	void visit(const String &p_path) {
+		int path_index = index.size();
+		index[p_path] = path_index;
+		low[p_path] = path_index;
+		stack.push_back(p_path);
+		on_stack.insert(p_path);
+
+		const Vector<String> deps = edges[p_path];
+		for (const String &E : deps) {
+			if (!index.has(E)) {
+				visit(E);
+				low[p_path] = MIN(low[p_path], low[E]);
+			} else if (on_stack.has(E)) {
+				low[p_path] = MIN(low[p_path], index[E]);
+			}
+		}
+
+		if (low[p_path] == path_index) {
+			Vector<String> group;
+			String member;
+			do {
+				member = stack[stack.size() - 1];
+				stack.resize(stack.size() - 1);
+				on_stack.erase(member);
+				group.push_back(member);
+			} while (member != p_path);
+			groups.push_back(group);
+		}
+	}
+};
+
+// Lists every script the source could refer to while compiling: the paths used by `extends` and `preload()`, and the
+// global classes and autoloads it names anywhere, function bodies included. Names that aren't used as such (like
+// a local variable shadowing a class name) only add an edge, which costs some parallelism but is never wrong.
+static void _prewarm_script_references(const String &p_path, List<String> *r_references) {
+	GDScriptTokenizer tokenizer;
+	tokenizer.set_source_code(GDScriptCache::get_source_code(p_path));
+
+	GDScriptTokenizer::Token::Type previous = GDScriptTokenizer::Token::EMPTY;
+	GDScriptTokenizer::Token::Type before_previous = GDScriptTokenizer::Token::EMPTY;
+	for (GDScriptTokenizer::Token token = tokenizer.scan(); token.type != GDScriptTokenizer::Token::TK_EOF; token = tokenizer.scan()) {
+		String path;
+		if (token.type == GDScriptTokenizer::Token::LITERAL && token.literal.get_type() == Variant::STRING) {
+			if (previous == GDScriptTokenizer::Token::EXTENDS || (previous == GDScriptTokenizer::Token::PARENTHESIS_OPEN && before_previous == GDScriptTokenizer::Token::PRELOAD)) {
+				// Same as how the analyzer resolves the path.
+				path = token.literal;
+				if (path.is_relative_path()) {
+					path = p_path.get_base_dir().plus_file(path);
+				}
+				path = path.simplify_path();
+			}
+		} else if (token.type == GDScriptTokenizer::Token::IDENTIFIER) {
+			StringName name = token.get_identifier();
+			if (ScriptServer::is_global_class(name)) {
+				path = ScriptServer::get_global_class_path(name);
+			} else if (ProjectSettings::get_singleton()->has_autoload(name) && ProjectSettings::get_singleton()->get_autoload(name).is_singleton) {
+				path = ProjectSettings::get_singleton()->get_autoload(name).path;
+			}
+		}
+		if (!path.is_empty() && path != p_path && !r_references->find(path)) {
+			r_references->push_back(path);
+		}
+		before_previous = previous;
+		previous = token.type;
+	}
+}
+
+void GDScriptCache::_prewarm_scan(uint32_t p_index, PrewarmData *p_data) {
+	const String &scan_path = p_data->scan[p_index];
+	List<String> deps;
+	if (_prewarm_is_script(scan_path)) {
+		// The loader only reports what's needed to load a script, not what compiling it touches.
+		_prewarm_script_references(scan_path, &deps);
+	} else {
+		ResourceLoader::get_dependencies(scan_path, &deps);
+	}
+
+	Vector<String> &result = p_data->scan_results[p_index];
+	for (const String &E : deps) {
+		String path = _prewarm_dependency_path(E);
+		if (!path.is_empty()) {
+			result.push_back(path);
+		}
+	}
+}
+
+void GDScriptCache::_prewarm_compile(uint32_t p_index, PrewarmData *p_data) {
+	// Scripts in the same group depend on each other, so they're compiled one after the other.
+	for (const String &path : p_data->compile_groups[p_index]) {
+		Ref<GDScript> script;
+		{
+			MutexLock guard(lock);
+			if (full_gdscript_cache.has(path)) {
+				// Already compiled along with another script of the group.
+				continue;
+			}
+			script = get_shallow_script(path);
+			_begin_compile(path);
+		}
+
+		// Same as get_full_script(), but without holding the cache lock for the whole compilation.
+		// The shallow script already loaded the source code.
+		script->reload();
+
+		MutexLock guard(lock);
+		_end_compile(path);
+		prewarmed_scripts.push_back(script);
+	}
+}
+
+void GDScriptCache::prewarm(const Vector<String> &p_paths) {
+	// Filled on first use, make sure it's not done by several threads at once.
+	GDScriptParser::get_builtin_type(StringName());
+
+	// Find every resource reachable from the given ones, one level of dependencies at a time.
+	HashMap<String, Vector<String>> graph;
+	Vector<String> wave;
+	for (const String &E : p_paths) {
+		String path = _prewarm_dependency_path(E);
+		if (!path.is_empty() && !graph.has(path)) {
+			graph.insert(path, Vector<String>());
+			wave.push_back(path);
+		}
+	}
+
+	ThreadWorkPool pool;
+	pool.init();
+
+	PrewarmData data;
+	while (!wave.is_empty()) {
+		data.scan = wave;
+		data.scan_results.clear();
+		data.scan_results.resize(wave.size());
+		pool.do_work(wave.size(), singleton, &GDScriptCache::_prewarm_scan, &data);
+
+		wave.clear();
+		for (int i = 0; i < data.scan.size(); i++) {
+			graph[data.scan[i]] = data.scan_results[i];
+			for (const String &E : data.scan_results[i]) {
+				if (!graph.has(E)) {
+					graph.insert(E, Vector<String>());
+					wave.push_back(E);
+				}
+			}
+		}
+	}
+
+	// Only scripts are compiled, scenes and resources in between just carry their dependencies.
+	GDScriptPrewarmSorter sorter;
+	for (const KeyValue<String, Vector<String>> &E : graph) {
+		if (_prewarm_is_script(E.key)) {
+			HashSet<String> visited;
+			Vector<String> scripts;
+			_prewarm_collect_scripts(E.key, graph, visited, scripts);
+			sorter.edges.insert(E.key, scripts);
+		}
+	}
+	for (const KeyValue<String, Vector<String>> &E : sorter.edges) {
+		if (!sorter.index.has(E.key)) {
+			sorter.visit(E.key);
+		}
+	}
+
+	// A group can be compiled once all the groups it depends on are, so groups are split in levels
+	// of independent ones.
+	HashMap<String, int> group_of;
+	Vector<int> group_levels;
+	Vector<Vector<Vector<String>>> levels;
+	for (int i = 0; i < sorter.groups.size(); i++) {
+		int level = 0;
+		for (const String &path : sorter.groups[i]) {
+			group_of[path] = i;
+		}
+		for (const String &path : sorter.groups[i]) {
+			for (const String &E : sorter.edges[path]) {
+				int dep_group = group_of[E];
+				if (dep_group != i) {
+					level = MAX(level, group_levels[dep_group] + 1);
+				}
+			}
+		}
+		group_levels.push_back(level);
+		if (level >= levels.size()) {
+			levels.resize(level + 1);
+		}
+		levels.write[level].push_back(sorter.groups[i]);
+	}
+
+	for (const Vector<Vector<String>> &level : levels) {
+		data.compile_groups = level;
+		pool.do_work(level.size(), singleton, &GDScriptCache::_prewarm_compile, &data);
+	}
+
+	pool.finish();
+}
+
+void GDScriptCache::release_prewarmed_scripts() {
+	// Only written while prewarming, which happens before the first frame.
+	if (singleton->prewarmed_scripts.is_empty()) {
+		return;
+	}
+	Vector<Ref<GDScript>> scripts;
+	{
+		MutexLock lock(singleton->lock);
+		scripts = singleton->prewarmed_scripts;
+		singleton->prewarmed_scripts.clear();
+	}
+	// Scripts nothing else uses are freed here, outside of the cache lock.
+	scripts.clear();
+}
+
 GDScriptCache::GDScriptCache() {
 	singleton = this;
 }
@@ -33,8 +33,11 @@
 
 #include "core/object/ref_counted.h"
 #include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
 #include "gdscript.h"
 
 class GDScriptAnalyzer;
@@ -57,6 +60,11 @@ private:
 	Error result = OK;
 	String path;
 
+	// Parsing only needs the source, so it's guarded separately from the cache.
+	BinaryMutex parse_lock;
+	bool parsed = false;
+	Error parse_result = OK;
+
 	friend class GDScriptCache;
 
 public:
@@ -69,6 +77,23 @@ public:
 	~GDScriptParserRef();
 };
 
+// Recursive like Mutex, but knows how often the calling thread holds it.
+class GDScriptCacheLock {
+	Mutex mutex;
+	static thread_local int depth;
+
+public:
+	void lock() const {
+		mutex.lock();
+		depth++;
+	}
+	void unlock() const {
+		depth--;
+		mutex.unlock();
+	}
+	int get_depth() const { return depth; }
+};
+
 class GDScriptCache {
 	// String key is full path.
 	HashMap<String, GDScriptParserRef *> parser_map;
@@ -76,14 +101,37 @@ class GDScriptCache {
 	HashMap<String, GDScript *> full_gdscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
 
+	// Scripts being compiled, and the threads waiting for one.
+	struct Compiling {
+		Thread::ID thread;
+		Semaphore done;
+		int waiters = 0;
+		bool finished = false;
+	};
+	HashMap<String, Compiling *> compiling;
+	HashMap<Thread::ID, Compiling *> compile_waiting;
+	Vector<Ref<GDScript>> prewarmed_scripts;
+
 	friend class GDScript;
 	friend class GDScriptParserRef;
 
 	static GDScriptCache *singleton;
 
-	Mutex lock;
+	GDScriptCacheLock lock;
 	static void remove_script(const String &p_path);
 
+	struct PrewarmData {
+		Vector<String> scan;
+		LocalVector<Vector<String>> scan_results;
+		Vector<Vector<String>> compile_groups;
+	};
+
+	void _begin_compile(const String &p_path);
+	void _end_compile(const String &p_path);
+	void _wait_for_compile(const String &p_path);
+	void _prewarm_scan(uint32_t p_index, PrewarmData *p_data);
+	void _prewarm_compile(uint32_t p_index, PrewarmData *p_data);
+
 public:
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
 	static String get_source_code(const String &p_path);
@@ -91,6 +139,10 @@ public:
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Error finish_compiling(const String &p_owner);
 
+	// Compiles the scripts used by the given resources, in parallel where their dependencies allow.
+	static void prewarm(const Vector<String> &p_paths);
+	static void release_prewarmed_scripts();
+
 	GDScriptCache();
 	~GDScriptCache();
 };
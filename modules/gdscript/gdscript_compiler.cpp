@@ -38,6 +38,8 @@
 #include "core/config/engine.h"
 #include "core/config/project_settings.h"
 
+int GDScriptCompiler::optimization_level = GDScriptCompiler::OPTIMIZATION_BASIC;
+
 bool GDScriptCompiler::_is_class_member_property(CodeGen &codegen, const StringName &p_name) {
 	if (codegen.function_node && codegen.function_node->is_static) {
 		return false;
@@ -586,7 +588,11 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 						} else if ((codegen.function_node && codegen.function_node->is_static) || call->function_name == "new") {
 							GDScriptCodeGenerator::Address self;
 							self.mode = GDScriptCodeGenerator::Address::CLASS;
-							if (within_await) {
+							if (optimization_level >= OPTIMIZATION_INLINE && !within_await && _try_inline_call(codegen, r_error, call, arguments, result)) {
+								if (r_error) {
+									return GDScriptCodeGenerator::Address();
+								}
+							} else if (within_await) {
 								gen->write_call_async(result, self, call->function_name, arguments);
 							} else {
 								gen->write_call(return_addr, self, call->function_name, arguments);
@@ -867,6 +873,12 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 		case GDScriptParser::Node::TERNARY_OPERATOR: {
 			// x IF a ELSE y operator with early out on failure.
 			const GDScriptParser::TernaryOpNode *ternary = static_cast<const GDScriptParser::TernaryOpNode *>(p_expression);
+
+			if (optimization_level >= OPTIMIZATION_BASIC && ternary->condition->is_constant) {
+				// Only the chosen expression is evaluated.
+				return _parse_expression(codegen, r_error, ternary->condition->reduced_value.booleanize() ? ternary->true_expr : ternary->false_expr);
+			}
+
 			GDScriptCodeGenerator::Address result = codegen.add_temporary(_gdtype_from_datatype(ternary->get_datatype()));
 
 			gen->write_start_ternary(result);
@@ -1207,6 +1219,8 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 					// Just assign.
 					if (assignment->use_conversion_assign) {
 						gen->write_assign_with_conversion(target, to_assign);
+					} else if (optimization_level >= OPTIMIZATION_BASIC) {
+						gen->write_assign_from_result(target, to_assign);
 					} else {
 						gen->write_assign(target, to_assign);
 					}
@@ -1258,6 +1272,84 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 	}
 }
 
+// Expressions small and simple enough to be copied into the caller: operators on parameters and constants.
+static bool _is_inlinable_expression(const GDScriptParser::ExpressionNode *p_expression, int &r_budget) {
+	if (--r_budget < 0) {
+		return false;
+	}
+	if (p_expression->is_constant) {
+		return true;
+	}
+
+	switch (p_expression->type) {
+		case GDScriptParser::Node::IDENTIFIER:
+			return static_cast<const GDScriptParser::IdentifierNode *>(p_expression)->source == GDScriptParser::IdentifierNode::FUNCTION_PARAMETER;
+		case GDScriptParser::Node::UNARY_OPERATOR:
+			return _is_inlinable_expression(static_cast<const GDScriptParser::UnaryOpNode *>(p_expression)->operand, r_budget);
+		case GDScriptParser::Node::BINARY_OPERATOR: {
+			const GDScriptParser::BinaryOpNode *binary = static_cast<const GDScriptParser::BinaryOpNode *>(p_expression);
+			return _is_inlinable_expression(binary->left_operand, r_budget) && _is_inlinable_expression(binary->right_operand, r_budget);
+		}
+		case GDScriptParser::Node::TERNARY_OPERATOR: {
+			const GDScriptParser::TernaryOpNode *ternary = static_cast<const GDScriptParser::TernaryOpNode *>(p_expression);
+			return _is_inlinable_expression(ternary->condition, r_budget) && _is_inlinable_expression(ternary->true_expr, r_budget) && _is_inlinable_expression(ternary->false_expr, r_budget);
+		}
+		default:
+			return false;
+	}
+}
+
+static bool _is_same_builtin_type(const GDScriptParser::DataType &p_a, const GDScriptParser::DataType &p_b) {
+	return p_a.is_hard_type() && p_b.is_hard_type() && p_a.kind == GDScriptParser::DataType::BUILTIN && p_b.kind == GDScriptParser::DataType::BUILTIN && p_a.builtin_type == p_b.builtin_type;
+}
+
+bool GDScriptCompiler::_try_inline_call(CodeGen &codegen, Error &r_error, const GDScriptParser::CallNode *p_call, const Vector<GDScriptCodeGenerator::Address> &p_arguments, const GDScriptCodeGenerator::Address &p_target) {
+	// From a static function, calls by name always reach the function of this class, so
+	// static functions made of a single return can be replaced by their expression.
+	if (!codegen.class_node->has_function(p_call->function_name)) {
+		return false;
+	}
+	const GDScriptParser::FunctionNode *function = codegen.class_node->get_member(p_call->function_name).function;
+	if (!function->is_static || function->parameters.size() != p_arguments.size() || function->body->statements.size() != 1 || function->body->statements[0]->type != GDScriptParser::Node::RETURN) {
+		return false;
+	}
+
+	const GDScriptParser::ExpressionNode *return_value = static_cast<const GDScriptParser::ReturnNode *>(function->body->statements[0])->return_value;
+	int budget = 16;
+	if (return_value == nullptr || !_is_inlinable_expression(return_value, budget)) {
+		return false;
+	}
+
+	// Typed parameters and return values would need conversions, only take them when none is needed.
+	if (function->get_datatype().is_hard_type() && !_is_same_builtin_type(function->get_datatype(), return_value->get_datatype())) {
+		return false;
+	}
+	for (int i = 0; i < function->parameters.size(); i++) {
+		const GDScriptParser::DataType parameter_type = function->parameters[i]->get_datatype();
+		if (parameter_type.is_hard_type() && !_is_same_builtin_type(parameter_type, p_call->arguments[i]->get_datatype())) {
+			return false;
+		}
+	}
+
+	HashMap<StringName, GDScriptCodeGenerator::Address> caller_parameters = codegen.parameters;
+	codegen.parameters.clear();
+	for (int i = 0; i < function->parameters.size(); i++) {
+		codegen.parameters[function->parameters[i]->identifier->name] = p_arguments[i];
+	}
+
+	GDScriptCodeGenerator::Address value = _parse_expression(codegen, r_error, return_value);
+	codegen.parameters = caller_parameters;
+	if (r_error) {
+		return true;
+	}
+
+	codegen.generator->write_assign(p_target, value);
+	if (value.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+		codegen.generator->pop_temporary();
+	}
+	return true;
+}
+
 GDScriptCodeGenerator::Address GDScriptCompiler::_parse_match_pattern(CodeGen &codegen, Error &r_error, const GDScriptParser::PatternNode *p_pattern, const GDScriptCodeGenerator::Address &p_value_addr, const GDScriptCodeGenerator::Address &p_type_addr, const GDScriptCodeGenerator::Address &p_previous_test, bool p_is_first, bool p_is_nested) {
 	switch (p_pattern->pattern_type) {
 		case GDScriptParser::PatternNode::PT_LITERAL: {
@@ -1649,6 +1741,26 @@ void GDScriptCompiler::_add_locals_in_block(CodeGen &codegen, const GDScriptPars
 	}
 }
 
+// Whether the statement never falls through to the next one in its block.
+static bool _is_block_exit(const GDScriptParser::Node *p_statement) {
+	switch (p_statement->type) {
+		case GDScriptParser::Node::RETURN:
+		case GDScriptParser::Node::BREAK:
+		case GDScriptParser::Node::CONTINUE:
+			return true;
+		case GDScriptParser::Node::IF: {
+			const GDScriptParser::IfNode *if_n = static_cast<const GDScriptParser::IfNode *>(p_statement);
+			if (if_n->condition->is_constant) {
+				const GDScriptParser::SuiteNode *taken = if_n->condition->reduced_value.booleanize() ? if_n->true_block : if_n->false_block;
+				return taken && taken->has_return;
+			}
+			return if_n->false_block && if_n->true_block->has_return && if_n->false_block->has_return;
+		}
+		default:
+			return false;
+	}
+}
+
 Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block, bool p_add_locals) {
 	Error error = OK;
 	GDScriptCodeGenerator *gen = codegen.generator;
@@ -1662,10 +1774,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 	for (int i = 0; i < p_block->statements.size(); i++) {
 		const GDScriptParser::Node *s = p_block->statements[i];
 
-#ifdef DEBUG_ENABLED
-		// Add a newline before each statement, since the debugger needs those.
-		gen->write_newline(s->start_line);
-#endif
+		if (debug_codegen) {
+			// Add a newline before each statement, since the debugger needs those.
+			gen->write_newline(s->start_line);
+		}
 
 		switch (s->type) {
 			case GDScriptParser::Node::MATCH: {
@@ -1716,10 +1828,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 					// Add locals in block before patterns, so temporaries don't use the stack address for binds.
 					_add_locals_in_block(codegen, branch->block);
 
-#ifdef DEBUG_ENABLED
-					// Add a newline before each branch, since the debugger needs those.
-					gen->write_newline(branch->start_line);
-#endif
+					if (debug_codegen) {
+						// Add a newline before each branch, since the debugger needs those.
+						gen->write_newline(branch->start_line);
+					}
 					// For each pattern in branch.
 					GDScriptCodeGenerator::Address pattern_result = codegen.add_temporary();
 					for (int k = 0; k < branch->patterns.size(); k++) {
@@ -1753,6 +1865,19 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::IF: {
 				const GDScriptParser::IfNode *if_n = static_cast<const GDScriptParser::IfNode *>(s);
+
+				if (optimization_level >= OPTIMIZATION_BASIC && if_n->condition->is_constant) {
+					// Only the branch that can run is compiled.
+					const GDScriptParser::SuiteNode *taken = if_n->condition->reduced_value.booleanize() ? if_n->true_block : if_n->false_block;
+					if (taken) {
+						error = _parse_block(codegen, taken);
+						if (error) {
+							return error;
+						}
+					}
+					break;
+				}
+
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, error, if_n->condition);
 				if (error) {
 					return error;
@@ -1813,6 +1938,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			case GDScriptParser::Node::WHILE: {
 				const GDScriptParser::WhileNode *while_n = static_cast<const GDScriptParser::WhileNode *>(s);
 
+				if (optimization_level >= OPTIMIZATION_BASIC && while_n->condition->is_constant && !while_n->condition->reduced_value.booleanize()) {
+					break; // Never runs.
+				}
+
 				gen->start_while_condition();
 
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, error, while_n->condition);
@@ -1862,7 +1991,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				}
 			} break;
 			case GDScriptParser::Node::ASSERT: {
-#ifdef DEBUG_ENABLED
+				if (!debug_codegen) {
+					break;
+				}
+
 				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
 
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, error, as->condition);
@@ -1886,12 +2018,11 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				if (message.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
 					codegen.generator->pop_temporary();
 				}
-#endif
 			} break;
 			case GDScriptParser::Node::BREAKPOINT: {
-#ifdef DEBUG_ENABLED
-				gen->write_breakpoint();
-#endif
+				if (debug_codegen) {
+					gen->write_breakpoint();
+				}
 			} break;
 			case GDScriptParser::Node::VARIABLE: {
 				const GDScriptParser::VariableNode *lv = static_cast<const GDScriptParser::VariableNode *>(s);
@@ -1914,6 +2045,8 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 					}
 					if (lv->use_conversion_assign) {
 						gen->write_assign_with_conversion(local, src_address);
+					} else if (optimization_level >= OPTIMIZATION_BASIC) {
+						gen->write_assign_from_result(local, src_address);
 					} else {
 						gen->write_assign(local, src_address);
 					}
@@ -1958,6 +2091,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				}
 			} break;
 		}
+
+		if (optimization_level >= OPTIMIZATION_BASIC && _is_block_exit(s)) {
+			break; // The rest of the block is unreachable.
+		}
 	}
 
 	codegen.end_block();
@@ -2253,6 +2390,7 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, const GDScriptPar
 	p_script->implicit_ready = nullptr;
 
 	p_script->tool = parser->is_tool();
+	p_script->thread_safe = parser->is_thread_safe();
 	p_script->name = p_class->identifier ? p_class->identifier->name : "";
 
 	if (!p_script->name.is_empty()) {
@@ -2306,6 +2444,8 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, const GDScriptPar
 			p_script->member_indices = base->member_indices;
 			native = base->native;
 			p_script->native = native;
+			// Inherited functions use the same members, so they need the same lock.
+			p_script->thread_safe = p_script->thread_safe || base->thread_safe;
 		} break;
 		default: {
 			_set_error("Parser bug: invalid inheritance.", p_class);
@@ -2693,7 +2833,9 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 		return err;
 	}
 
-	return GDScriptCache::finish_compiling(p_script->get_path());
+	// Scripts compiled off the resource cache (e.g. for export) only have a script path,
+	// which is also what their dependencies were registered under.
+	return GDScriptCache::finish_compiling(p_script->get_path().is_empty() ? p_script->path : p_script->get_path());
 }
 
 String GDScriptCompiler::get_error() const {
@@ -125,6 +125,7 @@ class GDScriptCompiler {
 
 	GDScriptCodeGenerator::Address _parse_assign_right_expression(CodeGen &codegen, Error &r_error, const GDScriptParser::AssignmentNode *p_assignmentint, const GDScriptCodeGenerator::Address &p_index_addr = GDScriptCodeGenerator::Address());
 	GDScriptCodeGenerator::Address _parse_expression(CodeGen &codegen, Error &r_error, const GDScriptParser::ExpressionNode *p_expression, bool p_root = false, bool p_initializer = false, const GDScriptCodeGenerator::Address &p_index_addr = GDScriptCodeGenerator::Address());
+	bool _try_inline_call(CodeGen &codegen, Error &r_error, const GDScriptParser::CallNode *p_call, const Vector<GDScriptCodeGenerator::Address> &p_arguments, const GDScriptCodeGenerator::Address &p_target);
 	GDScriptCodeGenerator::Address _parse_match_pattern(CodeGen &codegen, Error &r_error, const GDScriptParser::PatternNode *p_pattern, const GDScriptCodeGenerator::Address &p_value_addr, const GDScriptCodeGenerator::Address &p_type_addr, const GDScriptCodeGenerator::Address &p_previous_test, bool p_is_first, bool p_is_nested);
 	void _add_locals_in_block(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block);
 	Error _parse_block(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block, bool p_add_locals = true);
@@ -138,10 +139,31 @@ class GDScriptCompiler {
 	StringName source;
 	String error;
 	bool within_await = false;
+#ifdef DEBUG_ENABLED
+	bool debug_codegen = true;
+#else
+	bool debug_codegen = false;
+#endif
+
+	static int optimization_level;
 
 public:
+	enum {
+		OPTIMIZATION_NONE,
+		OPTIMIZATION_BASIC, // Fold constant branches, skip unreachable code and reuse temporaries.
+		OPTIMIZATION_INLINE, // Also inline calls to small static functions from static functions.
+	};
+
+	static void set_optimization_level(int p_level) { optimization_level = p_level; }
+	static int get_optimization_level() { return optimization_level; }
+
 	Error compile(const GDScriptParser *p_parser, GDScript *p_script, bool p_keep_state = false);
 
+	// Line markers, asserts and breakpoints are only emitted for debug builds.
+	// Exporting overrides this to match the target template.
+	void set_debug_codegen(bool p_enabled) { debug_codegen = p_enabled; }
+	bool is_debug_codegen() const { return debug_codegen; }
+
 	String get_error() const;
 	int get_error_line() const;
 	int get_error_column() const;
@@ -134,6 +134,37 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+#define DISASSEMBLE_OPERATOR_TYPED(m_opcode, m_type, m_operator) \
+	case m_opcode: {                                           \
+		text += m_type " operator ";                           \
+		text += DADDR(3);                                      \
+		text += " = ";                                         \
+		text += DADDR(1);                                      \
+		text += " " m_operator " ";                            \
+		text += DADDR(2);                                      \
+		incr += 4;                                             \
+	} break
+
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_ADD_INT, "int", "+");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_SUBTRACT_INT, "int", "-");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_MULTIPLY_INT, "int", "*");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_EQUAL_INT, "int", "==");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_NOT_EQUAL_INT, "int", "!=");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_INT, "int", "<");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_EQUAL_INT, "int", "<=");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_INT, "int", ">");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_EQUAL_INT, "int", ">=");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_ADD_FLOAT, "float", "+");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_SUBTRACT_FLOAT, "float", "-");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_MULTIPLY_FLOAT, "float", "*");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_DIVIDE_FLOAT, "float", "/");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_EQUAL_FLOAT, "float", "==");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_NOT_EQUAL_FLOAT, "float", "!=");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_FLOAT, "float", "<");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_EQUAL_FLOAT, "float", "<=");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_FLOAT, "float", ">");
+			DISASSEMBLE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_EQUAL_FLOAT, "float", ">=");
+#undef DISASSEMBLE_OPERATOR_TYPED
 			case OPCODE_EXTENDS_TEST: {
 				text += "is object ";
 				text += DADDR(3);
@@ -225,7 +256,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -246,7 +277,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -509,7 +540,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
@@ -833,6 +864,22 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 3;
 			} break;
+			case OPCODE_JUMP_IF_BOOL: {
+				text += "jump-if bool ";
+				text += DADDR(1);
+				text += " to ";
+				text += itos(_code_ptr[ip + 2]);
+
+				incr = 3;
+			} break;
+			case OPCODE_JUMP_IF_NOT_BOOL: {
+				text += "jump-if-not bool ";
+				text += DADDR(1);
+				text += " to ";
+				text += itos(_code_ptr[ip + 2]);
+
+				incr = 3;
+			} break;
 			case OPCODE_JUMP_TO_DEF_ARGUMENT: {
 				text += "jump-to-default-argument ";
 
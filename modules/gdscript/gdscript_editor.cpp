@@ -217,10 +217,11 @@ Script *GDScriptLanguage::create_script() const {
 bool GDScriptLanguage::debug_break_parse(const String &p_file, int p_line, const String &p_error) {
 	// break because of parse error
 
+	ThreadDebugState &debug_state = _get_thread_debug_state();
 	if (EngineDebugger::is_active() && Thread::get_caller_id() == Thread::get_main_id()) {
-		_debug_parse_err_line = p_line;
-		_debug_parse_err_file = p_file;
-		_debug_error = p_error;
+		debug_state.parse_err_line = p_line;
+		debug_state.parse_err_file = p_file;
+		debug_state.error = p_error;
 		EngineDebugger::get_script_debugger()->debug(this, false, true);
 		return true;
 	} else {
@@ -229,10 +230,11 @@ bool GDScriptLanguage::debug_break_parse(const String &p_file, int p_line, const
 }
 
 bool GDScriptLanguage::debug_break(const String &p_error, bool p_allow_continue) {
+	ThreadDebugState &debug_state = _get_thread_debug_state();
 	if (EngineDebugger::is_active() && Thread::get_caller_id() == Thread::get_main_id()) {
-		_debug_parse_err_line = -1;
-		_debug_parse_err_file = "";
-		_debug_error = p_error;
+		debug_state.parse_err_line = -1;
+		debug_state.parse_err_file = "";
+		debug_state.error = p_error;
 		bool is_error_breakpoint = p_error != "Breakpoint";
 		EngineDebugger::get_script_debugger()->debug(this, p_allow_continue, is_error_breakpoint);
 		return true;
@@ -242,77 +244,83 @@ bool GDScriptLanguage::debug_break(const String &p_error, bool p_allow_continue)
 }
 
 String GDScriptLanguage::debug_get_error() const {
-	return _debug_error;
+	return _get_thread_debug_state().error;
 }
 
 int GDScriptLanguage::debug_get_stack_level_count() const {
-	if (_debug_parse_err_line >= 0) {
+	const ThreadDebugState &debug_state = _get_thread_debug_state();
+	if (debug_state.parse_err_line >= 0) {
 		return 1;
 	}
 
-	return _debug_call_stack_pos;
+	return debug_state.call_stack.stack_pos;
 }
 
 int GDScriptLanguage::debug_get_stack_level_line(int p_level) const {
-	if (_debug_parse_err_line >= 0) {
-		return _debug_parse_err_line;
+	const ThreadDebugState &debug_state = _get_thread_debug_state();
+	if (debug_state.parse_err_line >= 0) {
+		return debug_state.parse_err_line;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, _debug_call_stack_pos, -1);
+	ERR_FAIL_INDEX_V(p_level, debug_state.call_stack.stack_pos, -1);
 
-	int l = _debug_call_stack_pos - p_level - 1;
+	int l = debug_state.call_stack.stack_pos - p_level - 1;
 
-	return *(_call_stack[l].line);
+	return *(debug_state.call_stack.levels[l].line);
 }
 
 String GDScriptLanguage::debug_get_stack_level_function(int p_level) const {
-	if (_debug_parse_err_line >= 0) {
+	const ThreadDebugState &debug_state = _get_thread_debug_state();
+	if (debug_state.parse_err_line >= 0) {
 		return "";
 	}
 
-	ERR_FAIL_INDEX_V(p_level, _debug_call_stack_pos, "");
-	int l = _debug_call_stack_pos - p_level - 1;
-	return _call_stack[l].function->get_name();
+	ERR_FAIL_INDEX_V(p_level, debug_state.call_stack.stack_pos, "");
+	int l = debug_state.call_stack.stack_pos - p_level - 1;
+	return debug_state.call_stack.levels[l].function->get_name();
 }
 
 String GDScriptLanguage::debug_get_stack_level_source(int p_level) const {
-	if (_debug_parse_err_line >= 0) {
-		return _debug_parse_err_file;
+	const ThreadDebugState &debug_state = _get_thread_debug_state();
+	if (debug_state.parse_err_line >= 0) {
+		return debug_state.parse_err_file;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, _debug_call_stack_pos, "");
-	int l = _debug_call_stack_pos - p_level - 1;
-	return _call_stack[l].function->get_source();
+	ERR_FAIL_INDEX_V(p_level, debug_state.call_stack.stack_pos, "");
+	int l = debug_state.call_stack.stack_pos - p_level - 1;
+	return debug_state.call_stack.levels[l].function->get_source();
 }
 
 void GDScriptLanguage::debug_get_stack_level_locals(int p_level, List<String> *p_locals, List<Variant> *p_values, int p_max_subitems, int p_max_depth) {
-	if (_debug_parse_err_line >= 0) {
+	ThreadDebugState &debug_state = _get_thread_debug_state();
+	if (debug_state.parse_err_line >= 0) {
 		return;
 	}
 
-	ERR_FAIL_INDEX(p_level, _debug_call_stack_pos);
-	int l = _debug_call_stack_pos - p_level - 1;
+	ERR_FAIL_INDEX(p_level, debug_state.call_stack.stack_pos);
+	int l = debug_state.call_stack.stack_pos - p_level - 1;
 
-	GDScriptFunction *f = _call_stack[l].function;
+	GDScriptFunction *f = debug_state.call_stack.levels[l].function;
 
 	List<Pair<StringName, int>> locals;
 
-	f->debug_get_stack_member_state(*_call_stack[l].line, &locals);
+	f->debug_get_stack_member_state(*debug_state.call_stack.levels[l].line, &locals);
 	for (const Pair<StringName, int> &E : locals) {
 		p_locals->push_back(E.first);
-		p_values->push_back(_call_stack[l].stack[E.second]);
+		p_values->push_back(debug_state.call_stack.levels[l].stack[E.second]);
 	}
 }
 
 void GDScriptLanguage::debug_get_stack_level_members(int p_level, List<String> *p_members, List<Variant> *p_values, int p_max_subitems, int p_max_depth) {
-	if (_debug_parse_err_line >= 0) {
+	ThreadDebugState &debug_state = _get_thread_debug_state();
+	if (debug_state.parse_err_line >= 0) {
 		return;
 	}
 
-	ERR_FAIL_INDEX(p_level, _debug_call_stack_pos);
-	int l = _debug_call_stack_pos - p_level - 1;
+	ERR_FAIL_INDEX(p_level, debug_state.call_stack.stack_pos);
+	int l = debug_state.call_stack.stack_pos - p_level - 1;
 
-	GDScriptInstance *instance = _call_stack[l].instance;
+	GDScriptInstance *instance = debug_state.call_stack.levels[l].instance;
 
 	if (!instance) {
 		return;
@@ -330,14 +338,15 @@ void GDScriptLanguage::debug_get_stack_level_members(int p_level, List<String> *
 }
 
 ScriptInstance *GDScriptLanguage::debug_get_stack_level_instance(int p_level) {
-	if (_debug_parse_err_line >= 0) {
+	ThreadDebugState &debug_state = _get_thread_debug_state();
+	if (debug_state.parse_err_line >= 0) {
 		return nullptr;
 	}
 
-	ERR_FAIL_INDEX_V(p_level, _debug_call_stack_pos, nullptr);
+	ERR_FAIL_INDEX_V(p_level, debug_state.call_stack.stack_pos, nullptr);
 
-	int l = _debug_call_stack_pos - p_level - 1;
-	ScriptInstance *instance = _call_stack[l].instance;
+	int l = debug_state.call_stack.stack_pos - p_level - 1;
+	ScriptInstance *instance = debug_state.call_stack.levels[l].instance;
 
 	return instance;
 }
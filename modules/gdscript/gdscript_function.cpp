@@ -148,11 +148,230 @@ GDScriptFunction::GDScriptFunction() {
 #endif
 }
 
+bool GDScriptFunction::get_instruction_layout(Opcode p_opcode, InstructionLayout &r_layout) {
+	r_layout = InstructionLayout();
+	switch (p_opcode) {
+		case OPCODE_OPERATOR:
+		case OPCODE_OPERATOR_VALIDATED:
+		case OPCODE_SET_KEYED_VALIDATED:
+		case OPCODE_SET_INDEXED_VALIDATED:
+		case OPCODE_GET_KEYED_VALIDATED:
+		case OPCODE_GET_INDEXED_VALIDATED:
+			r_layout.addresses = 3;
+			r_layout.extra = 1;
+			break;
+		case OPCODE_EXTENDS_TEST:
+		case OPCODE_SET_KEYED:
+		case OPCODE_GET_KEYED:
+		case OPCODE_ASSIGN_TYPED_NATIVE:
+		case OPCODE_ASSIGN_TYPED_SCRIPT:
+		case OPCODE_CAST_TO_NATIVE:
+		case OPCODE_CAST_TO_SCRIPT:
+			r_layout.addresses = 3;
+			break;
+		case OPCODE_IS_BUILTIN:
+		case OPCODE_SET_NAMED_VALIDATED:
+		case OPCODE_GET_NAMED_VALIDATED:
+		case OPCODE_ASSIGN_TYPED_BUILTIN:
+		case OPCODE_CAST_TO_BUILTIN:
+			r_layout.addresses = 2;
+			r_layout.extra = 1;
+			break;
+		case OPCODE_SET_NAMED:
+		case OPCODE_GET_NAMED:
+		case OPCODE_RETURN_TYPED_ARRAY:
+			r_layout.addresses = 2;
+			r_layout.extra = 2;
+			break;
+		case OPCODE_ASSIGN:
+		case OPCODE_ASSIGN_TYPED_ARRAY:
+		case OPCODE_RETURN_TYPED_NATIVE:
+		case OPCODE_RETURN_TYPED_SCRIPT:
+		case OPCODE_ASSERT:
+			r_layout.addresses = 2;
+			break;
+		case OPCODE_SET_MEMBER:
+		case OPCODE_GET_MEMBER:
+		case OPCODE_JUMP_IF:
+		case OPCODE_JUMP_IF_NOT:
+		case OPCODE_JUMP_IF_BOOL:
+		case OPCODE_JUMP_IF_NOT_BOOL:
+		case OPCODE_JUMP_IF_SHARED:
+		case OPCODE_RETURN_TYPED_BUILTIN:
+		case OPCODE_STORE_GLOBAL:
+		case OPCODE_STORE_NAMED_GLOBAL:
+			r_layout.addresses = 1;
+			r_layout.extra = 1;
+			break;
+		case OPCODE_ASSIGN_TRUE:
+		case OPCODE_ASSIGN_FALSE:
+		case OPCODE_AWAIT:
+		case OPCODE_AWAIT_RESUME:
+		case OPCODE_RETURN:
+			r_layout.addresses = 1;
+			break;
+		case OPCODE_JUMP:
+		case OPCODE_LINE:
+			r_layout.extra = 1;
+			break;
+		case OPCODE_JUMP_TO_DEF_ARGUMENT:
+		case OPCODE_BREAKPOINT:
+		case OPCODE_END:
+			break;
+		case OPCODE_CONSTRUCT:
+		case OPCODE_CONSTRUCT_VALIDATED:
+		case OPCODE_CALL_UTILITY:
+		case OPCODE_CALL_UTILITY_VALIDATED:
+		case OPCODE_CALL_GDSCRIPT_UTILITY:
+		case OPCODE_CALL_SELF_BASE:
+		case OPCODE_CREATE_LAMBDA:
+		case OPCODE_CREATE_SELF_LAMBDA:
+			r_layout.addresses = -1;
+			r_layout.extra = 2;
+			r_layout.argc_pos = 0;
+			break;
+		case OPCODE_CONSTRUCT_ARRAY:
+			r_layout.addresses = -1;
+			r_layout.extra = 1;
+			r_layout.argc_pos = 0;
+			break;
+		case OPCODE_CONSTRUCT_DICTIONARY:
+			r_layout.addresses = -1;
+			r_layout.extra = 1;
+			r_layout.argc_pos = 0;
+			r_layout.addresses_per_argument = 2;
+			break;
+		case OPCODE_CONSTRUCT_TYPED_ARRAY:
+		case OPCODE_CALL:
+		case OPCODE_CALL_RETURN:
+		case OPCODE_CALL_ASYNC:
+			r_layout.addresses = -2;
+			r_layout.extra = 3;
+			r_layout.argc_pos = 0;
+			break;
+		case OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+		case OPCODE_CALL_METHOD_BIND:
+		case OPCODE_CALL_METHOD_BIND_RET:
+			r_layout.addresses = -2;
+			r_layout.extra = 2;
+			r_layout.argc_pos = 0;
+			break;
+		case OPCODE_CALL_BUILTIN_STATIC:
+			r_layout.addresses = -1;
+			r_layout.extra = 3;
+			r_layout.argc_pos = 2;
+			break;
+		case OPCODE_CALL_NATIVE_STATIC:
+			r_layout.addresses = -1;
+			r_layout.extra = 2;
+			r_layout.argc_pos = 1;
+			break;
+		default:
+			if (p_opcode >= OPCODE_OPERATOR_ADD_INT && p_opcode <= OPCODE_OPERATOR_GREATER_EQUAL_FLOAT) {
+				r_layout.addresses = 3;
+			} else if (p_opcode >= OPCODE_CALL_PTRCALL_NO_RETURN && p_opcode <= OPCODE_CALL_PTRCALL_PACKED_COLOR_ARRAY) {
+				r_layout.addresses = -2;
+				r_layout.extra = 2;
+				r_layout.argc_pos = 0;
+			} else if (p_opcode >= OPCODE_ITERATE_BEGIN && p_opcode <= OPCODE_ITERATE_OBJECT) {
+				r_layout.addresses = 3;
+				r_layout.extra = 1;
+			} else if (p_opcode >= OPCODE_TYPE_ADJUST_BOOL && p_opcode <= OPCODE_TYPE_ADJUST_PACKED_COLOR_ARRAY) {
+				r_layout.addresses = 1;
+			} else {
+				return false;
+			}
+			break;
+	}
+	return true;
+}
+
+SafeNumeric<uint32_t> GDScriptFunction::inline_cache_epoch;
+Mutex GDScriptFunction::inline_cache_mutex;
+GDScriptInlineCache::Block *GDScriptFunction::retired_inline_cache_blocks = nullptr;
+std::atomic<uint64_t> GDScriptFunction::reclaim_epoch = { 1 };
+LocalVector<GDScriptFunction::ThreadEpoch *> GDScriptFunction::thread_epochs;
+thread_local GDScriptFunction::ThreadEpoch *GDScriptFunction::thread_epoch = nullptr;
+thread_local uint32_t GDScriptFunction::running_depth = 0;
+
+void GDScriptFunction::_register_thread_epoch() {
+	ThreadEpoch *record = memnew(ThreadEpoch);
+
+	MutexLock lock(inline_cache_mutex);
+	thread_epochs.push_back(record);
+	thread_epoch = record;
+}
+
+void GDScriptFunction::thread_exit() {
+	if (!thread_epoch) {
+		return;
+	}
+
+	MutexLock lock(inline_cache_mutex);
+	int64_t index = thread_epochs.find(thread_epoch);
+	if (index != -1) {
+		thread_epochs.remove_at_unordered(index);
+	}
+	memdelete(thread_epoch);
+	thread_epoch = nullptr;
+}
+
+void GDScriptFunction::free_retired_inline_caches() {
+	MutexLock lock(inline_cache_mutex);
+	_free_retired_inline_cache_blocks();
+}
+
+void GDScriptFunction::_free_retired_inline_cache_blocks() {
+	// The calling thread holds no block, lookups copy the entries out.
+	uint64_t oldest_running = UINT64_MAX;
+	for (uint32_t i = 0; i < thread_epochs.size(); i++) {
+		uint64_t epoch = thread_epochs[i]->epoch.load();
+		if (epoch != 0 && thread_epochs[i] != thread_epoch) {
+			oldest_running = MIN(oldest_running, epoch);
+		}
+	}
+
+	GDScriptInlineCache::Block **prev = &retired_inline_cache_blocks;
+	while (*prev) {
+		GDScriptInlineCache::Block *block = *prev;
+		if (block->retired_epoch < oldest_running) {
+			*prev = block->next_retired;
+			memdelete(block);
+		} else {
+			prev = &block->next_retired;
+		}
+	}
+}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+const GDScriptJIT::Code *GDScriptFunction::_get_jit_code() {
+	GDScriptJIT::Code *code = jit_code.load(std::memory_order_acquire);
+	if (code || jit_call_count.increment() != GDScriptJIT::get_call_threshold()) {
+		return code;
+	}
+
+	// Only the call reaching the threshold compiles, others keep interpreting until it's done.
+	code = GDScriptJIT::compile(this);
+	jit_code.store(code, std::memory_order_release);
+	return code;
+}
+#endif
+
 GDScriptFunction::~GDScriptFunction() {
 	for (int i = 0; i < lambdas.size(); i++) {
 		memdelete(lambdas[i]);
 	}
 
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+	}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (jit_code.load()) {
+		GDScriptJIT::free_code(jit_code.load());
+	}
+#endif
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
@@ -161,40 +380,37 @@ GDScriptFunction::~GDScriptFunction() {
 #endif
 }
 
-/////////////////////
-
-Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
-	Variant arg;
-	r_error.error = Callable::CallError::CALL_OK;
-
-	if (p_argcount == 0) {
-		r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
-		r_error.argument = 1;
-		return Variant();
-	} else if (p_argcount == 1) {
-		//noooneee
-	} else if (p_argcount == 2) {
-		arg = *p_args[0];
-	} else {
-		Array extra_args;
-		for (int i = 0; i < p_argcount - 1; i++) {
-			extra_args.push_back(*p_args[i]);
+Vector<uint8_t> GDScriptFunction::_take_state_stack(uint32_t p_size) {
+	{
+		MutexLock lock(state_stack_pool_mutex);
+		if (state_stack_pool.size()) {
+			Vector<uint8_t> stack = state_stack_pool[state_stack_pool.size() - 1];
+			state_stack_pool.resize(state_stack_pool.size() - 1);
+			return stack;
 		}
-		arg = extra_args;
 	}
 
-	Ref<GDScriptFunctionState> self = *p_args[p_argcount - 1];
+	Vector<uint8_t> stack;
+	stack.resize(p_size);
+	return stack;
+}
 
-	if (self.is_null()) {
-		r_error.error = Callable::CallError::CALL_ERROR_INVALID_ARGUMENT;
-		r_error.argument = p_argcount - 1;
-		r_error.expected = Variant::OBJECT;
-		return Variant();
+void GDScriptFunction::_recycle_state_stack(Vector<uint8_t> &r_stack) {
+	if (r_stack.is_empty()) {
+		return;
 	}
 
-	return resume(arg);
+	{
+		MutexLock lock(state_stack_pool_mutex);
+		if (state_stack_pool.size() < STATE_STACK_POOL_MAX) {
+			state_stack_pool.push_back(r_stack);
+		}
+	}
+	r_stack.clear();
 }
 
+/////////////////////
+
 bool GDScriptFunctionState::is_valid(bool p_extended_check) const {
 	if (function == nullptr) {
 		return false;
@@ -242,6 +458,7 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 
 	state.result = p_arg;
 	Callable::CallError err;
+	GDScriptFunction *resumed_function = function;
 	Variant ret = function->call(nullptr, nullptr, 0, err, &state);
 
 	bool completed = true;
@@ -259,6 +476,11 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 	function = nullptr; //cleaned up;
 	state.result = Variant();
 
+	// By now the stack was freed, or moved to the state of the next await. Recycle it before emitting
+	// `completed`, as its handlers may free or reload the script, and the function with it.
+	state.stack_size = 0;
+	resumed_function->_recycle_state_stack(state.stack);
+
 	if (completed) {
 		if (first_state.is_valid()) {
 			first_state->emit_signal(SNAME("completed"), ret);
@@ -270,8 +492,6 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 		if (EngineDebugger::is_active()) {
 			GDScriptLanguage::get_singleton()->exit_function();
 		}
-
-		_clear_stack();
 #endif
 	}
 
@@ -292,7 +512,6 @@ void GDScriptFunctionState::_clear_stack() {
 void GDScriptFunctionState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("resume", "arg"), &GDScriptFunctionState::resume, DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("is_valid", "extended_check"), &GDScriptFunctionState::is_valid, DEFVAL(false));
-	ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "_signal_callback", &GDScriptFunctionState::_signal_callback, MethodInfo("_signal_callback"));
 
 	ADD_SIGNAL(MethodInfo("completed", PropertyInfo(Variant::NIL, "result", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NIL_IS_VARIANT)));
 }
@@ -309,3 +528,115 @@ GDScriptFunctionState::~GDScriptFunctionState() {
 		instances_list.remove_from_list();
 	}
 }
+
+/////////////////////
+
+Mutex GDScriptAwaitCallable::mutex;
+HashMap<GDScriptAwaitCallable::Key, GDScriptAwaitCallable *, GDScriptAwaitCallable::KeyHasher> GDScriptAwaitCallable::waiting;
+
+bool GDScriptAwaitCallable::compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Await callables are only compared by reference.
+	return p_a == p_b;
+}
+
+bool GDScriptAwaitCallable::compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Await callables are only compared by reference.
+	return p_a < p_b;
+}
+
+uint32_t GDScriptAwaitCallable::hash() const {
+	return h;
+}
+
+String GDScriptAwaitCallable::get_as_text() const {
+	return "await " + String(key.signal);
+}
+
+CallableCustom::CompareEqualFunc GDScriptAwaitCallable::get_compare_equal_func() const {
+	return compare_equal;
+}
+
+CallableCustom::CompareLessFunc GDScriptAwaitCallable::get_compare_less_func() const {
+	return compare_less;
+}
+
+ObjectID GDScriptAwaitCallable::get_object() const {
+	// Connected to the emitter itself, so the connection goes away together with it.
+	return key.object;
+}
+
+void GDScriptAwaitCallable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const {
+	r_call_error.error = Callable::CallError::CALL_OK;
+	{
+		MutexLock lock(mutex);
+		// Resumed functions may emit the signal again before the one-shot connection is removed.
+		if (fired) {
+			return;
+		}
+		fired = true;
+		// Later awaits have to connect again, so nothing else gets added to this one.
+		GDScriptAwaitCallable **E = waiting.getptr(key);
+		if (E && *E == this) {
+			waiting.erase(key);
+		}
+	}
+
+	Variant arg;
+	if (p_argcount == 1) {
+		arg = *p_arguments[0];
+	} else if (p_argcount > 1) {
+		Array extra_args;
+		for (int i = 0; i < p_argcount; i++) {
+			extra_args.push_back(*p_arguments[i]);
+		}
+		arg = extra_args;
+	}
+
+	for (uint32_t i = 0; i < states.size(); i++) {
+		states[i]->resume(arg);
+	}
+	states.clear();
+}
+
+Error GDScriptAwaitCallable::await(const Signal &p_signal, const Ref<GDScriptFunctionState> &p_state) {
+	Object *object = p_signal.get_object();
+	ERR_FAIL_COND_V(!object, ERR_INVALID_PARAMETER);
+
+	Key key;
+	key.object = object->get_instance_id();
+	key.signal = p_signal.get_name();
+
+	uint64_t emission_id = object->get_signal_emission_id();
+
+	MutexLock lock(mutex);
+
+	// An emission that started after connecting may still be about to call the connection,
+	// and joining it would resume the state within that same emission. Connect anew then.
+	GDScriptAwaitCallable **E = waiting.getptr(key);
+	if (E && emission_id <= (*E)->emission_id) {
+		(*E)->states.push_back(p_state);
+		return OK;
+	}
+
+	GDScriptAwaitCallable *await_callable = memnew(GDScriptAwaitCallable(key, emission_id));
+	await_callable->states.push_back(p_state);
+	Error err = object->connect(key.signal, Callable(await_callable), Vector<Variant>(), Object::CONNECT_ONESHOT);
+	if (err == OK) {
+		waiting[key] = await_callable;
+	}
+	return err;
+}
+
+GDScriptAwaitCallable::GDScriptAwaitCallable(const Key &p_key, uint64_t p_emission_id) {
+	key = p_key;
+	emission_id = p_emission_id;
+	h = (uint32_t)hash_murmur3_one_64((uint64_t)this);
+}
+
+GDScriptAwaitCallable::~GDScriptAwaitCallable() {
+	MutexLock lock(mutex);
+	GDScriptAwaitCallable **E = waiting.getptr(key);
+	if (E && *E == this) {
+		waiting.erase(key);
+	}
+}
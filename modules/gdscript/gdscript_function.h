@@ -35,9 +35,12 @@
 #include "core/object/script_language.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
+#include "gdscript_jit.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_utility_functions.h"
 
 class GDScriptInstance;
@@ -214,11 +217,75 @@ public:
 	}
 };
 
+// Remembers how an untyped call or named property access was resolved for the
+// last few receiver classes it saw, so the next receivers of those classes can
+// skip the lookup by name.
+struct GDScriptInlineCache {
+	enum {
+		MAX_ENTRIES = 4,
+	};
+
+	enum Target {
+		TARGET_SCRIPT_FUNCTION,
+		TARGET_SCRIPT_MEMBER,
+		TARGET_METHOD_BIND,
+	};
+
+	struct Entry {
+		// Receivers match when both their GDScript (null if none) and native class do.
+		const GDScript *script = nullptr;
+		const void *native_class = nullptr; // The class name's StringName::data_unique_pointer().
+
+		Target target = TARGET_METHOD_BIND;
+		GDScriptFunction *function = nullptr;
+		MethodBind *method = nullptr;
+		int member_index = -1;
+		const GDScriptDataType *member_type = nullptr; // Only for typed members.
+	};
+
+	// Entries never change once published: adding one copies the block, and a new epoch starts an empty one.
+	// Replaced blocks are freed once no thread can still be reading them.
+	struct Block {
+		uint32_t epoch = 0;
+		uint32_t size = 0;
+		Entry entries[MAX_ENTRIES];
+		Block *next_retired = nullptr;
+		uint64_t retired_epoch = 0; // Reclaim epoch in which the block was replaced.
+	};
+
+	std::atomic<Block *> block = { nullptr };
+
+	~GDScriptInlineCache() {
+		if (block.load()) {
+			memdelete(block.load());
+		}
+	}
+};
+
 class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_ADD_INT,
+		OPCODE_OPERATOR_SUBTRACT_INT,
+		OPCODE_OPERATOR_MULTIPLY_INT,
+		OPCODE_OPERATOR_EQUAL_INT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT,
+		OPCODE_OPERATOR_GREATER_INT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUBTRACT_FLOAT,
+		OPCODE_OPERATOR_MULTIPLY_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_FLOAT,
+		OPCODE_OPERATOR_EQUAL_FLOAT,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT,
+		OPCODE_OPERATOR_LESS_FLOAT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT,
+		OPCODE_OPERATOR_GREATER_FLOAT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET_KEYED,
@@ -303,6 +370,8 @@ public:
 		OPCODE_JUMP,
 		OPCODE_JUMP_IF,
 		OPCODE_JUMP_IF_NOT,
+		OPCODE_JUMP_IF_BOOL,
+		OPCODE_JUMP_IF_NOT_BOOL,
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_JUMP_IF_SHARED,
 		OPCODE_RETURN,
@@ -416,6 +485,20 @@ public:
 		INSTR_ARGS_MASK = ~INSTR_MASK,
 	};
 
+	// What follows the opcode word of an instruction: the addresses, whose count is in the opcode word,
+	// then `extra` words. Instructions taking arguments store their argument count in the extra word at
+	// `argc_pos`, and their number of addresses besides the arguments (e.g. the base and the result of
+	// a call) is stored negated in `addresses`.
+	struct InstructionLayout {
+		int addresses = 0;
+		int extra = 0;
+		int argc_pos = -1;
+		int addresses_per_argument = 1;
+	};
+
+	// Returns false for opcodes that don't exist.
+	static bool get_instruction_layout(Opcode p_opcode, InstructionLayout &r_layout);
+
 	struct StackDebug {
 		int line;
 		int pos;
@@ -426,6 +509,10 @@ public:
 private:
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
+	friend class GDScriptByteCodeCache;
+	friend class GDScriptJIT;
+	friend class GDScriptJITCompiler;
+	friend class GDScriptFunctionState;
 
 	StringName source;
 
@@ -462,6 +549,8 @@ private:
 	MethodBind **_methods_ptr = nullptr;
 	int _lambdas_count = 0;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	GDScriptInlineCache *_inline_caches_ptr = nullptr;
+	int _inline_caches_count = 0;
 	const int *_code_ptr = nullptr;
 	int _code_size = 0;
 	int _argument_count = 0;
@@ -498,6 +587,10 @@ private:
 
 	HashMap<int, Variant::Type> temporary_slots;
 
+	// Code positions of OPCODE_STORE_GLOBAL and OPCODE_STORE_NAMED_GLOBAL. Global indices
+	// depend on the engine build, so cached bytecode relocates them by name when loaded.
+	Vector<int> store_global_positions;
+
 #ifdef TOOLS_ENABLED
 	Vector<StringName> arg_names;
 	Vector<Variant> default_arg_values;
@@ -510,21 +603,96 @@ private:
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
+	static SafeNumeric<uint32_t> inline_cache_epoch;
+	static Mutex inline_cache_mutex;
+	static GDScriptInlineCache::Block *retired_inline_cache_blocks;
+	static void _free_retired_inline_cache_blocks();
+
+	// Threads only look at inline cache blocks while they run a function. Each one publishes the
+	// reclaim epoch it started running in, and a block replaced in some epoch can only still be
+	// read by threads that started running in that epoch or earlier. So a thread stuck in a long
+	// function only holds back the blocks replaced since it started, and idle threads none.
+	struct ThreadEpoch {
+		std::atomic<uint64_t> epoch = { 0 }; // Zero while the thread runs no function.
+	};
+	static std::atomic<uint64_t> reclaim_epoch;
+	static LocalVector<ThreadEpoch *> thread_epochs; // Guarded by inline_cache_mutex.
+	// Only a plain pointer is thread_local, freed in thread_exit().
+	static thread_local ThreadEpoch *thread_epoch;
+	static thread_local uint32_t running_depth;
+	static void _register_thread_epoch();
+	struct RunningScope {
+		RunningScope() {
+			if (running_depth++ == 0) {
+				if (unlikely(!thread_epoch)) {
+					_register_thread_epoch();
+				}
+				// Sequentially consistent, so blocks replaced after this can't be seen as current.
+				thread_epoch->epoch.store(reclaim_epoch.load());
+			}
+		}
+		~RunningScope() {
+			if (--running_depth == 0) {
+				thread_epoch->epoch.store(0, std::memory_order_release);
+			}
+		}
+	};
+#ifdef DEBUG_ENABLED
+	uint64_t inline_cache_hits = 0;
+	uint64_t inline_cache_misses = 0;
+#endif
+
+	_FORCE_INLINE_ bool _find_inline_cache_entry(const GDScriptInlineCache *p_cache, Object *p_object, GDScriptInstance *p_instance, GDScriptInlineCache::Entry &r_entry) const;
+	void _add_inline_cache_entry(GDScriptInlineCache *p_cache, const GDScriptInlineCache::Entry &p_entry);
+	_FORCE_INLINE_ void _call_cached(GDScriptInlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+	_FORCE_INLINE_ void _get_named_cached(GDScriptInlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret, bool &r_valid);
+	_FORCE_INLINE_ void _set_named_cached(GDScriptInlineCache *p_cache, Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid);
+
 	friend class GDScriptLanguage;
 
 	SelfList<GDScriptFunction> function_list{ this };
+
+	SafeNumeric<uint32_t> sampling_id; // Zero until the sampling profiler first sees the function.
+
+	_FORCE_INLINE_ uint32_t _get_sampling_id() {
+		uint32_t id = sampling_id.get();
+		if (unlikely(id == 0)) {
+			id = GDScriptSamplingProfiler::register_function(String(source) + ":" + String(name));
+			sampling_id.set(id);
+		}
+		return id;
+	}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+	SafeNumeric<uint32_t> jit_call_count;
+	std::atomic<GDScriptJIT::Code *> jit_code = { nullptr };
+
+	const GDScriptJIT::Code *_get_jit_code();
+#endif
+
+	// Stack buffers of finished awaits, reused by the next await so coroutines don't allocate.
+	enum {
+		STATE_STACK_POOL_MAX = 256,
+	};
+	BinaryMutex state_stack_pool_mutex;
+	LocalVector<Vector<uint8_t>> state_stack_pool;
+
+	Vector<uint8_t> _take_state_stack(uint32_t p_size);
+	void _recycle_state_stack(Vector<uint8_t> &r_stack);
+
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
 	const char *_func_cname = nullptr;
 
 	struct Profile {
 		StringName signature;
-		uint64_t call_count = 0;
-		uint64_t self_time = 0;
-		uint64_t total_time = 0;
-		uint64_t frame_call_count = 0;
-		uint64_t frame_self_time = 0;
-		uint64_t frame_total_time = 0;
+		// Functions can run on several threads at once.
+		SafeNumeric<uint64_t> call_count;
+		SafeNumeric<uint64_t> self_time;
+		SafeNumeric<uint64_t> total_time;
+		SafeNumeric<uint64_t> frame_call_count;
+		SafeNumeric<uint64_t> frame_self_time;
+		SafeNumeric<uint64_t> frame_total_time;
 		uint64_t last_frame_call_count = 0;
 		uint64_t last_frame_self_time = 0;
 		uint64_t last_frame_total_time = 0;
@@ -594,6 +762,18 @@ public:
 #endif
 
 	_FORCE_INLINE_ Multiplayer::RPCConfig get_rpc_config() const { return rpc_config; }
+
+	// Drops what the inline caches of all functions learned, for when scripts change.
+	static void invalidate_inline_caches() { inline_cache_epoch.increment(); }
+	// Frees the replaced inline cache blocks that no running thread can still be reading.
+	static void free_retired_inline_caches();
+	// Forgets the calling thread's reclaim epoch, called before threads exit.
+	static void thread_exit();
+#ifdef DEBUG_ENABLED
+	uint64_t get_inline_cache_hits() const { return inline_cache_hits; }
+	uint64_t get_inline_cache_misses() const { return inline_cache_misses; }
+#endif
+
 	GDScriptFunction();
 	~GDScriptFunction();
 };
@@ -603,7 +783,6 @@ class GDScriptFunctionState : public RefCounted {
 	friend class GDScriptFunction;
 	GDScriptFunction *function = nullptr;
 	GDScriptFunction::CallState state;
-	Variant _signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	Ref<GDScriptFunctionState> first_state;
 
 	SelfList<GDScriptFunctionState> scripts_list;
@@ -622,4 +801,48 @@ public:
 	~GDScriptFunctionState();
 };
 
+// Resumes every function state awaiting the same signal of the same object, so that
+// many awaits on e.g. `process_frame` share one one-shot connection instead of one each.
+// The states resume in the order they awaited. Signals call custom callables after the
+// connections to methods, so awaits resume after those, even when they were made later.
+// Their order relative to other custom callables (e.g. lambdas) is unspecified.
+class GDScriptAwaitCallable : public CallableCustom {
+	struct Key {
+		ObjectID object;
+		StringName signal;
+
+		bool operator==(const Key &p_key) const { return object == p_key.object && signal == p_key.signal; }
+	};
+
+	struct KeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const Key &p_key) { return hash_murmur3_one_64((uint64_t)p_key.object, p_key.signal.hash()); }
+	};
+
+	static Mutex mutex;
+	static HashMap<Key, GDScriptAwaitCallable *, KeyHasher> waiting;
+
+	Key key;
+	uint64_t emission_id = 0; // Emission of the object that was in progress when connecting.
+	uint32_t h;
+	mutable LocalVector<Ref<GDScriptFunctionState>> states;
+	mutable bool fired = false;
+
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b);
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b);
+
+	GDScriptAwaitCallable(const Key &p_key, uint64_t p_emission_id);
+
+public:
+	uint32_t hash() const override;
+	String get_as_text() const override;
+	CompareEqualFunc get_compare_equal_func() const override;
+	CompareLessFunc get_compare_less_func() const override;
+	ObjectID get_object() const override;
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override;
+
+	static Error await(const Signal &p_signal, const Ref<GDScriptFunctionState> &p_state);
+
+	virtual ~GDScriptAwaitCallable();
+};
+
 #endif // GDSCRIPT_FUNCTION_H
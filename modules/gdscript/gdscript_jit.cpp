@@ -0,0 +1,672 @@
+/*************************************************************************/
+/*  gdscript_jit.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_jit.h"
+
+#ifdef GDSCRIPT_JIT_ENABLED
+#include "core/object/class_db.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant_internal.h"
+#include "gdscript_function.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool GDScriptJIT::enabled = false;
+uint32_t GDScriptJIT::call_threshold = 1000;
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+// Called by the generated code for anything that isn't worth writing in machine code.
+
+static void _jit_assign(Variant *p_dst, const Variant *p_src) {
+	*p_dst = *p_src;
+}
+
+static void _jit_assign_true(Variant *p_dst) {
+	*p_dst = true;
+}
+
+static void _jit_assign_false(Variant *p_dst) {
+	*p_dst = false;
+}
+
+static bool _jit_booleanize(const Variant *p_value) {
+	return p_value->booleanize();
+}
+
+static void _jit_change_to_bool(Variant *p_value) {
+	VariantTypeChanger<bool>::change(p_value);
+}
+
+static void _jit_change_to_int(Variant *p_value) {
+	VariantTypeChanger<int64_t>::change(p_value);
+}
+
+static void _jit_change_to_float(Variant *p_value) {
+	VariantTypeChanger<double>::change(p_value);
+}
+
+static bool _jit_iterate_begin_int(Variant *p_counter, const Variant *p_container, Variant *p_iterator) {
+	int64_t size = *VariantInternal::get_int(p_container);
+
+	VariantInternal::initialize(p_counter, Variant::INT);
+	*VariantInternal::get_int(p_counter) = 0;
+
+	if (size > 0) {
+		VariantInternal::initialize(p_iterator, Variant::INT);
+		*VariantInternal::get_int(p_iterator) = 0;
+		return true;
+	}
+	return false;
+}
+
+// Emits the few x86-64 instructions the translation needs. Memory operands are
+// always [base + disp32], with the stack, constants, members and line pointer
+// kept in callee-saved registers.
+class GDScriptJITAssembler {
+public:
+	enum Register {
+		RAX = 0,
+		RCX = 1,
+		RDX = 2,
+		RSI = 6,
+		RDI = 7,
+		R12 = 12,
+		R13 = 13,
+		R14 = 14,
+		R15 = 15,
+	};
+
+	enum Condition {
+		CC_B = 0x2,
+		CC_AE = 0x3,
+		CC_E = 0x4,
+		CC_NE = 0x5,
+		CC_A = 0x7,
+		CC_P = 0xA,
+		CC_NP = 0xB,
+		CC_L = 0xC,
+		CC_GE = 0xD,
+		CC_LE = 0xE,
+		CC_G = 0xF,
+	};
+
+	struct Operand {
+		Register base = R12;
+		int32_t disp = 0;
+	};
+
+	LocalVector<uint8_t> code;
+
+	void put_8(uint8_t p_value) {
+		code.push_back(p_value);
+	}
+
+	void put_32(int32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			code.push_back((uint32_t(p_value) >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void put_64(uint64_t p_value) {
+		for (int i = 0; i < 8; i++) {
+			code.push_back((p_value >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void patch_32(uint32_t p_pos, int32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			code[p_pos + i] = (uint32_t(p_value) >> (i * 8)) & 0xFF;
+		}
+	}
+
+	void rex(bool p_wide, int p_reg, int p_base) {
+		uint8_t prefix = 0x40 | (p_wide ? 0x08 : 0) | ((p_reg >> 3) << 2) | (p_base >> 3);
+		if (prefix != 0x40) {
+			put_8(prefix);
+		}
+	}
+
+	void modrm(int p_reg, const Operand &p_mem, int32_t p_offset) {
+		put_8(0x80 | ((p_reg & 7) << 3) | (p_mem.base & 7));
+		if ((p_mem.base & 7) == 4) {
+			put_8(0x24); // SIB without index, needed for R12.
+		}
+		put_32(p_mem.disp + p_offset);
+	}
+
+	// Integer instructions taking a register and a memory operand (mov, add, sub, cmp, lea...).
+	void op_64(uint8_t p_opcode, Register p_reg, const Operand &p_mem, int32_t p_offset) {
+		rex(true, p_reg, p_mem.base);
+		put_8(p_opcode);
+		modrm(p_reg, p_mem, p_offset);
+	}
+
+	void imul_64(Register p_reg, const Operand &p_mem, int32_t p_offset) {
+		rex(true, p_reg, p_mem.base);
+		put_8(0x0F);
+		put_8(0xAF);
+		modrm(p_reg, p_mem, p_offset);
+	}
+
+	// Scalar double instructions (movsd, addsd, ucomisd...) on xmm0.
+	void sse(uint8_t p_prefix, uint8_t p_opcode, const Operand &p_mem, int32_t p_offset) {
+		put_8(p_prefix);
+		rex(false, 0, p_mem.base);
+		put_8(0x0F);
+		put_8(p_opcode);
+		modrm(0, p_mem, p_offset);
+	}
+
+	void store_8(const Operand &p_mem, int32_t p_offset, Register p_reg) {
+		rex(false, p_reg, p_mem.base);
+		put_8(0x88);
+		modrm(p_reg, p_mem, p_offset);
+	}
+
+	void cmp_8(const Operand &p_mem, int32_t p_offset, int8_t p_value) {
+		rex(false, 0, p_mem.base);
+		put_8(0x80);
+		modrm(7, p_mem, p_offset);
+		put_8(p_value);
+	}
+
+	void cmp_32(const Operand &p_mem, int32_t p_offset, int8_t p_value) {
+		rex(false, 0, p_mem.base);
+		put_8(0x83);
+		modrm(7, p_mem, p_offset);
+		put_8(p_value);
+	}
+
+	void store_imm_32(const Operand &p_mem, int32_t p_offset, int32_t p_value) {
+		rex(false, 0, p_mem.base);
+		put_8(0xC7);
+		modrm(0, p_mem, p_offset);
+		put_32(p_value);
+	}
+
+	void add_imm_64(Register p_reg, int8_t p_value) {
+		rex(true, 0, p_reg);
+		put_8(0x83);
+		put_8(0xC0 | (p_reg & 7));
+		put_8(p_value);
+	}
+
+	void set_cc(Condition p_condition, Register p_reg) {
+		put_8(0x0F);
+		put_8(0x90 | p_condition);
+		put_8(0xC0 | p_reg);
+	}
+
+	void call(const void *p_function) {
+		put_8(0x48); // mov rax, imm64
+		put_8(0xB8);
+		put_64(uint64_t(p_function));
+		put_8(0xFF); // call rax
+		put_8(0xD0);
+	}
+
+	// Returns the position of the offset to patch.
+	uint32_t jump(int p_condition = -1) {
+		if (p_condition < 0) {
+			put_8(0xE9);
+		} else {
+			put_8(0x0F);
+			put_8(0x80 | p_condition);
+		}
+		uint32_t pos = code.size();
+		put_32(0);
+		return pos;
+	}
+
+	void bind(uint32_t p_jump) {
+		patch_32(p_jump, code.size() - (p_jump + 4));
+	}
+
+	void prologue() {
+		static const uint8_t bytes[] = {
+			0x55, // push rbp
+			0x48, 0x89, 0xE5, // mov rbp, rsp
+			0x41, 0x54, // push r12
+			0x41, 0x55, // push r13
+			0x41, 0x56, // push r14
+			0x41, 0x57, // push r15
+			0x49, 0x89, 0xFC, // mov r12, rdi (stack)
+			0x49, 0x89, 0xF5, // mov r13, rsi (constants)
+			0x49, 0x89, 0xD7, // mov r15, rdx (members)
+			0x49, 0x89, 0xCE, // mov r14, rcx (line)
+			0x41, 0xFF, 0xE0, // jmp r8 (resume point)
+		};
+		for (uint8_t b : bytes) {
+			put_8(b);
+		}
+	}
+
+	// Returns to the VM, which continues at the given instruction.
+	void exit(int p_ip) {
+		put_8(0xB8); // mov eax, imm32
+		put_32(p_ip);
+		static const uint8_t bytes[] = {
+			0x41, 0x5F, // pop r15
+			0x41, 0x5E, // pop r14
+			0x41, 0x5D, // pop r13
+			0x41, 0x5C, // pop r12
+			0x5D, // pop rbp
+			0xC3, // ret
+		};
+		for (uint8_t b : bytes) {
+			put_8(b);
+		}
+	}
+};
+
+class GDScriptJITCompiler {
+	typedef GDScriptJITAssembler Asm;
+
+	struct Jump {
+		uint32_t pos = 0;
+		int target = 0;
+		bool exit = false; // Leave to the VM at the target even if it was compiled.
+	};
+
+	const GDScriptFunction *function = nullptr;
+	Asm as;
+	LocalVector<int> native_offsets;
+	LocalVector<Jump> jumps;
+	int32_t data_offset = 0;
+	int member_count = 0;
+
+	bool get_operand(int p_address, Asm::Operand &r_operand) {
+		int index = p_address & GDScriptFunction::ADDR_MASK;
+		switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK:
+				ERR_FAIL_INDEX_V(index, function->_stack_size, false);
+				r_operand.base = Asm::R12;
+				break;
+			case GDScriptFunction::ADDR_TYPE_CONSTANT:
+				ERR_FAIL_INDEX_V(index, function->_constant_count, false);
+				r_operand.base = Asm::R13;
+				break;
+			case GDScriptFunction::ADDR_TYPE_MEMBER:
+				r_operand.base = Asm::R15;
+				member_count = MAX(member_count, index + 1);
+				break;
+			default:
+				return false;
+		}
+		r_operand.disp = index * sizeof(Variant);
+		return true;
+	}
+
+	void jump_to(int p_target, int p_condition = -1, bool p_exit = false) {
+		Jump jump;
+		jump.pos = as.jump(p_condition);
+		jump.target = p_target;
+		jump.exit = p_exit;
+		jumps.push_back(jump);
+	}
+
+	void call_1(const void *p_function, const Asm::Operand &p_arg) {
+		as.op_64(0x8D, Asm::RDI, p_arg, 0); // lea
+		as.call(p_function);
+	}
+
+	void call_2(const void *p_function, const Asm::Operand &p_arg1, const Asm::Operand &p_arg2) {
+		as.op_64(0x8D, Asm::RSI, p_arg2, 0);
+		call_1(p_function, p_arg1);
+	}
+
+	void call_3(const void *p_function, const Asm::Operand &p_arg1, const Asm::Operand &p_arg2, const Asm::Operand &p_arg3) {
+		as.op_64(0x8D, Asm::RDX, p_arg3, 0);
+		call_2(p_function, p_arg1, p_arg2);
+	}
+
+	// Same as VariantTypeChanger, only calling out when the type is different.
+	void change_type(const Asm::Operand &p_variant, Variant::Type p_type) {
+		as.cmp_32(p_variant, 0, p_type);
+		as.put_8(0x74); // je rel8
+		as.put_8(0);
+		uint32_t skip = as.code.size();
+		switch (p_type) {
+			case Variant::BOOL:
+				call_1((const void *)&_jit_change_to_bool, p_variant);
+				break;
+			case Variant::INT:
+				call_1((const void *)&_jit_change_to_int, p_variant);
+				break;
+			default:
+				call_1((const void *)&_jit_change_to_float, p_variant);
+				break;
+		}
+		as.code[skip - 1] = as.code.size() - skip;
+	}
+
+	void int_operator(Asm::Operand a, Asm::Operand b, Asm::Operand dst, int p_opcode) {
+		bool comparison = p_opcode >= GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT;
+		change_type(dst, comparison ? Variant::BOOL : Variant::INT);
+		as.op_64(0x8B, Asm::RAX, a, data_offset); // mov
+		switch (p_opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_INT:
+				as.op_64(0x03, Asm::RAX, b, data_offset);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT:
+				as.op_64(0x2B, Asm::RAX, b, data_offset);
+				break;
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT:
+				as.imul_64(Asm::RAX, b, data_offset);
+				break;
+			default: {
+				static const Asm::Condition conditions[] = { Asm::CC_E, Asm::CC_NE, Asm::CC_L, Asm::CC_LE, Asm::CC_G, Asm::CC_GE };
+				as.op_64(0x3B, Asm::RAX, b, data_offset); // cmp
+				as.set_cc(conditions[p_opcode - GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT], Asm::RAX);
+				as.store_8(dst, data_offset, Asm::RAX);
+				return;
+			}
+		}
+		as.op_64(0x89, Asm::RAX, dst, data_offset); // mov
+	}
+
+	void float_operator(Asm::Operand a, Asm::Operand b, Asm::Operand dst, int p_opcode) {
+		bool comparison = p_opcode >= GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+		change_type(dst, comparison ? Variant::BOOL : Variant::FLOAT);
+		if (!comparison) {
+			static const uint8_t sse_ops[] = { 0x58, 0x5C, 0x59, 0x5E }; // addsd, subsd, mulsd, divsd
+			as.sse(0xF2, 0x10, a, data_offset); // movsd xmm0, a
+			as.sse(0xF2, sse_ops[p_opcode - GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT], b, data_offset);
+			as.sse(0xF2, 0x11, dst, data_offset); // movsd dst, xmm0
+			return;
+		}
+
+		// Unordered results (NaN) set the parity flag, and must compare false like in C++.
+		switch (p_opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT:
+			case GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT: {
+				bool equal = p_opcode == GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+				as.sse(0xF2, 0x10, a, data_offset);
+				as.sse(0x66, 0x2E, b, data_offset); // ucomisd
+				as.set_cc(equal ? Asm::CC_E : Asm::CC_NE, Asm::RAX);
+				as.set_cc(equal ? Asm::CC_NP : Asm::CC_P, Asm::RCX);
+				as.put_8(equal ? 0x20 : 0x08); // and/or al, cl
+				as.put_8(0xC8);
+			} break;
+			case GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT:
+			case GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+				as.sse(0xF2, 0x10, b, data_offset);
+				as.sse(0x66, 0x2E, a, data_offset);
+				as.set_cc(p_opcode == GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT ? Asm::CC_A : Asm::CC_AE, Asm::RAX);
+				break;
+			default:
+				as.sse(0xF2, 0x10, a, data_offset);
+				as.sse(0x66, 0x2E, b, data_offset);
+				as.set_cc(p_opcode == GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT ? Asm::CC_A : Asm::CC_AE, Asm::RAX);
+				break;
+		}
+		as.store_8(dst, data_offset, Asm::RAX);
+	}
+
+	// Returns the size of the translated instruction, or 0 if the VM has to run it.
+	int translate(int p_ip) {
+		const int *code = function->_code_ptr + p_ip;
+		int opcode = code[0] & GDScriptFunction::INSTR_MASK;
+		Asm::Operand ops[3];
+
+		if (opcode >= GDScriptFunction::OPCODE_OPERATOR_ADD_INT && opcode <= GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT) {
+			if (!get_operand(code[1], ops[0]) || !get_operand(code[2], ops[1]) || !get_operand(code[3], ops[2])) {
+				return 0;
+			}
+			if (opcode <= GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT) {
+				int_operator(ops[0], ops[1], ops[2], opcode);
+			} else {
+				float_operator(ops[0], ops[1], ops[2], opcode);
+			}
+			return 4;
+		}
+
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+				int operator_idx = code[4];
+				if (operator_idx < 0 || operator_idx >= function->_operator_funcs_count) {
+					return 0;
+				}
+				if (!get_operand(code[1], ops[0]) || !get_operand(code[2], ops[1]) || !get_operand(code[3], ops[2])) {
+					return 0;
+				}
+				call_3((const void *)function->_operator_funcs_ptr[operator_idx], ops[0], ops[1], ops[2]);
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN: {
+				if (!get_operand(code[1], ops[0]) || !get_operand(code[2], ops[1])) {
+					return 0;
+				}
+				call_2((const void *)&_jit_assign, ops[0], ops[1]);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+				if (!get_operand(code[1], ops[0])) {
+					return 0;
+				}
+				call_1(opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE ? (const void *)&_jit_assign_true : (const void *)&_jit_assign_false, ops[0]);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+				Variant::Type type = Variant::Type(code[3]);
+				if (type < 0 || type >= Variant::VARIANT_MAX || !get_operand(code[1], ops[0]) || !get_operand(code[2], ops[1])) {
+					return 0;
+				}
+				// Conversions and type errors are left to the VM.
+				as.cmp_32(ops[1], 0, type);
+				jump_to(p_ip, Asm::CC_NE, true);
+				if (type == Variant::BOOL || type == Variant::INT || type == Variant::FLOAT) {
+					change_type(ops[0], type);
+					as.op_64(0x8B, Asm::RAX, ops[1], data_offset);
+					as.op_64(0x89, Asm::RAX, ops[0], data_offset);
+				} else {
+					call_2((const void *)&_jit_assign, ops[0], ops[1]);
+				}
+				return 4;
+			}
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL:
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_INT:
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT: {
+				if (!get_operand(code[1], ops[0])) {
+					return 0;
+				}
+				static const void *changers[] = { (const void *)&_jit_change_to_bool, (const void *)&_jit_change_to_int, (const void *)&_jit_change_to_float };
+				call_1(changers[opcode - GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL], ops[0]);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_JUMP: {
+				jump_to(code[1]);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_JUMP_IF_BOOL:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT_BOOL: {
+				if (!get_operand(code[1], ops[0])) {
+					return 0;
+				}
+				as.cmp_8(ops[0], data_offset, 0);
+				jump_to(code[2], opcode == GDScriptFunction::OPCODE_JUMP_IF_BOOL ? Asm::CC_NE : Asm::CC_E);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+				if (!get_operand(code[1], ops[0])) {
+					return 0;
+				}
+				call_1((const void *)&_jit_booleanize, ops[0]);
+				as.put_8(0x84); // test al, al
+				as.put_8(0xC0);
+				jump_to(code[2], opcode == GDScriptFunction::OPCODE_JUMP_IF ? Asm::CC_NE : Asm::CC_E);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT: {
+				if (!get_operand(code[1], ops[0]) || !get_operand(code[2], ops[1]) || !get_operand(code[3], ops[2])) {
+					return 0;
+				}
+				call_3((const void *)&_jit_iterate_begin_int, ops[0], ops[1], ops[2]);
+				as.put_8(0x84); // test al, al
+				as.put_8(0xC0);
+				jump_to(code[4], Asm::CC_E);
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_INT: {
+				if (!get_operand(code[1], ops[0]) || !get_operand(code[2], ops[1]) || !get_operand(code[3], ops[2])) {
+					return 0;
+				}
+				as.op_64(0x8B, Asm::RAX, ops[0], data_offset);
+				as.add_imm_64(Asm::RAX, 1);
+				as.op_64(0x89, Asm::RAX, ops[0], data_offset);
+				as.op_64(0x3B, Asm::RAX, ops[1], data_offset);
+				jump_to(code[4], Asm::CC_GE);
+				as.op_64(0x89, Asm::RAX, ops[2], data_offset);
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_LINE: {
+				Asm::Operand line;
+				line.base = Asm::R14;
+				as.store_imm_32(line, 0, code[1]);
+				return 2;
+			}
+			default:
+				return 0;
+		}
+	}
+
+public:
+	GDScriptJIT::Code *compile(const GDScriptFunction *p_function) {
+		function = p_function;
+		GDScriptJIT::Code *result = memnew(GDScriptJIT::Code);
+
+		// The generated code relies on the type being the first field of a Variant.
+		Variant probe_int = int64_t(1);
+		Variant probe_float = 1.0;
+		data_offset = (const uint8_t *)VariantInternal::get_int(&probe_int) - (const uint8_t *)&probe_int;
+		ERR_FAIL_COND_V(*(const int32_t *)&probe_int != Variant::INT || *(const int32_t *)&probe_float != Variant::FLOAT, result);
+
+		int code_size = function->_code_size;
+		native_offsets.resize(code_size + 1);
+		LocalVector<bool> translated;
+		translated.resize(code_size);
+		for (int i = 0; i < code_size; i++) {
+			native_offsets[i] = -1;
+			translated[i] = false;
+		}
+		native_offsets[code_size] = -1;
+
+		as.prologue();
+		int translated_count = 0;
+		int ip = 0;
+		while (ip < code_size) {
+			native_offsets[ip] = as.code.size();
+			int size = translate(ip);
+			if (size > 0) {
+				translated[ip] = true;
+				translated_count++;
+				ip += size;
+				continue;
+			}
+
+			// Left to the VM, which comes back at the next translated instruction it reaches.
+			as.exit(ip);
+			const int *code = function->_code_ptr + ip;
+			GDScriptFunction::InstructionLayout layout;
+			if (!GDScriptFunction::get_instruction_layout(GDScriptFunction::Opcode(code[0] & GDScriptFunction::INSTR_MASK), layout)) {
+				break;
+			}
+			ip += 1 + (uint32_t(code[0]) >> GDScriptFunction::INSTR_BITS) + layout.extra;
+		}
+		as.exit(ip); // Never runs into the exits added below.
+		if (translated_count == 0) {
+			// Nothing worth switching to native code for.
+			return result;
+		}
+
+		HashMap<int, uint32_t> exits;
+		for (uint32_t i = 0; i < jumps.size(); i++) {
+			const Jump &jump = jumps[i];
+			uint32_t target_offset;
+			if (!jump.exit && jump.target >= 0 && jump.target < code_size && native_offsets[jump.target] >= 0) {
+				// Translated instructions, or the exits in place of the others.
+				target_offset = native_offsets[jump.target];
+			} else if (exits.has(jump.target)) {
+				target_offset = exits[jump.target];
+			} else {
+				target_offset = as.code.size();
+				exits[jump.target] = target_offset;
+				as.exit(jump.target);
+			}
+			as.patch_32(jump.pos, target_offset - (jump.pos + 4));
+		}
+
+		size_t page_size = sysconf(_SC_PAGESIZE);
+		size_t memory_size = (as.code.size() + page_size - 1) / page_size * page_size;
+		void *memory = mmap(nullptr, memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		ERR_FAIL_COND_V(memory == MAP_FAILED, result);
+		memcpy(memory, as.code.ptr(), as.code.size());
+		if (mprotect(memory, memory_size, PROT_READ | PROT_EXEC) != 0) {
+			munmap(memory, memory_size);
+			ERR_FAIL_V_MSG(result, "Couldn't make memory executable for the GDScript JIT.");
+		}
+
+		result->entry = (GDScriptJIT::EntryPoint)memory;
+		result->resume_points.resize(code_size);
+		for (int i = 0; i < code_size; i++) {
+			result->resume_points[i] = translated[i] ? (const uint8_t *)memory + native_offsets[i] : nullptr;
+		}
+		result->member_count = member_count;
+		result->memory = memory;
+		result->memory_size = memory_size;
+		return result;
+	}
+};
+
+#endif // GDSCRIPT_JIT_ENABLED
+
+GDScriptJIT::Code *GDScriptJIT::compile(const GDScriptFunction *p_function) {
+#ifdef GDSCRIPT_JIT_ENABLED
+	GDScriptJITCompiler compiler;
+	return compiler.compile(p_function);
+#else
+	return memnew(Code);
+#endif
+}
+
+void GDScriptJIT::free_code(Code *p_code) {
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (p_code->memory) {
+		munmap(p_code->memory, p_code->memory_size);
+	}
+#endif
+	memdelete(p_code);
+}
@@ -0,0 +1,78 @@
+/*************************************************************************/
+/*  gdscript_jit.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_JIT_H
+#define GDSCRIPT_JIT_H
+
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+#if defined(UNIX_ENABLED) && (defined(__x86_64__) || defined(__amd64__))
+#define GDSCRIPT_JIT_ENABLED
+#endif
+
+class GDScriptFunction;
+
+// Baseline compiler from GDScript byte code to x86-64 machine code, used for
+// functions called often. Native code runs until it reaches an instruction it
+// doesn't translate, then returns the position of that instruction. The VM runs
+// it and enters the native code again at the next translated instruction it
+// gets to, so loops keep running natively past calls and other untranslated
+// instructions.
+class GDScriptJIT {
+public:
+	// Runs from p_resume_at, one of the resume points, and returns the position the VM continues at.
+	typedef int (*EntryPoint)(Variant *p_stack, Variant *p_constants, Variant *p_members, int *r_line, const void *p_resume_at);
+
+	struct Code {
+		EntryPoint entry = nullptr; // Null if the function couldn't be compiled.
+		// Native code of each instruction, indexed by its position in the byte code.
+		// Null for the ones the VM runs, and for positions within instructions.
+		LocalVector<const void *> resume_points;
+		int member_count = 0; // Highest member index used plus one.
+		void *memory = nullptr;
+		size_t memory_size = 0;
+	};
+
+private:
+	static bool enabled;
+	static uint32_t call_threshold;
+
+public:
+	static void set_enabled(bool p_enabled) { enabled = p_enabled; }
+	static _FORCE_INLINE_ bool is_enabled() { return enabled; }
+	static void set_call_threshold(uint32_t p_calls) { call_threshold = p_calls; }
+	static uint32_t get_call_threshold() { return call_threshold; }
+
+	static Code *compile(const GDScriptFunction *p_function);
+	static void free_code(Code *p_code);
+};
+
+#endif // GDSCRIPT_JIT_H
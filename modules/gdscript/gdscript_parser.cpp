@@ -114,6 +114,7 @@ GDScriptParser::GDScriptParser() {
 	// TODO: Should this be static?
 	register_annotation(MethodInfo("@tool"), AnnotationInfo::SCRIPT, &GDScriptParser::tool_annotation);
 	register_annotation(MethodInfo("@icon", PropertyInfo(Variant::STRING, "icon_path")), AnnotationInfo::SCRIPT, &GDScriptParser::icon_annotation);
+	register_annotation(MethodInfo("@thread_safe"), AnnotationInfo::SCRIPT, &GDScriptParser::thread_safe_annotation);
 	register_annotation(MethodInfo("@onready"), AnnotationInfo::VARIABLE, &GDScriptParser::onready_annotation);
 	// Export annotations.
 	register_annotation(MethodInfo("@export"), AnnotationInfo::VARIABLE, &GDScriptParser::export_annotations<PROPERTY_HINT_NONE, Variant::NIL>);
@@ -159,6 +160,7 @@ void GDScriptParser::clear() {
 	head = nullptr;
 	list = nullptr;
 	_is_tool = false;
+	_is_thread_safe = false;
 	for_completion = false;
 	errors.clear();
 	multiline_stack.clear();
@@ -3670,6 +3672,12 @@ bool GDScriptParser::tool_annotation(const AnnotationNode *p_annotation, Node *p
 	return true;
 }
 
+bool GDScriptParser::thread_safe_annotation(const AnnotationNode *p_annotation, Node *p_node) {
+	ERR_FAIL_COND_V_MSG(p_node->type != Node::CLASS, false, R"("@thread_safe" annotation can only be applied to classes.)");
+	this->_is_thread_safe = true;
+	return true;
+}
+
 bool GDScriptParser::icon_annotation(const AnnotationNode *p_annotation, Node *p_node) {
 	ERR_FAIL_COND_V_MSG(p_node->type != Node::CLASS, false, R"("@icon" annotation can only be applied to classes.)");
 	ClassNode *p_class = static_cast<ClassNode *>(p_node);
@@ -4929,6 +4937,9 @@ void GDScriptParser::TreePrinter::print_tree(const GDScriptParser &p_parser) {
 	if (p_parser.is_tool()) {
 		push_line("@tool");
 	}
+	if (p_parser.is_thread_safe()) {
+		push_line("@thread_safe");
+	}
 	if (!p_parser.get_tree()->icon_path.is_empty()) {
 		push_text(R"(@icon (")");
 		push_text(p_parser.get_tree()->icon_path);
@@ -0,0 +1,156 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "core/os/os.h"
+
+SafeFlag GDScriptSamplingProfiler::active;
+SafeFlag GDScriptSamplingProfiler::exit_thread;
+Thread *GDScriptSamplingProfiler::thread = nullptr;
+uint32_t GDScriptSamplingProfiler::interval_usec = 1000;
+
+thread_local GDScriptSamplingProfiler::ThreadStack *GDScriptSamplingProfiler::thread_stack = nullptr;
+thread_local uint32_t GDScriptSamplingProfiler::thread_stack_generation = 0;
+SafeNumeric<uint32_t> GDScriptSamplingProfiler::generation;
+
+BinaryMutex GDScriptSamplingProfiler::mutex;
+LocalVector<GDScriptSamplingProfiler::ThreadStack *> GDScriptSamplingProfiler::thread_stacks;
+LocalVector<String> GDScriptSamplingProfiler::function_names;
+HashMap<String, uint64_t> GDScriptSamplingProfiler::samples;
+
+void GDScriptSamplingProfiler::_register_thread() {
+	ThreadStack *stack = memnew(ThreadStack);
+
+	MutexLock lock(mutex);
+	thread_stacks.push_back(stack);
+	thread_stack = stack;
+	// Read under the lock, so finish() can't free the stack without this thread noticing.
+	thread_stack_generation = generation.get();
+}
+
+uint32_t GDScriptSamplingProfiler::register_function(const String &p_name) {
+	MutexLock lock(mutex);
+	function_names.push_back(p_name);
+	return function_names.size();
+}
+
+void GDScriptSamplingProfiler::_take_sample() {
+	MutexLock lock(mutex);
+
+	for (uint32_t i = 0; i < thread_stacks.size(); i++) {
+		const ThreadStack *stack = thread_stacks[i];
+		// The thread keeps running while it's read, so the frames may be from a
+		// slightly different moment than the depth. This evens out over many samples.
+		uint32_t depth = MIN(stack->depth.get(), (uint32_t)MAX_DEPTH);
+		if (depth == 0) {
+			continue;
+		}
+
+		String key;
+		for (uint32_t j = 0; j < depth; j++) {
+			uint32_t id = stack->frames[j].get();
+			if (j > 0) {
+				key += ";";
+			}
+			key += id > 0 && id <= function_names.size() ? function_names[id - 1] : String("<unknown>");
+		}
+
+		samples[key]++;
+	}
+}
+
+void GDScriptSamplingProfiler::_thread_func(void *p_userdata) {
+	while (!exit_thread.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		_take_sample();
+	}
+}
+
+void GDScriptSamplingProfiler::start(uint32_t p_interval_usec) {
+	ERR_FAIL_COND_MSG(thread, "The GDScript sampling profiler is already running.");
+	ERR_FAIL_COND(p_interval_usec == 0);
+
+	interval_usec = p_interval_usec;
+	active.set();
+	exit_thread.clear();
+	thread = memnew(Thread);
+	thread->start(_thread_func, nullptr);
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!thread) {
+		return;
+	}
+
+	active.clear();
+	exit_thread.set();
+	thread->wait_to_finish();
+	memdelete(thread);
+	thread = nullptr;
+}
+
+void GDScriptSamplingProfiler::get_samples(HashMap<String, uint64_t> &r_samples) {
+	MutexLock lock(mutex);
+
+	for (const KeyValue<String, uint64_t> &E : samples) {
+		r_samples[E.key] += E.value;
+	}
+}
+
+void GDScriptSamplingProfiler::thread_exit() {
+	if (!thread_stack) {
+		return;
+	}
+
+	MutexLock lock(mutex);
+	if (thread_stack_generation == generation.get()) {
+		// Not freed by finish() yet.
+		int64_t index = thread_stacks.find(thread_stack);
+		if (index != -1) {
+			thread_stacks.remove_at_unordered(index);
+		}
+		memdelete(thread_stack);
+	}
+	thread_stack = nullptr;
+}
+
+void GDScriptSamplingProfiler::finish() {
+	stop();
+
+	MutexLock lock(mutex);
+	for (uint32_t i = 0; i < thread_stacks.size(); i++) {
+		memdelete(thread_stacks[i]);
+	}
+	thread_stacks.clear();
+	samples.clear();
+	generation.increment();
+	thread_stack = nullptr;
+}
@@ -0,0 +1,114 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/string/ustring.h"
+
+// Statistical profiler that works in release builds. While it's active, every
+// thread running GDScript keeps a small stack of the functions it is in, and a
+// separate thread periodically reads those stacks and counts how often each
+// call path was seen. Samples are keyed by folded stacks ("a;b;c", outermost
+// function first), which is the input format of flame graph tools.
+class GDScriptSamplingProfiler {
+public:
+	enum {
+		MAX_DEPTH = 128, // Deeper frames are still tracked, but not reported.
+	};
+
+private:
+	struct ThreadStack {
+		SafeNumeric<uint32_t> depth;
+		SafeNumeric<uint32_t> frames[MAX_DEPTH];
+	};
+
+	static SafeFlag active;
+	static SafeFlag exit_thread;
+	static Thread *thread;
+	static uint32_t interval_usec;
+
+	// Stacks are freed when their thread exits or when the language finishes,
+	// the generation tells threads which outlived that to register a new one.
+	static thread_local ThreadStack *thread_stack;
+	static thread_local uint32_t thread_stack_generation;
+	static SafeNumeric<uint32_t> generation;
+
+	static BinaryMutex mutex;
+	static LocalVector<ThreadStack *> thread_stacks;
+	static LocalVector<String> function_names; // Indexed by function ID minus one.
+	static HashMap<String, uint64_t> samples;
+
+	static void _register_thread();
+	static void _take_sample();
+	static void _thread_func(void *p_userdata);
+
+public:
+	static _FORCE_INLINE_ bool is_active() { return active.is_set(); }
+
+	// Returns the ID to pass to enter() for a function, starting at one.
+	static uint32_t register_function(const String &p_name);
+
+	// Calls must be paired, even if the profiler is stopped in between.
+	static _FORCE_INLINE_ void enter(uint32_t p_function_id) {
+		if (unlikely(!thread_stack || thread_stack_generation != generation.get())) {
+			_register_thread();
+		}
+		uint32_t depth = thread_stack->depth.get();
+		if (likely(depth < MAX_DEPTH)) {
+			thread_stack->frames[depth].set(p_function_id);
+		}
+		thread_stack->depth.set(depth + 1);
+	}
+	static _FORCE_INLINE_ void exit() {
+		// The stack is gone if the language finished while the function ran.
+		if (unlikely(!thread_stack || thread_stack_generation != generation.get())) {
+			return;
+		}
+		uint32_t depth = thread_stack->depth.get();
+		if (likely(depth > 0)) {
+			thread_stack->depth.set(depth - 1);
+		}
+	}
+
+	static void start(uint32_t p_interval_usec);
+	static void stop();
+	static void get_samples(HashMap<String, uint64_t> &r_samples);
+	// Frees the stack of the calling thread, called before threads exit.
+	static void thread_exit();
+	static void finish();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -186,6 +186,248 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+// Inline caches only handle objects without a script and GDScript instances.
+static _FORCE_INLINE_ bool _get_inline_cache_receiver(const Variant *p_base, Object *&r_object, GDScriptInstance *&r_instance) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return false;
+	}
+	r_object = p_base->get_validated_object();
+	if (!r_object) {
+		return false;
+	}
+	ScriptInstance *script_instance = r_object->get_script_instance();
+	if (!script_instance) {
+		r_instance = nullptr;
+		return true;
+	}
+	if (script_instance->is_placeholder() || script_instance->get_language() != GDScriptLanguage::get_singleton()) {
+		return false;
+	}
+	r_instance = static_cast<GDScriptInstance *>(script_instance);
+	return true;
+}
+
+// Same accessor as ClassDB::get_property()/set_property() would use, if it's a plain method bind.
+static MethodBind *_get_inline_cache_accessor(const StringName &p_class, const StringName &p_property, bool p_setter) {
+	// Extension classes can handle properties before ClassDB does.
+	ClassDB::APIType api = ClassDB::get_api_type(p_class);
+	if (api == ClassDB::API_EXTENSION || api == ClassDB::API_EDITOR_EXTENSION) {
+		return nullptr;
+	}
+
+	bool valid = false;
+	int index = ClassDB::get_property_index(p_class, p_property, &valid);
+	if (!valid || index >= 0) {
+		return nullptr;
+	}
+
+	StringName accessor = p_setter ? ClassDB::get_property_setter(p_class, p_property) : ClassDB::get_property_getter(p_class, p_property);
+	if (accessor == StringName()) {
+		return nullptr;
+	}
+	return ClassDB::get_method(p_class, accessor);
+}
+
+// Entries are copied out, so a block is only referenced during the lookup.
+bool GDScriptFunction::_find_inline_cache_entry(const GDScriptInlineCache *p_cache, Object *p_object, GDScriptInstance *p_instance, GDScriptInlineCache::Entry &r_entry) const {
+	const GDScriptInlineCache::Block *block = p_cache->block.load();
+	if (!block || block->epoch != inline_cache_epoch.get()) {
+		return false;
+	}
+
+	const GDScript *script = p_instance ? p_instance->script.ptr() : nullptr;
+	const void *native_class = p_object->get_class_name().data_unique_pointer();
+	for (uint32_t i = 0; i < block->size; i++) {
+		const GDScriptInlineCache::Entry &entry = block->entries[i];
+		if (entry.script == script && entry.native_class == native_class) {
+			r_entry = entry;
+			return true;
+		}
+	}
+	return false;
+}
+
+void GDScriptFunction::_add_inline_cache_entry(GDScriptInlineCache *p_cache, const GDScriptInlineCache::Entry &p_entry) {
+	MutexLock lock(inline_cache_mutex);
+
+	GDScriptInlineCache::Block *old_block = p_cache->block.load();
+	uint32_t epoch = inline_cache_epoch.get();
+	uint32_t size = (old_block && old_block->epoch == epoch) ? old_block->size : 0;
+	if (size == GDScriptInlineCache::MAX_ENTRIES) {
+		return; // Too many receiver classes, leave the others to the lookup by name.
+	}
+	for (uint32_t i = 0; i < size; i++) {
+		if (old_block->entries[i].script == p_entry.script && old_block->entries[i].native_class == p_entry.native_class) {
+			return; // Added by another thread.
+		}
+	}
+
+	GDScriptInlineCache::Block *new_block = memnew(GDScriptInlineCache::Block);
+	new_block->epoch = epoch;
+	for (uint32_t i = 0; i < size; i++) {
+		new_block->entries[i] = old_block->entries[i];
+	}
+	new_block->entries[size] = p_entry;
+	new_block->size = size + 1;
+	p_cache->block.store(new_block);
+
+	if (old_block) {
+		// Threads that start running after the epoch advanced can only see the new block.
+		old_block->retired_epoch = reclaim_epoch.fetch_add(1);
+		old_block->next_retired = retired_inline_cache_blocks;
+		retired_inline_cache_blocks = old_block;
+		_free_retired_inline_cache_blocks();
+	}
+}
+
+void GDScriptFunction::_call_cached(GDScriptInlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	Object *object = nullptr;
+	GDScriptInstance *instance = nullptr;
+	if (_get_inline_cache_receiver(p_base, object, instance)) {
+		GDScriptInlineCache::Entry entry;
+		if (likely(_find_inline_cache_entry(p_cache, object, instance, entry))) {
+#ifdef DEBUG_ENABLED
+			inline_cache_hits++;
+#endif
+			r_error.error = Callable::CallError::CALL_OK;
+			if (entry.target == GDScriptInlineCache::TARGET_SCRIPT_FUNCTION) {
+				r_ret = entry.function->call(instance, p_args, p_argcount, r_error);
+			} else {
+				r_ret = entry.method->call(object, p_args, p_argcount, r_error);
+			}
+			return;
+		}
+
+#ifdef DEBUG_ENABLED
+		inline_cache_misses++;
+#endif
+		// Object::callp() and GDScriptInstance::callp() do more for these.
+		if (p_method != CoreStringNames::get_singleton()->_free && p_method != SNAME("_ready")) {
+			GDScriptInlineCache::Entry new_entry;
+			new_entry.native_class = object->get_class_name().data_unique_pointer();
+			if (instance) {
+				new_entry.script = instance->script.ptr();
+				for (GDScript *script = instance->script.ptr(); script; script = script->_base) {
+					HashMap<StringName, GDScriptFunction *>::Iterator E = script->member_functions.find(p_method);
+					if (E) {
+						new_entry.target = GDScriptInlineCache::TARGET_SCRIPT_FUNCTION;
+						new_entry.function = E->value;
+						break;
+					}
+				}
+			}
+			if (!new_entry.function) {
+				new_entry.method = ClassDB::get_method(object->get_class_name(), p_method);
+			}
+			if (new_entry.function || new_entry.method) {
+				_add_inline_cache_entry(p_cache, new_entry);
+			}
+		}
+	}
+
+	p_base->callp(p_method, p_args, p_argcount, r_ret, r_error);
+}
+
+void GDScriptFunction::_get_named_cached(GDScriptInlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret, bool &r_valid) {
+	Object *object = nullptr;
+	GDScriptInstance *instance = nullptr;
+	if (_get_inline_cache_receiver(p_base, object, instance)) {
+		GDScriptInlineCache::Entry entry;
+		if (likely(_find_inline_cache_entry(p_cache, object, instance, entry))) {
+#ifdef DEBUG_ENABLED
+			inline_cache_hits++;
+#endif
+			r_valid = true;
+			if (entry.target == GDScriptInlineCache::TARGET_SCRIPT_MEMBER) {
+				r_ret = instance->members[entry.member_index];
+			} else {
+				Callable::CallError ce;
+				r_ret = entry.method->call(object, nullptr, 0, ce);
+			}
+			return;
+		}
+
+#ifdef DEBUG_ENABLED
+		inline_cache_misses++;
+#endif
+		GDScriptInlineCache::Entry new_entry;
+		new_entry.native_class = object->get_class_name().data_unique_pointer();
+		if (instance) {
+			// Only plain members, GDScriptInstance::get() resolves everything else.
+			new_entry.script = instance->script.ptr();
+			// Members of thread-safe scripts are only read under the instance lock.
+			const GDScript::MemberInfo *member = instance->script->member_indices.getptr(p_name);
+			if (member && !member->getter && !instance->script->thread_safe) {
+				new_entry.target = GDScriptInlineCache::TARGET_SCRIPT_MEMBER;
+				new_entry.member_index = member->index;
+			}
+		} else {
+			new_entry.method = _get_inline_cache_accessor(object->get_class_name(), p_name, false);
+		}
+		if (new_entry.member_index >= 0 || new_entry.method) {
+			_add_inline_cache_entry(p_cache, new_entry);
+		}
+	}
+
+	r_ret = p_base->get_named(p_name, r_valid);
+}
+
+void GDScriptFunction::_set_named_cached(GDScriptInlineCache *p_cache, Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid) {
+	Object *object = nullptr;
+	GDScriptInstance *instance = nullptr;
+	if (_get_inline_cache_receiver(p_base, object, instance)) {
+		GDScriptInlineCache::Entry entry;
+		const bool found = _find_inline_cache_entry(p_cache, object, instance, entry);
+		// Values that need converting to the member type take the regular path.
+		if (likely(found) && (!entry.member_type || entry.member_type->is_type(p_value))) {
+#ifdef DEBUG_ENABLED
+			inline_cache_hits++;
+#endif
+#ifdef TOOLS_ENABLED
+			// Like Object::set().
+			if (!object->is_edited()) {
+				object->set_edited(true);
+			}
+#endif
+			if (entry.target == GDScriptInlineCache::TARGET_SCRIPT_MEMBER) {
+				instance->members.write[entry.member_index] = p_value;
+				r_valid = true;
+			} else {
+				const Variant *args[1] = { &p_value };
+				Callable::CallError ce;
+				entry.method->call(object, args, 1, ce);
+				r_valid = ce.error == Callable::CallError::CALL_OK;
+			}
+			return;
+		}
+
+		if (!found) {
+#ifdef DEBUG_ENABLED
+			inline_cache_misses++;
+#endif
+			GDScriptInlineCache::Entry new_entry;
+			new_entry.native_class = object->get_class_name().data_unique_pointer();
+			if (instance) {
+				// Only plain members, typed arrays are assigned differently by GDScriptInstance::set().
+				new_entry.script = instance->script.ptr();
+				const GDScript::MemberInfo *member = instance->script->member_indices.getptr(p_name);
+				if (member && !member->setter && !(member->data_type.builtin_type == Variant::ARRAY && member->data_type.has_container_element_type()) && !instance->script->thread_safe) {
+					new_entry.target = GDScriptInlineCache::TARGET_SCRIPT_MEMBER;
+					new_entry.member_index = member->index;
+					new_entry.member_type = member->data_type.has_type ? &member->data_type : nullptr;
+				}
+			} else {
+				new_entry.method = _get_inline_cache_accessor(object->get_class_name(), p_name, true);
+			}
+			if (new_entry.member_index >= 0 || new_entry.method) {
+				_add_inline_cache_entry(p_cache, new_entry);
+			}
+		}
+	}
+
+	p_base->set_named(p_name, p_value, r_valid);
+}
+
 void (*type_init_function_table[])(Variant *) = {
 	nullptr, // NIL (shouldn't be called).
 	&VariantInitializer<bool>::init, // BOOL.
@@ -229,6 +471,25 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {        \
 		&&OPCODE_OPERATOR,                           \
 		&&OPCODE_OPERATOR_VALIDATED,                 \
+		&&OPCODE_OPERATOR_ADD_INT,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,              \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,              \
+		&&OPCODE_OPERATOR_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_LESS_INT,                  \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,            \
+		&&OPCODE_OPERATOR_GREATER_INT,               \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,         \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                 \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,            \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,            \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,              \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,           \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,          \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,             \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,       \
 		&&OPCODE_EXTENDS_TEST,                       \
 		&&OPCODE_IS_BUILTIN,                         \
 		&&OPCODE_SET_KEYED,                          \
@@ -312,6 +573,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_JUMP,                               \
 		&&OPCODE_JUMP_IF,                            \
 		&&OPCODE_JUMP_IF_NOT,                        \
+		&&OPCODE_JUMP_IF_BOOL,                       \
+		&&OPCODE_JUMP_IF_NOT_BOOL,                   \
 		&&OPCODE_JUMP_TO_DEF_ARGUMENT,               \
 		&&OPCODE_JUMP_IF_SHARED,                     \
 		&&OPCODE_RETURN,                             \
@@ -464,6 +727,8 @@ void (*type_init_function_table[])(Variant *) = {
 Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state) {
 	OPCODES_TABLE;
 
+	RunningScope running;
+
 	if (!_code_ptr) {
 		return _get_default_variant_for_data_type(return_type);
 	}
@@ -576,6 +841,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	memnew_placement(&stack[ADDR_STACK_CLASS], Variant(script));
 	memnew_placement(&stack[ADDR_STACK_NIL], Variant);
 
+	// Other threads wait while this runs on an instance of a thread-safe script.
+	GDScriptInstance::MutexLockIfThreadSafe instance_lock(p_instance ? p_instance->mutex : nullptr);
+
 	String err_text;
 
 #ifdef DEBUG_ENABLED
@@ -621,18 +889,44 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		function_start_time = OS::get_singleton()->get_ticks_usec();
 		function_call_time = 0;
-		profile.call_count++;
-		profile.frame_call_count++;
+		profile.call_count.increment();
+		profile.frame_call_count.increment();
 	}
 	bool exit_ok = false;
 	bool awaited = false;
 #endif
 
+	bool sampled = GDScriptSamplingProfiler::is_active();
+	if (sampled) {
+		GDScriptSamplingProfiler::enter(_get_sampling_id());
+	}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+	const GDScriptJIT::Code *jit = nullptr;
+	int jit_exit_ip = -1;
+	if (GDScriptJIT::is_enabled() && !EngineDebugger::is_active()) {
+		jit = _get_jit_code();
+		if (jit && !jit->entry) {
+			jit = nullptr;
+		}
+	}
+#endif
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
-		int last_opcode = _code_ptr[ip] & INSTR_MASK;
 #else
 	OPCODE_WHILE(true) {
+#endif
+#ifdef GDSCRIPT_JIT_ENABLED
+		// Native code runs until an instruction it doesn't translate, which the VM runs before going back to it.
+		// It may also leave at a translated one for the VM to handle a case it doesn't (like a conversion).
+		if (jit && ip != jit_exit_ip && jit->resume_points[ip] && jit->member_count <= (p_instance ? p_instance->members.size() : 0)) {
+			ip = jit->entry(stack, _constants_ptr, p_instance ? p_instance->members.ptrw() : nullptr, &line, jit->resume_points[ip]);
+			jit_exit_ip = ip;
+		}
+#endif
+#ifdef DEBUG_ENABLED
+		int last_opcode = _code_ptr[ip] & INSTR_MASK;
 #endif
 		// Load arguments for the instruction before each instruction.
 		int instr_arg_count = ((_code_ptr[ip]) & INSTR_ARGS_MASK) >> INSTR_BITS;
@@ -694,6 +988,43 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			// Both operands are known to be int or float, so their values are used in place.
+#define OPCODE_OPERATOR_TYPED(m_opcode, m_type, m_result_type, m_operator) \
+	OPCODE(m_opcode) {                                                     \
+		CHECK_SPACE(4);                                                    \
+		GET_INSTRUCTION_ARG(a, 0);                                         \
+		GET_INSTRUCTION_ARG(b, 1);                                         \
+		GET_INSTRUCTION_ARG(dst, 2);                                       \
+		const m_type &left = *VariantGetInternalPtr<m_type>::get_ptr(a);   \
+		const m_type &right = *VariantGetInternalPtr<m_type>::get_ptr(b);  \
+		m_result_type result = left m_operator right;                      \
+		VariantTypeChanger<m_result_type>::change(dst);                    \
+		*VariantGetInternalPtr<m_result_type>::get_ptr(dst) = result;      \
+		ip += 4;                                                           \
+	}                                                                      \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_ADD_INT, int64_t, int64_t, +);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_SUBTRACT_INT, int64_t, int64_t, -);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_MULTIPLY_INT, int64_t, int64_t, *);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_EQUAL_INT, int64_t, bool, ==);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_NOT_EQUAL_INT, int64_t, bool, !=);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_INT, int64_t, bool, <);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_EQUAL_INT, int64_t, bool, <=);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_INT, int64_t, bool, >);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_EQUAL_INT, int64_t, bool, >=);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_ADD_FLOAT, double, double, +);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_SUBTRACT_FLOAT, double, double, -);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_MULTIPLY_FLOAT, double, double, *);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_DIVIDE_FLOAT, double, double, /);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_EQUAL_FLOAT, double, bool, ==);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_NOT_EQUAL_FLOAT, double, bool, !=);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_FLOAT, double, bool, <);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_LESS_EQUAL_FLOAT, double, bool, <=);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_FLOAT, double, bool, >);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_GREATER_EQUAL_FLOAT, double, bool, >=);
+#undef OPCODE_OPERATOR_TYPED
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -972,7 +1303,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 
 				GET_INSTRUCTION_ARG(dst, 0);
 				GET_INSTRUCTION_ARG(value, 1);
@@ -982,8 +1313,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				_set_named_cached(&_inline_caches_ptr[cache_idx], dst, *index, *value, valid);
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -992,7 +1326,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1012,7 +1346,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(src, 0);
 				GET_INSTRUCTION_ARG(dst, 1);
@@ -1022,22 +1356,21 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
 
-#else
-				*dst = src->get_named(*index, valid);
-#endif
+				bool valid;
+				// Not written to dst directly, src may be in the same stack position.
+				Variant ret;
+				_get_named_cached(&_inline_caches_ptr[cache_idx], src, *index, ret, valid);
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "').";
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
-				ip += 4;
+				*dst = ret;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1492,7 +1825,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 				bool call_ret = (_code_ptr[ip] & INSTR_MASK) != OPCODE_CALL;
 #ifdef DEBUG_ENABLED
 				bool call_async = (_code_ptr[ip] & INSTR_MASK) == OPCODE_CALL_ASYNC;
@@ -1507,6 +1840,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_idx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+				GDScriptInlineCache *cache = &_inline_caches_ptr[cache_idx];
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1521,7 +1858,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					_call_cached(cache, base, *methodname, (const Variant **)argptrs, argc, *ret, err);
 #ifdef DEBUG_ENABLED
 					if (!call_async && ret->get_type() == Variant::OBJECT) {
 						// Check if getting a function state without await.
@@ -1540,7 +1877,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					_call_cached(cache, base, *methodname, (const Variant **)argptrs, argc, ret, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1585,7 +1922,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -2189,11 +2526,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
+					gdfs->state.stack = _take_state_stack(alloca_size);
 
 					// First 3 stack addresses are special, so we just skip them here.
+					// The rest is moved rather than copied, leaving NIL behind so freeing the stack on exit is a no-op.
+					Variant *state_stack = (Variant *)gdfs->state.stack.ptrw();
 					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+						memcpy((void *)&state_stack[i], (const void *)&stack[i], sizeof(Variant));
+						memnew_placement(&stack[i], Variant);
 					}
 					gdfs->state.stack_size = _stack_size;
 					gdfs->state.alloca_size = alloca_size;
@@ -2219,8 +2559,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 					retvalue = gdfs;
 
-					Error err = sig.connect(callable_bind(Callable(gdfs.ptr(), "_signal_callback"), retvalue), Object::CONNECT_ONESHOT);
+					Error err = GDScriptAwaitCallable::await(sig, gdfs);
 					if (err != OK) {
+						gdfs->_clear_stack();
 						err_text = "Error connecting to signal: " + sig.get_name() + " during await.";
 						OPCODE_BREAK;
 					}
@@ -2354,6 +2695,36 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_JUMP_IF_BOOL) {
+				CHECK_SPACE(3);
+
+				GET_INSTRUCTION_ARG(test, 0);
+
+				if (*VariantInternal::get_bool(test)) {
+					int to = _code_ptr[ip + 2];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 3;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_JUMP_IF_NOT_BOOL) {
+				CHECK_SPACE(3);
+
+				GET_INSTRUCTION_ARG(test, 0);
+
+				if (!*VariantInternal::get_bool(test)) {
+					int to = _code_ptr[ip + 2];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 3;
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_JUMP_TO_DEF_ARGUMENT) {
 				CHECK_SPACE(2);
 				ip = _default_arg_ptr[defarg];
@@ -3457,11 +3828,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #ifdef DEBUG_ENABLED
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
-		profile.total_time += time_taken;
-		profile.self_time += time_taken - function_call_time;
-		profile.frame_total_time += time_taken;
-		profile.frame_self_time += time_taken - function_call_time;
-		GDScriptLanguage::get_singleton()->script_frame_time += time_taken - function_call_time;
+		profile.total_time.add(time_taken);
+		profile.self_time.add(time_taken - function_call_time);
+		profile.frame_total_time.add(time_taken);
+		profile.frame_self_time.add(time_taken - function_call_time);
+		GDScriptLanguage::get_singleton()->script_frame_time.add(time_taken - function_call_time);
 	}
 
 	// Check if this is not the last time it was interrupted by `await` or if it's the first time executing.
@@ -3486,5 +3857,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		stack[i].~Variant();
 	}
 
+	if (sampled) {
+		GDScriptSamplingProfiler::exit();
+	}
+
 	return retvalue;
 }
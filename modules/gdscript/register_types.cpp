@@ -36,6 +36,7 @@
 #include "core/io/resource_loader.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_byte_code_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_tokenizer.h"
 #include "gdscript_utility_functions.h"
@@ -69,7 +70,13 @@ Ref<GDScriptEditorTranslationParserPlugin> gdscript_translation_parser_plugin;
 class EditorExportGDScript : public EditorExportPlugin {
 	GDCLASS(EditorExportGDScript, EditorExportPlugin);
 
+	bool debug = false;
+
 public:
+	virtual void _export_begin(const HashSet<String> &p_features, bool p_debug, const String &p_path, int p_flags) override {
+		debug = p_debug;
+	}
+
 	virtual void _export_file(const String &p_path, const String &p_type, const HashSet<String> &p_features) override {
 		int script_mode = EditorExportPreset::MODE_SCRIPT_COMPILED;
 		String script_key;
@@ -85,8 +92,14 @@ public:
 			return;
 		}
 
-		// TODO: Re-add compiled GDScript on export.
-		return;
+		// The source is kept, scripts fall back to it if the compiled form can't be used.
+		Vector<uint8_t> byte_code;
+		Error err = GDScriptByteCodeCache::compile(p_path, debug, byte_code);
+		if (err != OK) {
+			print_verbose("GDScript: Can't compile '" + p_path + "' for export, only the source will be exported.");
+			return;
+		}
+		add_file(GDScriptByteCodeCache::get_cache_path(p_path), byte_code, false);
 	}
 };
 
@@ -182,7 +182,7 @@ int GDScriptTestRunner::run_tests() {
 	int failed = 0;
 	for (int i = 0; i < tests.size(); i++) {
 		GDScriptTest test = tests[i];
-		GDScriptTest::TestResult result = test.run_test();
+		GDScriptTest::TestResult result = test.run_test(byte_code_round_trip);
 
 		String expected = FileAccess::get_file_as_string(test.get_output_file());
 #ifndef DEBUG_ENABLED
@@ -446,7 +446,7 @@ String GDScriptTest::get_text_for_status(GDScriptTest::TestStatus p_status) cons
 	return "";
 }
 
-GDScriptTest::TestResult GDScriptTest::execute_test_code(bool p_is_generating) {
+GDScriptTest::TestResult GDScriptTest::execute_test_code(bool p_is_generating, bool p_byte_code_round_trip) {
 	disable_stdout();
 
 	TestResult result;
@@ -554,6 +554,27 @@ GDScriptTest::TestResult GDScriptTest::execute_test_code(bool p_is_generating) {
 
 	script->reload();
 
+	if (p_byte_code_round_trip) {
+		// Scripts with constants that can't be stored aren't exported in compiled form, run those as they are.
+		Vector<uint8_t> byte_code = script->get_as_byte_code();
+		if (!byte_code.is_empty()) {
+			// Load into a new script, like an exported project does, so nothing compiled from source is reused.
+			Ref<GDScript> compiled_script;
+			compiled_script.instantiate();
+			compiled_script->set_path(source_file, true);
+			compiled_script->set_script_path(source_file);
+			compiled_script->set_source_code(script->get_source_code()); // The compiled form is checked against it.
+			if (compiled_script->load_byte_code_from_buffer(byte_code) != OK) {
+				enable_stdout();
+				result.status = GDTEST_LOAD_ERROR;
+				result.output = "";
+				result.passed = false;
+				ERR_FAIL_V_MSG(result, "\nCould not load the compiled form of: '" + source_file + "'");
+			}
+			script = compiled_script;
+		}
+	}
+
 	// Create object instance for test.
 	Object *obj = ClassDB::instantiate(script->get_native()->get_name());
 	Ref<RefCounted> obj_ref;
@@ -600,8 +621,8 @@ GDScriptTest::TestResult GDScriptTest::execute_test_code(bool p_is_generating) {
 	return result;
 }
 
-GDScriptTest::TestResult GDScriptTest::run_test() {
-	return execute_test_code(false);
+GDScriptTest::TestResult GDScriptTest::run_test(bool p_byte_code_round_trip) {
+	return execute_test_code(false, p_byte_code_round_trip);
 }
 
 bool GDScriptTest::generate_output() {
@@ -83,12 +83,12 @@ private:
 	bool check_output(const String &p_output) const;
 	String get_text_for_status(TestStatus p_status) const;
 
-	TestResult execute_test_code(bool p_is_generating);
+	TestResult execute_test_code(bool p_is_generating, bool p_byte_code_round_trip = false);
 
 public:
 	static void print_handler(void *p_this, const String &p_message, bool p_error, bool p_rich);
 	static void error_handler(void *p_this, const char *p_function, const char *p_file, int p_line, const char *p_error, const char *p_explanation, bool p_editor_notify, ErrorHandlerType p_type);
-	TestResult run_test();
+	TestResult run_test(bool p_byte_code_round_trip = false);
 	bool generate_output();
 
 	const String &get_source_file() const { return source_file; }
@@ -105,6 +105,7 @@ class GDScriptTestRunner {
 
 	bool is_generating = false;
 	bool do_init_languages = false;
+	bool byte_code_round_trip = false;
 
 	bool make_tests();
 	bool make_tests_for_dir(const String &p_dir);
@@ -117,6 +118,9 @@ public:
 	int run_tests();
 	bool generate_outputs();
 
+	// Runs the compiled form of each script after storing and loading it, like exported projects do.
+	void set_byte_code_round_trip(bool p_enabled) { byte_code_round_trip = p_enabled; }
+
 	GDScriptTestRunner(const String &p_source_dir, bool p_init_language);
 	~GDScriptTestRunner();
 };
@@ -31,6 +31,13 @@
 #ifndef GDSCRIPT_TEST_RUNNER_SUITE_H
 #define GDSCRIPT_TEST_RUNNER_SUITE_H
 
+#include "../gdscript_byte_code_cache.h"
+#include "../gdscript_cache.h"
+#include "../gdscript_compiler.h"
+#include "../gdscript_jit.h"
+#include "../gdscript_parser.h"
+#include "core/io/dir_access.h"
+#include "core/os/os.h"
 #include "gdscript_test_runner.h"
 #include "tests/test_macros.h"
 
@@ -46,6 +53,30 @@ TEST_SUITE("[Modules][GDScript]") {
 		INFO("Make sure `*.out` files have expected results.");
 		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass.");
 	}
+
+	TEST_CASE("Script compilation and runtime from byte code") {
+		GDScriptTestRunner runner("modules/gdscript/tests/scripts", true);
+		runner.set_byte_code_round_trip(true);
+		int fail_count = runner.run_tests();
+		INFO("Make sure `*.out` files have expected results.");
+		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass when loaded from byte code.");
+	}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+	TEST_CASE("Script compilation and runtime with the JIT") {
+		GDScriptTestRunner runner("modules/gdscript/tests/scripts", true);
+		// Compile every function on its first call, so the native code has to give the same results as the VM.
+		const bool enabled = GDScriptJIT::is_enabled();
+		const uint32_t call_threshold = GDScriptJIT::get_call_threshold();
+		GDScriptJIT::set_enabled(true);
+		GDScriptJIT::set_call_threshold(1);
+		int fail_count = runner.run_tests();
+		GDScriptJIT::set_enabled(enabled);
+		GDScriptJIT::set_call_threshold(call_threshold);
+		INFO("Make sure `*.out` files have expected results.");
+		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass with the JIT.");
+	}
+#endif
 }
 
 TEST_CASE("[Modules][GDScript] Load source code dynamically and run it") {
@@ -69,6 +100,313 @@ func _init():
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
 
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Modules][GDScript] Inline caches of untyped accesses count hits") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+class Item:
+	var value = 1
+
+	func get_value():
+		return value
+
+func sum(items):
+	var total = 0
+	for item in items:
+		total += item.get_value() + item.value
+	return total
+
+func make_items():
+	var items = []
+	for i in 10:
+		items.append(Item.new())
+	return items
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+	Variant items = ref_counted->call("make_items");
+	CHECK_MESSAGE(int(ref_counted->call("sum", items)) == 20, "The script should compute the sum successfully.");
+
+	// Both the call and the property access only miss for the first item.
+	const GDScriptFunction *sum = gdscript->get_member_functions()["sum"];
+	CHECK(sum->get_inline_cache_misses() == 2);
+	CHECK(sum->get_inline_cache_hits() == 18);
+}
+#endif
+
+TEST_CASE("[Modules][GDScript] Sampling profiler records folded call stacks") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func outer():
+	return inner()
+
+func inner():
+	var total = 0
+	for i in 1000:
+		total += i
+	return total
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	GDScriptLanguage::get_singleton()->sampling_profiler_start(100);
+	bool found = false;
+	const uint64_t start_time = OS::get_singleton()->get_ticks_msec();
+	while (!found && OS::get_singleton()->get_ticks_msec() - start_time < 5000) {
+		ref_counted->call("outer");
+
+		HashMap<String, uint64_t> samples;
+		GDScriptLanguage::get_singleton()->sampling_profiler_get_samples(samples);
+		for (const KeyValue<String, uint64_t> &E : samples) {
+			if (E.key.ends_with(":inner") && E.key.contains(":outer;")) {
+				found = true;
+			}
+		}
+	}
+	GDScriptLanguage::get_singleton()->sampling_profiler_stop();
+
+	CHECK_MESSAGE(found, "The profiler should sample the inner function with the outer one as its caller.");
+}
+
+TEST_CASE("[Modules][GDScript] Optimization levels keep results") {
+	const String source = R"(
+extends RefCounted
+
+const SCALE = 3
+
+static func lerp_int(from, to, weight):
+	return from + (to - from) * weight / SCALE
+
+static func clamp_positive(value: int) -> int:
+	return value if value > 0 else 0
+
+static func compute(values):
+	var total = 0
+	for value in values:
+		var step = lerp_int(total, value, 2)
+		total = clamp_positive(step) + values.size()
+	if SCALE < 0:
+		total = -1
+	return total
+)";
+
+	int code_sizes[3];
+	uint64_t cached_calls[3] = {};
+	const int previous_level = GDScriptCompiler::get_optimization_level();
+	for (int level = GDScriptCompiler::OPTIMIZATION_NONE; level <= GDScriptCompiler::OPTIMIZATION_INLINE; level++) {
+		GDScriptCompiler::set_optimization_level(level);
+		Ref<GDScript> gdscript = memnew(GDScript);
+		gdscript->set_source_code(source);
+		ERR_PRINT_OFF;
+		const Error error = gdscript->reload();
+		ERR_PRINT_ON;
+		REQUIRE_MESSAGE(error == OK, "The script should compile at every optimization level.");
+
+		Array values;
+		values.push_back(6);
+		values.push_back(-30);
+		values.push_back(12);
+
+		CHECK_MESSAGE(int(gdscript->call("compute", values)) == 12, "The result shouldn't depend on the optimization level.");
+
+		const GDScriptFunction *compute = gdscript->get_member_functions()["compute"];
+		code_sizes[level] = compute->get_code_size();
+#ifdef DEBUG_ENABLED
+		cached_calls[level] = compute->get_inline_cache_hits() + compute->get_inline_cache_misses();
+#endif
+	}
+	GDScriptCompiler::set_optimization_level(previous_level);
+
+	// The constant branch is left out and temporaries are written to directly.
+	CHECK(code_sizes[GDScriptCompiler::OPTIMIZATION_BASIC] < code_sizes[GDScriptCompiler::OPTIMIZATION_NONE]);
+#ifdef DEBUG_ENABLED
+	// Only `lerp_int()` qualifies, `clamp_positive()` would need to convert its argument.
+	CHECK_MESSAGE(cached_calls[GDScriptCompiler::OPTIMIZATION_BASIC] - cached_calls[GDScriptCompiler::OPTIMIZATION_INLINE] == 3, "The three calls to the small static function should be inlined.");
+#endif
+}
+
+TEST_CASE("[Modules][GDScript] Store compiled script and load it back") {
+	const String source = R"(
+extends RefCounted
+
+const VALUES = { "a": [1, 2], "b": Vector2(3, 4) }
+
+class Inner:
+	var factor := 2
+
+	func scale(value: int) -> int:
+		return value * factor
+
+var inner = Inner.new()
+
+func _init():
+	var add := func(a: int, b: int) -> int: return a + b
+	set_meta("result", add.call(inner.scale(VALUES.a[1]), int(VALUES.b.y)) + absi(-3) + str(10).to_int())
+)";
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(source);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Vector<uint8_t> byte_code = gdscript->get_as_byte_code();
+	REQUIRE_MESSAGE(!byte_code.is_empty(), "The compiled script should be stored.");
+
+	Ref<GDScript> loaded = memnew(GDScript);
+	loaded->set_source_code(source);
+	CHECK_MESSAGE(GDScriptByteCodeCache::deserialize(loaded.ptr(), byte_code) == OK, "The compiled script should load.");
+	CHECK(loaded->is_valid());
+	CHECK(loaded->get_subclasses().has("Inner"));
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(loaded);
+	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 21, "The loaded script should run like the original one.");
+
+	Ref<GDScript> changed = memnew(GDScript);
+	changed->set_source_code(source + "\n");
+	CHECK_MESSAGE(GDScriptByteCodeCache::deserialize(changed.ptr(), byte_code) != OK, "The compiled script shouldn't load for different source code.");
+	CHECK_FALSE(changed->is_valid());
+
+	const int optimization_level = GDScriptCompiler::get_optimization_level();
+	GDScriptCompiler::set_optimization_level(optimization_level == GDScriptCompiler::OPTIMIZATION_NONE ? GDScriptCompiler::OPTIMIZATION_BASIC : GDScriptCompiler::OPTIMIZATION_NONE);
+	Ref<GDScript> other_level = memnew(GDScript);
+	other_level->set_source_code(source);
+	CHECK_MESSAGE(GDScriptByteCodeCache::deserialize(other_level.ptr(), byte_code) != OK, "The compiled script shouldn't load at another optimization level.");
+	GDScriptCompiler::set_optimization_level(optimization_level);
+}
+
+TEST_CASE("[Modules][GDScript] Prewarm scripts that refer to each other") {
+	const String dir = OS::get_singleton()->get_cache_path().plus_file("gdscript_prewarm");
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->make_dir_recursive(dir);
+
+	// The cycle between A and B only goes through function bodies, the main script reaches it through
+	// `extends` and `preload()`.
+	const String a_path = dir.plus_file("cycle_a.gd");
+	const String b_path = dir.plus_file("cycle_b.gd");
+	const String main_path = dir.plus_file("main.gd");
+	const String sources[3][2] = {
+		{ a_path, R"(
+class_name PrewarmCycleA
+extends RefCounted
+
+func get_value() -> int:
+	return 1
+
+func add_other() -> int:
+	return get_value() + PrewarmCycleB.new().get_value()
+)" },
+		{ b_path, R"(
+class_name PrewarmCycleB
+extends RefCounted
+
+func get_value() -> int:
+	return 2
+
+func add_other() -> int:
+	return get_value() + PrewarmCycleA.new().get_value()
+)" },
+		{ main_path, R"(
+extends "cycle_a.gd"
+
+const B = preload("cycle_b.gd")
+
+func get_sum() -> int:
+	return add_other() + B.new().add_other()
+)" },
+	};
+	for (int i = 0; i < 3; i++) {
+		Ref<FileAccess> f = FileAccess::open(sources[i][0], FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(sources[i][1]);
+	}
+	const StringName gdscript_name = GDScriptLanguage::get_singleton()->get_name();
+	ScriptServer::add_global_class("PrewarmCycleA", "RefCounted", gdscript_name, a_path);
+	ScriptServer::add_global_class("PrewarmCycleB", "RefCounted", gdscript_name, b_path);
+
+	GDScriptCache::prewarm({ main_path });
+
+	Ref<GDScript> main_script = ResourceLoader::load(main_path);
+	REQUIRE(main_script.is_valid());
+	CHECK_MESSAGE(main_script->is_valid(), "Prewarming should compile the scripts.");
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(main_script);
+	CHECK(int(instance->call("get_sum")) == 6);
+
+	instance.unref();
+	main_script.unref();
+	GDScriptCache::release_prewarmed_scripts();
+	ScriptServer::remove_global_class("PrewarmCycleA");
+	ScriptServer::remove_global_class("PrewarmCycleB");
+	for (int i = 0; i < 3; i++) {
+		da->remove(sources[i][0]);
+	}
+	da->remove(dir);
+}
+
+TEST_CASE("[Modules][GDScript] Tasks share instances of thread-safe scripts") {
+	Ref<GDScript> counter_script = memnew(GDScript);
+	counter_script->set_source_code(R"(
+extends RefCounted
+@thread_safe
+
+var value := 0
+
+func add(amount):
+	value += amount
+)");
+	ERR_PRINT_OFF;
+	Error error = counter_script->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+	CHECK(counter_script->is_thread_safe());
+
+	Ref<GDScript> tasks_script = memnew(GDScript);
+	tasks_script->set_source_code(R"(
+extends RefCounted
+
+func count(counter, n):
+	parallel_for(n, func(i): counter.add(i))
+	return counter.value
+
+func count_nested(counter):
+	parallel_for(4, func(i): parallel_for(4, func(j): counter.add(i * 4 + j)))
+	return counter.value
+)");
+	ERR_PRINT_OFF;
+	error = tasks_script->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+	CHECK_FALSE(tasks_script->is_thread_safe());
+
+	Ref<RefCounted> tasks = memnew(RefCounted);
+	tasks->set_script(tasks_script);
+
+	Ref<RefCounted> counter = memnew(RefCounted);
+	counter->set_script(counter_script);
+	CHECK_MESSAGE(int(tasks->call("count", counter, 1000)) == 499500, "Every task should run once, without losing updates.");
+
+	Ref<RefCounted> nested_counter = memnew(RefCounted);
+	nested_counter->set_script(counter_script);
+	CHECK_MESSAGE(int(tasks->call("count_nested", nested_counter)) == 120, "Nested tasks should run on the calling thread.");
+}
+
 } // namespace GDScriptTests
 
 #endif // GDSCRIPT_TEST_RUNNER_SUITE_H
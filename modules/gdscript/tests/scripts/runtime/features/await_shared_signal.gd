@@ -0,0 +1,50 @@
+signal ping(value)
+signal pair(a, b)
+signal tick
+
+func wait_ping(id):
+	var value = await ping
+	print("%d got %s" % [id, value])
+	value = await ping
+	print("%d again %s" % [id, value])
+
+func wait_pair():
+	var values = await pair
+	print(values)
+
+func chain():
+	await wait_ping(9)
+	print("chain done")
+
+func wait_tick(id):
+	await tick
+	print("await %d resumed" % id)
+
+func on_tick():
+	print("handler called")
+
+func on_ping(_value):
+	# Awaiting while the signal is being emitted must wait for the next emission.
+	await ping
+	print("handler resumed")
+
+func test():
+	for i in 3:
+		wait_ping(i)
+	chain()
+	ping.connect(on_ping, CONNECT_ONESHOT)
+	# All awaits share one connection.
+	print(get_signal_connection_list("ping").size())
+	ping.emit("a")
+	# Awaiting again while resuming shares a new connection.
+	print(get_signal_connection_list("ping").size())
+	ping.emit("b")
+	print(get_signal_connection_list("ping").size())
+	ping.emit("c")
+	wait_pair()
+	pair.emit(1, 2)
+	# Awaits resume in await order, after the connections to methods, even later ones.
+	wait_tick(0)
+	wait_tick(1)
+	tick.connect(on_tick, CONNECT_ONESHOT)
+	tick.emit()
@@ -0,0 +1,55 @@
+const VERBOSE = false
+const MODE = 2
+
+
+func pick(value):
+	if VERBOSE:
+		print("not printed")
+	elif MODE == 1:
+		return "one"
+	elif MODE == 2:
+		return "two %s" % value
+	else:
+		return "other"
+
+
+func early(value):
+	if value > 0:
+		return "positive"
+	else:
+		return "not positive"
+	print("not printed")
+
+
+func test():
+	print(pick(1))
+	print(early(1), " ", early(-1))
+
+	while VERBOSE:
+		print("not printed")
+
+	var label = "yes" if MODE == 2 else str(MODE)
+	print(label)
+
+	# Results written straight into the assigned variable.
+	var items = [1, 2, 3]
+	var total = items.size() + items[0]
+	var text = str(total)
+	print(total, " ", text)
+
+	# The variable is also an operand, so it still goes through a temporary.
+	total = total + total
+	items = items + [total]
+	text = text + str(text)
+	print(total, " ", items, " ", text)
+
+	var typed: int = items.size()
+	typed = items.find(total)
+	print(typed)
+
+	for i in 3:
+		if i == 1:
+			continue
+			print("not printed")
+		var square = i * i
+		print(square)
@@ -0,0 +1,43 @@
+class A:
+	var value = 1
+
+	func describe():
+		return "A%s" % value
+
+
+class B:
+	var value := 2.5
+
+	func describe():
+		return "B%s" % value
+
+
+class C extends A:
+	func describe():
+		return "C" + super()
+
+
+func test():
+	# The same call and property sites see several receiver classes.
+	var objects = [A.new(), B.new(), C.new(), A.new()]
+	for i in 3:
+		var descriptions := []
+		for object in objects:
+			object.value = object.value + 1
+			descriptions.append(object.describe())
+		print(descriptions)
+
+	# Typed members still convert what's assigned to them.
+	var b = objects[1]
+	for value in [7, 8.5]:
+		b.value = value
+		print(b.value, " ", typeof(b.value) == TYPE_FLOAT)
+
+	# Native properties and methods.
+	var natives = [Resource.new(), RefCounted.new(), Resource.new()]
+	for native in natives:
+		if native is Resource:
+			native.resource_name = "named"
+			print(native.get_class(), " ", native.resource_name, " ", native.get_name())
+		else:
+			print(native.get_class())
@@ -0,0 +1,9 @@
+func test():
+	var ints: Array[int] = [1, 2, 3]
+	var packed := PackedInt64Array(ints)
+	packed.append(4)
+	print(packed)
+	print(Array(packed))
+
+	var vectors: Array[Vector2] = [Vector2(1, 2)]
+	print(PackedVector2Array(vectors))
@@ -0,0 +1,23 @@
+func test():
+	var a := 7
+	var b := 3
+	print(a + b, " ", a - b, " ", a * b)
+	print(a == b, " ", a != b, " ", a < b, " ", a <= b, " ", a > b, " ", a >= b)
+
+	var x := 2.5
+	var y := 0.5
+	print(x + y, " ", x - y, " ", x * y, " ", x / y)
+	print(x == y, " ", x != y, " ", x < y, " ", x <= y, " ", x > y, " ", x >= y)
+
+	# Result replaces the previous value of an untyped variable.
+	var untyped = "text"
+	untyped = a * b
+	print(untyped)
+
+	var total := 0
+	var i := 0
+	while i < 10:
+		if i % 2 == 0 and i != 4:
+			total += i
+		i += 1
+	print(total)
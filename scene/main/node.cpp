@@ -48,7 +48,7 @@
 VARIANT_ENUM_CAST(Node::ProcessMode);
 VARIANT_ENUM_CAST(Node::InternalMode);
 
-int Node::orphan_node_count = 0;
+SafeNumeric<int> Node::orphan_node_count;
 
 void Node::_notification(int p_notification) {
 	switch (p_notification) {
@@ -90,7 +90,7 @@ void Node::_notification(int p_notification) {
 			}
 
 			get_tree()->node_count++;
-			orphan_node_count--;
+			orphan_node_count.decrement();
 		} break;
 
 		case NOTIFICATION_EXIT_TREE: {
@@ -98,7 +98,7 @@ void Node::_notification(int p_notification) {
 			ERR_FAIL_COND(!get_tree());
 
 			get_tree()->node_count--;
-			orphan_node_count++;
+			orphan_node_count.increment();
 
 			if (data.input) {
 				remove_from_group("_vp_input" + itos(get_viewport()->get_instance_id()));
@@ -3028,7 +3028,7 @@ String Node::_get_name_num_separator() {
 }
 
 Node::Node() {
-	orphan_node_count++;
+	orphan_node_count.increment();
 }
 
 Node::~Node() {
@@ -3039,7 +3039,7 @@ Node::~Node() {
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
 
-	orphan_node_count--;
+	orphan_node_count.decrement();
 }
 
 ////////////////////////////////
@@ -32,6 +32,9 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
 #include "tests/test_macros.h"
 #include "tests/test_utils.h"
 
@@ -78,6 +81,168 @@ TEST_CASE("[FileAccess] CSV read") {
 	CHECK(row5[1] == "tab separated");
 	CHECK(row5[2] == "lines, good?");
 }
+
+TEST_CASE("[FileAccess] Memory-mapped read") {
+	const String path = TestUtils::get_data_path("translations.csv");
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+	Ref<FileAccess> mapped = FileAccess::open_mapped(path);
+	REQUIRE(f.is_valid());
+	REQUIRE(mapped.is_valid());
+
+	const uint64_t length = f->get_length();
+	REQUIRE(mapped->get_length() == length);
+
+	Vector<uint8_t> expected;
+	expected.resize(length);
+	f->get_buffer(expected.ptrw(), length);
+
+	Vector<uint8_t> actual;
+	actual.resize(length);
+	CHECK(mapped->get_buffer(actual.ptrw(), length) == length);
+	CHECK(actual == expected);
+	CHECK_FALSE(mapped->eof_reached());
+
+	// Reading past the end behaves like a regular file.
+	uint8_t extra[4];
+	CHECK(mapped->get_buffer(extra, 4) == 0);
+	CHECK(mapped->eof_reached());
+
+	mapped->seek(0);
+	CHECK(mapped->get_32() == decode_uint32(expected.ptr()));
+	CHECK(mapped->get_position() == 4);
+
+	const uint8_t *span = mapped->get_mapped_span(0, length);
+	if (span) {
+		// Only platforms with a memory-mapped backend hand out spans.
+		CHECK(memcmp(span, expected.ptr(), length) == 0);
+		CHECK(mapped->get_mapped_span(length, 0) != nullptr);
+		CHECK(mapped->get_mapped_span(length, 1) == nullptr);
+		CHECK(mapped->get_mapped_span(1, length) == nullptr);
+	}
+	CHECK(f->get_mapped_span(0, length) == nullptr);
+}
+
+static Vector<uint8_t> _make_compressible_data(int p_size) {
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	uint8_t *w = data.ptrw();
+	for (int i = 0; i < p_size; i++) {
+		w[i] = (i / 7) ^ (i % 13);
+	}
+	return data;
+}
+
+TEST_CASE("[FileAccess] Compressed seek and read-ahead") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("compressed.bin");
+	// Not a multiple of the block size, so the last block is partial.
+	const Vector<uint8_t> data = _make_compressible_data(4096 * 20 + 123);
+
+	Ref<FileAccessCompressed> w;
+	w.instantiate();
+	w->configure("GCPF", Compression::MODE_ZSTD, 4096);
+	REQUIRE(w->_open(path, FileAccess::WRITE) == OK);
+	w->store_buffer(data.ptr(), data.size());
+	w.unref();
+
+	for (int read_ahead = 0; read_ahead < 2; read_ahead++) {
+		Ref<FileAccessCompressed> r;
+		r.instantiate();
+		r->configure("GCPF", Compression::MODE_ZSTD, 4096);
+		r->set_read_ahead(read_ahead);
+		REQUIRE(r->_open(path, FileAccess::READ) == OK);
+		CHECK(r->get_length() == (uint64_t)data.size());
+
+		// Sequential read, crossing blocks both byte by byte and in bulk.
+		Vector<uint8_t> result;
+		result.resize(data.size());
+		for (int i = 0; i < 5000; i++) {
+			result.write[i] = r->get_8();
+		}
+		CHECK(r->get_buffer(result.ptrw() + 5000, data.size() - 5000) == (uint64_t)data.size() - 5000);
+		CHECK(result == data);
+		CHECK_FALSE(r->eof_reached());
+		CHECK(r->get_position() == (uint64_t)data.size());
+		r->get_8();
+		CHECK(r->eof_reached());
+
+		// Random access, including back into blocks that are still cached.
+		const uint64_t positions[] = { 4095, 4096, 70000, 10, 4097, 81960, 0, 4096 * 20 };
+		for (uint64_t pos : positions) {
+			r->seek(pos);
+			CHECK(r->get_position() == pos);
+			uint8_t buf[64];
+			uint64_t expected = MIN((uint64_t)64, (uint64_t)data.size() - pos);
+			CHECK(r->get_buffer(buf, 64) == expected);
+			CHECK(memcmp(buf, data.ptr() + pos, expected) == 0);
+		}
+
+		r->seek_end();
+		CHECK(r->get_position() == (uint64_t)data.size());
+	}
+}
+
+static Vector<uint8_t> _make_resource_text(int p_index) {
+	String text = "[gd_resource type=\"Resource\" load_steps=2 format=3]\n\n";
+	text += "[ext_resource type=\"Script\" path=\"res://item.gd\" id=\"1\"]\n\n[resource]\n";
+	text += "script = ExtResource(\"1\")\nname = \"Item " + itos(p_index) + "\"\n";
+	text += "price = " + itos(p_index * 37 % 1000) + "\nweight = " + rtos(p_index * 0.25) + "\n";
+	text += "tags = PackedStringArray(\"" + (p_index % 2 ? String("weapon") : String("armor")) + "\", \"tier_" + itos(p_index % 5) + "\")\n";
+	CharString cs = text.utf8();
+	Vector<uint8_t> data;
+	data.resize(cs.length());
+	memcpy(data.ptrw(), cs.get_data(), cs.length());
+	return data;
+}
+
+TEST_CASE("[FileAccess] Compressed with zstd dictionary") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("compressed_dict.bin");
+
+	Vector<Vector<uint8_t>> samples;
+	for (int i = 0; i < 200; i++) {
+		samples.push_back(_make_resource_text(i));
+	}
+	Vector<uint8_t> dict_data = Compression::zstd_dictionary_build(samples, 4096);
+	REQUIRE(dict_data.size() > 0);
+	CHECK(dict_data.size() <= 4096);
+	Compression::ZstdDictionary *dict = Compression::zstd_dictionary_create(dict_data);
+	REQUIRE(dict != nullptr);
+	CHECK(Compression::zstd_dictionary_get_id(dict) != 0);
+
+	const Vector<uint8_t> data = _make_resource_text(1000);
+	CHECK_MESSAGE(
+			FileAccessCompressed::compress_buffer(data.ptr(), data.size(), "GCPF", Compression::MODE_ZSTD, 4096, dict).size() <
+					FileAccessCompressed::compress_buffer(data.ptr(), data.size(), "GCPF", Compression::MODE_ZSTD, 4096).size(),
+			"A small file similar to the samples should compress better with the dictionary.");
+
+	Ref<FileAccessCompressed> w;
+	w.instantiate();
+	w->configure("GCPF", Compression::MODE_ZSTD, 4096);
+	w->set_zstd_dictionary(dict);
+	REQUIRE(w->_open(path, FileAccess::WRITE) == OK);
+	w->store_buffer(data.ptr(), data.size());
+	w.unref();
+
+	Ref<FileAccessCompressed> r;
+	r.instantiate();
+	r->configure("GCPF", Compression::MODE_ZSTD, 4096);
+	r->set_zstd_dictionary(dict);
+	REQUIRE(r->_open(path, FileAccess::READ) == OK);
+	Vector<uint8_t> result;
+	result.resize(data.size());
+	CHECK(r->get_buffer(result.ptrw(), data.size()) == (uint64_t)data.size());
+	CHECK(result == data);
+	r.unref();
+
+	// The stream records which dictionary it needs.
+	r.instantiate();
+	r->configure("GCPF", Compression::MODE_ZSTD, 4096);
+	ERR_PRINT_OFF;
+	CHECK(r->_open(path, FileAccess::READ) != OK);
+	ERR_PRINT_ON;
+	r.unref();
+
+	Compression::zstd_dictionary_free(dict);
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
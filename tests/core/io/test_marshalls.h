@@ -324,6 +324,82 @@ TEST_CASE("[Marshalls] FLOAT double precision Variant decoding") {
 	CHECK(r_len == 12);
 	CHECK(variant == Variant(0.33333333333333333));
 }
+
+TEST_CASE("[Marshalls] PACKED_INT32_ARRAY Variant encoding") {
+	int r_len;
+	PackedInt32Array array;
+	array.push_back(0x12345678);
+	array.push_back(-2);
+	uint8_t buffer[16];
+
+	CHECK(encode_variant(array, buffer, r_len) == OK);
+	CHECK_MESSAGE(r_len == 16, "Length == 4 bytes for header + 4 bytes for count + 2 * 4 bytes for elements");
+	CHECK(buffer[0] == 0x1b); // Variant::PACKED_INT32_ARRAY
+	CHECK(buffer[4] == 0x02); // Count
+	// Elements are stored in little-endian.
+	CHECK(buffer[8] == 0x78);
+	CHECK(buffer[9] == 0x56);
+	CHECK(buffer[10] == 0x34);
+	CHECK(buffer[11] == 0x12);
+	CHECK(buffer[12] == 0xfe);
+	CHECK(buffer[15] == 0xff);
+}
+
+TEST_CASE("[Marshalls] PACKED_COLOR_ARRAY Variant decoding") {
+	Variant variant;
+	int r_len;
+	uint8_t buffer[] = {
+		0x22, 0x00, 0x00, 0x00, // Variant::PACKED_COLOR_ARRAY
+		0x01, 0x00, 0x00, 0x00, // count
+		0x00, 0x00, 0x20, 0x3e, // r
+		0x00, 0x00, 0x80, 0x3f, // g
+		0x00, 0x00, 0x00, 0x00, // b
+		0x00, 0x00, 0x00, 0x3f // a
+	};
+
+	CHECK(decode_variant(variant, buffer, 24, &r_len) == OK);
+	CHECK(r_len == 24);
+	CHECK(variant == Variant(PackedColorArray({ Color(0.15625, 1.0, 0.0, 0.5) })));
+}
+
+TEST_CASE("[Marshalls] Packed array Variant round trip") {
+	PackedByteArray bytes;
+	PackedInt32Array ints32;
+	PackedInt64Array ints64;
+	PackedFloat32Array floats32;
+	PackedFloat64Array floats64;
+	PackedVector2Array vectors2;
+	PackedVector3Array vectors3;
+	PackedColorArray colors;
+	for (int i = 0; i < 1001; i++) {
+		bytes.push_back(i * 7);
+		ints32.push_back(i * 123457 - 1000000);
+		ints64.push_back(int64_t(i) * 1234567890123 - 5);
+		floats32.push_back(i * 0.25f);
+		floats64.push_back(i / 3.0);
+		vectors2.push_back(Vector2(i, -i * 0.5));
+		vectors3.push_back(Vector3(i, i * 0.125, -i));
+		colors.push_back(Color(i / 1000.0, 0.5, 1.0, 0.25));
+	}
+
+	const Variant arrays[] = { bytes, ints32, ints64, floats32, floats64, vectors2, vectors3, colors };
+	for (const Variant &array : arrays) {
+		int len;
+		REQUIRE(encode_variant(array, nullptr, len) == OK);
+		Vector<uint8_t> buffer;
+		buffer.resize(len + 1);
+		// Write at an odd offset, elements must not need to be aligned in the buffer.
+		int written;
+		REQUIRE(encode_variant(array, buffer.ptrw() + 1, written) == OK);
+		CHECK(written == len);
+
+		Variant decoded;
+		int read;
+		REQUIRE(decode_variant(decoded, buffer.ptr() + 1, len, &read) == OK);
+		CHECK(read == len);
+		CHECK_MESSAGE(decoded == array, Variant::get_type_name(array.get_type()));
+	}
+}
 } // namespace TestMarshalls
 
 #endif // TEST_MARSHALLS_H
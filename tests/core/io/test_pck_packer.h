@@ -31,8 +31,10 @@
 #ifndef TEST_PCK_PACKER_H
 #define TEST_PCK_PACKER_H
 
+#include "core/io/dir_access.h"
 #include "core/io/file_access_pack.h"
 #include "core/io/pck_packer.h"
+#include "core/math/random_pcg.h"
 #include "core/os/os.h"
 
 #include "tests/test_utils.h"
@@ -117,6 +119,127 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 35000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Pack and read compressed files") {
+	const String cache_dir = OS::get_singleton()->get_cache_path();
+	const String text_path = cache_dir.plus_file("compressible.txt");
+	const String noise_path = cache_dir.plus_file("incompressible.bin");
+
+	Vector<uint8_t> text;
+	Vector<uint8_t> noise;
+	{
+		Ref<FileAccess> f = FileAccess::open(text_path, FileAccess::WRITE);
+		for (int i = 0; i < 20000; i++) {
+			f->store_string(itos(i % 100) + " lorem ipsum\n");
+		}
+		f = FileAccess::open(noise_path, FileAccess::WRITE);
+		RandomPCG rng(42);
+		for (int i = 0; i < 50000; i++) {
+			f->store_32(rng.rand());
+		}
+	}
+	text = FileAccess::get_file_as_array(text_path);
+	noise = FileAccess::get_file_as_array(noise_path);
+
+	PCKPacker pck_packer;
+	const String output_pck_path = cache_dir.plus_file("output_compressed.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	pck_packer.set_compression(Compression::MODE_ZSTD, 0.9);
+	CHECK(pck_packer.add_file("res://pck_compressed/text.txt", text_path, false, true) == OK);
+	CHECK(pck_packer.add_file("res://pck_compressed/text_encrypted.txt", text_path, true, true) == OK);
+	CHECK(pck_packer.add_file("res://pck_compressed/noise.bin", noise_path, false, true) == OK);
+	CHECK(pck_packer.add_file("res://pck_compressed/text_raw.txt", text_path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+
+	Ref<FileAccess> pck = FileAccess::open(output_pck_path, FileAccess::READ);
+	REQUIRE(pck.is_valid());
+	CHECK_MESSAGE(
+			pck->get_length() < (uint64_t)(noise.size() + text.size() * 2),
+			"Compressible files should take less space than stored as is.");
+	pck.unref();
+
+	REQUIRE(PackedData::get_singleton() != nullptr);
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+
+	const char *text_files[] = { "res://pck_compressed/text.txt", "res://pck_compressed/text_encrypted.txt", "res://pck_compressed/text_raw.txt" };
+	for (const char *path : text_files) {
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+		REQUIRE(f.is_valid());
+		CHECK(f->get_length() == (uint64_t)text.size());
+		Vector<uint8_t> data;
+		data.resize(text.size());
+		CHECK(f->get_buffer(data.ptrw(), data.size()) == (uint64_t)data.size());
+		CHECK(data == text);
+
+		f->seek(text.size() - 10);
+		CHECK(f->get_8() == text[text.size() - 10]);
+		f->seek(100000);
+		uint8_t buf[16];
+		CHECK(f->get_buffer(buf, 16) == 16);
+		CHECK(memcmp(buf, text.ptr() + 100000, 16) == 0);
+	}
+
+	Ref<FileAccess> f = FileAccess::open("res://pck_compressed/noise.bin", FileAccess::READ);
+	REQUIRE(f.is_valid());
+	Ref<FileAccess> mapped_pck = FileAccess::open_mapped(output_pck_path);
+	REQUIRE(mapped_pck.is_valid());
+	if (mapped_pck->get_mapped_span(0, 1)) {
+		CHECK_MESSAGE(
+				f->get_mapped_span(0, noise.size()) != nullptr,
+				"Incompressible files should be stored as is, and be read straight from the mapping.");
+	}
+	mapped_pck.unref();
+	Vector<uint8_t> data;
+	data.resize(noise.size());
+	CHECK(f->get_buffer(data.ptrw(), data.size()) == (uint64_t)data.size());
+	CHECK(data == noise);
+	f.unref();
+
+	PackedData::get_singleton()->remove_pack(output_pck_path);
+	CHECK_FALSE(PackedData::get_singleton()->has_path("res://pck_compressed/text.txt"));
+	CHECK_FALSE(PackedData::get_singleton()->has_directory("res://pck_compressed"));
+}
+
+TEST_CASE("[PCKPacker] Pack compressed files with a zstd dictionary") {
+	const String cache_dir = OS::get_singleton()->get_cache_path().plus_file("pck_dictionary");
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	REQUIRE(da->make_dir_recursive(cache_dir) == OK);
+
+	// Many small files of the same kind, which compress poorly on their own.
+	const int file_count = 100;
+	Vector<String> contents;
+	for (int i = 0; i < file_count; i++) {
+		String text = "[gd_resource type=\"Resource\" format=3]\n\n[resource]\n";
+		text += "name = \"Item " + itos(i) + "\"\nprice = " + itos(i * 37 % 1000) + "\n";
+		text += "icon = \"res://icons/item_" + itos(i % 7) + ".png\"\n";
+		contents.push_back(text);
+		Ref<FileAccess> f = FileAccess::open(cache_dir.plus_file(itos(i) + ".tres"), FileAccess::WRITE);
+		f->store_string(text);
+	}
+
+	uint64_t pck_size[2] = {};
+	for (int use_dictionary = 0; use_dictionary < 2; use_dictionary++) {
+		const String output_pck_path = cache_dir.plus_file("output_" + itos(use_dictionary) + ".pck");
+		PCKPacker pck_packer;
+		REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+		pck_packer.set_compression(Compression::MODE_ZSTD, 1.0, use_dictionary);
+		for (int i = 0; i < file_count; i++) {
+			CHECK(pck_packer.add_file("res://pck_dictionary/" + itos(i) + ".tres", cache_dir.plus_file(itos(i) + ".tres"), false, true) == OK);
+		}
+		REQUIRE(pck_packer.flush() == OK);
+		pck_size[use_dictionary] = FileAccess::open(output_pck_path, FileAccess::READ)->get_length();
+
+		REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+		CHECK_FALSE(PackedData::get_singleton()->has_path(PACK_ZSTD_DICTIONARY_PATH));
+		for (int i = 0; i < file_count; i++) {
+			CHECK(FileAccess::get_file_as_string("res://pck_dictionary/" + itos(i) + ".tres") == contents[i]);
+		}
+		PackedData::get_singleton()->remove_pack(output_pck_path);
+	}
+	CHECK_MESSAGE(
+			pck_size[1] < pck_size[0],
+			"Small similar files should take less space with a dictionary, even counting the dictionary.");
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
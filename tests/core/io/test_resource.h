@@ -31,10 +31,14 @@
 #ifndef TEST_RESOURCE
 #define TEST_RESOURCE
 
+#include "core/io/file_access_memory.h"
 #include "core/io/resource.h"
+#include "core/io/resource_format_binary.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/templates/thread_work_pool.h"
 
 #include "thirdparty/doctest/doctest.h"
 
@@ -109,6 +113,196 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+static SafeNumeric<uint32_t> load_timing_calls;
+static Semaphore *load_timing_semaphore = nullptr;
+
+static void _count_load_timing(const String &p_path, uint64_t p_queued_usec, uint64_t p_load_usec) {
+	// Called after the load is complete, without any ResourceLoader lock held.
+	CHECK(ResourceLoader::load_threaded_get_status(p_path) != ResourceLoader::THREAD_LOAD_IN_PROGRESS);
+	load_timing_calls.increment();
+	load_timing_semaphore->post();
+}
+
+TEST_CASE("[Resource] Threaded loading with external dependencies") {
+	const String cache_path = OS::get_singleton()->get_cache_path();
+	const String parent_path = cache_path.plus_file("threaded_parent.res");
+	Vector<String> child_paths;
+	{
+		Ref<Resource> parent = memnew(Resource);
+		parent->set_name("Parent");
+		for (int i = 0; i < 8; i++) {
+			Ref<Resource> child = memnew(Resource);
+			child->set_name(vformat("Child %d", i));
+			child->set_meta("data", i);
+			const String child_path = cache_path.plus_file(vformat("threaded_child_%d.res", i));
+			REQUIRE(ResourceSaver::save(child_path, child) == OK);
+			// Children with a path are saved as external resources of the parent.
+			child->set_path(child_path);
+			parent->set_meta(vformat("child_%d", i), child);
+			child_paths.push_back(child_path);
+		}
+		REQUIRE(ResourceSaver::save(parent_path, parent) == OK);
+	}
+
+	Semaphore semaphore;
+	load_timing_calls.set(0);
+	load_timing_semaphore = &semaphore;
+	ResourceLoader::set_load_timing_callback(_count_load_timing);
+
+	REQUIRE(ResourceLoader::load_threaded_request(parent_path, "", true) == OK);
+	// A second request for the same path joins the first one.
+	REQUIRE(ResourceLoader::load_threaded_request(parent_path, "", true) == OK);
+
+	Error err = FAILED;
+	Ref<Resource> loaded = ResourceLoader::load_threaded_get(parent_path, &err);
+	CHECK(err == OK);
+	REQUIRE(loaded.is_valid());
+	CHECK(loaded->get_name() == "Parent");
+	for (int i = 0; i < child_paths.size(); i++) {
+		Ref<Resource> child = loaded->get_meta(vformat("child_%d", i));
+		REQUIRE(child.is_valid());
+		CHECK(child->get_name() == vformat("Child %d", i));
+		CHECK(int(child->get_meta("data")) == i);
+	}
+	CHECK(ResourceLoader::load_threaded_get_status(parent_path) == ResourceLoader::THREAD_LOAD_LOADED);
+
+	CHECK(ResourceLoader::load_threaded_get(parent_path) == loaded);
+	CHECK(ResourceLoader::load_threaded_get_status(parent_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+
+	// One timing report for the parent and one per child. Reports are made once the
+	// result is available, so the last ones may still be on their way.
+	for (int i = 0; i < child_paths.size() + 1; i++) {
+		semaphore.wait();
+	}
+	CHECK(load_timing_calls.get() == (uint32_t)child_paths.size() + 1);
+	ResourceLoader::set_load_timing_callback(nullptr);
+	load_timing_semaphore = nullptr;
+}
+
+static void _check_decoded_children(const Ref<Resource> &p_loaded) {
+	REQUIRE(p_loaded.is_valid());
+	CHECK(p_loaded->get_name() == "Parent");
+
+	Array loaded_children = p_loaded->get_meta("children");
+	REQUIRE(loaded_children.size() == 16);
+	for (int i = 0; i < loaded_children.size(); i++) {
+		Ref<Resource> child = loaded_children[i];
+		REQUIRE(child.is_valid());
+		CHECK(child->get_name() == vformat("Child %d", i));
+		PackedVector3Array points = child->get_meta("points");
+		REQUIRE(points.size() == 4096);
+		CHECK(points[4095] == Vector3(i, 4095, i + 4095));
+		if (i > 0) {
+			CHECK(Ref<Resource>(child->get_meta("previous")) == loaded_children[i - 1]);
+		}
+	}
+}
+
+TEST_CASE("[Resource] Parallel sub-resource decoding") {
+	// Enough data for the binary loader to decode sub-resources on several threads.
+	Ref<Resource> parent = memnew(Resource);
+	parent->set_name("Parent");
+	Array children;
+	for (int i = 0; i < 16; i++) {
+		Ref<Resource> child = memnew(Resource);
+		child->set_name(vformat("Child %d", i));
+		PackedVector3Array points;
+		points.resize(4096);
+		for (int j = 0; j < points.size(); j++) {
+			points.write[j] = Vector3(i, j, i + j);
+		}
+		child->set_meta("points", points);
+		if (i > 0) {
+			// Sub-resources referencing each other must keep their identity.
+			child->set_meta("previous", children[i - 1]);
+		}
+		children.push_back(child);
+	}
+	parent->set_meta("children", children);
+
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("parallel_decode.res");
+	REQUIRE(ResourceSaver::save(save_path, parent) == OK);
+
+	// The file isn't mapped here, so these decode serially.
+	for (int use_sub_threads = 0; use_sub_threads < 2; use_sub_threads++) {
+		REQUIRE(ResourceLoader::load_threaded_request(save_path, "", use_sub_threads, ResourceFormatLoader::CACHE_MODE_IGNORE) == OK);
+		_check_decoded_children(ResourceLoader::load_threaded_get(save_path));
+	}
+
+	// Contents already in memory, as in a mapped pack, are decoded on the sub-threads.
+	Vector<uint8_t> data = FileAccess::get_file_as_array(save_path);
+	REQUIRE(data.size() > 0);
+	Ref<FileAccessMemory> fa;
+	fa.instantiate();
+	REQUIRE(fa->open_custom(data.ptr(), data.size()) == OK);
+
+	ThreadWorkPool decode_pool;
+	Mutex decode_pool_mutex;
+	ResourceLoaderBinary loader;
+	loader.set_local_path(save_path);
+	loader.set_sub_threads(&decode_pool, &decode_pool_mutex);
+	loader.open(fa);
+	REQUIRE(loader.load() == OK);
+	CHECK(loader.was_decoded_in_parallel());
+	_check_decoded_children(loader.get_resource());
+}
+
+class ResourceCacheWorker {
+public:
+	static const int RESOURCES_PER_THREAD = 512;
+	SafeNumeric<uint32_t> failures;
+
+	void work(uint32_t p_index, void *p_userdata) {
+		Vector<Ref<Resource>> resources;
+		for (int i = 0; i < RESOURCES_PER_THREAD; i++) {
+			Ref<Resource> res = memnew(Resource);
+			res->set_path(vformat("res://cache_test/%d/%d.tres", p_index, i));
+			resources.push_back(res);
+		}
+		for (int i = 0; i < RESOURCES_PER_THREAD; i++) {
+			const String path = vformat("res://cache_test/%d/%d.tres", p_index, i);
+			if (!ResourceCache::has(path) || ResourceCache::get_ref(path) != resources[i]) {
+				failures.increment();
+			}
+		}
+		// Every resource unregisters itself when freed.
+		resources.clear();
+		for (int i = 0; i < RESOURCES_PER_THREAD; i++) {
+			if (ResourceCache::has(vformat("res://cache_test/%d/%d.tres", p_index, i))) {
+				failures.increment();
+			}
+		}
+	}
+};
+
+TEST_CASE("[Resource] Cache under concurrent access") {
+	const int cached_count = ResourceCache::get_cached_resource_count();
+
+	ResourceCacheWorker worker;
+	ThreadWorkPool pool;
+	pool.init(8);
+	pool.do_work(8, &worker, &ResourceCacheWorker::work, nullptr);
+	pool.finish();
+
+	CHECK(worker.failures.get() == 0);
+	CHECK(ResourceCache::get_cached_resource_count() == cached_count);
+
+	// Taking over a path unregisters the previous owner, which must not remove the new entry when freed.
+	Ref<Resource> first = memnew(Resource);
+	first->set_path("res://cache_test/take_over.tres");
+	Ref<Resource> second = memnew(Resource);
+	ERR_PRINT_OFF;
+	second->set_path("res://cache_test/take_over.tres");
+	ERR_PRINT_ON;
+	CHECK(second->get_path().is_empty());
+	second->set_path("res://cache_test/take_over.tres", true);
+	CHECK(first->get_path().is_empty());
+	first.unref();
+	CHECK(ResourceCache::get_ref("res://cache_test/take_over.tres") == second);
+	second.unref();
+	CHECK_FALSE(ResourceCache::has("res://cache_test/take_over.tres"));
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE
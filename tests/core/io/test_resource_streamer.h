@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  test_resource_streamer.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RESOURCE_STREAMER_H
+#define TEST_RESOURCE_STREAMER_H
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/io/resource_streamer.h"
+#include "core/os/os.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestResourceStreamer {
+
+static String _save_resource(const String &p_name, int p_size) {
+	const String path = OS::get_singleton()->get_cache_path().plus_file(p_name + ".res");
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name(String("x").repeat(p_size));
+	ResourceSaver::save(path, resource);
+	return path;
+}
+
+static uint64_t _file_size(const String &p_path) {
+	return FileAccess::open(p_path, FileAccess::READ)->get_length();
+}
+
+// Polls until none of the paths is loading anymore. Entries waiting for room stay pending.
+static void _poll_until_idle(ResourceStreamer *p_streamer, const Vector<String> &p_paths) {
+	bool loading = true;
+	while (loading) {
+		p_streamer->poll();
+		loading = false;
+		for (const String &path : p_paths) {
+			if (ResourceLoader::load_threaded_get_status(path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE) {
+				continue; // Not requested, or already collected by the streamer.
+			}
+			// Joins the streamer's request, so this only waits for its load to finish.
+			ResourceLoader::load_threaded_request(path);
+			ResourceLoader::load_threaded_get(path);
+			loading = true;
+		}
+	}
+}
+
+TEST_CASE("[ResourceStreamer] Loading and releasing") {
+	ResourceStreamer *streamer = ResourceStreamer::get_singleton();
+	REQUIRE(streamer != nullptr);
+	streamer->clear();
+
+	const String a = _save_resource("streamed_a", 1000);
+	const String b = _save_resource("streamed_b", 2000);
+
+	streamer->request(a, 1);
+	streamer->request(b, 2);
+	CHECK(streamer->get_pending_count() == 2);
+	CHECK_FALSE(streamer->is_resident(a));
+
+	_poll_until_idle(streamer, { a, b });
+
+	CHECK(streamer->get_pending_count() == 0);
+	CHECK(streamer->get_resident_count() == 2);
+	CHECK(streamer->get_resident_bytes() == _file_size(a) + _file_size(b));
+	REQUIRE(streamer->is_resident(b));
+	CHECK(streamer->get_resource(b)->get_name().length() == 2000);
+
+	streamer->release(a);
+	CHECK_FALSE(streamer->is_resident(a));
+	CHECK(streamer->get_resource(a).is_null());
+	CHECK(streamer->get_resident_bytes() == _file_size(b));
+
+	streamer->clear();
+	CHECK(streamer->get_resident_count() == 0);
+	CHECK(streamer->get_resident_bytes() == 0);
+}
+
+TEST_CASE("[ResourceStreamer] Memory budget") {
+	ResourceStreamer *streamer = ResourceStreamer::get_singleton();
+	streamer->clear();
+
+	const String a = _save_resource("streamed_a", 4000);
+	const String b = _save_resource("streamed_b", 4000);
+	const String c = _save_resource("streamed_c", 4000);
+	const uint64_t size = _file_size(a);
+
+	// Room for two of them.
+	streamer->set_memory_budget(size * 2 + size / 2);
+	const uint64_t evicted = streamer->get_evicted_count();
+
+	streamer->request(a, 0);
+	streamer->request(b, 0);
+	_poll_until_idle(streamer, { a, b });
+	CHECK(streamer->get_resident_count() == 2);
+
+	// Held elsewhere, so it can't be evicted; b is then the least recently used one.
+	Ref<Resource> held = streamer->get_resource(a);
+	REQUIRE(held.is_valid());
+
+	streamer->request(c, 1);
+	_poll_until_idle(streamer, { a, b, c });
+
+	CHECK(streamer->get_evicted_count() == evicted + 1);
+	CHECK(streamer->is_resident(a));
+	CHECK_FALSE(streamer->is_resident(b));
+	CHECK(streamer->is_resident(c));
+	CHECK(streamer->get_resident_bytes() <= streamer->get_memory_budget());
+
+	// A lower priority request doesn't evict anything and waits for room.
+	streamer->request(b, -1);
+	streamer->poll();
+	CHECK_FALSE(streamer->is_resident(b));
+	CHECK(streamer->get_pending_count() == 1);
+
+	streamer->release(c);
+	_poll_until_idle(streamer, { b });
+	CHECK(streamer->is_resident(b));
+
+	streamer->set_memory_budget(0);
+	streamer->clear();
+}
+
+TEST_CASE("[ResourceStreamer] Failed loads are retried when requested again") {
+	ResourceStreamer *streamer = ResourceStreamer::get_singleton();
+	streamer->clear();
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("streamed_later.res");
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(path);
+
+	ERR_PRINT_OFF;
+	streamer->request(path);
+	_poll_until_idle(streamer, { path });
+	ERR_PRINT_ON;
+	CHECK_FALSE(streamer->is_resident(path));
+	CHECK(streamer->get_pending_count() == 0);
+
+	_save_resource("streamed_later", 100);
+	streamer->request(path);
+	CHECK(streamer->get_pending_count() == 1);
+	_poll_until_idle(streamer, { path });
+	CHECK(streamer->is_resident(path));
+
+	streamer->clear();
+}
+} // namespace TestResourceStreamer
+
+#endif // TEST_RESOURCE_STREAMER_H
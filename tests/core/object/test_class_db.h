@@ -33,12 +33,21 @@
 
 #include "core/core_bind.h"
 #include "core/core_constants.h"
+#include "core/io/resource.h"
 #include "core/object/class_db.h"
 
 #include "tests/test_macros.h"
 
 namespace TestClassDB {
 
+class _TestLookupTableBase : public Object {
+	GDCLASS(_TestLookupTableBase, Object);
+};
+
+class _TestLookupTableDerived : public _TestLookupTableBase {
+	GDCLASS(_TestLookupTableDerived, _TestLookupTableBase);
+};
+
 struct TypeReference {
 	StringName name;
 	bool is_enum = false;
@@ -852,6 +861,115 @@ TEST_SUITE("[ClassDB]") {
 			}
 		}
 	}
+
+	TEST_CASE("[ClassDB] Method lookup tables match the inheritance chain") {
+		const bool lookup_tables_enabled = ClassDB::are_lookup_tables_enabled();
+		ClassDB::enable_lookup_tables();
+
+		List<StringName> class_list;
+		ClassDB::get_class_list(&class_list);
+
+		int mismatches = 0;
+		for (const StringName &class_name : class_list) {
+			List<MethodInfo> methods;
+			ClassDB::get_method_list(class_name, &methods);
+
+			for (const MethodInfo &method : methods) {
+				MethodBind *expected = nullptr;
+				for (ClassDB::ClassInfo *check = ClassDB::classes.getptr(class_name); check && !expected; check = check->inherits_ptr) {
+					MethodBind **bind = check->method_map.getptr(method.name);
+					if (bind) {
+						expected = *bind;
+					}
+				}
+				if (ClassDB::get_method(class_name, method.name) != expected) {
+					mismatches++;
+				}
+			}
+		}
+
+		CHECK(mismatches == 0);
+		CHECK(ClassDB::get_method("Object", "does_not_exist") == nullptr);
+
+		if (!lookup_tables_enabled) {
+			ClassDB::disable_lookup_tables();
+		}
+	}
+
+	TEST_CASE("[ClassDB] Property access through lookup tables") {
+		const bool lookup_tables_enabled = ClassDB::are_lookup_tables_enabled();
+		ClassDB::enable_lookup_tables();
+
+		Ref<Resource> resource;
+		resource.instantiate();
+
+		bool valid = false;
+		CHECK(ClassDB::set_property(resource.ptr(), "resource_name", "test", &valid));
+		CHECK(valid);
+
+		Variant value;
+		CHECK(ClassDB::get_property(resource.ptr(), "resource_name", value));
+		CHECK(String(value) == "test");
+
+		// Constants, methods and signals (from any ancestor) are readable as properties too.
+		CHECK(ClassDB::get_property(resource.ptr(), "NOTIFICATION_PREDELETE", value));
+		CHECK(int(value) == Object::NOTIFICATION_PREDELETE);
+		CHECK(ClassDB::get_property(resource.ptr(), "duplicate", value));
+		CHECK(value.get_type() == Variant::CALLABLE);
+		CHECK(ClassDB::get_property(resource.ptr(), "changed", value));
+		CHECK(value.get_type() == Variant::SIGNAL);
+
+		CHECK_FALSE(ClassDB::get_property(resource.ptr(), "does_not_exist", value));
+		CHECK_FALSE(ClassDB::set_property(resource.ptr(), "does_not_exist", 1));
+
+		if (!lookup_tables_enabled) {
+			ClassDB::disable_lookup_tables();
+		}
+	}
+
+	TEST_CASE("[ClassDB] Lookup tables follow changes to classes") {
+		GDREGISTER_CLASS(_TestLookupTableBase);
+		GDREGISTER_CLASS(_TestLookupTableDerived);
+		const bool lookup_tables_enabled = ClassDB::are_lookup_tables_enabled();
+		ClassDB::enable_lookup_tables();
+
+		_TestLookupTableDerived object;
+		Variant value;
+		CHECK_FALSE(ClassDB::get_property(&object, "ADDED_LATER", value));
+
+		// Seen by the classes inheriting the changed one as well.
+		ClassDB::bind_integer_constant(_TestLookupTableBase::get_class_static(), StringName(), "ADDED_LATER", 42);
+		CHECK_MESSAGE(ClassDB::are_lookup_tables_enabled(), "Changing a class shouldn't drop the lookup tables.");
+		CHECK(ClassDB::get_property(&object, "ADDED_LATER", value));
+		CHECK(int(value) == 42);
+
+		if (!lookup_tables_enabled) {
+			ClassDB::disable_lookup_tables();
+		}
+	}
+
+	TEST_CASE("[ClassDB] Replaced lookup tables are freed") {
+		const bool lookup_tables_enabled = ClassDB::are_lookup_tables_enabled();
+		Object object;
+		Variant value;
+
+		// Warm up, so that only the tables themselves are allocated below.
+		ClassDB::enable_lookup_tables();
+		ClassDB::get_property(&object, "script", value);
+		ClassDB::disable_lookup_tables();
+
+		const uint64_t mem_usage = Memory::get_mem_usage();
+		for (int i = 0; i < 10; i++) {
+			ClassDB::enable_lookup_tables();
+			ClassDB::get_property(&object, "script", value);
+			ClassDB::disable_lookup_tables();
+		}
+		CHECK_MESSAGE(Memory::get_mem_usage() == mem_usage, "Tables that were replaced and aren't read anymore should be freed.");
+
+		if (lookup_tables_enabled) {
+			ClassDB::enable_lookup_tables();
+		}
+	}
 }
 } // namespace TestClassDB
 
@@ -275,6 +275,28 @@ TEST_CASE("[Object] Absent name getter") {
 			actual_value == Variant(),
 			"The returned value should equal nil variant.");
 }
+
+TEST_CASE("[Object] User signals are listed in the order they were added") {
+	Object object;
+	const int signal_count = 20;
+	for (int i = 0; i < signal_count; i++) {
+		object.add_user_signal(MethodInfo(vformat("signal_%d", i)));
+	}
+
+	List<MethodInfo> signals;
+	object.get_signal_list(&signals);
+	Vector<String> user_signals;
+	for (const MethodInfo &mi : signals) {
+		if (mi.name.begins_with("signal_")) {
+			user_signals.push_back(mi.name);
+		}
+	}
+
+	REQUIRE(user_signals.size() == signal_count);
+	for (int i = 0; i < signal_count; i++) {
+		CHECK(user_signals[i] == vformat("signal_%d", i));
+	}
+}
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
@@ -0,0 +1,209 @@
+/*************************************************************************/
+/*  test_flat_hash_map.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/string/string_name.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/flat_hash_set.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Insert element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+	CHECK_FALSE(map.find(43));
+}
+
+TEST_CASE("[FlatHashMap] Overwrite element") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[FlatHashMap] Erase via element and key") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.insert(43, 86);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.erase(43));
+	CHECK_FALSE(map.erase(43));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[FlatHashMap] Empty map") {
+	FlatHashMap<int, int> map;
+	CHECK(map.is_empty());
+	CHECK_FALSE(map.has(0));
+	CHECK(map.getptr(0) == nullptr);
+	CHECK(map.begin() == map.end());
+	map.clear();
+
+	const FlatHashMap<int, int> copy = map;
+	CHECK(copy.begin() == copy.end());
+}
+
+TEST_CASE("[FlatHashMap] Insert, iterate and erase many elements") {
+	const int elem_max = 12343;
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < elem_max; i++) {
+		map.insert(i, i * 3);
+	}
+	CHECK(map.size() == elem_max);
+
+	// Iteration order is unspecified, but every element must be visited once.
+	Vector<int> seen;
+	seen.resize(elem_max);
+	seen.fill(0);
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(E.value == E.key * 3);
+		seen.write[E.key]++;
+	}
+	for (int i = 0; i < elem_max; i++) {
+		CHECK(seen[i] == 1);
+	}
+
+	for (int i = 0; i < elem_max; i++) {
+		if ((i % 5) != 0) {
+			map.erase(i);
+		}
+	}
+	CHECK(map.size() == (elem_max + 4) / 5);
+	for (int i = 0; i < elem_max; i++) {
+		CHECK(map.has(i) == ((i % 5) == 0));
+	}
+
+	int count = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK((E.key % 5) == 0);
+		count++;
+	}
+	CHECK(count == (elem_max + 4) / 5);
+}
+
+TEST_CASE("[FlatHashMap] Reuse deleted slots without growing") {
+	FlatHashMap<int, int> map;
+	map.insert(-1, -1);
+	const uint32_t capacity = map.get_capacity();
+
+	// Keep the element count low while churning through many keys, which
+	// fills the table with deleted slots that must be purged in place.
+	for (int i = 0; i < 10000; i++) {
+		map.insert(i, i);
+		map.erase(i);
+	}
+	CHECK(map.size() == 1);
+	CHECK(map.get_capacity() == capacity);
+	CHECK(map[-1] == -1);
+}
+
+TEST_CASE("[FlatHashMap] Reserve and copy") {
+	FlatHashMap<StringName, int> map;
+	map.reserve(100);
+	const uint32_t capacity = map.get_capacity();
+	CHECK(capacity >= 100);
+	for (int i = 0; i < 100; i++) {
+		map[StringName(itos(i))] = i;
+	}
+	CHECK(map.get_capacity() == capacity);
+
+	FlatHashMap<StringName, int> copy = map;
+	map[StringName("0")] = -1;
+	CHECK(copy.size() == 100);
+	CHECK(copy[StringName("0")] == 0);
+	CHECK(copy[StringName("99")] == 99);
+
+	copy = map;
+	CHECK(copy[StringName("0")] == -1);
+}
+
+TEST_CASE("[FlatHashMap] Insert a value referring to an element while growing") {
+	FlatHashMap<int, String> map;
+	map.insert(0, "value 0");
+	for (int i = 1; i < 1000; i++) {
+		const uint32_t capacity = map.get_capacity();
+		// The value is read from the slots the insertion may reallocate.
+		map.insert(i, map[i - 1]);
+		if (map.get_capacity() != capacity) {
+			CHECK(map[i] == "value 0");
+		}
+	}
+	CHECK(map.size() == 1000);
+	CHECK(map[999] == "value 0");
+}
+
+TEST_CASE("[FlatHashSet] Insert, find and erase") {
+	FlatHashSet<int> set;
+	FlatHashSet<int>::Iterator e = set.insert(42);
+	set.insert(42);
+
+	CHECK(e);
+	CHECK(*e == 42);
+	CHECK(set.size() == 1);
+	CHECK(set.has(42));
+	CHECK(set.find(42));
+
+	for (int i = 0; i < 1000; i++) {
+		set.insert(i * 7);
+	}
+	for (int i = 0; i < 1000; i += 2) {
+		set.erase(i * 7);
+	}
+	int count = 0;
+	for (const int &K : set) {
+		CHECK((K / 7) % 2 == 1);
+		count++;
+	}
+	CHECK(count == 500);
+	CHECK_FALSE(set.has(42));
+
+	const FlatHashSet<int> copy = set;
+	CHECK(copy.size() == 500);
+	CHECK(copy.has(7));
+}
+
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
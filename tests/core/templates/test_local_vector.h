@@ -235,6 +235,70 @@ TEST_CASE("[LocalVector] Size / Resize / Reserve.") {
 	CHECK(vector.size() == 4);
 	CHECK(vector.get_capacity() >= 4);
 }
+
+TEST_CASE("[LocalVector] Scratch allocation.") {
+	uint64_t chunk_allocs = 0;
+	{
+		ScratchArena::Scope scope;
+		ScratchLocalVector<int> vector;
+		for (int i = 0; i < 1000; i++) {
+			vector.push_back(i);
+		}
+		CHECK(vector.size() == 1000);
+		CHECK(vector[0] == 0);
+		CHECK(vector[999] == 999);
+		chunk_allocs = ScratchArena::get_chunk_alloc_count();
+	}
+	{
+		ScratchArena::Scope scope;
+		ScratchLocalVector<int> vector;
+		vector.resize(1000);
+		CHECK_MESSAGE(
+				ScratchArena::get_chunk_alloc_count() == chunk_allocs,
+				"Chunks from a previous scope should be reused.");
+	}
+}
+
+TEST_CASE("[LocalVector] Scratch allocation, nested scopes.") {
+	ScratchArena::Scope scope;
+	ScratchLocalVector<int> outer{ 1, 2, 3 };
+	{
+		ScratchArena::Scope inner_scope;
+		ScratchLocalVector<int> inner;
+		inner.resize(ScratchArena::CHUNK_SIZE); // Forces a second chunk.
+		inner[0] = 4;
+		CHECK(inner[0] == 4);
+	}
+	outer.push_back(5);
+	CHECK(outer.size() == 4);
+	CHECK(outer[0] == 1);
+	CHECK(outer[2] == 3);
+	CHECK(outer[3] == 5);
+}
+
+TEST_CASE("[LocalVector] Scratch allocation, growing an outer vector in a nested scope.") {
+	ScratchArena::Scope scope;
+	ScratchLocalVector<int> outer{ 1, 2, 3 };
+	{
+		ScratchArena::Scope inner_scope;
+		// The last allocation belongs to the outer scope, growing it in place would be undone below.
+		for (int i = 0; i < 100; i++) {
+			outer.push_back(4 + i);
+		}
+	}
+	ScratchLocalVector<int> other;
+	other.resize(200);
+	for (int i = 0; i < 200; i++) {
+		other[i] = -1;
+	}
+	CHECK(outer.size() == 103);
+	bool intact = true;
+	for (int i = 0; i < 103; i++) {
+		intact = intact && outer[i] == i + 1;
+	}
+	CHECK_MESSAGE(intact, "The outer vector shouldn't be overwritten by allocations made after the inner scope ended.");
+}
+
 } // namespace TestLocalVector
 
 #endif // TEST_LOCAL_VECTOR_H
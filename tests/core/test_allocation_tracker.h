@@ -0,0 +1,86 @@
+/*************************************************************************/
+/*  test_allocation_tracker.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ALLOCATION_TRACKER_H
+#define TEST_ALLOCATION_TRACKER_H
+
+#ifdef ALLOCATION_TRACKING_ENABLED
+
+#include "core/io/file_access.h"
+#include "core/os/allocation_tracker.h"
+#include "core/os/os.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestAllocationTracker {
+
+TEST_CASE("[AllocationTracker] Allocations are reported per site") {
+	static const char *site = "tests/core/test_allocation_tracker.h:test_site";
+
+	AllocationTracker::clear();
+	for (int i = 0; i < 3; i++) {
+		Memory::set_alloc_site(site);
+		void *mem = Memory::alloc_static(100);
+		Memory::free_static(mem);
+	}
+	AllocationTracker::frame_end();
+
+	bool found = false;
+	Vector<AllocationTracker::SiteStats> frame = AllocationTracker::get_frame_summary();
+	for (const AllocationTracker::SiteStats &s : frame) {
+		if (s.site == site) {
+			found = true;
+			CHECK(s.count == 3);
+			CHECK(s.bytes == 300);
+		}
+	}
+	CHECK_MESSAGE(found, "The allocations should be attributed to their site.");
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("allocations.csv");
+	REQUIRE(AllocationTracker::dump(path) == OK);
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+	REQUIRE(f.is_valid());
+	CHECK(f->get_line() == "site,count,bytes,count_per_frame,bytes_per_frame");
+	bool dumped = false;
+	while (!f->eof_reached()) {
+		if (f->get_line() == vformat("\"%s\",3,300,3.00,300.00", site)) {
+			dumped = true;
+		}
+	}
+	CHECK_MESSAGE(dumped, "The dump should list the site with its totals.");
+
+	AllocationTracker::clear();
+}
+
+} // namespace TestAllocationTracker
+
+#endif // ALLOCATION_TRACKING_ENABLED
+
+#endif // TEST_ALLOCATION_TRACKER_H
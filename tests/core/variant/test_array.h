@@ -516,6 +516,105 @@ TEST_CASE("[Array] Recursive self comparison") {
 	a2.clear();
 }
 
+TEST_CASE("[Array] Growing and shrinking across the inline capacity") {
+	Array arr;
+	for (int i = 0; i < 10; i++) {
+		arr.push_back(i);
+	}
+	CHECK(arr.size() == 10);
+	for (int i = 0; i < 10; i++) {
+		CHECK(int(arr[i]) == i);
+	}
+
+	arr.insert(2, "two");
+	CHECK(arr.size() == 11);
+	CHECK(arr[2] == "two");
+	CHECK(int(arr[3]) == 2);
+
+	while (arr.size() > 2) {
+		arr.remove_at(arr.size() - 1);
+	}
+	CHECK(arr.size() == 2);
+	CHECK(int(arr[0]) == 0);
+	CHECK(int(arr[1]) == 1);
+
+	arr.resize(6);
+	CHECK(arr.size() == 6);
+	CHECK(arr[5].get_type() == Variant::NIL);
+	arr.resize(3);
+	CHECK(arr.size() == 3);
+	CHECK(int(arr[1]) == 1);
+
+	arr.append_array(arr);
+	CHECK(arr.size() == 6);
+	CHECK(int(arr[4]) == 1);
+
+	arr.clear();
+	CHECK(arr.is_empty());
+	arr.push_back(42);
+	CHECK(int(arr[0]) == 42);
+}
+
+TEST_CASE("[Array] Sort and search across the inline capacity") {
+	Array small = build_array(3, 1, 2);
+	small.sort();
+	CHECK(small == build_array(1, 2, 3));
+	CHECK(small.bsearch(2) == 1);
+
+	Array large = build_array(9, 4, 7, 1, 8, 2, 6, 3, 5);
+	large.sort();
+	for (int i = 0; i < large.size(); i++) {
+		CHECK(int(large[i]) == i + 1);
+	}
+	CHECK(large.bsearch(7) == 6);
+	large.reverse();
+	CHECK(int(large[0]) == 9);
+	CHECK(large.find(1) == 8);
+
+	Array copy = large.duplicate();
+	copy.resize(2);
+	CHECK(large.size() == 9);
+	CHECK(copy == build_array(9, 8));
+}
+
+TEST_CASE("[Array] Conversion to and from packed arrays") {
+	Array ints;
+	ints.set_typed(Variant::INT, StringName(), Variant());
+	for (int i = 0; i < 10; i++) {
+		ints.push_back(i * 3);
+	}
+
+	PackedInt64Array packed = Variant(ints);
+	REQUIRE(packed.size() == 10);
+	for (int i = 0; i < 10; i++) {
+		CHECK(packed[i] == i * 3);
+	}
+
+	// Elements that aren't of the packed type are still converted.
+	PackedFloat32Array floats = Variant(build_array(1, 2.5, true));
+	REQUIRE(floats.size() == 3);
+	CHECK(floats[0] == 1.0f);
+	CHECK(floats[1] == 2.5f);
+	CHECK(floats[2] == 1.0f);
+
+	Callable::CallError ce;
+	Variant packed_variant = packed;
+	const Variant *args[1] = { &packed_variant };
+	Variant array_variant;
+	Variant::construct(Variant::ARRAY, array_variant, args, 1, ce);
+	REQUIRE(ce.error == Callable::CallError::CALL_OK);
+	Array array = array_variant;
+	CHECK(array.size() == 10);
+	CHECK(array[9] == Variant(27));
+
+	args[0] = &array_variant;
+	Variant vectors_variant;
+	Variant::construct(Variant::PACKED_VECTOR3_ARRAY, vectors_variant, args, 1, ce);
+	REQUIRE(ce.error == Callable::CallError::CALL_OK);
+	PackedVector3Array vectors = vectors_variant;
+	CHECK(vectors.size() == 10);
+}
+
 } // namespace TestArray
 
 #endif // TEST_ARRAY_H
@@ -500,6 +500,80 @@ TEST_CASE("[Dictionary] Recursive self comparison") {
 	d2.clear();
 }
 
+TEST_CASE("[Dictionary] Growing past the inline capacity") {
+	Dictionary map;
+	for (int i = 0; i < 8; i++) {
+		map[i] = i * 10;
+	}
+	CHECK(map.size() == 8);
+
+	// Insertion order must survive the move to hashed storage.
+	Array keys = map.keys();
+	for (int i = 0; i < 8; i++) {
+		CHECK(int(keys[i]) == i);
+		CHECK(int(map[i]) == i * 10);
+	}
+
+	map.erase(3);
+	CHECK(map.size() == 7);
+	CHECK_FALSE(map.has(3));
+	CHECK(int(map.get_key_at_index(3)) == 4);
+
+	Dictionary copy = map.duplicate();
+	map[100] = 1;
+	CHECK(copy.size() == 7);
+	CHECK_FALSE(copy.has(100));
+
+	map.clear();
+	CHECK(map.is_empty());
+	map["a"] = 1;
+	CHECK(int(map["a"]) == 1);
+}
+
+TEST_CASE("[Dictionary] Erase and iterate while stored inline") {
+	Dictionary map;
+	map["a"] = 1;
+	map["b"] = 2;
+	map["c"] = 3;
+	map.erase("b");
+	CHECK(map.size() == 2);
+	CHECK(map.keys() == build_array("a", "c"));
+	CHECK(map.values() == build_array(1, 3));
+
+	const Variant *key = map.next(nullptr);
+	REQUIRE(key);
+	CHECK(*key == "a");
+	key = map.next(key);
+	REQUIRE(key);
+	CHECK(*key == "c");
+	CHECK(map.next(key) == nullptr);
+
+	map["b"] = 4;
+	CHECK(map.get_key_at_index(2) == "b");
+	CHECK(map.getptr("missing") == nullptr);
+	CHECK(map.get_valid("missing").get_type() == Variant::NIL);
+}
+
+TEST_CASE("[Dictionary] Values keep their address") {
+	Dictionary map;
+	map["a"] = 1;
+	map["b"] = 2;
+	Variant *a = map.getptr("a");
+	REQUIRE(a);
+
+	// Neither erasing other pairs nor growing past the inline capacity moves a value.
+	map.erase("b");
+	for (int i = 0; i < 8; i++) {
+		map[i] = i;
+	}
+	CHECK(map.getptr("a") == a);
+	Variant *last = map.getptr(7);
+	map.erase(0);
+	map.erase("a");
+	CHECK(map.getptr(7) == last);
+	CHECK(map.keys()[0] == Variant(1));
+}
+
 } // namespace TestDictionary
 
 #endif // TEST_DICTIONARY_H
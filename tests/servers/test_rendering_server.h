@@ -0,0 +1,97 @@
+/*************************************************************************/
+/*  test_rendering_server.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERING_SERVER_H
+#define TEST_RENDERING_SERVER_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/templates/thread_work_pool.h"
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingServer {
+
+// Does what threaded scene imports do (GH-48265): reading meshes back from the server and
+// running scripts through the message queue both need the main thread.
+class ThreadedWork : public Object {
+public:
+	enum {
+		ELEMENT_COUNT = 8,
+	};
+
+	RID mesh;
+	Semaphore done[ELEMENT_COUNT];
+	SafeNumeric<uint32_t> queries;
+	SafeNumeric<uint32_t> main_thread_calls;
+
+	void main_thread_call(int p_element) {
+		if (Thread::get_caller_id() == Thread::get_main_id()) {
+			main_thread_calls.increment();
+		}
+		done[p_element].post();
+	}
+
+	void process(uint32_t p_element, void *p_userdata) {
+		// Returns once the main thread has flushed the server's command queue.
+		if (RenderingServer::get_singleton()->mesh_get_surface_count(mesh) == 0) {
+			queries.increment();
+		}
+		MessageQueue::get_singleton()->push_callable(callable_mp(this, &ThreadedWork::main_thread_call), p_element);
+		done[p_element].wait();
+	}
+};
+
+TEST_CASE("[SceneTree][RenderingServer] Worker threads needing the main thread while it waits for them") {
+	ThreadedWork work;
+	work.mesh = RenderingServer::get_singleton()->mesh_create();
+
+	ThreadWorkPool pool;
+	pool.init(4);
+	pool.begin_work(ThreadedWork::ELEMENT_COUNT, &work, &ThreadedWork::process, nullptr);
+	// Hangs if the last elements still running once everything was dispatched aren't waited for here.
+	do {
+		RenderingServer::get_singleton()->sync();
+		MessageQueue::get_singleton()->flush();
+		OS::get_singleton()->delay_usec(1);
+	} while (!pool.is_done_working());
+	pool.end_work();
+	pool.finish();
+
+	CHECK(work.queries.get() == ThreadedWork::ELEMENT_COUNT);
+	CHECK(work.main_thread_calls.get() == ThreadedWork::ELEMENT_COUNT);
+
+	RenderingServer::get_singleton()->free(work.mesh);
+}
+} // namespace TestRenderingServer
+
+#endif // TEST_RENDERING_SERVER_H